@@ -0,0 +1,270 @@
+
+//
+// bench_compare: Compare two sets of benchmark results and flag the regressions.
+//
+// Usage:
+//   bench_compare [options] <baseline.csv> <current.csv>
+//   bench_compare [options] -b base1.csv -b base2.csv ... -c cur1.csv -c cur2.csv ...
+//
+// The input files are the CSV reports written by jtest::BenchmarkReport
+// (set the JTEST_CSV_OUT environment variable when running a benchmark).
+// The samples of the same name in multiple files are merged, so the repeated
+// runs of a benchmark can be passed to reduce the noise.
+//
+// A result is a regression if:
+//
+//   (median_current - median_baseline) > max(k * 1.4826 * max(MAD_baseline, MAD_current),
+//                                            threshold * median_baseline)
+//
+// The units of all results are "time" (ms, ns/op, ...), so the lower is better.
+// The exit code is 1 if there is any regression, 2 for the usage or input errors, otherwise 0.
+//
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include <jstd/test/BenchmarkReport.h>
+
+struct Samples {
+    std::string unit;
+    std::vector<double> values;
+};
+
+typedef std::map<std::string, Samples> SampleMap;
+
+static void print_usage(const char * program)
+{
+    printf("Usage: %s [options] <baseline.csv> <current.csv>\n", program);
+    printf("       %s [options] -b <baseline.csv> [-b ...] -c <current.csv> [-c ...]\n\n", program);
+    printf("Options:\n");
+    printf("  -b, --baseline <file>   Add a baseline CSV file, can be repeated.\n");
+    printf("  -c, --current <file>    Add a current CSV file, can be repeated.\n");
+    printf("  -t, --threshold <ratio> The minimum relative change to report, default is 0.02 (2%%).\n");
+    printf("  -k, --mad-k <k>         The noise band in scaled MADs, default is 3.0.\n");
+    printf("  -a, --all               Print all results, not only the changed results.\n");
+    printf("  -h, --help              Print this help.\n\n");
+}
+
+//
+// Split a CSV line into fields, the quoted fields ("a,b" and "a""b") are supported.
+//
+static void split_csv_line(const std::string & line, std::vector<std::string> & fields)
+{
+    fields.clear();
+    std::string field;
+    bool in_quotes = false;
+    for (std::size_t i = 0; i < line.size(); i++) {
+        char ch = line[i];
+        if (in_quotes) {
+            if (ch == '"') {
+                if ((i + 1) < line.size() && line[i + 1] == '"') {
+                    field.push_back('"');
+                    i++;
+                } else {
+                    in_quotes = false;
+                }
+            } else {
+                field.push_back(ch);
+            }
+        } else {
+            if (ch == '"') {
+                in_quotes = true;
+            } else if (ch == ',') {
+                fields.push_back(field);
+                field.clear();
+            } else if (ch != '\r' && ch != '\n') {
+                field.push_back(ch);
+            }
+        }
+    }
+    fields.push_back(field);
+}
+
+static bool read_csv_file(const char * filename, SampleMap & samples)
+{
+    FILE * fp = ::fopen(filename, "r");
+    if (fp == nullptr) {
+        fprintf(stderr, "bench_compare: Can not open the file: %s\n", filename);
+        return false;
+    }
+
+    std::string line;
+    std::vector<std::string> fields;
+    char buffer[4096];
+    bool has_header = false;
+    std::size_t line_no = 0;
+    while (::fgets(buffer, sizeof(buffer), fp) != nullptr) {
+        line += buffer;
+        if (line.empty() || line.back() != '\n') {
+            // The line is longer than the buffer, or the last line without '\n'.
+            if (!::feof(fp))
+                continue;
+        }
+        line_no++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            line.clear();
+            continue;
+        }
+        split_csv_line(line, fields);
+        line.clear();
+
+        // Format: suite,name,unit,run,value
+        if (!has_header && fields.size() >= 1 && fields[0] == "suite") {
+            has_header = true;
+            continue;
+        }
+        if (fields.size() != 5) {
+            fprintf(stderr, "bench_compare: %s:%u: Bad format, expect 5 fields.\n",
+                    filename, (unsigned)line_no);
+            continue;
+        }
+
+        char * end_ptr = nullptr;
+        double value = ::strtod(fields[4].c_str(), &end_ptr);
+        if (end_ptr == fields[4].c_str()) {
+            fprintf(stderr, "bench_compare: %s:%u: Bad value \"%s\".\n",
+                    filename, (unsigned)line_no, fields[4].c_str());
+            continue;
+        }
+
+        std::string name = fields[0] + ":" + fields[1];
+        Samples & entry = samples[name];
+        entry.unit = fields[2];
+        entry.values.push_back(value);
+    }
+
+    ::fclose(fp);
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    std::vector<const char *> baseline_files;
+    std::vector<const char *> current_files;
+    std::vector<const char *> positional_files;
+    double threshold = 0.02;
+    double mad_k = 3.0;
+    bool print_all = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char * arg = argv[i];
+        bool has_next = ((i + 1) < argc);
+        if (::strcmp(arg, "-h") == 0 || ::strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if ((::strcmp(arg, "-b") == 0 || ::strcmp(arg, "--baseline") == 0) && has_next) {
+            baseline_files.push_back(argv[++i]);
+        } else if ((::strcmp(arg, "-c") == 0 || ::strcmp(arg, "--current") == 0) && has_next) {
+            current_files.push_back(argv[++i]);
+        } else if ((::strcmp(arg, "-t") == 0 || ::strcmp(arg, "--threshold") == 0) && has_next) {
+            threshold = ::atof(argv[++i]);
+        } else if ((::strcmp(arg, "-k") == 0 || ::strcmp(arg, "--mad-k") == 0) && has_next) {
+            mad_k = ::atof(argv[++i]);
+        } else if (::strcmp(arg, "-a") == 0 || ::strcmp(arg, "--all") == 0) {
+            print_all = true;
+        } else if (arg[0] == '-') {
+            fprintf(stderr, "bench_compare: Unknown option: %s\n\n", arg);
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            positional_files.push_back(arg);
+        }
+    }
+
+    if (baseline_files.empty() && current_files.empty() && positional_files.size() == 2) {
+        baseline_files.push_back(positional_files[0]);
+        current_files.push_back(positional_files[1]);
+    } else if (!positional_files.empty()) {
+        fprintf(stderr, "bench_compare: Too many input files, use -b and -c for multiple files.\n\n");
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (baseline_files.empty() || current_files.empty()) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    SampleMap baseline, current;
+    for (std::size_t i = 0; i < baseline_files.size(); i++) {
+        if (!read_csv_file(baseline_files[i], baseline))
+            return 2;
+    }
+    for (std::size_t i = 0; i < current_files.size(); i++) {
+        if (!read_csv_file(current_files[i], current))
+            return 2;
+    }
+
+    // 1.4826 * MAD is a consistent estimator of the standard deviation for normal distribution.
+    static const double kMadScale = 1.4826;
+
+    std::size_t num_regressions = 0, num_improvements = 0, num_unchanged = 0;
+    std::size_t num_missing = 0;
+
+    printf("threshold = %0.2f%%, noise band = %0.1f * 1.4826 * MAD\n\n", threshold * 100.0, mad_k);
+    printf("%-64s %12s %12s %9s   %s\n", "name", "baseline", "current", "change", "status");
+    printf("---------------------------------------------------------------------"
+           "----------------------------------------------\n");
+
+    for (SampleMap::const_iterator iter = baseline.begin(); iter != baseline.end(); ++iter) {
+        const std::string & name = iter->first;
+        SampleMap::const_iterator cur_iter = current.find(name);
+        if (cur_iter == current.end()) {
+            num_missing++;
+            if (print_all)
+                printf("%-64s %12s %12s %9s   %s\n", name.c_str(), "-", "-", "-", "missing");
+            continue;
+        }
+
+        const Samples & base_samples = iter->second;
+        const Samples & cur_samples = cur_iter->second;
+        double base_median = jtest::stats::median(base_samples.values);
+        double cur_median  = jtest::stats::median(cur_samples.values);
+        double base_mad = jtest::stats::mad(base_samples.values);
+        double cur_mad  = jtest::stats::mad(cur_samples.values);
+
+        double noise = mad_k * kMadScale * std::max(base_mad, cur_mad);
+        double min_delta = std::max(noise, threshold * base_median);
+        double delta = cur_median - base_median;
+        double change = (base_median != 0.0) ? (delta / base_median * 100.0) : 0.0;
+
+        const char * status;
+        if (delta > min_delta) {
+            status = "REGRESSION";
+            num_regressions++;
+        } else if (-delta > min_delta) {
+            status = "improved";
+            num_improvements++;
+        } else {
+            status = "";
+            num_unchanged++;
+            if (!print_all)
+                continue;
+        }
+
+        printf("%-64s %12.3f %12.3f %+8.2f%%   %s  (%s)\n",
+               name.c_str(), base_median, cur_median, change, status, cur_samples.unit.c_str());
+    }
+
+    for (SampleMap::const_iterator iter = current.begin(); iter != current.end(); ++iter) {
+        if (baseline.find(iter->first) == baseline.end()) {
+            if (print_all)
+                printf("%-64s %12s %12.3f %9s   %s\n", iter->first.c_str(), "-",
+                       jtest::stats::median(iter->second.values), "-", "new");
+        }
+    }
+
+    printf("\n");
+    printf("regressions: %u, improvements: %u, unchanged: %u, missing: %u\n\n",
+           (unsigned)num_regressions, (unsigned)num_improvements,
+           (unsigned)num_unchanged, (unsigned)num_missing);
+
+    return (num_regressions != 0) ? 1 : 0;
+}
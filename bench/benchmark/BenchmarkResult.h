@@ -12,6 +12,8 @@
 
 #include <stdio.h>
 
+#include "jstd/test/BenchmarkReport.h"
+
 #include <cstdint>
 #include <cstddef>
 #include <string>
@@ -213,6 +215,26 @@ public:
         return false;
     }
 
+    //
+    // Append the results to a machine-readable report, one record per container:
+    // "<category>/<test>/<container name>", Unit: ms.
+    //
+    void addToReport(BenchmarkReport & report) const {
+        for (size_type catId = 0; catId < category_size(); catId++) {
+            const BenchmarkCategory * category = category_list_[catId];
+            if (category != nullptr) {
+                for (size_type i = 0; i < category->size(); i++) {
+                    const Result & result = category->getResult(i);
+                    if (result.name != "_blank") {
+                        std::string name = category->name() + "/" + result.name;
+                        report.addSample(name + "/" + this->name1_, "ms", result.elaspedTime1);
+                        report.addSample(name + "/" + this->name2_, "ms", result.elaspedTime2);
+                    }
+                }
+            }
+        }
+    }
+
     std::string formatMsTime(double fMillisec) {
         char time_buf[256];
 
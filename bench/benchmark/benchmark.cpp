@@ -83,6 +83,8 @@
 #define USE_JSTD_ROBIN_HASH_MAP         1
 #define USE_JSTD_GROUP16_FALT_MAP       1
 #define USE_JSTD_GROUP15_FALT_MAP       1
+#define USE_JSTD_FROZEN_MAP             1
+#define USE_JSTD_STATIC_MAP             1
 #define USE_SKA_FLAT_HASH_MAP           0
 #define USE_SKA_BYTELL_HASH_MAP         0
 #define USE_ABSL_FLAT_HASH_MAP          0
@@ -125,9 +127,17 @@
 #if USE_JSTD_GROUP16_FALT_MAP
 #include <jstd/hashmap/group16_flat_map.hpp>
 #endif
-#if USE_JSTD_GROUP15_FALT_MAP
+#if USE_JSTD_GROUP15_FALT_MAP || USE_JSTD_FROZEN_MAP || USE_JSTD_STATIC_MAP
 #include <jstd/hashmap/group15_flat_map.hpp>
 #endif
+#if USE_JSTD_FROZEN_MAP
+#include <jstd/hashmap/frozen_map.hpp>
+#include <jstd/test/CountingAllocator.h>
+#endif
+#if USE_JSTD_STATIC_MAP
+#include <string_view>
+#include <jstd/hashmap/static_map.hpp>
+#endif
 #include <jstd/hashmap/hashmap_analyzer.h>
 #include <jstd/hasher/hashes.h>
 #include <jstd/hasher/hash_helper.h>
@@ -138,10 +148,15 @@
 #include <jstd/test/StopWatch.h>
 #include <jstd/test/CPUWarmUp.h>
 #include <jstd/test/ProcessMemInfo.h>
+#include <jstd/test/KeyCorpus.h>
 
 #include "BenchmarkResult.h"
 
-static std::vector<std::string> dict_words;
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+jtest::BenchmarkReport gBenchmarkReport("benchmark");
+
+// The dictionary words are mapped from the file, see jtest::KeyCorpus.
+static jtest::KeyCorpus dict_words;
 
 static std::string dict_filename;
 static bool dict_words_is_ready = false;
@@ -436,6 +451,27 @@ void reverse_value(std::uint64_t & value)
     value = ~value;
 }
 
+//
+// The keys of the dictionary words point into the mapped file directly,
+// the values and the header fields point into test_data_ss.
+//
+void make_test_data_svsv(jstd::string_view_array<jstd::string_view, jstd::string_view> & test_data_svsv,
+                         const std::vector<std::pair<std::string, std::string>> & test_data_ss) {
+    typedef typename jstd::string_view_array<jstd::string_view, jstd::string_view>::element_type element_type;
+
+    test_data_svsv.reserve(test_data_ss.size());
+    if (dict_words_is_ready) {
+        assert(dict_words.size() == test_data_ss.size());
+        for (std::size_t i = 0; i < test_data_ss.size(); i++) {
+            test_data_svsv.push_back(new element_type(dict_words[i], test_data_ss[i].second));
+        }
+    } else {
+        for (std::size_t i = 0; i < test_data_ss.size(); i++) {
+            test_data_svsv.push_back(new element_type(test_data_ss[i].first, test_data_ss[i].second));
+        }
+    }
+}
+
 template <typename Vector>
 void copy_vector_and_reverse_item(Vector & dest_list, const Vector & src_list) {
     typedef typename Vector::value_type value_type;
@@ -1244,7 +1280,7 @@ void jstd_flat16_hash_map_benchmark()
     }
     else {
         for (std::size_t i = 0; i < dict_words.size(); i++) {
-            test_data_ss.push_back(std::make_pair(dict_words[i], std::to_string(i)));
+            test_data_ss.push_back(std::make_pair(dict_words[i].to_string(), std::to_string(i)));
         }
     }
 
@@ -1327,9 +1363,7 @@ void jstd_flat16_hash_map_benchmark()
             string_view_array_t test_data_svsv;
             string_view_array_t reverse_data_svsv;
 
-            for (std::size_t i = 0; i < test_data_ss.size(); i++) {
-                test_data_svsv.push_back(new element_type(test_data_ss[i].first, test_data_ss[i].second));
-            }
+            make_test_data_svsv(test_data_svsv, test_data_ss);
             for (std::size_t i = 0; i < reverse_data_ss.size(); i++) {
                 reverse_data_svsv.push_back(new element_type(reverse_data_ss[i].first, reverse_data_ss[i].second));
             }
@@ -1351,6 +1385,7 @@ void jstd_flat16_hash_map_benchmark()
 
     printf("\n");
     test_result.printResult(dict_filename, sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
 #endif // USE_JSTD_FLAT16_HASH_MAP
 }
 
@@ -1377,7 +1412,7 @@ void jstd_robin16_hash_map_benchmark()
     }
     else {
         for (std::size_t i = 0; i < dict_words.size(); i++) {
-            test_data_ss.push_back(std::make_pair(dict_words[i], std::to_string(i)));
+            test_data_ss.push_back(std::make_pair(dict_words[i].to_string(), std::to_string(i)));
         }
     }
 
@@ -1460,9 +1495,7 @@ void jstd_robin16_hash_map_benchmark()
             string_view_array_t test_data_svsv;
             string_view_array_t reverse_data_svsv;
 
-            for (std::size_t i = 0; i < test_data_ss.size(); i++) {
-                test_data_svsv.push_back(new element_type(test_data_ss[i].first, test_data_ss[i].second));
-            }
+            make_test_data_svsv(test_data_svsv, test_data_ss);
             for (std::size_t i = 0; i < reverse_data_ss.size(); i++) {
                 reverse_data_svsv.push_back(new element_type(reverse_data_ss[i].first, reverse_data_ss[i].second));
             }
@@ -1484,6 +1517,7 @@ void jstd_robin16_hash_map_benchmark()
 
     printf("\n");
     test_result.printResult(dict_filename, sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
 #endif // USE_JSTD_ROBIN16_HASH_MAP
 }
 
@@ -1510,7 +1544,7 @@ void jstd_robin_hash_map_benchmark()
     }
     else {
         for (std::size_t i = 0; i < dict_words.size(); i++) {
-            test_data_ss.push_back(std::make_pair(dict_words[i], std::to_string(i)));
+            test_data_ss.push_back(std::make_pair(dict_words[i].to_string(), std::to_string(i)));
         }
     }
 
@@ -1593,9 +1627,7 @@ void jstd_robin_hash_map_benchmark()
             string_view_array_t test_data_svsv;
             string_view_array_t reverse_data_svsv;
 
-            for (std::size_t i = 0; i < test_data_ss.size(); i++) {
-                test_data_svsv.push_back(new element_type(test_data_ss[i].first, test_data_ss[i].second));
-            }
+            make_test_data_svsv(test_data_svsv, test_data_ss);
             for (std::size_t i = 0; i < reverse_data_ss.size(); i++) {
                 reverse_data_svsv.push_back(new element_type(reverse_data_ss[i].first, reverse_data_ss[i].second));
             }
@@ -1617,6 +1649,7 @@ void jstd_robin_hash_map_benchmark()
 
     printf("\n");
     test_result.printResult(dict_filename, sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
 #endif // USE_JSTD_ROBIN_HASH_MAP
 }
 
@@ -1643,7 +1676,7 @@ void jstd_group16_flat_map_benchmark()
     }
     else {
         for (std::size_t i = 0; i < dict_words.size(); i++) {
-            test_data_ss.push_back(std::make_pair(dict_words[i], std::to_string(i)));
+            test_data_ss.push_back(std::make_pair(dict_words[i].to_string(), std::to_string(i)));
         }
     }
 
@@ -1726,9 +1759,7 @@ void jstd_group16_flat_map_benchmark()
             string_view_array_t test_data_svsv;
             string_view_array_t reverse_data_svsv;
 
-            for (std::size_t i = 0; i < test_data_ss.size(); i++) {
-                test_data_svsv.push_back(new element_type(test_data_ss[i].first, test_data_ss[i].second));
-            }
+            make_test_data_svsv(test_data_svsv, test_data_ss);
             for (std::size_t i = 0; i < reverse_data_ss.size(); i++) {
                 reverse_data_svsv.push_back(new element_type(reverse_data_ss[i].first, reverse_data_ss[i].second));
             }
@@ -1750,6 +1781,7 @@ void jstd_group16_flat_map_benchmark()
 
     printf("\n");
     test_result.printResult(dict_filename, sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
 #endif // USE_JSTD_GROUP16_FALT_MAP
 }
 
@@ -1776,7 +1808,7 @@ void jstd_group15_flat_map_benchmark()
     }
     else {
         for (std::size_t i = 0; i < dict_words.size(); i++) {
-            test_data_ss.push_back(std::make_pair(dict_words[i], std::to_string(i)));
+            test_data_ss.push_back(std::make_pair(dict_words[i].to_string(), std::to_string(i)));
         }
     }
 
@@ -1859,9 +1891,7 @@ void jstd_group15_flat_map_benchmark()
             string_view_array_t test_data_svsv;
             string_view_array_t reverse_data_svsv;
 
-            for (std::size_t i = 0; i < test_data_ss.size(); i++) {
-                test_data_svsv.push_back(new element_type(test_data_ss[i].first, test_data_ss[i].second));
-            }
+            make_test_data_svsv(test_data_svsv, test_data_ss);
             for (std::size_t i = 0; i < reverse_data_ss.size(); i++) {
                 reverse_data_svsv.push_back(new element_type(reverse_data_ss[i].first, reverse_data_ss[i].second));
             }
@@ -1883,31 +1913,306 @@ void jstd_group15_flat_map_benchmark()
 
     printf("\n");
     test_result.printResult(dict_filename, sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
 #endif // USE_JSTD_GROUP16_FALT_MAP
 }
 
-bool read_dict_words(const std::string & filename)
+#if USE_JSTD_FROZEN_MAP || USE_JSTD_STATIC_MAP
+
+template <typename Container, typename Vector>
+void test_container_find(const Container & container, const Vector & find_data,
+                         double & elapsedTime, std::size_t & check_sum)
 {
-    bool is_ok = false;
-    try {
-        std::ifstream dict(filename.c_str());
-
-        if (dict.is_open()) {
-            std::string word;
-            while (!dict.eof()) {
-                char buf[256];
-                dict.getline(buf, sizeof(buf));
-                word = buf;
-                dict_words.push_back(word);
+    typedef typename Container::const_iterator const_iterator;
+
+    std::size_t data_length = find_data.size();
+    std::size_t repeat_times;
+    if (data_length != 0)
+        repeat_times = (kIterations / data_length) + 1;
+    else
+        repeat_times = 0;
+
+    std::size_t checksum = 0;
+    jtest::StopWatch sw;
+
+    sw.start();
+    for (std::size_t n = 0; n < repeat_times; n++) {
+        for (std::size_t i = 0; i < data_length; i++) {
+            const_iterator iter = container.find(find_data[i].first);
+            if (iter != container.end()) {
+                checksum++;
             }
+        }
+    }
+    sw.stop();
+
+    elapsedTime = sw.getElapsedMillisec();
+    check_sum = checksum;
+
+    print_test_time<Container>(check_sum, elapsedTime);
+}
+
+#endif // USE_JSTD_FROZEN_MAP || USE_JSTD_STATIC_MAP
+
+#if USE_JSTD_FROZEN_MAP
+
+//
+// Build a group15_flat_map, freeze() it into a frozen_map, then compare the memory
+// of the tables (by jtest::CountingAllocator) and the lookup time of the two maps.
+//
+template <typename Key, typename Value, typename Vector>
+void frozen_map_benchmark_simple(const std::string & cat_name,
+                                 const Vector & test_data, const Vector & reverse_data,
+                                 jtest::BenchmarkResult & result)
+{
+    typedef jtest::CountingAllocator<std::pair<const Key, Value>>   allocator_type;
+    typedef jstd::group15_flat_map<Key, Value, std::hash<Key>, std::equal_to<Key>, allocator_type>
+                                                                    map_type;
+    typedef jstd::frozen_map<Key, Value, std::hash<Key>, std::equal_to<Key>, allocator_type>
+                                                                    frozen_map_type;
+
+    std::size_t cat_id = result.addCategory(cat_name);
+
+    double elapsedTime1, elapsedTime2;
+    std::size_t checksum1, checksum2;
+
+    Vector rand_data;
+    copy_and_shuffle_vector(rand_data, test_data);
+
+    std::size_t start_bytes = jtest::AllocCounter::current_bytes();
+    map_type hashmap;
+    for (std::size_t i = 0; i < test_data.size(); i++) {
+        hashmap.emplace(test_data[i].first, test_data[i].second);
+    }
+    std::size_t map_bytes = jtest::AllocCounter::current_bytes() - start_bytes;
+
+    jtest::StopWatch sw;
+    start_bytes = jtest::AllocCounter::current_bytes();
+    sw.start();
+    frozen_map_type frozen = jstd::freeze(hashmap);
+    sw.stop();
+    std::size_t frozen_bytes = jtest::AllocCounter::current_bytes() - start_bytes;
+
+    std::size_t map_size = hashmap.size();
+    double map_bytes_per_elem = (map_size != 0) ? (double)map_bytes / map_size : 0.0;
+    double frozen_bytes_per_elem = (map_size != 0) ? (double)frozen_bytes / map_size : 0.0;
+
+    printf(" size = %" PRIuPTR ", freeze() time: %0.3f ms, collisions = %" PRIuPTR "\n",
+           map_size, sw.getElapsedMillisec(), frozen.collision_size());
+    printf(" %-36s  %10" PRIuPTR " bytes, %8.2f bytes/element\n",
+           map_type::name(), map_bytes, map_bytes_per_elem);
+    printf(" %-36s  %10" PRIuPTR " bytes, %8.2f bytes/element\n\n",
+           frozen_map_type::name(), frozen_bytes, frozen_bytes_per_elem);
+
+    gBenchmarkReport.addSample("frozen_map/" + cat_name + "/freeze", "ms", sw.getElapsedMillisec());
+    gBenchmarkReport.addSample("frozen_map/" + cat_name + "/bytes_per_element/" + map_type::name(),
+                               "bytes", map_bytes_per_elem);
+    gBenchmarkReport.addSample("frozen_map/" + cat_name + "/bytes_per_element/" + frozen_map_type::name(),
+                               "bytes", frozen_bytes_per_elem);
+
+    //
+    // test hashmap<K, V>/find/sequential
+    //
+    test_container_find(hashmap, test_data, elapsedTime1, checksum1);
+    test_container_find(frozen, test_data, elapsedTime2, checksum2);
+
+    result.addResult(cat_id, "hash_map<K, V>/find/sequential", elapsedTime1, checksum1, elapsedTime2, checksum2);
+
+    //
+    // test hashmap<K, V>/find/random
+    //
+    test_container_find(hashmap, rand_data, elapsedTime1, checksum1);
+    test_container_find(frozen, rand_data, elapsedTime2, checksum2);
+
+    result.addResult(cat_id, "hash_map<K, V>/find/random", elapsedTime1, checksum1, elapsedTime2, checksum2);
+
+    //
+    // test hashmap<K, V>/find/failed
+    //
+    test_container_find(hashmap, reverse_data, elapsedTime1, checksum1);
+    test_container_find(frozen, reverse_data, elapsedTime2, checksum2);
+
+    result.addResult(cat_id, "hash_map<K, V>/find/failed", elapsedTime1, checksum1, elapsedTime2, checksum2);
+}
+
+#endif // USE_JSTD_FROZEN_MAP
+
+void jstd_frozen_map_benchmark()
+{
+#if USE_JSTD_FROZEN_MAP
+    jtest::BenchmarkResult test_result;
+    test_result.setName("jstd::group15_flat_map", "jstd::frozen_map");
+
+    jtest::StopWatch sw;
+    sw.start();
+
+    std::vector<std::pair<std::string, std::string>> test_data_ss;
+
+    if (!dict_words_is_ready) {
+        for (std::size_t i = 0; i < kHeaderFieldSize; i++) {
+            test_data_ss.push_back(std::make_pair(std::string(header_fields[i]), std::to_string(i)));
+        }
+    }
+    else {
+        for (std::size_t i = 0; i < dict_words.size(); i++) {
+            test_data_ss.push_back(std::make_pair(dict_words[i].to_string(), std::to_string(i)));
+        }
+    }
+
+    {
+        //
+        // frozen_map<size_t, size_t>
+        //
+        std::vector<std::pair<std::size_t, std::size_t>> test_data_uu;
+        std::vector<std::pair<std::size_t, std::size_t>> reverse_data_uu;
 
-            is_ok = true;
-            dict.close();
+        for (std::size_t i = 0; i < test_data_ss.size(); i++) {
+            test_data_uu.push_back(std::make_pair(i, i + 1));
         }
+
+        copy_vector_and_reverse_item(reverse_data_uu, test_data_uu);
+
+        printf(" hash_map<std::size_t, std::size_t>\n\n");
+
+        frozen_map_benchmark_simple<std::size_t, std::size_t>("hash_map<std::size_t, std::size_t>",
+                                                              test_data_uu, reverse_data_uu, test_result);
+
+        printf("\n");
     }
-    catch (const std::exception & ex) {
-        std::cout << "read_dict_file() Exception: " << ex.what() << std::endl << std::endl;
-        is_ok = false;
+
+    {
+        //
+        // frozen_map<std::string, std::string>
+        //
+        std::vector<std::pair<std::string, std::string>> reverse_data_ss;
+        copy_vector_and_reverse_item(reverse_data_ss, test_data_ss);
+
+        printf(" hash_map<std::string, std::string>\n\n");
+
+        frozen_map_benchmark_simple<std::string, std::string>("hash_map<std::string, std::string>",
+                                                              test_data_ss, reverse_data_ss, test_result);
+
+        printf("\n");
+    }
+
+    sw.stop();
+
+    printf("\n");
+    test_result.printResult(dict_filename, sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
+#endif // USE_JSTD_FROZEN_MAP
+}
+
+#if USE_JSTD_STATIC_MAP
+
+//
+// The unique fields of header_fields[], the perfect hash is built at compile time.
+//
+static constexpr auto kHeaderFieldMap = jstd::make_static_map<std::string_view, int>({
+    // Request
+    { "Accept", 0 }, { "Accept-Charset", 1 }, { "Accept-Encoding", 2 }, { "Accept-Language", 3 },
+    { "Authorization", 4 }, { "Cache-Control", 5 }, { "Connection", 6 }, { "Cookie", 7 },
+    { "Content-Length", 8 }, { "Content-MD5", 9 }, { "Content-Type", 10 }, { "Date", 11 },
+    { "DNT", 12 }, { "From", 13 }, { "Front-End-Https", 14 }, { "Host", 15 },
+    { "If-Match", 16 }, { "If-Modified-Since", 17 }, { "If-None-Match", 18 }, { "If-Range", 19 },
+    { "If-Unmodified-Since", 20 }, { "Max-Forwards", 21 }, { "Pragma", 22 },
+    { "Proxy-Authorization", 23 }, { "Range", 24 }, { "Referer", 25 }, { "User-Agent", 26 },
+    { "Upgrade", 27 }, { "Via", 28 }, { "Warning", 29 }, { "X-ATT-DeviceId", 30 },
+    { "X-Content-Type-Options", 31 }, { "X-Forwarded-For", 32 }, { "X-Forwarded-Proto", 33 },
+    { "X-Powered-By", 34 }, { "X-Requested-With", 35 }, { "X-XSS-Protection", 36 },
+
+    // Response
+    { "Access-Control-Allow-Origin", 37 }, { "Accept-Ranges", 38 }, { "Age", 39 }, { "Allow", 40 },
+    { "Content-Encoding", 41 }, { "Content-Language", 42 }, { "Content-Disposition", 43 },
+    { "Content-Range", 44 }, { "ETag", 45 }, { "Expires", 46 }, { "Last-Modified", 47 },
+    { "Link", 48 }, { "Location", 49 }, { "P3P", 50 }, { "Proxy-Authenticate", 51 },
+    { "Refresh", 52 }, { "Retry-After", 53 }, { "Server", 54 }, { "Set-Cookie", 55 },
+    { "Strict-Transport-Security", 56 }, { "Trailer", 57 }, { "Transfer-Encoding", 58 },
+    { "Vary", 59 }, { "WWW-Authenticate", 60 }, { "Last", 61 }
+});
+
+static_assert(kHeaderFieldMap.at("Host") == 15, "kHeaderFieldMap is broken");
+
+#endif // USE_JSTD_STATIC_MAP
+
+void jstd_static_map_benchmark()
+{
+#if USE_JSTD_STATIC_MAP
+    typedef jstd::group15_flat_map<std::string_view, int>  map_type;
+    typedef std::vector<std::pair<std::string_view, int>>  Vector;
+
+    jtest::BenchmarkResult test_result;
+    test_result.setName("jstd::group15_flat_map", "jstd::static_map");
+
+    jtest::StopWatch sw;
+    sw.start();
+
+    std::size_t cat_id = test_result.addCategory("header_fields<std::string_view, int>");
+
+    map_type hashmap;
+    for (auto iter = kHeaderFieldMap.begin(); iter != kHeaderFieldMap.end(); ++iter) {
+        hashmap.emplace(iter->first, iter->second);
+    }
+
+    // The lookups of header_fields[], include the repeat fields.
+    Vector test_data;
+    for (std::size_t i = 0; i < kHeaderFieldSize; i++) {
+        test_data.push_back(std::make_pair(std::string_view(header_fields[i]), int(i)));
+    }
+
+    Vector rand_data;
+    copy_and_shuffle_vector(rand_data, test_data);
+
+    // The reversed fields are never found.
+    std::vector<std::string> reverse_fields;
+    for (std::size_t i = 0; i < kHeaderFieldSize; i++) {
+        std::string field(header_fields[i]);
+        std::reverse(field.begin(), field.end());
+        reverse_fields.push_back(field);
+    }
+    Vector reverse_data;
+    for (std::size_t i = 0; i < reverse_fields.size(); i++) {
+        reverse_data.push_back(std::make_pair(std::string_view(reverse_fields[i]), int(i)));
+    }
+
+    double elapsedTime1, elapsedTime2;
+    std::size_t checksum1, checksum2;
+
+    printf(" header_fields<std::string_view, int>\n\n");
+    printf(" size = %" PRIuPTR ", static_map: %" PRIuPTR " slots, %" PRIuPTR " bytes\n\n",
+           kHeaderFieldMap.size(), kHeaderFieldMap.bucket_count(), sizeof(kHeaderFieldMap));
+
+    test_container_find(hashmap, test_data, elapsedTime1, checksum1);
+    test_container_find(kHeaderFieldMap, test_data, elapsedTime2, checksum2);
+
+    test_result.addResult(cat_id, "hash_map<K, V>/find/sequential", elapsedTime1, checksum1, elapsedTime2, checksum2);
+
+    test_container_find(hashmap, rand_data, elapsedTime1, checksum1);
+    test_container_find(kHeaderFieldMap, rand_data, elapsedTime2, checksum2);
+
+    test_result.addResult(cat_id, "hash_map<K, V>/find/random", elapsedTime1, checksum1, elapsedTime2, checksum2);
+
+    test_container_find(hashmap, reverse_data, elapsedTime1, checksum1);
+    test_container_find(kHeaderFieldMap, reverse_data, elapsedTime2, checksum2);
+
+    test_result.addResult(cat_id, "hash_map<K, V>/find/failed", elapsedTime1, checksum1, elapsedTime2, checksum2);
+
+    sw.stop();
+
+    printf("\n");
+    test_result.printResult("header_fields", sw.getElapsedMillisec());
+    test_result.addToReport(gBenchmarkReport);
+#endif // USE_JSTD_STATIC_MAP
+}
+
+bool read_dict_words(const std::string & filename)
+{
+    bool is_ok = dict_words.load(filename);
+    if (is_ok) {
+        printf("read_dict_words(): %" PRIuPTR " words, %" PRIuPTR " bytes mapped from \"%s\".\n\n",
+               dict_words.size(), dict_words.file_size(), filename.c_str());
+    } else {
+        printf("read_dict_words(): Can't open the file \"%s\".\n\n", filename.c_str());
     }
     return is_ok;
 }
@@ -1998,6 +2303,24 @@ int main(int argc, char * argv[])
     }
 #endif
 
+#if USE_JSTD_FROZEN_MAP
+    if (1)
+    {
+        jstd_frozen_map_benchmark();
+        jstd::Console::ReadKey();
+    }
+#endif
+
+#if USE_JSTD_STATIC_MAP
+    if (1)
+    {
+        jstd_static_map_benchmark();
+        jstd::Console::ReadKey();
+    }
+#endif
+
+    gBenchmarkReport.writeFromEnv();
+
 #if defined(_MSC_VER) && defined(_DEBUG)
     //jstd::Console::ReadKey();
 #endif
@@ -0,0 +1,282 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+//
+// capacity_policy_bench: jstd::robin_hash_map with the pow2, prime and fastrange
+//                        capacity policies, the memory per element and the lookup overhead.
+//
+// Usage: capacity_policy_bench [size] [lookups]
+//
+// For each policy, insert N uint64 keys into an empty map (grow as needed), and also
+// into a map of reserve(N), N is size / 20 (in the cache) and size * { 1.0, 1.25, 1.5, 1.75, 2.0 }
+// to cover the growth sawtooth of the power of 2 capacities. And record:
+//
+//   lf:          The load factor after the insertions.
+//   alloc/elem:  The bytes allocated by the allocator (jtest::CountingAllocator) per element.
+//   insert:      The ns per insertion, include the growth.
+//   hit, miss:   The ns per find() of the existing keys and the absent keys, in a random order.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/hashmap/capacity_policy.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/CountingAllocator.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSize = 2 * 1000 * 1000;
+static const std::size_t kDefaultLookups = 8 * 1024 * 1024;
+#else
+static const std::size_t kDefaultSize = 64 * 1000;
+static const std::size_t kDefaultLookups = 256 * 1024;
+#endif
+
+// The sizes are size * kSizeScales[i] / 4.
+static const std::size_t kSizeScales[] = { 4, 5, 6, 7, 8 };
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("capacity_policy_bench");
+
+typedef std::uint64_t key_type;
+typedef std::uint64_t mapped_type;
+
+typedef jtest::CountingAllocator<std::pair<const key_type, mapped_type>> allocator_t;
+
+//
+// Policies, all use jtest::CountingAllocator.
+//
+template <typename CapacityPolicy>
+struct robin_hash_map_with {
+    typedef jstd::robin_hash_map<key_type, mapped_type, std::hash<key_type>, std::equal_to<key_type>,
+                                 jstd::capacity_layout_policy<key_type, mapped_type, CapacityPolicy>,
+                                 allocator_t> table_type;
+};
+
+struct pow2_policy : public robin_hash_map_with<jstd::pow2_capacity_policy> {
+    static const char * name() { return "pow2"; }
+};
+
+struct prime_policy : public robin_hash_map_with<jstd::prime_capacity_policy> {
+    static const char * name() { return "prime (fastmod)"; }
+};
+
+struct fastrange_policy : public robin_hash_map_with<jstd::fastrange_capacity_policy> {
+    static const char * name() { return "fastrange"; }
+};
+
+//
+// The keys are random (splitmix64 is a bijection), the keys of (i * golden_ratio)
+// are collision free for the pow2 policy with the identity hash, that's not fair.
+//
+static key_type splitmix64(std::uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31));
+}
+
+static key_type make_key(std::size_t i)
+{
+    return splitmix64(static_cast<std::uint64_t>(i));
+}
+
+// The absent keys, the highest bit of the input never appears in make_key().
+static key_type make_absent_key(std::size_t i)
+{
+    return splitmix64(static_cast<std::uint64_t>(i) | 0x8000000000000000ULL);
+}
+
+template <typename Policy>
+void measure_policy(const std::vector<key_type> & keys,
+                    const std::vector<key_type> & hit_keys,
+                    const std::vector<key_type> & miss_keys,
+                    bool need_reserve)
+{
+    typedef typename Policy::table_type table_type;
+
+    std::size_t size = keys.size();
+    std::size_t alloc_before = jtest::AllocCounter::current_bytes();
+
+    jtest::StopWatch sw;
+    table_type * table = new table_type();
+
+    sw.start();
+    if (need_reserve)
+        table->reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+        table->emplace(keys[i], mapped_type(i));
+    }
+    sw.stop();
+    double insert_ns = sw.getElapsedNanosec() / static_cast<double>(size);
+
+    std::size_t alloc_bytes = jtest::AllocCounter::current_bytes() - alloc_before + sizeof(table_type);
+    double alloc_per_elem = static_cast<double>(alloc_bytes) / static_cast<double>(size);
+    double lf = table->load_factor();
+
+    const table_type & ctable = *table;
+    std::size_t checksum = 0;
+    sw.start();
+    for (std::size_t i = 0; i < hit_keys.size(); i++) {
+        auto iter = ctable.find(hit_keys[i]);
+        if (iter != ctable.end())
+            checksum += static_cast<std::size_t>(iter->second);
+    }
+    sw.stop();
+    double hit_ns = sw.getElapsedNanosec() / static_cast<double>(hit_keys.size());
+
+    sw.start();
+    for (std::size_t i = 0; i < miss_keys.size(); i++) {
+        auto iter = ctable.find(miss_keys[i]);
+        if (iter != ctable.end())
+            checksum += static_cast<std::size_t>(iter->second);
+    }
+    sw.stop();
+    double miss_ns = sw.getElapsedNanosec() / static_cast<double>(miss_keys.size());
+
+    delete table;
+
+    printf("%-18s %-8s %8.3f %12.2f %10.2f %10.2f %10.2f   (checksum = %" PRIuPTR ")\n",
+           Policy::name(), (need_reserve ? "reserve" : "grow"),
+           lf, alloc_per_elem, insert_ns, hit_ns, miss_ns, checksum);
+    ::fflush(stdout);
+
+    std::string report_name = std::string(Policy::name()) + "/" +
+                              (need_reserve ? "reserve/" : "grow/") + std::to_string(size);
+    g_benchmark_report.addSample(report_name + "/lf", "ratio", lf);
+    g_benchmark_report.addSample(report_name + "/alloc", "bytes/elem", alloc_per_elem);
+    g_benchmark_report.addSample(report_name + "/insert", "ns/op", insert_ns);
+    g_benchmark_report.addSample(report_name + "/hit", "ns/op", hit_ns);
+    g_benchmark_report.addSample(report_name + "/miss", "ns/op", miss_ns);
+}
+
+void measure_policies(std::size_t size, std::size_t lookups)
+{
+    std::vector<key_type> keys;
+    keys.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+        keys.push_back(make_key(i));
+    }
+
+    std::vector<key_type> hit_keys, miss_keys;
+    hit_keys.reserve(lookups);
+    miss_keys.reserve(lookups);
+    jstd::MtRandomGen::srand(20240601UL);
+    for (std::size_t i = 0; i < lookups; i++) {
+        std::size_t index = static_cast<std::size_t>(jstd::MtRandomGen::nextUInt64()) % size;
+        hit_keys.push_back(make_key(index));
+        miss_keys.push_back(make_absent_key(index));
+    }
+
+    printf("size = %" PRIuPTR ", lookups = %" PRIuPTR ", sizeof(value_type) = %u bytes\n\n",
+           size, lookups, (unsigned)sizeof(std::pair<const key_type, mapped_type>));
+    printf("%-18s %-8s %8s %12s %10s %10s %10s\n",
+           "policy", "mode", "lf", "alloc/elem", "insert", "hit", "miss");
+    printf("------------------------------------------------------------------------------------\n");
+
+    for (int need_reserve = 0; need_reserve <= 1; need_reserve++) {
+        measure_policy<pow2_policy>(keys, hit_keys, miss_keys, (need_reserve != 0));
+        measure_policy<prime_policy>(keys, hit_keys, miss_keys, (need_reserve != 0));
+        measure_policy<fastrange_policy>(keys, hit_keys, miss_keys, (need_reserve != 0));
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size = kDefaultSize;
+    std::size_t lookups = kDefaultLookups;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            lookups = static_cast<std::size_t>(value);
+    }
+
+    // In the cache, the overhead of index_for_hash() is not hidden by the cache misses.
+    measure_policies(size / 20, lookups);
+
+    for (std::size_t n = 0; n < sizeof(kSizeScales) / sizeof(kSizeScales[0]); n++) {
+        measure_policies(size * kSizeScales[n] / 4, lookups);
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
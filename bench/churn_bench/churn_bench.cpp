@@ -0,0 +1,243 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+//
+//
+// churn_bench: The steady-state probe length and throughput of jstd::flat16_hash_map
+//              under the insert/erase churn at a flat size.
+//
+// Usage: churn_bench [size] [epochs] [max_load_factor]
+//
+// The map is set to max_load_factor (default 0.75) and filled to size (default 1M)
+// uint64 keys, then each epoch erases size random live keys and inserts size new keys,
+// so size() never changes.
+// After each epoch, these are printed:
+//
+//   capacity:  slot_capacity(), must not grow after the first epochs.
+//   deleted:   slot_deleted() / slot_capacity(), the ratio of the tombstones.
+//   probe:     the average number of groups probed by find(), by probe_length()
+//              of all the live keys.
+//   ns/op:     the time of the churn operations, per erase or insert.
+//
+// flat16_hash_map drops the tombstones in place when slot_deleted() reach 1/8 of
+// the capacity, or when the table is full but size() is less than 25/32 of the threshold.
+// jstd::robin_hash_map (backward shift deletion, no tombstones) is the reference
+// of the throughput.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/flat16_hash_map.h>
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSize = 1000 * 1000;
+static const std::size_t kDefaultEpochs = 12;
+#else
+static const std::size_t kDefaultSize = 24 * 1000;
+static const std::size_t kDefaultEpochs = 4;
+#endif
+static const float kDefaultMaxLoadFactor = 0.75f;
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("churn_bench");
+
+typedef std::uint64_t key_type;
+typedef std::uint64_t mapped_type;
+
+// splitmix64, the keys are unique for the different counters.
+static key_type make_key(std::uint64_t counter)
+{
+    std::uint64_t z = counter + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31));
+}
+
+// xorshift64, to pick the live keys to erase.
+static std::uint64_t next_random(std::uint64_t & state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+template <typename Map>
+struct MapStats {
+    static std::size_t capacity(const Map & map) { return map.bucket_count(); }
+    static double deleted_ratio(const Map &) { return 0.0; }
+    static double probe_length(const Map &, const std::vector<key_type> &) { return 0.0; }
+};
+
+template <typename K, typename V>
+struct MapStats<jstd::flat16_hash_map<K, V>> {
+    typedef jstd::flat16_hash_map<K, V> map_type;
+
+    static std::size_t capacity(const map_type & map) { return map.slot_capacity(); }
+
+    static double deleted_ratio(const map_type & map) {
+        return (static_cast<double>(map.slot_deleted()) / map.slot_capacity());
+    }
+
+    static double probe_length(const map_type & map, const std::vector<key_type> & keys) {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < keys.size(); i++) {
+            total += map.probe_length(keys[i]);
+        }
+        return (keys.empty() ? 0.0 : (static_cast<double>(total) / keys.size()));
+    }
+};
+
+template <typename Map>
+void run_churn(const char * name, std::size_t size, std::size_t epochs, float mlf)
+{
+    typedef MapStats<Map> stats_type;
+
+    std::vector<key_type> live_keys(size);
+    std::uint64_t counter = 0;
+    std::uint64_t random_state = 20240815ULL;
+
+    Map map;
+    map.max_load_factor(mlf);
+    for (std::size_t i = 0; i < size; i++) {
+        live_keys[i] = make_key(counter++);
+        map.emplace(live_keys[i], mapped_type(i));
+    }
+
+    jtest::StopWatch sw;
+    double total_ns = 0.0;
+
+    for (std::size_t epoch = 0; epoch < epochs; epoch++) {
+        sw.start();
+        for (std::size_t i = 0; i < size; i++) {
+            std::size_t pos = static_cast<std::size_t>(next_random(random_state) % size);
+            map.erase(live_keys[pos]);
+            live_keys[pos] = make_key(counter++);
+            map.emplace(live_keys[pos], mapped_type(i));
+        }
+        sw.stop();
+
+        double ns_per_op = sw.getElapsedNanosec() / (2.0 * size);
+        total_ns += ns_per_op;
+
+        double deleted = stats_type::deleted_ratio(map) * 100.0;
+        double probe = stats_type::probe_length(map, live_keys);
+        printf("%-28s %6" PRIuPTR " %10" PRIuPTR " %12" PRIuPTR " %10.2f%% %8.3f %10.2f\n",
+               name, epoch, map.size(), stats_type::capacity(map), deleted, probe, ns_per_op);
+        ::fflush(stdout);
+
+        std::string report_name = std::string(name) + "/" + std::to_string(epoch);
+        g_benchmark_report.addSample(report_name + "/time", "ns/op", ns_per_op);
+        g_benchmark_report.addSample(report_name + "/probe", "groups", probe);
+    }
+
+    printf("%-28s %6s %10s %12s %11s %8s %10.2f\n\n", name, "avg", "", "", "", "",
+           (epochs != 0) ? (total_ns / epochs) : 0.0);
+    g_benchmark_report.addSample(std::string(name) + "/avg/time", "ns/op",
+                                 (epochs != 0) ? (total_ns / epochs) : 0.0);
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size = kDefaultSize;
+    std::size_t epochs = kDefaultEpochs;
+    float mlf = kDefaultMaxLoadFactor;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            epochs = static_cast<std::size_t>(value);
+    }
+    if (argc > 3) {
+        double value = ::atof(argv[3]);
+        if (value > 0.0)
+            mlf = static_cast<float>(value);
+    }
+
+    printf("size = %" PRIuPTR ", epochs = %" PRIuPTR ", ops/epoch = %" PRIuPTR
+           ", max_load_factor = %0.2f\n\n", size, epochs, size * 2, mlf);
+    printf("%-28s %6s %10s %12s %11s %8s %10s\n",
+           "map", "epoch", "size", "capacity", "deleted", "probe", "ns/op");
+    printf("---------------------------------------------------------------------------------------\n");
+
+    run_churn<jstd::flat16_hash_map<key_type, mapped_type>>("jstd::flat16_hash_map", size, epochs, mlf);
+    run_churn<jstd::robin_hash_map<key_type, mapped_type>>("jstd::robin_hash_map", size, epochs, mlf);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
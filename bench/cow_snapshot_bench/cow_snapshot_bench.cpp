@@ -0,0 +1,407 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// cow_snapshot_bench: The cost of a consistent snapshot of a map, and of the writes after it.
+//
+// Usage: cow_snapshot_bench [size_K]
+//
+// The maps are uint64_t -> uint64_t with size_K (default 1024) K random keys.
+//
+//   snapshot:  a deep copy of group15_flat_map vs. snapshot() of group15_cow_flat_map,
+//              and find() on the snapshot vs. find() on group15_flat_map.
+//   writer:    the ns/op of a stream of assign / erase / insert on group15_flat_map,
+//              on group15_cow_flat_map without a snapshot, and with a live snapshot
+//              (the first write to each page copies it), and the number of copied pages.
+//   reader:    a thread sums the values of snapshots while the writer keeps updating
+//              the map, each sum must be the sum when the snapshot was taken.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/group15_cow_flat_map.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSizeK = 1024;
+#else
+static const std::size_t kDefaultSizeK = 64;
+#endif
+
+static const std::uint64_t kSeed = 20241212ull;
+
+// The writes between two snapshots, in percent of the size.
+static const std::size_t kWriteRates[] = { 1, 10, 100 };
+
+// The snapshots taken by the reader test.
+static const std::size_t kReaderSnapshots = 16;
+
+typedef jstd::group15_flat_map<std::uint64_t, std::uint64_t>      flat_map_t;
+typedef jstd::group15_cow_flat_map<std::uint64_t, std::uint64_t>  cow_map_t;
+typedef typename cow_map_t::snapshot_type                          snapshot_t;
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("cow_snapshot_bench");
+
+static void report(const std::string & name, double elapsed_ns, std::size_t ops, const char * note)
+{
+    double ns_per_op = elapsed_ns / ops;
+    printf("%-40s %10.3f %10.2f   %s\n", name.c_str(), elapsed_ns / 1.0E6, ns_per_op, note);
+    ::fflush(stdout);
+
+    g_benchmark_report.addSample(name + "/ns_per_op", "ns/op", ns_per_op);
+}
+
+template <typename HashMap>
+static std::uint64_t sum_values(const HashMap & map)
+{
+    std::uint64_t sum = 0;
+    for (auto iter = map.begin(); iter != map.end(); ++iter) {
+        sum += iter->second;
+    }
+    return sum;
+}
+
+template <typename HashMap>
+static std::size_t find_all(const HashMap & map, const std::vector<std::uint64_t> & keys)
+{
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        found += (map.find(keys[i]) != map.end());
+    }
+    return found;
+}
+
+//
+// The writes: assign, erase and insert in turn, the erased keys are inserted again later,
+// so the size stays about the same.
+//
+struct WriteOp {
+    std::uint64_t key;
+    std::uint64_t value;
+    int           type;
+};
+
+static std::vector<WriteOp> make_writes(const std::vector<std::uint64_t> & keys,
+                                        std::size_t num_writes, std::uint64_t seed)
+{
+    std::vector<WriteOp> writes(num_writes);
+    jstd::Xoshiro256 random(seed);
+    for (std::size_t i = 0; i < num_writes; i++) {
+        WriteOp & op = writes[i];
+        op.key = keys[static_cast<std::size_t>(random.rand() % keys.size())];
+        op.value = random.rand();
+        op.type = static_cast<int>(i % 3);
+    }
+    return writes;
+}
+
+template <typename HashMap>
+static void apply_write(HashMap & map, const WriteOp & op)
+{
+    switch (op.type) {
+        case 0:
+            map.insert_or_assign(op.key, op.value);
+            break;
+        case 1:
+            map.erase(op.key);
+            break;
+        default:
+            map.insert(std::make_pair(op.key, op.value));
+            break;
+    }
+}
+
+static void bench_snapshot(const std::vector<std::uint64_t> & keys)
+{
+    jtest::StopWatch sw;
+
+    flat_map_t flat_map;
+    cow_map_t cow_map;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        flat_map.insert(std::make_pair(keys[i], keys[i]));
+        cow_map.insert(std::make_pair(keys[i], keys[i]));
+    }
+
+    sw.start();
+    flat_map_t flat_copy(flat_map);
+    sw.stop();
+    report("group15_flat_map/copy", sw.getElapsedNanosec(), keys.size(),
+           (flat_copy.size() == keys.size()) ? "" : "MISMATCH");
+
+    sw.start();
+    snapshot_t snapshot = cow_map.snapshot();
+    sw.stop();
+    char note[128];
+    snprintf(note, sizeof(note), "%s%" PRIuPTR " pages of %" PRIuPTR " bytes",
+             (snapshot.size() == keys.size()) ? "" : "MISMATCH ",
+             cow_map.page_count(), cow_map.page_bytes());
+    report("group15_cow_flat_map/snapshot", sw.getElapsedNanosec(), keys.size(), note);
+
+    sw.start();
+    std::size_t found = find_all(flat_map, keys);
+    sw.stop();
+    report("group15_flat_map/find", sw.getElapsedNanosec(), keys.size(),
+           (found == keys.size()) ? "" : "MISMATCH");
+
+    sw.start();
+    found = find_all(snapshot, keys);
+    sw.stop();
+    report("group15_cow_flat_map/snapshot.find", sw.getElapsedNanosec(), keys.size(),
+           (found == keys.size()) ? "" : "MISMATCH");
+
+    sw.start();
+    std::uint64_t sum = sum_values(flat_map);
+    sw.stop();
+    report("group15_flat_map/iterate", sw.getElapsedNanosec(), keys.size(), "");
+
+    sw.start();
+    std::uint64_t snapshot_sum = sum_values(snapshot);
+    sw.stop();
+    report("group15_cow_flat_map/snapshot.iterate", sw.getElapsedNanosec(), keys.size(),
+           (snapshot_sum == sum) ? "" : "MISMATCH");
+    printf("\n");
+}
+
+//
+// The writes after a snapshot: each round takes a snapshot and applies rate% writes,
+// so the pages are shared again at the start of every round.
+//
+static void bench_writer(const std::vector<std::uint64_t> & keys)
+{
+    jtest::StopWatch sw;
+
+    for (std::size_t r = 0; r < sizeof(kWriteRates) / sizeof(kWriteRates[0]); r++) {
+        std::size_t rate = kWriteRates[r];
+        std::size_t num_writes = keys.size() * rate / 100;
+        std::size_t rounds = (rate < 100) ? (100 / rate) : 1;
+        std::vector<WriteOp> writes = make_writes(keys, num_writes, ~kSeed + rate);
+        std::size_t total_writes = num_writes * rounds;
+        std::string prefix = std::to_string(rate) + "%";
+
+        flat_map_t flat_map;
+        cow_map_t cow_map, cow_snap_map;
+        for (std::size_t i = 0; i < keys.size(); i++) {
+            flat_map.insert(std::make_pair(keys[i], keys[i]));
+            cow_map.insert(std::make_pair(keys[i], keys[i]));
+            cow_snap_map.insert(std::make_pair(keys[i], keys[i]));
+        }
+
+        sw.start();
+        for (std::size_t round = 0; round < rounds; round++) {
+            for (std::size_t i = 0; i < writes.size(); i++) {
+                apply_write(flat_map, writes[i]);
+            }
+        }
+        sw.stop();
+        report("group15_flat_map/write/" + prefix, sw.getElapsedNanosec(), total_writes, "");
+
+        sw.start();
+        for (std::size_t round = 0; round < rounds; round++) {
+            for (std::size_t i = 0; i < writes.size(); i++) {
+                apply_write(cow_map, writes[i]);
+            }
+        }
+        sw.stop();
+        report("group15_cow_flat_map/write/" + prefix, sw.getElapsedNanosec(), total_writes,
+               (cow_map.size() == flat_map.size()) ? "" : "MISMATCH");
+
+        // Includes the time of the snapshots and of releasing the old pages.
+        std::size_t copied_pages = cow_snap_map.copied_pages();
+        bool is_consistent = true;
+        sw.start();
+        for (std::size_t round = 0; round < rounds; round++) {
+            snapshot_t snapshot = cow_snap_map.snapshot();
+            std::size_t snapshot_size = snapshot.size();
+            for (std::size_t i = 0; i < writes.size(); i++) {
+                apply_write(cow_snap_map, writes[i]);
+            }
+            is_consistent = is_consistent && (snapshot.size() == snapshot_size);
+        }
+        sw.stop();
+        copied_pages = cow_snap_map.copied_pages() - copied_pages;
+
+        char note[128];
+        snprintf(note, sizeof(note), "%s%" PRIuPTR " pages copied of %" PRIuPTR " per round",
+                 (is_consistent && cow_snap_map.size() == flat_map.size()) ? "" : "MISMATCH ",
+                 copied_pages / rounds, cow_snap_map.page_count());
+        report("group15_cow_flat_map/snapshot+write/" + prefix, sw.getElapsedNanosec(),
+               total_writes, note);
+        printf("\n");
+    }
+}
+
+//
+// The reader thread sums each snapshot and checks the sum, while the writer thread keeps
+// writing to the map. The snapshots are taken by the writer and handed to the reader.
+//
+static void bench_reader(const std::vector<std::uint64_t> & keys)
+{
+    cow_map_t cow_map;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        cow_map.insert(std::make_pair(keys[i], keys[i]));
+    }
+    std::vector<WriteOp> writes = make_writes(keys, keys.size(), kSeed + 1);
+
+    std::mutex lock;
+    std::condition_variable cond;
+    snapshot_t pending;
+    std::uint64_t pending_sum = 0;
+    bool has_pending = false;
+    bool is_done = false;
+    std::atomic<std::size_t> mismatches(0);
+    std::atomic<std::size_t> checked(0);
+
+    std::thread reader([&]() {
+        for (;;) {
+            snapshot_t snapshot;
+            std::uint64_t expected_sum;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                cond.wait(guard, [&]() { return has_pending || is_done; });
+                if (!has_pending)
+                    break;
+                snapshot = std::move(pending);
+                expected_sum = pending_sum;
+                has_pending = false;
+            }
+            cond.notify_all();
+            if (sum_values(snapshot) != expected_sum)
+                mismatches++;
+            checked++;
+        }
+    });
+
+    jtest::StopWatch sw;
+    std::size_t write_index = 0;
+    std::size_t writes_per_snapshot = writes.size() / kReaderSnapshots;
+    sw.start();
+    for (std::size_t s = 0; s < kReaderSnapshots; s++) {
+        snapshot_t snapshot = cow_map.snapshot();
+        std::uint64_t sum = sum_values(snapshot);
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            cond.wait(guard, [&]() { return !has_pending; });
+            pending = std::move(snapshot);
+            pending_sum = sum;
+            has_pending = true;
+        }
+        cond.notify_all();
+        for (std::size_t i = 0; i < writes_per_snapshot; i++) {
+            apply_write(cow_map, writes[write_index++]);
+        }
+    }
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        is_done = true;
+    }
+    cond.notify_all();
+    reader.join();
+    sw.stop();
+
+    char note[128];
+    snprintf(note, sizeof(note), "%s%" PRIuPTR " snapshots checked",
+             (mismatches.load() == 0 && checked.load() == kReaderSnapshots) ? "" : "MISMATCH ",
+             checked.load());
+    report("group15_cow_flat_map/reader+writer", sw.getElapsedNanosec(), write_index, note);
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size_k = kDefaultSizeK;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size_k = static_cast<std::size_t>(value);
+    }
+
+    std::size_t size = size_k * 1024;
+    std::vector<std::uint64_t> keys(size);
+    jstd::Xoshiro256x4 random(kSeed);
+    random.fill(keys.data(), keys.size());
+
+    printf("size = %" PRIuPTR " K\n\n", size_k);
+    printf("%-40s %10s %10s\n", "name", "total (ms)", "ns/op");
+    printf("--------------------------------------------------------------\n");
+
+    bench_snapshot(keys);
+    bench_writer(keys);
+    bench_reader(keys);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
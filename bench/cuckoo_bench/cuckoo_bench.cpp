@@ -0,0 +1,326 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// cuckoo_bench: jstd::cuckoo_flat_map (4-way and 8-way buckets) vs. the other engines,
+//               the load factor, the memory per element and the lookup latency.
+//
+// Usage: cuckoo_bench [size] [lookups]
+//
+// Part 1, the max load factor: fill a cuckoo_flat_map of a fixed capacity with
+//         max_load_factor(1.0), until the first insertion can't find a displacement path.
+//
+// Part 2, for each engine, insert size (default 4M) uint64 keys into an empty map, and record:
+//
+//   lf:          The load factor after the insertions.
+//   alloc/elem:  The bytes allocated by the allocator (jtest::CountingAllocator) per element.
+//   insert:      The ns per insertion, include the growth.
+//   hit, miss:   The ns per find() of the existing keys and the absent keys, in a random order.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/cuckoo_flat_map.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/CountingAllocator.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSize = 3800 * 1000;
+static const std::size_t kDefaultLookups = 8 * 1024 * 1024;
+#else
+static const std::size_t kDefaultSize = 64 * 1024;
+static const std::size_t kDefaultLookups = 256 * 1024;
+#endif
+
+// The capacities (in slots) of the max load factor test.
+static const std::size_t kFillCapacities[] = { 1 << 12, 1 << 16, 1 << 20, 1 << 23 };
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("cuckoo_bench");
+
+typedef std::uint64_t key_type;
+typedef std::uint64_t mapped_type;
+
+typedef jtest::CountingAllocator<std::pair<const key_type, mapped_type>> allocator_t;
+
+//
+// Engines, all use jtest::CountingAllocator.
+//
+struct std_unordered_map {
+    typedef std::unordered_map<key_type, mapped_type, std::hash<key_type>,
+                               std::equal_to<key_type>, allocator_t> table_type;
+    static const char * name() { return "std::unordered_map"; }
+};
+
+struct jstd_robin_hash_map {
+    typedef jstd::robin_hash_map<key_type, mapped_type, std::hash<key_type>, std::equal_to<key_type>,
+                                 jstd::default_layout_policy<key_type, mapped_type>, allocator_t> table_type;
+    static const char * name() { return "jstd::robin_hash_map"; }
+};
+
+struct jstd_group16_flat_map {
+    typedef jstd::group16_flat_map<key_type, mapped_type, std::hash<key_type>,
+                                   std::equal_to<key_type>, allocator_t> table_type;
+    static const char * name() { return "jstd::group16_flat_map"; }
+};
+
+struct jstd_group15_flat_map {
+    typedef jstd::group15_flat_map<key_type, mapped_type, std::hash<key_type>,
+                                   std::equal_to<key_type>, allocator_t> table_type;
+    static const char * name() { return "jstd::group15_flat_map"; }
+};
+
+template <std::size_t BucketWidth>
+struct jstd_cuckoo_flat_map {
+    typedef jstd::cuckoo_flat_map<key_type, mapped_type, std::hash<key_type>,
+                                  std::equal_to<key_type>, allocator_t, BucketWidth> table_type;
+    static const char * name() { return table_type::name(); }
+};
+
+static key_type make_key(std::size_t i)
+{
+    return (static_cast<key_type>(i) * 0x9E3779B97F4A7C15ULL);
+}
+
+// The absent keys, the odd multiplier never produces a key of make_key().
+static key_type make_absent_key(std::size_t i)
+{
+    return (static_cast<key_type>(i) * 0x9E3779B97F4A7C15ULL + 1);
+}
+
+//
+// Part 1: The load factor of the first insertion that fails to find a displacement path.
+//
+template <std::size_t BucketWidth>
+void measure_max_load_factor()
+{
+    typedef typename jstd_cuckoo_flat_map<BucketWidth>::table_type table_type;
+
+    printf("%s, max_load_factor(1.0)\n\n", table_type::name());
+    printf("%12s %12s %12s %14s\n", "capacity", "max size", "max lf", "displace/elem");
+    printf("-------------------------------------------------------\n");
+
+    for (std::size_t n = 0; n < sizeof(kFillCapacities) / sizeof(kFillCapacities[0]); n++) {
+        std::size_t capacity = kFillCapacities[n];
+        table_type table;
+        table.max_load_factor(1.0f);
+        table.reserve(capacity);
+        std::size_t slot_capacity = table.slot_capacity();
+
+        std::size_t max_size = 0;
+        for (std::size_t i = 0; i < slot_capacity + 1; i++) {
+            table.emplace(make_key(i), mapped_type(i));
+            if (table.slot_capacity() != slot_capacity)
+                break;
+            max_size = table.size();
+        }
+
+        double max_lf = static_cast<double>(max_size) / static_cast<double>(slot_capacity);
+        double displace_per_elem = static_cast<double>(table.displace_count()) / static_cast<double>(max_size);
+        printf("%12" PRIuPTR " %12" PRIuPTR " %12.4f %14.3f\n",
+               slot_capacity, max_size, max_lf, displace_per_elem);
+
+        std::string report_name = std::string(table_type::name()) + "/" + std::to_string(slot_capacity);
+        g_benchmark_report.addSample(report_name + "/max_lf", "ratio", max_lf);
+    }
+
+    printf("\n");
+    ::fflush(stdout);
+}
+
+//
+// Part 2: The load factor, the memory and the latency of an engine.
+//
+template <typename Engine>
+void measure_engine(const std::vector<key_type> & keys,
+                    const std::vector<key_type> & hit_keys,
+                    const std::vector<key_type> & miss_keys)
+{
+    typedef typename Engine::table_type table_type;
+
+    std::size_t size = keys.size();
+    std::size_t alloc_before = jtest::AllocCounter::current_bytes();
+
+    jtest::StopWatch sw;
+    table_type * table = new table_type();
+
+    sw.start();
+    for (std::size_t i = 0; i < size; i++) {
+        table->emplace(keys[i], mapped_type(i));
+    }
+    sw.stop();
+    double insert_ns = sw.getElapsedNanosec() / static_cast<double>(size);
+
+    std::size_t alloc_bytes = jtest::AllocCounter::current_bytes() - alloc_before + sizeof(table_type);
+    double alloc_per_elem = static_cast<double>(alloc_bytes) / static_cast<double>(size);
+    double lf = table->load_factor();
+
+    const table_type & ctable = *table;
+    std::size_t checksum = 0;
+    sw.start();
+    for (std::size_t i = 0; i < hit_keys.size(); i++) {
+        auto iter = ctable.find(hit_keys[i]);
+        if (iter != ctable.end())
+            checksum += static_cast<std::size_t>(iter->second);
+    }
+    sw.stop();
+    double hit_ns = sw.getElapsedNanosec() / static_cast<double>(hit_keys.size());
+
+    sw.start();
+    for (std::size_t i = 0; i < miss_keys.size(); i++) {
+        auto iter = ctable.find(miss_keys[i]);
+        if (iter != ctable.end())
+            checksum += static_cast<std::size_t>(iter->second);
+    }
+    sw.stop();
+    double miss_ns = sw.getElapsedNanosec() / static_cast<double>(miss_keys.size());
+
+    delete table;
+
+    printf("%-28s %8.3f %12.2f %10.2f %10.2f %10.2f   (checksum = %" PRIuPTR ")\n",
+           Engine::name(), lf, alloc_per_elem, insert_ns, hit_ns, miss_ns, checksum);
+    ::fflush(stdout);
+
+    std::string report_name = std::string(Engine::name()) + "/" + std::to_string(size);
+    g_benchmark_report.addSample(report_name + "/lf", "ratio", lf);
+    g_benchmark_report.addSample(report_name + "/alloc", "bytes/elem", alloc_per_elem);
+    g_benchmark_report.addSample(report_name + "/insert", "ns/op", insert_ns);
+    g_benchmark_report.addSample(report_name + "/hit", "ns/op", hit_ns);
+    g_benchmark_report.addSample(report_name + "/miss", "ns/op", miss_ns);
+}
+
+void measure_engines(std::size_t size, std::size_t lookups)
+{
+    std::vector<key_type> keys;
+    keys.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+        keys.push_back(make_key(i));
+    }
+
+    std::vector<key_type> hit_keys, miss_keys;
+    hit_keys.reserve(lookups);
+    miss_keys.reserve(lookups);
+    jstd::MtRandomGen::srand(20240601UL);
+    for (std::size_t i = 0; i < lookups; i++) {
+        std::size_t index = static_cast<std::size_t>(jstd::MtRandomGen::nextUInt64()) % size;
+        hit_keys.push_back(make_key(index));
+        miss_keys.push_back(make_absent_key(index));
+    }
+
+    printf("size = %" PRIuPTR ", lookups = %" PRIuPTR ", sizeof(value_type) = %u bytes\n\n",
+           size, lookups, (unsigned)sizeof(std::pair<const key_type, mapped_type>));
+    printf("%-28s %8s %12s %10s %10s %10s\n",
+           "engine", "lf", "alloc/elem", "insert", "hit", "miss");
+    printf("------------------------------------------------------------------------------------\n");
+
+    measure_engine<std_unordered_map>(keys, hit_keys, miss_keys);
+    measure_engine<jstd_robin_hash_map>(keys, hit_keys, miss_keys);
+    measure_engine<jstd_group16_flat_map>(keys, hit_keys, miss_keys);
+    measure_engine<jstd_group15_flat_map>(keys, hit_keys, miss_keys);
+    measure_engine<jstd_cuckoo_flat_map<4>>(keys, hit_keys, miss_keys);
+    measure_engine<jstd_cuckoo_flat_map<8>>(keys, hit_keys, miss_keys);
+
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size = kDefaultSize;
+    std::size_t lookups = kDefaultLookups;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            lookups = static_cast<std::size_t>(value);
+    }
+
+    measure_max_load_factor<4>();
+    measure_max_load_factor<8>();
+
+    // The load factors of the engines depend on where the size is in the growth sawtooth,
+    // so measure at the size and 1.5x the size.
+    measure_engines(size, lookups);
+    measure_engines(size + size / 2, lookups);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
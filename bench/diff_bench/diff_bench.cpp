@@ -0,0 +1,300 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// diff_bench: Map equality and diff(), by the group walk vs. the plain for + find() loop.
+//
+// Usage: diff_bench [size_K]
+//
+// The maps are uint64_t -> uint64_t with size_K (default 1024) K random keys. For each change
+// rate of 1%, 10% and 50%, the new map is changed from the old map by: 1/3 of the changes
+// assign a new value, 1/3 erase a key, 1/3 insert a new key. The new map is made in two ways:
+//
+//   copy:     a copy of the old map, then changed, the capacity is the same, and most groups
+//             are still identical to the old ones (the memcmp fast path).
+//   rebuilt:  the entries of the copy inserted into a new map of a different capacity,
+//             every key must be looked up.
+//
+// For group15_flat_map and group16_flat_map, time operator == and diff() against the loops
+// that find() each key of one map in the other one. The change counts must match.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSizeK = 1024;
+#else
+static const std::size_t kDefaultSizeK = 64;
+#endif
+
+static const std::uint64_t kSeed = 20241212ull;
+
+// The change rates, in percent.
+static const std::size_t kChangeRates[] = { 1, 10, 50 };
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("diff_bench");
+
+struct DiffCounts {
+    std::size_t added;
+    std::size_t removed;
+    std::size_t changed;
+
+    DiffCounts() : added(0), removed(0), changed(0) {}
+
+    std::size_t total() const { return (added + removed + changed); }
+
+    bool operator == (const DiffCounts & rhs) const {
+        return (added == rhs.added && removed == rhs.removed && changed == rhs.changed);
+    }
+};
+
+template <typename HashMap>
+static bool naive_equals(const HashMap & lhs, const HashMap & rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (auto iter = lhs.begin(); iter != lhs.end(); ++iter) {
+        auto other = rhs.find(iter->first);
+        if (other == rhs.end() || !(other->second == iter->second))
+            return false;
+    }
+    return true;
+}
+
+template <typename HashMap>
+static DiffCounts naive_diff(const HashMap & old_map, const HashMap & new_map)
+{
+    DiffCounts counts;
+    for (auto iter = old_map.begin(); iter != old_map.end(); ++iter) {
+        auto other = new_map.find(iter->first);
+        if (other == new_map.end())
+            counts.removed++;
+        else if (!(other->second == iter->second))
+            counts.changed++;
+    }
+    for (auto iter = new_map.begin(); iter != new_map.end(); ++iter) {
+        if (old_map.find(iter->first) == old_map.end())
+            counts.added++;
+    }
+    return counts;
+}
+
+template <typename HashMap>
+static DiffCounts fast_diff(const HashMap & old_map, const HashMap & new_map)
+{
+    typedef typename HashMap::value_type value_type;
+
+    DiffCounts counts;
+    jstd::diff(old_map, new_map,
+               [&](const value_type &) { counts.added++; },
+               [&](const value_type &) { counts.removed++; },
+               [&](const value_type &, const value_type &) { counts.changed++; });
+    return counts;
+}
+
+static void report(const std::string & name, double elapsed_ns, std::size_t entries, const char * note)
+{
+    double ns_per_entry = elapsed_ns / entries;
+    printf("%-36s %10.3f %10.2f   %s\n", name.c_str(), elapsed_ns / 1.0E6, ns_per_entry, note);
+    ::fflush(stdout);
+
+    g_benchmark_report.addSample(name + "/ns_per_entry", "ns/op", ns_per_entry);
+}
+
+//
+// Changes rate% of the entries of the map: assign, erase and insert in turn.
+// Returns the expected diff counts.
+//
+template <typename HashMap>
+static DiffCounts change_map(HashMap & map, const std::vector<std::uint64_t> & keys,
+                             std::size_t rate, jstd::Xoshiro256 & random)
+{
+    DiffCounts expected;
+    std::size_t num_changes = keys.size() * rate / 100;
+    std::vector<std::uint64_t> victims(keys);
+    jstd::random_shuffle<jstd::Xoshiro256x4>(victims.begin(), victims.end(), random.rand());
+
+    for (std::size_t i = 0; i < num_changes; i++) {
+        std::uint64_t key = victims[i];
+        switch (i % 3) {
+            case 0:
+                map[key] = ~map[key];
+                expected.changed++;
+                break;
+            case 1:
+                map.erase(key);
+                expected.removed++;
+                break;
+            default: {
+                std::uint64_t new_key = random.rand();
+                if (map.insert(std::make_pair(new_key, new_key)).second)
+                    expected.added++;
+                break;
+            }
+        }
+    }
+    return expected;
+}
+
+template <typename HashMap>
+static void bench_one(const std::string & prefix, const HashMap & old_map,
+                      const HashMap & new_map, const DiffCounts & expected)
+{
+    std::size_t entries = old_map.size() + new_map.size();
+    jtest::StopWatch sw;
+
+    sw.start();
+    bool is_equal = naive_equals(old_map, new_map);
+    sw.stop();
+    report(prefix + "/naive_equals", sw.getElapsedNanosec(), entries,
+           (is_equal == (expected.total() == 0)) ? "" : "MISMATCH");
+
+    sw.start();
+    is_equal = (old_map == new_map);
+    sw.stop();
+    report(prefix + "/operator==", sw.getElapsedNanosec(), entries,
+           (is_equal == (expected.total() == 0)) ? "" : "MISMATCH");
+
+    sw.start();
+    DiffCounts counts = naive_diff(old_map, new_map);
+    sw.stop();
+    report(prefix + "/naive_diff", sw.getElapsedNanosec(), entries,
+           (counts == expected) ? "" : "MISMATCH");
+
+    sw.start();
+    counts = fast_diff(old_map, new_map);
+    sw.stop();
+    report(prefix + "/diff", sw.getElapsedNanosec(), entries,
+           (counts == expected) ? "" : "MISMATCH");
+}
+
+template <typename HashMap>
+static void bench_map(const char * map_name, const std::vector<std::uint64_t> & keys)
+{
+    HashMap old_map;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        old_map.insert(std::make_pair(keys[i], keys[i]));
+    }
+
+    // The equality of the identical copy, the best case of the memcmp fast path.
+    HashMap same_map(old_map);
+    bench_one(std::string(map_name) + "/0%/copy", old_map, same_map, DiffCounts());
+
+    // Not the stream of the keys, or the "new" keys would be the old ones.
+    jstd::Xoshiro256 random(~kSeed);
+    for (std::size_t r = 0; r < sizeof(kChangeRates) / sizeof(kChangeRates[0]); r++) {
+        std::size_t rate = kChangeRates[r];
+        HashMap new_map(old_map);
+        DiffCounts expected = change_map(new_map, keys, rate, random);
+
+        std::string prefix = std::string(map_name) + "/" + std::to_string(rate) + "%";
+        bench_one(prefix + "/copy", old_map, new_map, expected);
+
+        // Twice the capacity, the groups can't be compared.
+        HashMap rebuilt_map(new_map.capacity() * 2);
+        for (auto iter = new_map.begin(); iter != new_map.end(); ++iter) {
+            rebuilt_map.insert(*iter);
+        }
+        bench_one(prefix + "/rebuilt", old_map, rebuilt_map, expected);
+        printf("\n");
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size_k = kDefaultSizeK;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size_k = static_cast<std::size_t>(value);
+    }
+
+    std::size_t size = size_k * 1024;
+    std::vector<std::uint64_t> keys(size);
+    jstd::Xoshiro256x4 random(kSeed);
+    random.fill(keys.data(), keys.size());
+
+    printf("size = %" PRIuPTR " K, change = assign / erase / insert in turn\n\n", size_k);
+    printf("%-36s %10s %10s\n", "name", "total (ms)", "ns/entry");
+    printf("----------------------------------------------------------\n");
+
+    bench_map<jstd::group15_flat_map<std::uint64_t, std::uint64_t>>("group15_flat_map", keys);
+    bench_map<jstd::group16_flat_map<std::uint64_t, std::uint64_t>>("group16_flat_map", keys);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
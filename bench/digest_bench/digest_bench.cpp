@@ -0,0 +1,299 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// digest_bench: The lookups of the digest keyed maps, with and without the avalanching hasher.
+//
+// Usage: digest_bench [size] [lookups]
+//
+// The keys are uniformly distributed: uint64 (the IDs hashed upstream), digest128 (MD5, UUID),
+// digest160 (SHA-1) and digest256 (SHA-256). Each map is tested with two hashers that
+// return the same hash code:
+//
+//   mixed:      std::hash<uint64> or a digest slice hasher without the is_avalanching trait,
+//               the tables do the second mixing of the hash code.
+//   avalanche:  jstd::prehashed_hash<uint64> or jstd::digest_hash<N>, the mixing is skipped.
+//
+// For each one, record the ns per insertion, and per find() of the existing keys (hit)
+// and the absent keys (miss) in a random order. The map size is size / 20 (in the cache)
+// and size (default 1M).
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hasher/digest_hash.h>
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSize = 1000 * 1000;
+static const std::size_t kDefaultLookups = 8 * 1024 * 1024;
+#else
+static const std::size_t kDefaultSize = 32 * 1000;
+static const std::size_t kDefaultLookups = 256 * 1024;
+#endif
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("digest_bench");
+
+//
+// The same hash code as jstd::digest_slice_hash<Key>, but not avalanching.
+//
+template <typename Key>
+struct mixed_slice_hash {
+    typedef Key             argument_type;
+    typedef std::size_t     result_type;
+
+    result_type operator () (const Key & key) const noexcept {
+        return jstd::digest_slice_hash<Key>()(key);
+    }
+};
+
+// splitmix64, the keys are unique for the different counters.
+static std::uint64_t mix64(std::uint64_t counter)
+{
+    std::uint64_t z = counter + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31));
+}
+
+template <typename Key>
+struct key_maker;
+
+template <>
+struct key_maker<std::uint64_t> {
+    typedef std::hash<std::uint64_t>            mixed_hasher;
+    typedef jstd::prehashed_hash<std::uint64_t> avalanching_hasher;
+
+    static const char * name() { return "uint64"; }
+    static std::uint64_t make(std::uint64_t i) { return mix64(i); }
+};
+
+template <std::size_t N>
+struct key_maker<jstd::digest<N>> {
+    typedef mixed_slice_hash<jstd::digest<N>>   mixed_hasher;
+    typedef jstd::digest_hash<N>                avalanching_hasher;
+
+    static const char * name() {
+        return (N == 16) ? "digest128" : ((N == 20) ? "digest160" : "digest256");
+    }
+
+    static jstd::digest<N> make(std::uint64_t i) {
+        jstd::digest<N> key;
+        for (std::size_t offset = 0; offset < N; offset += sizeof(std::uint64_t)) {
+            std::uint64_t x = mix64(i * 4 + offset / sizeof(std::uint64_t));
+            std::size_t bytes = (std::min)(N - offset, sizeof(std::uint64_t));
+            ::memcpy(&key.bytes[offset], &x, bytes);
+        }
+        return key;
+    }
+};
+
+struct robin_maps {
+    template <typename Key, typename Hash>
+    using map_type = jstd::robin_hash_map<Key, std::uint64_t, Hash>;
+
+    static const char * name() { return "robin"; }
+};
+
+struct group15_maps {
+    template <typename Key, typename Hash>
+    using map_type = jstd::group15_flat_map<Key, std::uint64_t, Hash>;
+
+    static const char * name() { return "group15"; }
+};
+
+struct group16_maps {
+    template <typename Key, typename Hash>
+    using map_type = jstd::group16_flat_map<Key, std::uint64_t, Hash>;
+
+    static const char * name() { return "group16"; }
+};
+
+static void add_result(const std::string & name, double ns_per_op)
+{
+    g_benchmark_report.addSample(name, "ns/op", ns_per_op);
+}
+
+template <typename Maps, typename Key, typename Hash>
+void run_one(const char * hasher_name,
+             const std::vector<Key> & keys, const std::vector<Key> & absent_keys,
+             const std::vector<std::size_t> & order)
+{
+    typedef typename Maps::template map_type<Key, Hash> map_type;
+
+    std::size_t size = keys.size();
+    std::size_t lookups = order.size();
+
+    jtest::StopWatch sw;
+    map_type map;
+
+    sw.start();
+    for (std::size_t i = 0; i < size; i++) {
+        map.emplace(keys[i], std::uint64_t(i));
+    }
+    sw.stop();
+    double insert_ns = sw.getElapsedNanosec() / size;
+
+    std::size_t checksum = 0;
+    sw.start();
+    for (std::size_t i = 0; i < lookups; i++) {
+        checksum += (map.find(keys[order[i]]) != map.end()) ? 1 : 0;
+    }
+    sw.stop();
+    double hit_ns = sw.getElapsedNanosec() / lookups;
+
+    sw.start();
+    for (std::size_t i = 0; i < lookups; i++) {
+        checksum += (map.find(absent_keys[order[i]]) != map.end()) ? 1 : 0;
+    }
+    sw.stop();
+    double miss_ns = sw.getElapsedNanosec() / lookups;
+
+    printf("%-8s %-10s %-10s %10" PRIuPTR " %10.2f %10.2f %10.2f   (checksum = %" PRIuPTR ")\n",
+           Maps::name(), key_maker<Key>::name(), hasher_name, size,
+           insert_ns, hit_ns, miss_ns, checksum);
+    ::fflush(stdout);
+
+    std::string report_name = std::string(Maps::name()) + "/" + key_maker<Key>::name() + "/" +
+                              hasher_name + "/" + std::to_string(size);
+    add_result(report_name + "/insert", insert_ns);
+    add_result(report_name + "/hit", hit_ns);
+    add_result(report_name + "/miss", miss_ns);
+}
+
+template <typename Key>
+void run_bench(std::size_t size, std::size_t lookups)
+{
+    typedef typename key_maker<Key>::mixed_hasher       mixed_hasher;
+    typedef typename key_maker<Key>::avalanching_hasher avalanching_hasher;
+
+    std::vector<Key> keys(size), absent_keys(size);
+    for (std::size_t i = 0; i < size; i++) {
+        keys[i] = key_maker<Key>::make(i);
+        absent_keys[i] = key_maker<Key>::make(i + size);
+    }
+
+    std::vector<std::size_t> order(lookups);
+    jstd::MtRandomGen::srand(20240815UL);
+    for (std::size_t i = 0; i < lookups; i++) {
+        order[i] = static_cast<std::size_t>(jstd::MtRandomGen::nextUInt64()) % size;
+    }
+
+    run_one<robin_maps,   Key, mixed_hasher      >("mixed",     keys, absent_keys, order);
+    run_one<robin_maps,   Key, avalanching_hasher>("avalanche", keys, absent_keys, order);
+    run_one<group15_maps, Key, mixed_hasher      >("mixed",     keys, absent_keys, order);
+    run_one<group15_maps, Key, avalanching_hasher>("avalanche", keys, absent_keys, order);
+    run_one<group16_maps, Key, mixed_hasher      >("mixed",     keys, absent_keys, order);
+    run_one<group16_maps, Key, avalanching_hasher>("avalanche", keys, absent_keys, order);
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size = kDefaultSize;
+    std::size_t lookups = kDefaultLookups;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            lookups = static_cast<std::size_t>(value);
+    }
+
+    std::size_t small_size = (std::max)(size / 20, std::size_t(1));
+
+    printf("size = %" PRIuPTR ", lookups = %" PRIuPTR "\n\n", size, lookups);
+    printf("%-8s %-10s %-10s %10s %10s %10s %10s\n",
+           "map", "key", "hasher", "size", "insert", "hit", "miss");
+    printf("-------------------------------------------------------------------------------\n");
+
+    std::size_t sizes[2] = { small_size, size };
+    for (std::size_t i = 0; i < 2; i++) {
+        run_bench<std::uint64_t>(sizes[i], lookups);
+        run_bench<jstd::digest128>(sizes[i], lookups);
+        run_bench<jstd::digest160>(sizes[i], lookups);
+        run_bench<jstd::digest256>(sizes[i], lookups);
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
@@ -0,0 +1,272 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+
+//
+// interleaved_bench: The batched lookup find_interleaved() vs. the plain find() loop.
+//
+// Usage: interleaved_bench [max_size] [lookups]
+//
+// The tables are uint64_t -> uint64_t jstd::group15_flat_map with random keys, the sizes grow
+// from 64K to max_size (default 16M, 256MB+ of slots, far beyond the LLC), and the lookup keys
+// are in random order, so nearly every hop of a lookup is a cache miss.
+//
+// For each size, the plain find() loop and find_interleaved() with group width 1, 4, 8, 16, 32
+// are timed for the hit and the miss lookups, the results are checked against find().
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+static const std::size_t kMinSize = 64 * 1024;
+
+#ifndef _DEBUG
+static const std::size_t kDefaultMaxSize = 16 * 1024 * 1024;
+static const std::size_t kDefaultLookups = 4 * 1024 * 1024;
+#else
+static const std::size_t kDefaultMaxSize = 256 * 1024;
+static const std::size_t kDefaultLookups = 64 * 1024;
+#endif
+
+// The lookups are done in batches, like a query engine probes a hash table by vectors.
+static const std::size_t kBatchSize = 1024;
+
+static const std::size_t kGroupWidths[] = { 1, 4, 8, 16, 32 };
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("interleaved_bench");
+
+typedef jstd::group15_flat_map<std::uint64_t, std::uint64_t> hash_map_t;
+typedef hash_map_t::const_iterator const_iterator;
+
+static inline
+std::uint64_t splitmix64(std::uint64_t & state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (z ^ (z >> 31));
+}
+
+static std::uint64_t sum_results(const hash_map_t & table,
+                                 const std::vector<const_iterator> & results)
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        if (results[i] != table.end())
+            sum += results[i]->second;
+    }
+    return sum;
+}
+
+static double bench_find_loop(const hash_map_t & table,
+                              const std::vector<std::uint64_t> & keys,
+                              std::vector<const_iterator> & results)
+{
+    jtest::StopWatch sw;
+    sw.start();
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        results[i] = table.find(keys[i]);
+    }
+    sw.stop();
+    return sw.getElapsedNanosec();
+}
+
+static double bench_find_interleaved(const hash_map_t & table,
+                                     const std::vector<std::uint64_t> & keys,
+                                     std::vector<const_iterator> & results,
+                                     std::size_t group_width)
+{
+    jtest::StopWatch sw;
+    sw.start();
+    for (std::size_t first = 0; first < keys.size(); first += kBatchSize) {
+        std::size_t count = (std::min)(kBatchSize, keys.size() - first);
+        table.find_interleaved(&keys[first], count, &results[first], group_width);
+    }
+    sw.stop();
+    return sw.getElapsedNanosec();
+}
+
+static bool check_results(const hash_map_t & table,
+                          const std::vector<std::uint64_t> & keys,
+                          const std::vector<const_iterator> & results)
+{
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        if (results[i] != table.find(keys[i]))
+            return false;
+    }
+    return true;
+}
+
+static void report_result(std::size_t size, const char * kind, const char * method,
+                          double elapsed_ns, std::size_t lookups, double base_ns,
+                          bool is_correct, std::uint64_t checksum)
+{
+    double ns_per_op = elapsed_ns / static_cast<double>(lookups);
+    printf("  %-6s %-24s %8.2f ns/op   speedup = %5.2fx   checksum = %016" PRIx64 "%s\n",
+           kind, method, ns_per_op, base_ns / elapsed_ns, checksum,
+           is_correct ? "" : "   [MISMATCH]");
+
+    std::string name = std::to_string(size) + "/" + kind + "/" + method;
+    g_benchmark_report.addSample(name, "ns/op", ns_per_op);
+}
+
+static bool bench_lookups(const hash_map_t & table, std::size_t size, const char * kind,
+                          const std::vector<std::uint64_t> & keys)
+{
+    std::vector<const_iterator> results(keys.size());
+    std::vector<const_iterator> expected(keys.size());
+    bool all_correct = true;
+
+    double base_ns = bench_find_loop(table, keys, expected);
+    std::uint64_t base_checksum = sum_results(table, expected);
+    report_result(size, kind, "find()", base_ns, keys.size(), base_ns, true, base_checksum);
+
+    for (std::size_t i = 0; i < sizeof(kGroupWidths) / sizeof(kGroupWidths[0]); i++) {
+        std::size_t group_width = kGroupWidths[i];
+        double elapsed_ns = bench_find_interleaved(table, keys, results, group_width);
+        bool is_correct = check_results(table, keys, results);
+        all_correct = all_correct && is_correct;
+
+        std::string method = "find_interleaved(" + std::to_string(group_width) + ")";
+        report_result(size, kind, method.c_str(), elapsed_ns, keys.size(), base_ns,
+                      is_correct, sum_results(table, results));
+    }
+    return all_correct;
+}
+
+static bool bench_size(std::size_t size, std::size_t lookups)
+{
+    std::uint64_t state = 20240101ull + size;
+
+    hash_map_t table;
+    table.reserve(size);
+    std::vector<std::uint64_t> inserted;
+    inserted.reserve(size);
+    while (inserted.size() < size) {
+        std::uint64_t key = splitmix64(state);
+        if (table.emplace(key, key ^ 0x5555555555555555ull).second)
+            inserted.push_back(key);
+    }
+
+    std::vector<std::uint64_t> hit_keys(lookups);
+    std::vector<std::uint64_t> miss_keys(lookups);
+    for (std::size_t i = 0; i < lookups; i++) {
+        hit_keys[i] = inserted[splitmix64(state) % size];
+        std::uint64_t key;
+        do {
+            key = splitmix64(state);
+        } while (table.count(key) != 0);
+        miss_keys[i] = key;
+    }
+
+    printf("size = %" PRIuPTR ", capacity = %" PRIuPTR ", load_factor = %0.3f, lookups = %" PRIuPTR "\n\n",
+           size, table.slot_capacity(), table.load_factor(), lookups);
+
+    bool is_correct = bench_lookups(table, size, "hit", hit_keys);
+    printf("\n");
+    is_correct = bench_lookups(table, size, "miss", miss_keys) && is_correct;
+    printf("\n");
+    return is_correct;
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t max_size = kDefaultMaxSize;
+    std::size_t lookups = kDefaultLookups;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value >= static_cast<long long>(kMinSize))
+            max_size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            lookups = static_cast<std::size_t>(value);
+    }
+
+    printf("interleaved_bench: max_size = %" PRIuPTR ", lookups = %" PRIuPTR ", batch_size = %" PRIuPTR "\n\n",
+           max_size, lookups, kBatchSize);
+
+    bool is_correct = true;
+    for (std::size_t size = kMinSize; size <= max_size; size *= 4) {
+        is_correct = bench_size(size, lookups) && is_correct;
+    }
+
+    if (!is_correct) {
+        printf("interleaved_bench: find_interleaved() results mismatch with find().\n\n");
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return is_correct ? 0 : 1;
+}
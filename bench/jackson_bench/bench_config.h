@@ -72,6 +72,47 @@
 #define MILLISECOND_COOLDOWN_BETWEEN_BENCHMARKS     100
 #endif
 
+// The key access distributions.
+//   DIST_UNIFORM:   A window of consecutive keys at an uniform random position (the keys are shuffled).
+//   DIST_ZIPFIAN:   Zipfian distribution with ZIPFIAN_THETA, the first inserted keys are the hottest.
+//   DIST_HOT_COLD:  HOT_ACCESS_RATIO of accesses go to the HOT_SET_RATIO of keys inserted first.
+//   DIST_MONOTONIC: Monotonically increasing IDs, access the most recently inserted keys in order.
+//   DIST_CLUSTERED: Clustered ranges of CLUSTER_SIZE consecutive keys at uniform random positions.
+//
+// When KEY_INSERT_ORDER is DIST_MONOTONIC, the keys are not shuffled, so the key index is
+// also the ID order, and the clustered ranges are the ranges of IDs.
+#define DIST_UNIFORM        0
+#define DIST_ZIPFIAN        1
+#define DIST_HOT_COLD       2
+#define DIST_MONOTONIC      3
+#define DIST_CLUSTERED      4
+
+#define ZIPFIAN_THETA       0.99
+#define HOT_SET_RATIO       0.2
+#define HOT_ACCESS_RATIO    0.8
+#define CLUSTER_SIZE        32
+
+// The insert order of keys, DIST_UNIFORM (shuffled keys) or DIST_MONOTONIC (increasing IDs).
+#define KEY_INSERT_ORDER    DIST_UNIFORM
+
+// The default key access distribution of benchmarks.
+#define ACCESS_DISTRIBUTION DIST_UNIFORM
+
+// The key access distribution of each benchmark.
+#define FIND_EXISTING_DISTRIBUTION          ACCESS_DISTRIBUTION
+#define FIND_NON_EXISTING_DISTRIBUTION      ACCESS_DISTRIBUTION
+#define INSERT_EXISTING_DISTRIBUTION        ACCESS_DISTRIBUTION
+#define ERASE_EXISTING_DISTRIBUTION         ACCESS_DISTRIBUTION
+#define ERASE_NON_EXISTING_DISTRIBUTION     ACCESS_DISTRIBUTION
+
+// The latency sampling mode of the benchmark loops, the results are printed as p50/p99/p99.9/max per op.
+//   0: Disabled.
+//   1: Per batch, record the average cycles per op of each measurement batch (KEY_COUNT_MEASUREMENT_INTERVAL),
+//      the overhead is negligible, the rehash spikes are visible but diluted by the batch.
+//   2: Per op, record the cycles of every op by rdtscp, it can see the real tail latency,
+//      but the overhead of rdtscp (about 20 ~ 40 cycles) is included in the total elapsed time.
+#define LATENCY_SAMPLING_MODE   1
+
 // The specific benchmarks to run (comment them out to disable them).
 #define BENCHMARK_FIND_EXISTING
 #define BENCHMARK_FIND_NON_EXISTING
@@ -28,7 +28,12 @@
 #include "bench_config.h"
 
 #include "jstd/test/StopWatch.h"
+#include "jstd/test/CycleTimer.h"
+#include "jstd/test/LatencyHistogram.h"
+#include "jstd/test/BenchmarkReport.h"
+#include "jstd/test/PerfCounters.h"
 #include "jstd/system/Console.h"
+#include "jstd/system/RandomGen.h"
 
 //
 // Variable printed before the program closes to prevent compiler from optimizing out function calls during the
@@ -302,6 +307,12 @@ const char * get_benchmark_label(std::size_t benchmark_id)
 
 jtest::BenchmarkResults gBenchmarkResults;
 
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+jtest::BenchmarkReport gBenchmarkReport("jackson_bench");
+
+// The hardware performance counters of the measurement batches, see LatencySampler.
+jtest::PerfCounters gPerfCounters;
+
 namespace detail {
 
 constexpr std::size_t round_div(std::size_t dividend, std::size_t divisor)
@@ -326,9 +337,144 @@ void shuffled_unique_key(std::vector<typename BluePrint::key_type> & keys, std::
     keys.clear();
     keys.resize(data_size * KEY_SCALE);
     BluePrint::fill_unique_keys(keys);
-    std::shuffle(keys.begin(), keys.end(), random_number_generator);
+#if (KEY_INSERT_ORDER != DIST_MONOTONIC)
+    // The permutation is generated by the blocked xoshiro256** x4, seeded from random_number_generator.
+    jstd::random_shuffle<jstd::Xoshiro256x4>(keys.begin(), keys.end(), random_number_generator());
+#endif
+}
+
+const char * get_distribution_name(std::size_t distribution)
+{
+    switch (distribution) {
+        case DIST_UNIFORM:
+            return "uniform";
+        case DIST_ZIPFIAN:
+            return "zipfian";
+        case DIST_HOT_COLD:
+            return "hot/cold";
+        case DIST_MONOTONIC:
+            return "monotonic";
+        case DIST_CLUSTERED:
+            return "clustered";
+        default:
+            return "unknown";
+    }
+}
+
+std::size_t get_benchmark_distribution(std::size_t benchmark_id)
+{
+    switch (benchmark_id) {
+        case id_find_existing:
+            return FIND_EXISTING_DISTRIBUTION;
+        case id_find_non_existing:
+            return FIND_NON_EXISTING_DISTRIBUTION;
+        case id_insert_non_existing:
+            return KEY_INSERT_ORDER;
+        case id_insert_existing:
+            return INSERT_EXISTING_DISTRIBUTION;
+        case id_erase_existing:
+            return ERASE_EXISTING_DISTRIBUTION;
+        case id_erase_non_existing:
+            return ERASE_NON_EXISTING_DISTRIBUTION;
+        default:
+            return DIST_UNIFORM;
+    }
 }
 
+//
+// The key access patterns, see DIST_* in bench_config.h.
+//
+// fill() generates [count] key indices in range [base, base + range_size),
+// the generators are resized to follow the growing table.
+//
+template <std::size_t Distribution>
+class KeyAccessPattern;
+
+template <>
+class KeyAccessPattern<DIST_UNIFORM> {
+public:
+    void fill(std::vector<std::size_t> & indices, std::size_t base,
+              std::size_t range_size, std::size_t count) {
+        // The original jackson_bench pattern: a window of consecutive (shuffled) keys at a random position.
+        std::size_t first = std::uniform_int_distribution<std::size_t>
+                            (0, range_size - count - 1)(random_number_generator);
+        indices.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            indices[i] = base + first + i;
+        }
+    }
+};
+
+template <>
+class KeyAccessPattern<DIST_ZIPFIAN> {
+    jstd::ZipfianKeyGenerator<> generator_;
+
+public:
+    KeyAccessPattern() : generator_(1, ZIPFIAN_THETA) {}
+
+    void fill(std::vector<std::size_t> & indices, std::size_t base,
+              std::size_t range_size, std::size_t count) {
+        generator_.resize(range_size);
+        indices.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            indices[i] = base + generator_.next();
+        }
+    }
+};
+
+template <>
+class KeyAccessPattern<DIST_HOT_COLD> {
+    jstd::HotColdKeyGenerator<> generator_;
+
+public:
+    KeyAccessPattern() : generator_(1, HOT_SET_RATIO, HOT_ACCESS_RATIO) {}
+
+    void fill(std::vector<std::size_t> & indices, std::size_t base,
+              std::size_t range_size, std::size_t count) {
+        generator_.resize(range_size);
+        indices.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            indices[i] = base + generator_.next();
+        }
+    }
+};
+
+template <>
+class KeyAccessPattern<DIST_MONOTONIC> {
+    jstd::MonotonicKeyGenerator<> generator_;
+
+public:
+    KeyAccessPattern() : generator_(1) {}
+
+    void fill(std::vector<std::size_t> & indices, std::size_t base,
+              std::size_t range_size, std::size_t count) {
+        // Access the most recently inserted keys in increasing order.
+        generator_.resize(range_size);
+        generator_.seek((range_size > count) ? (range_size - count) : 0);
+        indices.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            indices[i] = base + generator_.next();
+        }
+    }
+};
+
+template <>
+class KeyAccessPattern<DIST_CLUSTERED> {
+    jstd::ClusteredKeyGenerator<> generator_;
+
+public:
+    KeyAccessPattern() : generator_(1, CLUSTER_SIZE) {}
+
+    void fill(std::vector<std::size_t> & indices, std::size_t base,
+              std::size_t range_size, std::size_t count) {
+        generator_.resize(range_size);
+        indices.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            indices[i] = base + generator_.next();
+        }
+    }
+};
+
 //
 // Remove the minimum and maximum time, and then take the average of the other values.
 //
@@ -401,6 +547,69 @@ double & results(std::size_t run_index, std::size_t result_index)
     return results[run_index * kLoopTimes + result_index];
 }
 
+//
+// Function for accessing the latency histogram (cycles per op) of a particular table, blueprint,
+// and benchmark, the samples of all runs are merged into one histogram.
+//
+template <template<typename> typename HashMap, typename BluePrint, benchmark_ids benchmark_id>
+jtest::LatencyHistogram & latency_histogram()
+{
+    static jtest::LatencyHistogram histogram;
+    return histogram;
+}
+
+//
+// The latency sampler of benchmark loops, see LATENCY_SAMPLING_MODE in bench_config.h.
+// It also scopes the hardware performance counters (gPerfCounters) around each batch.
+//
+class LatencySampler {
+public:
+    typedef jtest::CycleTimer::cycle_t cycle_t;
+
+    static constexpr bool kSampleBatch = (LATENCY_SAMPLING_MODE == 1);
+    static constexpr bool kSampleOp    = (LATENCY_SAMPLING_MODE == 2);
+
+private:
+    jtest::LatencyHistogram & histogram_;
+    cycle_t batch_start_;
+
+public:
+    LatencySampler(jtest::LatencyHistogram & histogram)
+        : histogram_(histogram), batch_start_(0) {
+    }
+
+    JSTD_FORCED_INLINE
+    void batch_begin() {
+        gPerfCounters.start();
+        if (kSampleBatch) {
+            this->batch_start_ = jtest::CycleTimer::begin_cycles();
+        }
+    }
+
+    JSTD_FORCED_INLINE
+    void batch_end(std::size_t op_count) {
+        if (kSampleBatch) {
+            cycle_t batch_cycles = jtest::CycleTimer::end_cycles() - this->batch_start_;
+            if (op_count != 0) {
+                this->histogram_.record_n(batch_cycles / op_count, op_count);
+            }
+        }
+        gPerfCounters.stop(op_count);
+    }
+
+    JSTD_FORCED_INLINE
+    cycle_t op_begin() {
+        return (kSampleOp ? jtest::CycleTimer::begin_cycles() : 0);
+    }
+
+    JSTD_FORCED_INLINE
+    void op_end(cycle_t op_start) {
+        if (kSampleOp) {
+            this->histogram_.record(jtest::CycleTimer::end_cycles() - op_start);
+        }
+    }
+};
+
 //
 // Function that attempts to reset the cache to the same state before each table is benchmarked.
 // The strategy is to iterate over an array that is at least as large as the L1, L2, and L3 caches combined.
@@ -441,8 +650,12 @@ void benchmark_find_existing(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_find_existing>());
     std::size_t result_index = 0;
 
+    KeyAccessPattern<FIND_EXISTING_DISTRIBUTION> access_pattern;
+    std::vector<std::size_t> access_indices;
+
     std::size_t insert_begin = 0;
     while (insert_begin < kDataSize) {
         std::size_t insert_end = (std::min)(insert_begin + NUMS_INSERT_KEY, kDataSize);
@@ -453,20 +666,23 @@ void benchmark_find_existing(std::size_t run,
         // To determine which keys to erase, we randomly chose a position in the sequence of keys already inserted and
         // then erase the subsequent 1000 keys, wrapping around to the start of the sequence if necessary.
         // This strategy has the potential drawback that keys are erased in the same order in which they were inserted.
-        std::size_t insert_begin2 = std::uniform_int_distribution<std::size_t>
-                                    (0, insert_end - NUMS_ERASE_KEY - 1)(random_number_generator);
-        std::size_t insert_end2 = insert_begin2 + NUMS_ERASE_KEY;
+        // For the other distributions, the keys are chosen by the access pattern, see DIST_* in bench_config.h.
+        access_pattern.fill(access_indices, 0, insert_end, NUMS_ERASE_KEY);
 
+        sampler.batch_begin();
         sw.start();
-        for (std::size_t i = insert_begin2; i < insert_end2; i++) {
-            auto iter = HashMap<BluePrint>::find(table, keys[i]);
+        for (std::size_t i = 0; i < NUMS_ERASE_KEY; i++) {
+            auto op_start = sampler.op_begin();
+            auto iter = HashMap<BluePrint>::find(table, keys[access_indices[i]]);
 
             // Accessing the first byte of the value prevents the above call from being optimized out and ensures that
             // tables that can preform look-ups without accessing the values (because the keys are stored separately)
             // actually incur the additional cache miss that they would incur during normal use.
             do_not_optimize += *(unsigned char *)&HashMap<BluePrint>::get_value_from_iter(table, iter);
+            sampler.op_end(op_start);
         }
         sw.stop();
+        sampler.batch_end(NUMS_ERASE_KEY);
 
         double used_time = sw.getElapsedMillisec();
         //printf("elapsed time = %0.3f ms\n", used_time);
@@ -492,8 +708,12 @@ void benchmark_find_non_existing(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_find_non_existing>());
     std::size_t result_index = 0;
 
+    KeyAccessPattern<FIND_NON_EXISTING_DISTRIBUTION> access_pattern;
+    std::vector<std::size_t> access_indices;
+
     std::size_t insert_begin = 0;
     while (insert_begin < kDataSize) {
         std::size_t insert_end = (std::min)(insert_begin + NUMS_INSERT_KEY, kDataSize);
@@ -504,17 +724,20 @@ void benchmark_find_non_existing(std::size_t run,
         // To determine which nonexisting keys to attempt to erase, we randomly chose a position in the sequence of
         // nonexisting keys (which starts at KEY_COUNT) and then call erase for the subsequent 1000 keys, wrapping
         // around to the start of the sequence if necessary.
-        std::size_t find_begin = std::uniform_int_distribution<std::size_t>
-                                    (kDataSize, kDataSize + insert_end - NUMS_ERASE_KEY - 1)(random_number_generator);
-        std::size_t find_end = find_begin + NUMS_ERASE_KEY;
+        // For the other distributions, the keys are chosen by the access pattern, see DIST_* in bench_config.h.
+        access_pattern.fill(access_indices, kDataSize, insert_end, NUMS_ERASE_KEY);
 
+        sampler.batch_begin();
         sw.start();
-        for (std::size_t i = find_begin; i < find_end; i++) {
-            auto iter = HashMap<BluePrint>::find(table, keys[i]);
+        for (std::size_t i = 0; i < NUMS_ERASE_KEY; i++) {
+            auto op_start = sampler.op_begin();
+            auto iter = HashMap<BluePrint>::find(table, keys[access_indices[i]]);
             // Should always be false.
             do_not_optimize += HashMap<BluePrint>::is_iter_valid(table, iter);
+            sampler.op_end(op_start);
         }
         sw.stop();
+        sampler.batch_end(NUMS_ERASE_KEY);
 
         double used_time = sw.getElapsedMillisec();
         //printf("elapsed time = %0.3f ms\n", used_time);
@@ -540,12 +763,31 @@ void benchmark_insert_non_existing(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_insert_non_existing>());
 
-    sw.start();
-    for (std::size_t i = 0; i < kDataSize; i++) {
-        HashMap<BluePrint>::insert(table, keys[i]);
+    if (LATENCY_SAMPLING_MODE == 0) {
+        sw.start();
+        for (std::size_t i = 0; i < kDataSize; i++) {
+            HashMap<BluePrint>::insert(table, keys[i]);
+        }
+        sw.stop();
+    } else {
+        // Split the inserts into the measurement batches, so that the rehash spikes can be seen.
+        sw.start();
+        std::size_t insert_begin = 0;
+        while (insert_begin < kDataSize) {
+            std::size_t insert_end = (std::min)(insert_begin + KEY_COUNT_MEASUREMENT_INTERVAL, kDataSize);
+            sampler.batch_begin();
+            for (std::size_t i = insert_begin; i < insert_end; i++) {
+                auto op_start = sampler.op_begin();
+                HashMap<BluePrint>::insert(table, keys[i]);
+                sampler.op_end(op_start);
+            }
+            sampler.batch_end(insert_end - insert_begin);
+            insert_begin = insert_end;
+        }
+        sw.stop();
     }
-    sw.stop();
 
     elapsed_time = sw.getElapsedMillisec();
     printf("elapsed time = %0.3f ms\n", elapsed_time);
@@ -564,8 +806,12 @@ void benchmark_insert_existing(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_insert_existing>());
     std::size_t result_index = 0;
 
+    KeyAccessPattern<INSERT_EXISTING_DISTRIBUTION> access_pattern;
+    std::vector<std::size_t> access_indices;
+
     std::size_t insert_begin = 0;
     while (insert_begin < kDataSize) {
         std::size_t insert_end = (std::min)(insert_begin + NUMS_INSERT_KEY, kDataSize);
@@ -576,15 +822,18 @@ void benchmark_insert_existing(std::size_t run,
         // To determine which keys to erase, we randomly chose a position in the sequence of keys already inserted and
         // then erase the subsequent 1000 keys, wrapping around to the start of the sequence if necessary.
         // This strategy has the potential drawback that keys are erased in the same order in which they were inserted.
-        std::size_t insert_begin2 = std::uniform_int_distribution<std::size_t>
-                                    (0, insert_end - NUMS_ERASE_KEY - 1)(random_number_generator);
-        std::size_t insert_end2 = insert_begin2 + NUMS_ERASE_KEY;
+        // For the other distributions, the keys are chosen by the access pattern, see DIST_* in bench_config.h.
+        access_pattern.fill(access_indices, 0, insert_end, NUMS_ERASE_KEY);
 
+        sampler.batch_begin();
         sw.start();
-        for (std::size_t i = insert_begin2; i < insert_end2; i++) {
-            HashMap<BluePrint>::insert(table, keys[i]);
+        for (std::size_t i = 0; i < NUMS_ERASE_KEY; i++) {
+            auto op_start = sampler.op_begin();
+            HashMap<BluePrint>::insert(table, keys[access_indices[i]]);
+            sampler.op_end(op_start);
         }
         sw.stop();
+        sampler.batch_end(NUMS_ERASE_KEY);
 
         double used_time = sw.getElapsedMillisec();
         //printf("elapsed time = %0.3f ms\n", used_time);
@@ -619,8 +868,12 @@ void benchmark_erase_existing(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_erase_existing>());
     std::size_t result_index = 0;
 
+    KeyAccessPattern<ERASE_EXISTING_DISTRIBUTION> access_pattern;
+    std::vector<std::size_t> access_indices;
+
     std::size_t insert_begin = 0;
     while (insert_begin < kDataSize) {
         std::size_t insert_end = (std::min)(insert_begin + NUMS_INSERT_KEY, kDataSize);
@@ -631,15 +884,18 @@ void benchmark_erase_existing(std::size_t run,
         // To determine which keys to erase, we randomly chose a position in the sequence of keys already inserted and
         // then erase the subsequent 1000 keys, wrapping around to the start of the sequence if necessary.
         // This strategy has the potential drawback that keys are erased in the same order in which they were inserted.
-        std::size_t erase_begin = std::uniform_int_distribution<std::size_t>
-                                    (0, insert_end - NUMS_ERASE_KEY - 1)(random_number_generator);
-        std::size_t erase_end = erase_begin + NUMS_ERASE_KEY;
+        // For the other distributions, the keys are chosen by the access pattern, see DIST_* in bench_config.h.
+        access_pattern.fill(access_indices, 0, insert_end, NUMS_ERASE_KEY);
 
+        sampler.batch_begin();
         sw.start();
-        for (std::size_t i = erase_begin; i < erase_end; i++) {
-            HashMap<BluePrint>::erase(table, keys[i]);
+        for (std::size_t i = 0; i < NUMS_ERASE_KEY; i++) {
+            auto op_start = sampler.op_begin();
+            HashMap<BluePrint>::erase(table, keys[access_indices[i]]);
+            sampler.op_end(op_start);
         }
         sw.stop();
+        sampler.batch_end(NUMS_ERASE_KEY);
 
         double used_time = sw.getElapsedMillisec();
         //printf("elapsed time = %0.3f ms\n", used_time);
@@ -651,8 +907,9 @@ void benchmark_erase_existing(std::size_t run,
         // This has the drawback that if tombstones are being used, those tombstones created by the above erasures will
         // all be replaced by the re-inserted keys.
         // Hence, this benchmark cannot show the lingering effect of tombstones.
-        for (std::size_t i = erase_begin; i < erase_end; i++) {
-            HashMap<BluePrint>::insert(table, keys[i]);
+        // With the skewed distributions, a key may be erased more than once, the repeats are erase failures.
+        for (std::size_t i = 0; i < NUMS_ERASE_KEY; i++) {
+            HashMap<BluePrint>::insert(table, keys[access_indices[i]]);
         }
 
         result_index++;
@@ -673,8 +930,12 @@ void benchmark_erase_non_existing(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_erase_non_existing>());
     std::size_t result_index = 0;
 
+    KeyAccessPattern<ERASE_NON_EXISTING_DISTRIBUTION> access_pattern;
+    std::vector<std::size_t> access_indices;
+
     std::size_t insert_begin = 0;
     while (insert_begin < kDataSize) {
         std::size_t insert_end = (std::min)(insert_begin + NUMS_INSERT_KEY, kDataSize);
@@ -685,15 +946,18 @@ void benchmark_erase_non_existing(std::size_t run,
         // To determine which nonexisting keys to attempt to erase, we randomly chose a position in the sequence of
         // nonexisting keys (which starts at KEY_COUNT) and then call erase for the subsequent 1000 keys, wrapping
         // around to the start of the sequence if necessary.
-        std::size_t erase_begin = std::uniform_int_distribution<std::size_t>
-                                    (kDataSize, kDataSize + insert_end - NUMS_ERASE_KEY - 1)(random_number_generator);
-        std::size_t erase_end = erase_begin + NUMS_ERASE_KEY;
+        // For the other distributions, the keys are chosen by the access pattern, see DIST_* in bench_config.h.
+        access_pattern.fill(access_indices, kDataSize, insert_end, NUMS_ERASE_KEY);
 
+        sampler.batch_begin();
         sw.start();
-        for (std::size_t i = erase_begin; i < erase_end; i++) {
-            HashMap<BluePrint>::erase(table, keys[i]);
+        for (std::size_t i = 0; i < NUMS_ERASE_KEY; i++) {
+            auto op_start = sampler.op_begin();
+            HashMap<BluePrint>::erase(table, keys[access_indices[i]]);
+            sampler.op_end(op_start);
         }
         sw.stop();
+        sampler.batch_end(NUMS_ERASE_KEY);
 
         double used_time = sw.getElapsedMillisec();
         //printf("elapsed time = %0.3f ms\n", used_time);
@@ -719,6 +983,7 @@ void benchmark_iteration(std::size_t run,
     table_type table;
 
     jtest::StopWatch sw;
+    LatencySampler sampler(latency_histogram<HashMap, BluePrint, id_iteration>());
     std::size_t result_index = 0;
 
     std::size_t insert_begin = 0;
@@ -739,8 +1004,10 @@ void benchmark_iteration(std::size_t run,
         // This ensures that we are not just hitting the same, cached memory every time we measure.
         auto iter = HashMap<BluePrint>::find(table, keys[find_begin]);
 
+        sampler.batch_begin();
         sw.start();
         for (std::size_t i = find_begin; i < find_end; i++) {
+            auto op_start = sampler.op_begin();
             // Accessing the first bytes of the key and value ensures that tables that iterate without directly accessing
             // the keys and/or values actually incur the additional cache misses that they would incur during normal
             // use.
@@ -751,8 +1018,10 @@ void benchmark_iteration(std::size_t run,
             if (unlikely(HashMap<BluePrint>::is_iter_valid(table, iter))) {
                 iter = HashMap<BluePrint>::begin_iter(table);
             }
+            sampler.op_end(op_start);
         }
         sw.stop();
+        sampler.batch_end(find_end - find_begin);
 
         double used_time = sw.getElapsedMillisec();
         //printf("elapsed time = %0.3f ms\n", used_time);
@@ -828,20 +1097,41 @@ void run_benchmark_loop(std::vector<typename BluePrint::key_type> & keys)
               << "Data size: " << jtest::detail::format_integer<3>(kDataSize) << ", "
               << "Element size: " << sizeof(element_type) << " Bytes" << std::endl;
     std::cout << HashMap<void>::name << ", "
-              << "Benchmark Id: " << get_benchmark_id(BenchmarkId)
+              << "Benchmark Id: " << get_benchmark_id(BenchmarkId) << ", "
+              << "Distribution: " << get_distribution_name(get_benchmark_distribution(BenchmarkId))
               << std::endl;
     std::cout << std::endl;
 
     double elapsed_time = 0.0;
     double elapsed_times[RUN_COUNT] = { 0.0 };
 
+    gPerfCounters.reset();
+
     for (std::size_t run = 0; run < RUN_COUNT; run++) {
         run_benchmark<HashMap, BluePrint, BenchmarkId, kDataSize>(run, keys, elapsed_time);
         elapsed_times[run] = elapsed_time;
     }
 
+    // calc_average_time() will discard the min and max samples, so record them first.
+    std::string report_name = std::string(BluePrint::name) + "/" + HashMap<void>::name + "/" +
+                              get_benchmark_id(BenchmarkId);
+    gBenchmarkReport.addSamples(report_name, "ms", elapsed_times, RUN_COUNT);
+
     double average_time = calc_average_time(elapsed_times);
     printf("Average time = %0.3f ms\n", average_time);
+#if (LATENCY_SAMPLING_MODE != 0)
+    jtest::print_latency_percentiles("Latency per op:",
+                                     latency_histogram<HashMap, BluePrint, static_cast<benchmark_ids>(BenchmarkId)>());
+#endif
+    if (gPerfCounters.is_available()) {
+        printf("Perf counters per op: %s\n", gPerfCounters.format_per_op().c_str());
+        for (std::size_t event = 0; event < jtest::PerfCounters::kEventCount; event++) {
+            if (gPerfCounters.has(event) && gPerfCounters.op_count() != 0) {
+                gBenchmarkReport.addSample(report_name + "/" + jtest::PerfCounters::event_name(event),
+                                           "events/op", gPerfCounters.per_op(event));
+            }
+        }
+    }
 
     if (category != nullptr) {
         jtest::BenchmarkResult * result = category->addResult(HashMap<void>::name, BluePrint::name, BenchmarkId,
@@ -967,6 +1257,14 @@ int main(int argc, char * argv[])
 
     std::cout << std::endl;
     std::cout << "Start time: " << startTime.str() << std::endl;
+#if (LATENCY_SAMPLING_MODE != 0)
+    std::cout << "Cycle timer frequency: " << jtest::CycleTimer::frequency() << " GHz";
+    std::cout << (jtest::CycleTimer::is_tsc_supported() ? " (rdtscp)" : " (steady_clock)") << std::endl;
+#endif
+    std::cout << "Perf counters: " << gPerfCounters.status() << std::endl;
+
+    // The seed of key access generators.
+    jstd::MtRandomGen::srand(20250118U);
 
     jtest::StopWatch sw;
     sw.start();
@@ -1039,6 +1337,7 @@ int main(int argc, char * argv[])
 
     //html_out(time_str);
     //csv_out(time_str);
+    gBenchmarkReport.writeFromEnv();
 
     std::cout << "Optimization preventer: " << do_not_optimize << std::endl;
     std::cout << "Done." << std::endl << std::endl;
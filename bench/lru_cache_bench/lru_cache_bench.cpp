@@ -0,0 +1,295 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// lru_cache_bench: jstd::flat_lru_cache (CLOCK) vs. the list-based LRU cache
+//                  (jstd::group16_flat_map + std::list), on the Zipfian traces.
+//
+// Usage: lru_cache_bench [universe] [accesses]
+//
+// The keys are the scrambled ranks of a Zipfian distribution over the universe (default 1M),
+// each access is a get(), and a miss inserts the key (evicts an entry if the cache is full).
+//
+// For each theta and each cache size (a ratio of the universe), the hit ratio
+// and the ns per access of both caches are recorded.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <list>
+#include <utility>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/hashmap/flat_lru_cache.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultUniverse = 1024 * 1024;
+static const std::size_t kDefaultAccesses = 8 * 1024 * 1024;
+#else
+static const std::size_t kDefaultUniverse = 64 * 1024;
+static const std::size_t kDefaultAccesses = 256 * 1024;
+#endif
+
+static const double kThetas[] = { 0.6, 0.8, 0.9, 0.99 };
+
+// The cache sizes, in the ratio of the universe.
+static const double kCacheRatios[] = { 0.001, 0.01, 0.1 };
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("lru_cache_bench");
+
+//
+// The classic LRU cache: a hash map from the key to the node in a list,
+// the list is in the recency order, a hit moves the node to the front.
+//
+template <typename Key, typename Value>
+class list_lru_cache {
+public:
+    typedef std::size_t                     size_type;
+    typedef std::pair<Key, Value>           entry_type;
+    typedef std::list<entry_type>           list_type;
+    typedef typename list_type::iterator    list_iterator;
+
+private:
+    list_type                                   list_;
+    jstd::group16_flat_map<Key, list_iterator>  map_;
+    size_type                                   capacity_;
+
+public:
+    explicit list_lru_cache(size_type capacity) : capacity_(capacity) {
+        this->map_.reserve(capacity);
+    }
+
+    size_type size() const { return this->map_.size(); }
+    size_type capacity() const { return this->capacity_; }
+
+    Value * get(const Key & key) {
+        auto iter = this->map_.find(key);
+        if (iter != this->map_.end()) {
+            list_iterator node = iter->second;
+            this->list_.splice(this->list_.begin(), this->list_, node);
+            return &node->second;
+        }
+        return nullptr;
+    }
+
+    void insert(const Key & key, const Value & value) {
+        if (this->map_.size() >= this->capacity_) {
+            this->map_.erase(this->list_.back().first);
+            this->list_.pop_back();
+        }
+        this->list_.emplace_front(key, value);
+        this->map_.emplace(key, this->list_.begin());
+    }
+};
+
+template <typename Key, typename Value>
+class clock_lru_cache {
+public:
+    typedef std::size_t size_type;
+
+private:
+    jstd::flat_lru_cache<Key, Value> cache_;
+
+public:
+    explicit clock_lru_cache(size_type capacity) : cache_(capacity) {}
+
+    size_type size() const { return this->cache_.size(); }
+    size_type capacity() const { return this->cache_.capacity(); }
+
+    Value * get(const Key & key) {
+        return this->cache_.get(key);
+    }
+
+    void insert(const Key & key, const Value & value) {
+        this->cache_.try_emplace(key, value);
+    }
+};
+
+static inline
+std::uint64_t splitmix64(std::uint64_t z)
+{
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (z ^ (z >> 31));
+}
+
+static void make_zipfian_trace(std::vector<std::uint64_t> & trace, std::size_t universe,
+                               std::size_t accesses, double theta)
+{
+    jstd::MtRandomGen::srand(20240101u);
+    jstd::ZipfianKeyGenerator<> generator(universe, theta);
+    trace.resize(accesses);
+    for (std::size_t i = 0; i < accesses; i++) {
+        // Scramble the ranks, so the hot keys are not adjacent.
+        trace[i] = splitmix64(static_cast<std::uint64_t>(generator.next()));
+    }
+}
+
+struct CacheResult {
+    double      hit_ratio;
+    double      ns_per_op;
+    std::size_t checksum;
+};
+
+template <typename Cache>
+static CacheResult run_trace(const std::vector<std::uint64_t> & trace, std::size_t capacity)
+{
+    Cache cache(capacity);
+
+    // Warm up with the first pass of the trace, the hit ratio is measured on the second.
+    for (std::size_t i = 0; i < trace.size(); i++) {
+        std::uint64_t key = trace[i];
+        if (cache.get(key) == nullptr)
+            cache.insert(key, key);
+    }
+
+    std::size_t hits = 0;
+    std::size_t checksum = 0;
+    jtest::StopWatch sw;
+    sw.start();
+    for (std::size_t i = 0; i < trace.size(); i++) {
+        std::uint64_t key = trace[i];
+        std::uint64_t * value = cache.get(key);
+        if (value != nullptr) {
+            hits++;
+            checksum += static_cast<std::size_t>(*value);
+        } else {
+            cache.insert(key, key);
+        }
+    }
+    sw.stop();
+
+    CacheResult result;
+    result.hit_ratio = static_cast<double>(hits) / static_cast<double>(trace.size());
+    result.ns_per_op = sw.getElapsedNanosec() / static_cast<double>(trace.size());
+    result.checksum = checksum;
+    return result;
+}
+
+static void report_result(double theta, std::size_t capacity, const char * name,
+                          const CacheResult & result, const CacheResult & base)
+{
+    printf("  %-24s hit = %6.2f%%   %8.2f ns/op   speedup = %5.2fx   checksum = %" PRIuPTR "\n",
+           name, result.hit_ratio * 100.0, result.ns_per_op,
+           base.ns_per_op / result.ns_per_op, result.checksum);
+
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "theta=%0.2f/%" PRIuPTR "/", theta, capacity);
+    std::string report_name = std::string(prefix) + name;
+    g_benchmark_report.addSample(report_name + "/time", "ns/op", result.ns_per_op);
+    g_benchmark_report.addSample(report_name + "/miss", "%", (1.0 - result.hit_ratio) * 100.0);
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t universe = kDefaultUniverse;
+    std::size_t accesses = kDefaultAccesses;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value >= 1024)
+            universe = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            accesses = static_cast<std::size_t>(value);
+    }
+
+    printf("lru_cache_bench: universe = %" PRIuPTR ", accesses = %" PRIuPTR "\n\n",
+           universe, accesses);
+
+    std::vector<std::uint64_t> trace;
+    for (std::size_t t = 0; t < sizeof(kThetas) / sizeof(kThetas[0]); t++) {
+        double theta = kThetas[t];
+        make_zipfian_trace(trace, universe, accesses, theta);
+
+        for (std::size_t r = 0; r < sizeof(kCacheRatios) / sizeof(kCacheRatios[0]); r++) {
+            std::size_t capacity = static_cast<std::size_t>(static_cast<double>(universe) * kCacheRatios[r]);
+            if (capacity == 0)
+                capacity = 1;
+
+            printf("theta = %0.2f, capacity = %" PRIuPTR " (%0.1f%% of the universe)\n\n",
+                   theta, capacity, kCacheRatios[r] * 100.0);
+
+            CacheResult list_result = run_trace< list_lru_cache<std::uint64_t, std::uint64_t> >(trace, capacity);
+            CacheResult clock_result = run_trace< clock_lru_cache<std::uint64_t, std::uint64_t> >(trace, capacity);
+
+            report_result(theta, capacity, "group16 + std::list LRU", list_result, list_result);
+            report_result(theta, capacity, "flat_lru_cache (CLOCK)", clock_result, list_result);
+            printf("\n");
+        }
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
@@ -0,0 +1,409 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+// mem_footprint: The memory footprint per element of all hash map engines.
+//
+// Usage: mem_footprint [max_size] [steps_per_octave]
+//
+// For each blueprint and each engine, insert N elements into an empty map and record:
+//
+//   alloc/elem:    The bytes allocated by the container's allocator (jtest::CountingAllocator) per element.
+//   peak/elem:     The peak allocator bytes per element while inserting, e.g. when the old and
+//                  the new tables both are alive during a rehash.
+//   rss/elem:      The delta of resident set size (RSS) per element, it also includes the memory
+//                  which is not allocated by the allocator (e.g. the group ctrl arrays of
+//                  jstd::flat16_hash_map and the bucket array of jstd::unordered_map).
+//   overhead/elem: (alloc/elem - sizeof(value_type)).
+//
+// N grows geometrically from 1024 to max_size with steps_per_octave points per power of 2,
+// so the output is a footprint-vs-size curve that shows the load factor sawtooth.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the curves, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+// jstd::unordered_map (jstd/hashmap/unordered_map.h) is still a work in progress,
+// and it can not be compiled now, enable it when it's ready.
+#define USE_JSTD_UNORDERED_MAP      0
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+#if defined(__GLIBC__)
+#include <malloc.h>     // For mallopt(), malloc_trim()
+#endif
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/flat16_hash_map.h>
+#include <jstd/hashmap/cuckoo_flat_map.hpp>
+#if USE_JSTD_UNORDERED_MAP
+#include <jstd/hashmap/unordered_map.h>
+#endif
+#include <jstd/test/CountingAllocator.h>
+#include <jstd/test/BenchmarkReport.h>
+#include <jstd/test/ReadRss.h>
+
+static const std::size_t kMinSize = 1024;
+
+#ifndef _DEBUG
+static const std::size_t kDefaultMaxSize = 1024 * 1024;
+#else
+static const std::size_t kDefaultMaxSize = 64 * 1024;
+#endif
+
+static const std::size_t kDefaultStepsPerOctave = 4;
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("mem_footprint");
+
+//
+// Blueprints
+//
+struct struct448 {
+    std::uint64_t data[7];
+
+    struct448() noexcept {
+        for (std::size_t i = 0; i < 7; i++) {
+            data[i] = 0;
+        }
+    }
+};
+
+struct uint32_uint32 {
+    typedef std::uint32_t   key_type;
+    typedef std::uint32_t   mapped_type;
+
+    static const char * name() { return "uint32_uint32"; }
+
+    static key_type make_key(std::size_t i) {
+        // A bijection of uint32_t, so the keys are unique.
+        return static_cast<key_type>(static_cast<std::uint32_t>(i) * 2654435761U);
+    }
+};
+
+struct uint64_uint64 {
+    typedef std::uint64_t   key_type;
+    typedef std::uint64_t   mapped_type;
+
+    static const char * name() { return "uint64_uint64"; }
+
+    static key_type make_key(std::size_t i) {
+        return (static_cast<std::uint64_t>(i) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+struct uint64_struct448 {
+    typedef std::uint64_t   key_type;
+    typedef struct448       mapped_type;
+
+    static const char * name() { return "uint64_struct448"; }
+
+    static key_type make_key(std::size_t i) {
+        return (static_cast<std::uint64_t>(i) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+//
+// The short keys fit in the small string buffer of std::string,
+// so there is no additional heap memory of keys.
+//
+struct string_uint64 {
+    typedef std::string     key_type;
+    typedef std::uint64_t   mapped_type;
+
+    static const char * name() { return "string_uint64"; }
+
+    static key_type make_key(std::size_t i) {
+        char buf[32];
+        ::snprintf(buf, sizeof(buf), "k%llu", static_cast<unsigned long long>(i) * 2654435761ULL);
+        return std::string(buf);
+    }
+};
+
+//
+// Engines, all use jtest::CountingAllocator.
+// capacity() is the number of slots (or buckets of std::unordered_map).
+//
+template <typename Key, typename Value>
+using allocator_t = jtest::CountingAllocator<std::pair<const Key, Value>>;
+
+template <typename BluePrint>
+struct std_unordered_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "std::unordered_map"; }
+    static std::size_t capacity(const table_type & table) { return table.bucket_count(); }
+};
+
+#if USE_JSTD_UNORDERED_MAP
+template <typename BluePrint>
+struct jstd_unordered_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef jstd::unordered_map<K, V, std::hash<K>, std::equal_to<K>,
+                                jstd::default_layout_policy<K, V>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::unordered_map"; }
+    static std::size_t capacity(const table_type & table) { return table.bucket_count(); }
+};
+#endif // USE_JSTD_UNORDERED_MAP
+
+template <typename BluePrint>
+struct jstd_flat16_hash_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef jstd::flat16_hash_map<K, V, std::hash<K>, std::equal_to<K>,
+                                  jtest::CountingAllocator<std::pair<K, V>>> table_type;
+    static const char * name() { return "jstd::flat16_hash_map"; }
+    static std::size_t capacity(const table_type & table) { return table.slot_capacity(); }
+};
+
+template <typename BluePrint>
+struct jstd_robin_hash_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef jstd::robin_hash_map<K, V, std::hash<K>, std::equal_to<K>,
+                                 jstd::default_layout_policy<K, V>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::robin_hash_map"; }
+    static std::size_t capacity(const table_type & table) { return table.slot_capacity(); }
+};
+
+template <typename BluePrint>
+struct jstd_group16_flat_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef jstd::group16_flat_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::group16_flat_map"; }
+    static std::size_t capacity(const table_type & table) { return table.slot_capacity(); }
+};
+
+template <typename BluePrint>
+struct jstd_group15_flat_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef jstd::group15_flat_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::group15_flat_map"; }
+    static std::size_t capacity(const table_type & table) { return table.slot_capacity(); }
+};
+
+template <typename BluePrint>
+struct jstd_cuckoo_flat_map {
+    typedef typename BluePrint::key_type    K;
+    typedef typename BluePrint::mapped_type V;
+    typedef jstd::cuckoo_flat_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::cuckoo_flat_map"; }
+    static std::size_t capacity(const table_type & table) { return table.slot_capacity(); }
+};
+
+//
+// Return the freed memory to the OS, so that the RSS delta of the next map is meaningful.
+//
+static void release_free_memory()
+{
+#if defined(__GLIBC__)
+    ::malloc_trim(0);
+#endif
+}
+
+static std::vector<std::size_t> make_sizes(std::size_t max_size, std::size_t steps_per_octave)
+{
+    std::vector<std::size_t> sizes;
+    if (steps_per_octave == 0)
+        steps_per_octave = 1;
+    for (std::size_t base = kMinSize; base <= max_size; base *= 2) {
+        for (std::size_t step = 0; step < steps_per_octave; step++) {
+            std::size_t size = base + base * step / steps_per_octave;
+            if (size > max_size)
+                break;
+            sizes.push_back(size);
+        }
+    }
+    return sizes;
+}
+
+template <template <typename> class Engine, typename BluePrint>
+void measure_footprint(const std::vector<typename BluePrint::key_type> & keys,
+                       const std::vector<std::size_t> & sizes)
+{
+    typedef typename Engine<BluePrint>::table_type  table_type;
+    typedef typename table_type::value_type         value_type;
+    typedef typename BluePrint::mapped_type         mapped_type;
+
+    const char * map_name = Engine<BluePrint>::name();
+
+    printf("%s<%s>, sizeof(value_type) = %u bytes\n\n", map_name, BluePrint::name(),
+           (unsigned)sizeof(value_type));
+    printf("%10s %10s %8s %12s %12s %12s %14s\n",
+           "size", "capacity", "lf", "alloc/elem", "peak/elem", "rss/elem", "overhead/elem");
+    printf("----------------------------------------------------------------------------------\n");
+
+    std::string report_prefix = std::string(BluePrint::name()) + "/" + map_name + "/";
+
+    for (std::size_t n = 0; n < sizes.size(); n++) {
+        std::size_t size = sizes[n];
+
+        release_free_memory();
+        jtest::AllocCounter::reset_peak();
+        std::size_t alloc_before = jtest::AllocCounter::current_bytes();
+        std::size_t rss_before = jtest::getCurrentRSS();
+
+        table_type * table = new table_type();
+        for (std::size_t i = 0; i < size; i++) {
+            table->emplace(keys[i], mapped_type());
+        }
+
+        std::size_t rss_after = jtest::getCurrentRSS();
+        std::size_t alloc_bytes = jtest::AllocCounter::current_bytes() - alloc_before + sizeof(table_type);
+        std::size_t peak_bytes = jtest::AllocCounter::peak_bytes() - alloc_before + sizeof(table_type);
+        std::size_t rss_bytes = (rss_after > rss_before) ? (rss_after - rss_before) : 0;
+        std::size_t capacity = Engine<BluePrint>::capacity(*table);
+        double lf = table->load_factor();
+
+        delete table;
+
+        double alloc_per_elem = static_cast<double>(alloc_bytes) / size;
+        double peak_per_elem = static_cast<double>(peak_bytes) / size;
+        double rss_per_elem = static_cast<double>(rss_bytes) / size;
+        double overhead_per_elem = alloc_per_elem - static_cast<double>(sizeof(value_type));
+
+        printf("%10" PRIuPTR " %10" PRIuPTR " %8.3f %12.2f %12.2f %12.2f %14.2f\n",
+               size, capacity, lf, alloc_per_elem, peak_per_elem, rss_per_elem, overhead_per_elem);
+
+        std::string report_name = report_prefix + std::to_string(size);
+        g_benchmark_report.addSample(report_name + "/alloc", "bytes/elem", alloc_per_elem);
+        g_benchmark_report.addSample(report_name + "/peak", "bytes/elem", peak_per_elem);
+        g_benchmark_report.addSample(report_name + "/rss", "bytes/elem", rss_per_elem);
+    }
+
+    printf("\n");
+    ::fflush(stdout);
+}
+
+template <typename BluePrint>
+void measure_blueprint(std::size_t max_size, std::size_t steps_per_octave)
+{
+    typedef typename BluePrint::key_type key_type;
+
+    printf("============================= BluePrint: %s =============================\n\n",
+           BluePrint::name());
+
+    std::vector<key_type> keys;
+    keys.reserve(max_size);
+    for (std::size_t i = 0; i < max_size; i++) {
+        keys.push_back(BluePrint::make_key(i));
+    }
+
+    std::vector<std::size_t> sizes = make_sizes(max_size, steps_per_octave);
+
+    measure_footprint<std_unordered_map,     BluePrint>(keys, sizes);
+#if USE_JSTD_UNORDERED_MAP
+    measure_footprint<jstd_unordered_map,    BluePrint>(keys, sizes);
+#endif
+    measure_footprint<jstd_flat16_hash_map,  BluePrint>(keys, sizes);
+    measure_footprint<jstd_robin_hash_map,   BluePrint>(keys, sizes);
+    measure_footprint<jstd_group16_flat_map, BluePrint>(keys, sizes);
+    measure_footprint<jstd_group15_flat_map, BluePrint>(keys, sizes);
+    measure_footprint<jstd_cuckoo_flat_map,  BluePrint>(keys, sizes);
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t max_size = kDefaultMaxSize;
+    std::size_t steps_per_octave = kDefaultStepsPerOctave;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value >= static_cast<long long>(kMinSize))
+            max_size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value >= 1 && value <= 64)
+            steps_per_octave = static_cast<std::size_t>(value);
+    }
+
+#if defined(__GLIBC__)
+    // Use mmap() for the big blocks and trim the heap eagerly,
+    // otherwise the freed tables stay resident and the RSS delta is under-estimated.
+    ::mallopt(M_MMAP_THRESHOLD, 64 * 1024);
+    ::mallopt(M_TRIM_THRESHOLD, 64 * 1024);
+#endif
+
+    printf("mem_footprint: max_size = %" PRIuPTR ", steps_per_octave = %" PRIuPTR "\n\n",
+           max_size, steps_per_octave);
+
+    measure_blueprint<uint32_uint32>(max_size, steps_per_octave);
+    measure_blueprint<uint64_uint64>(max_size, steps_per_octave);
+    measure_blueprint<uint64_struct448>(max_size, steps_per_octave);
+    measure_blueprint<string_uint64>(max_size, steps_per_octave);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
@@ -0,0 +1,271 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// ordered_map_bench: group15_ordered_flat_map (dense entries + group15 index) vs. group15_flat_map.
+//
+// Usage: ordered_map_bench [size_K]
+//
+// The maps are uint64_t -> uint64_t with size_K (default 1024) K random keys. group15_flat_map
+// is measured as built (dense) and with 4 times the capacity reserved (sparse), the iteration
+// of group15_ordered_flat_map doesn't depend on the load factor.
+//
+//   insert:        build the map from empty.
+//   iterate:       sum the values, ns per entry.
+//   find hit/miss: ns per find.
+//   erase 25%:     then iterate over the holes, and insert the keys again.
+//   mixes:         iterate-heavy (20 passes + size finds) and probe-heavy
+//                  (1 pass + 10 * size finds), ns per visited entry or find.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/group15_ordered_flat_map.hpp>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSizeK = 1024;
+#else
+static const std::size_t kDefaultSizeK = 64;
+#endif
+
+static const std::uint64_t kSeed = 20241212ull;
+
+// The passes and the finds (in sizes) of a mix.
+struct OpMix {
+    const char * name;
+    std::size_t  passes;
+    std::size_t  find_rounds;
+};
+
+static const OpMix kOpMixes[] = {
+    { "iterate-heavy", 20,  1 },
+    { "probe-heavy",    1, 10 },
+};
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("ordered_map_bench");
+
+// Written by each pass, so the repeated passes of a mix can't be merged by the compiler.
+static std::size_t g_sink = 0;
+
+static void report(const std::string & name, double elapsed_ns, std::size_t ops, const char * note)
+{
+    double ns_per_op = elapsed_ns / ops;
+    printf("%-44s %10.3f %10.2f   %s\n", name.c_str(), elapsed_ns / 1.0E6, ns_per_op, note);
+    ::fflush(stdout);
+
+    g_benchmark_report.addSample(name + "/ns_per_op", "ns/op", ns_per_op);
+}
+
+template <typename HashMap>
+static std::uint64_t sum_values(const HashMap & map)
+{
+    std::uint64_t sum = 0;
+    for (auto iter = map.begin(); iter != map.end(); ++iter) {
+        sum += iter->second;
+    }
+    g_sink += static_cast<std::size_t>(sum);
+    return sum;
+}
+
+template <typename HashMap>
+static std::size_t find_all(const HashMap & map, const std::vector<std::uint64_t> & keys)
+{
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        found += (map.find(keys[i]) != map.end());
+    }
+    g_sink += found;
+    return found;
+}
+
+template <typename HashMap>
+static void bench_map(const std::string & map_name, const std::vector<std::uint64_t> & keys,
+                      const std::vector<std::uint64_t> & miss_keys,
+                      const std::vector<std::uint64_t> & probe_keys,
+                      std::size_t reserve_size, std::uint64_t expected_sum)
+{
+    jtest::StopWatch sw;
+    HashMap map;
+    if (reserve_size != 0)
+        map.reserve(reserve_size);
+
+    sw.start();
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        map.insert(std::make_pair(keys[i], keys[i]));
+    }
+    sw.stop();
+    report(map_name + "/insert", sw.getElapsedNanosec(), keys.size(),
+           (map.size() == keys.size()) ? "" : "MISMATCH");
+
+    sw.start();
+    std::uint64_t sum = sum_values(map);
+    sw.stop();
+    report(map_name + "/iterate", sw.getElapsedNanosec(), keys.size(),
+           (sum == expected_sum) ? "" : "MISMATCH");
+
+    sw.start();
+    std::size_t found = find_all(map, probe_keys);
+    sw.stop();
+    report(map_name + "/find_hit", sw.getElapsedNanosec(), probe_keys.size(),
+           (found == probe_keys.size()) ? "" : "MISMATCH");
+
+    sw.start();
+    found = find_all(map, miss_keys);
+    sw.stop();
+    report(map_name + "/find_miss", sw.getElapsedNanosec(), miss_keys.size(), "");
+
+    for (std::size_t m = 0; m < sizeof(kOpMixes) / sizeof(kOpMixes[0]); m++) {
+        const OpMix & mix = kOpMixes[m];
+        std::size_t ops = mix.passes * map.size() + mix.find_rounds * probe_keys.size();
+        std::uint64_t mix_sum = 0;
+        found = 0;
+        sw.start();
+        for (std::size_t pass = 0; pass < mix.passes; pass++) {
+            mix_sum += sum_values(map);
+        }
+        for (std::size_t round = 0; round < mix.find_rounds; round++) {
+            found += find_all(map, probe_keys);
+        }
+        sw.stop();
+        report(map_name + "/" + mix.name, sw.getElapsedNanosec(), ops,
+               (mix_sum == expected_sum * mix.passes &&
+                found == probe_keys.size() * mix.find_rounds) ? "" : "MISMATCH");
+    }
+
+    // Erase every 4th key, iterate over the holes, then insert them again.
+    std::size_t quarter = 0;
+    std::uint64_t erased_sum = 0;
+    sw.start();
+    for (std::size_t i = 0; i < keys.size(); i += 4) {
+        quarter += map.erase(keys[i]);
+        erased_sum += keys[i];
+    }
+    sw.stop();
+    report(map_name + "/erase_25%", sw.getElapsedNanosec(), quarter, "");
+
+    sw.start();
+    sum = sum_values(map);
+    sw.stop();
+    report(map_name + "/iterate_after_erase", sw.getElapsedNanosec(), map.size(),
+           (sum == expected_sum - erased_sum) ? "" : "MISMATCH");
+
+    sw.start();
+    for (std::size_t i = 0; i < keys.size(); i += 4) {
+        map.insert(std::make_pair(keys[i], keys[i]));
+    }
+    sw.stop();
+    report(map_name + "/reinsert_25%", sw.getElapsedNanosec(), quarter,
+           (map.size() == keys.size()) ? "" : "MISMATCH");
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size_k = kDefaultSizeK;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size_k = static_cast<std::size_t>(value);
+    }
+
+    std::size_t size = size_k * 1024;
+    std::vector<std::uint64_t> keys(size), miss_keys(size), probe_keys(size);
+    jstd::Xoshiro256x4 random(kSeed);
+    random.fill(keys.data(), keys.size());
+    random.fill(miss_keys.data(), miss_keys.size());
+
+    // The hits in random order, not in insertion order.
+    jstd::Xoshiro256 probe_random(~kSeed);
+    std::uint64_t expected_sum = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        probe_keys[i] = keys[static_cast<std::size_t>(probe_random.rand() % size)];
+        expected_sum += keys[i];
+    }
+
+    printf("size = %" PRIuPTR " K\n\n", size_k);
+    printf("%-44s %10s %10s\n", "name", "total (ms)", "ns/op");
+    printf("------------------------------------------------------------------\n");
+
+    typedef jstd::group15_flat_map<std::uint64_t, std::uint64_t>          flat_map_t;
+    typedef jstd::group15_ordered_flat_map<std::uint64_t, std::uint64_t>  ordered_map_t;
+
+    bench_map<flat_map_t>("group15_flat_map/dense", keys, miss_keys, probe_keys, 0, expected_sum);
+    bench_map<flat_map_t>("group15_flat_map/sparse", keys, miss_keys, probe_keys, size * 4, expected_sum);
+    bench_map<ordered_map_t>("group15_ordered_flat_map", keys, miss_keys, probe_keys, 0, expected_sum);
+
+    printf("sink = %" PRIuPTR "\n", g_sink);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
@@ -0,0 +1,236 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// random_bench: The speed of generating the random datasets, by the random algorithm.
+//
+// Usage: random_bench [count_M]
+//
+// Generate count_M (default 64) million 64-bit random numbers with:
+//
+//   mt19937_64:    jstd::MT19937_64::rand(), one number at a time.
+//   xoshiro256:    jstd::Xoshiro256::fill(), scalar xoshiro256**.
+//   xoshiro256x4:  jstd::Xoshiro256x4::fill(), four lanes, AVX2 if it's enabled.
+//   parallel_xN:   jstd::parallel_random_fill<Xoshiro256x4>() with N threads.
+//
+// and record the ns per number and the GB/s. The parallel results must be identical
+// for any number of threads. At last, shuffle a vector of the same size by
+// the MT19937_64 modulo loop and by jstd::random_shuffle().
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <thread>
+#include <numeric>      // For std::iota()
+#include <algorithm>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultCountM = 64;
+#else
+static const std::size_t kDefaultCountM = 1;
+#endif
+
+static const std::uint64_t kSeed = 20241205ull;
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("random_bench");
+
+static std::uint64_t checksum(const std::vector<std::uint64_t> & numbers)
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < numbers.size(); i++) {
+        sum = (sum ^ numbers[i]) * 0x9E3779B97F4A7C15ull;
+    }
+    return sum;
+}
+
+static void report(const char * name, double elapsed_ns, std::size_t count, const char * note = "")
+{
+    double ns_per_num = elapsed_ns / count;
+    double gb_per_sec = (double)(count * sizeof(std::uint64_t)) / (1024.0 * 1024.0 * 1024.0) / (elapsed_ns / 1.0E9);
+
+    printf("%-16s %12.2f %12.3f %10.2f   %s\n", name, elapsed_ns / 1.0E6, ns_per_num, gb_per_sec, note);
+    ::fflush(stdout);
+
+    g_benchmark_report.addSample(std::string(name) + "/ns_per_num", "ns/op", ns_per_num);
+}
+
+template <typename RandomAlgorithm>
+static void bench_fill(const char * name, std::vector<std::uint64_t> & numbers)
+{
+    RandomAlgorithm random(kSeed);
+
+    jtest::StopWatch sw;
+    sw.start();
+    random.fill(numbers.data(), numbers.size());
+    sw.stop();
+
+    report(name, sw.getElapsedNanosec(), numbers.size());
+}
+
+static void bench_mt19937_64(std::vector<std::uint64_t> & numbers)
+{
+    jstd::MT19937_64 random(kSeed);
+
+    jtest::StopWatch sw;
+    sw.start();
+    for (std::size_t i = 0; i < numbers.size(); i++) {
+        numbers[i] = random.rand();
+    }
+    sw.stop();
+
+    report("mt19937_64", sw.getElapsedNanosec(), numbers.size());
+}
+
+static void bench_parallel_fill(std::vector<std::uint64_t> & numbers)
+{
+    std::size_t max_threads = (std::max)(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+    std::uint64_t expected = 0;
+
+    // 1, 2, 4, ... and max_threads.
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    for (std::size_t i = 0; i < thread_counts.size(); i++) {
+        std::size_t threads = thread_counts[i];
+        jtest::StopWatch sw;
+        sw.start();
+        jstd::parallel_random_fill<jstd::Xoshiro256x4>(numbers.data(), numbers.size(), kSeed, threads);
+        sw.stop();
+
+        std::uint64_t sum = checksum(numbers);
+        if (threads == 1)
+            expected = sum;
+
+        std::string name = "parallel_x" + std::to_string(threads);
+        report(name.c_str(), sw.getElapsedNanosec(), numbers.size(), (sum == expected) ? "" : "MISMATCH");
+    }
+}
+
+static void bench_shuffle(std::size_t count)
+{
+    std::vector<std::uint64_t> numbers(count);
+
+    std::iota(numbers.begin(), numbers.end(), 0);
+    jstd::MT19937_64 random(kSeed);
+    jtest::StopWatch sw;
+    sw.start();
+    for (std::size_t n = numbers.size(); n >= 2; n--) {
+        std::size_t rnd_idx = std::size_t(random.rand()) % n;
+        std::swap(numbers[n - 1], numbers[rnd_idx]);
+    }
+    sw.stop();
+    report("shuffle_mt", sw.getElapsedNanosec(), count);
+
+    std::iota(numbers.begin(), numbers.end(), 0);
+    sw.start();
+    jstd::random_shuffle<jstd::Xoshiro256x4>(numbers.begin(), numbers.end(), kSeed);
+    sw.stop();
+    report("shuffle_x4", sw.getElapsedNanosec(), count);
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t count_m = kDefaultCountM;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            count_m = static_cast<std::size_t>(value);
+    }
+
+    std::size_t count = count_m * 1024 * 1024;
+    std::vector<std::uint64_t> numbers(count);
+
+    printf("JSTD_HAVE_XOSHIRO256_AVX2 = %d, count = %" PRIuPTR " M, threads = %u\n\n",
+           (int)JSTD_HAVE_XOSHIRO256_AVX2, count_m, std::thread::hardware_concurrency());
+    printf("%-16s %12s %12s %10s\n", "method", "total (ms)", "ns/number", "GB/s");
+    printf("----------------------------------------------------------\n");
+
+    // Touch the pages first.
+    std::fill(numbers.begin(), numbers.end(), 0);
+
+    bench_mt19937_64(numbers);
+    bench_fill<jstd::Xoshiro256>("xoshiro256", numbers);
+    bench_fill<jstd::Xoshiro256x4>("xoshiro256x4", numbers);
+    bench_parallel_fill(numbers);
+    printf("\n");
+
+    bench_shuffle(count);
+    printf("\n");
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
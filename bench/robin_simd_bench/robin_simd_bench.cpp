@@ -0,0 +1,259 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+//
+//
+// robin_simd_bench: jstd::robin_hash_map with the AVX2, SSE2 and SWAR group match operations.
+//
+// Usage: robin_simd_bench_{avx2, sse2, swar} [size] [lookups]
+//
+// The same source is built three times with ROBIN_SIMD_LEVEL = 2 (AVX2), 1 (SSE2)
+// and 0 (SWAR), run them on the same machine to compare. For each key type
+// (uint64: 8-bit ctrl, 24 bytes key: 64-bit ctrl with the stored hash), record:
+//
+//   insert:    The ns per insertion into an empty map, include the growth.
+//   hit, miss: The ns per find() of the existing keys and the absent keys, in a random order.
+//   erase:     The ns per erase() of all the keys.
+//
+// The map size is size / 20 (in the cache) and size (default 1M).
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSize = 1000 * 1000;
+static const std::size_t kDefaultLookups = 8 * 1024 * 1024;
+#else
+static const std::size_t kDefaultSize = 32 * 1000;
+static const std::size_t kDefaultLookups = 256 * 1024;
+#endif
+
+#if (ROBIN_SIMD_LEVEL >= 2)
+static const char * const kSimdName = "avx2";
+#elif (ROBIN_SIMD_LEVEL == 1)
+static const char * const kSimdName = "sse2";
+#else
+static const char * const kSimdName = "swar";
+#endif
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("robin_simd_bench");
+
+struct Key24 {
+    std::uint64_t a, b, c;
+
+    bool operator == (const Key24 & rhs) const {
+        return (this->a == rhs.a && this->b == rhs.b && this->c == rhs.c);
+    }
+};
+
+struct Key24Hash {
+    typedef std::size_t result_type;
+
+    std::size_t operator () (const Key24 & key) const {
+        return static_cast<std::size_t>((key.a ^ (key.b >> 7) ^ (key.c << 11)) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+// splitmix64, the keys are unique for the different counters.
+static std::uint64_t mix64(std::uint64_t counter)
+{
+    std::uint64_t z = counter + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31));
+}
+
+struct u64_keys {
+    typedef std::uint64_t key_type;
+    typedef jstd::robin_hash_map<key_type, std::uint64_t> map_type;
+
+    static const char * name() { return "uint64"; }
+    static key_type make(std::uint64_t i) { return mix64(i); }
+};
+
+struct key24_keys {
+    typedef Key24 key_type;
+    typedef jstd::robin_hash_map<key_type, std::uint64_t, Key24Hash> map_type;
+
+    static const char * name() { return "key24"; }
+    static key_type make(std::uint64_t i) {
+        std::uint64_t x = mix64(i);
+        Key24 key = { x, x + 1, i };
+        return key;
+    }
+};
+
+static void add_result(const std::string & name, double ns_per_op)
+{
+    g_benchmark_report.addSample(name, "ns/op", ns_per_op);
+}
+
+template <typename Keys>
+void run_bench(std::size_t size, std::size_t lookups)
+{
+    typedef typename Keys::key_type key_type;
+    typedef typename Keys::map_type map_type;
+
+    std::vector<key_type> keys(size), absent_keys(size);
+    for (std::size_t i = 0; i < size; i++) {
+        keys[i] = Keys::make(i);
+        absent_keys[i] = Keys::make(i + size);
+    }
+
+    std::vector<std::size_t> order(lookups);
+    jstd::MtRandomGen::srand(20240815UL);
+    for (std::size_t i = 0; i < lookups; i++) {
+        order[i] = static_cast<std::size_t>(jstd::MtRandomGen::nextUInt64()) % size;
+    }
+
+    jtest::StopWatch sw;
+    map_type map;
+
+    sw.start();
+    for (std::size_t i = 0; i < size; i++) {
+        map.emplace(keys[i], std::uint64_t(i));
+    }
+    sw.stop();
+    double insert_ns = sw.getElapsedNanosec() / size;
+
+    std::size_t checksum = 0;
+    sw.start();
+    for (std::size_t i = 0; i < lookups; i++) {
+        checksum += (map.find(keys[order[i]]) != map.end()) ? 1 : 0;
+    }
+    sw.stop();
+    double hit_ns = sw.getElapsedNanosec() / lookups;
+
+    sw.start();
+    for (std::size_t i = 0; i < lookups; i++) {
+        checksum += (map.find(absent_keys[order[i]]) != map.end()) ? 1 : 0;
+    }
+    sw.stop();
+    double miss_ns = sw.getElapsedNanosec() / lookups;
+
+    sw.start();
+    for (std::size_t i = 0; i < size; i++) {
+        checksum += map.erase(keys[i]);
+    }
+    sw.stop();
+    double erase_ns = sw.getElapsedNanosec() / size;
+
+    printf("%-6s %-8s %10" PRIuPTR " %10.2f %10.2f %10.2f %10.2f   (checksum = %" PRIuPTR ")\n",
+           kSimdName, Keys::name(), size, insert_ns, hit_ns, miss_ns, erase_ns, checksum);
+    ::fflush(stdout);
+
+    std::string report_name = std::string(kSimdName) + "/" + Keys::name() + "/" + std::to_string(size);
+    add_result(report_name + "/insert", insert_ns);
+    add_result(report_name + "/hit", hit_ns);
+    add_result(report_name + "/miss", miss_ns);
+    add_result(report_name + "/erase", erase_ns);
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t size = kDefaultSize;
+    std::size_t lookups = kDefaultLookups;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            lookups = static_cast<std::size_t>(value);
+    }
+
+    std::size_t small_size = (std::max)(size / 20, std::size_t(1));
+
+    printf("ROBIN_SIMD_LEVEL = %d (%s), size = %" PRIuPTR ", lookups = %" PRIuPTR "\n\n",
+           (int)ROBIN_SIMD_LEVEL, kSimdName, size, lookups);
+    printf("%-6s %-8s %10s %10s %10s %10s %10s\n",
+           "simd", "key", "size", "insert", "hit", "miss", "erase");
+    printf("-----------------------------------------------------------------------\n");
+
+    run_bench<u64_keys>(small_size, lookups);
+    run_bench<u64_keys>(size, lookups);
+    run_bench<key24_keys>(small_size, lookups);
+    run_bench<key24_keys>(size, lookups);
+    printf("\n");
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
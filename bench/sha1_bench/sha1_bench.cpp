@@ -0,0 +1,210 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// sha1_bench: The throughput of the SHA-1 digests of many short messages, by the message size.
+//
+// Usage: sha1_bench [total_MB]
+//
+// For each message size, hash total_MB (default 32 MB) of the messages with:
+//
+//   scalar:    jstd::sha1::sha1_digest_batch_scalar(), one message at a time.
+//   avx2_x8:   jstd::sha1::sha1_digest_batch_avx2(), the 8 lanes multi-buffer.
+//   ni_x1:     jstd::sha1::sha1_digest_batch_ni<1>(), SHA-NI, one message at a time.
+//   ni_x2:     jstd::sha1::sha1_digest_batch_ni<2>(), SHA-NI, 2 messages interleaved.
+//   ni_x4:     jstd::sha1::sha1_digest_batch_ni<4>(), SHA-NI, 4 messages interleaved.
+//
+// and record the MB/s and the ns per message. The digests of all the methods are checked
+// against the scalar one. The methods that the CPU (or the compiler flags) don't support are skipped.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hasher/sha1.h>
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultTotalMB = 32;
+#else
+static const std::size_t kDefaultTotalMB = 1;
+#endif
+
+static const std::size_t kMinMessages = 1024;
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("sha1_bench");
+
+typedef void (*sha1_batch_func_t)(const char * const * data, const std::size_t * length,
+                                  jstd::digest160 * digests, std::size_t count);
+
+struct Messages {
+    std::vector<char>           buffer;
+    std::vector<const char *>   data;
+    std::vector<std::size_t>    length;
+
+    void init(std::size_t message_size, std::size_t count) {
+        this->buffer.resize(message_size * count + 1);
+        this->data.resize(count);
+        this->length.resize(count);
+
+        for (std::size_t i = 0; i < this->buffer.size(); i++) {
+            this->buffer[i] = static_cast<char>(jstd::MtRandomGen::nextUInt());
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            this->data[i] = &this->buffer[i * message_size];
+            this->length[i] = message_size;
+        }
+    }
+
+    std::size_t size() const { return this->data.size(); }
+};
+
+static void run_one(const char * name, sha1_batch_func_t func, const Messages & messages,
+                    std::size_t message_size, const std::vector<jstd::digest160> & expected)
+{
+    std::size_t count = messages.size();
+    std::vector<jstd::digest160> digests(count);
+
+    jtest::StopWatch sw;
+    sw.start();
+    func(messages.data.data(), messages.length.data(), digests.data(), count);
+    sw.stop();
+
+    double elapsed_ns = sw.getElapsedNanosec();
+    double ns_per_msg = elapsed_ns / count;
+    double mb_per_sec = (double)(message_size * count) / (1024.0 * 1024.0) / (elapsed_ns / 1.0E9);
+
+    std::size_t mismatches = 0;
+    if (!expected.empty()) {
+        for (std::size_t i = 0; i < count; i++) {
+            if (digests[i] != expected[i])
+                mismatches++;
+        }
+    }
+
+    printf("%-8s %10" PRIuPTR " %10" PRIuPTR " %12.2f %12.2f   %s\n",
+           name, message_size, count, mb_per_sec, ns_per_msg,
+           (mismatches == 0) ? "" : "MISMATCH");
+    ::fflush(stdout);
+
+    std::string report_name = std::string(name) + "/" + std::to_string(message_size);
+    g_benchmark_report.addSample(report_name + "/ns_per_msg", "ns/op", ns_per_msg);
+}
+
+static void run_bench(std::size_t message_size, std::size_t total_bytes)
+{
+    std::size_t count = (std::max)(total_bytes / (std::max)(message_size, std::size_t(1)), kMinMessages);
+
+    Messages messages;
+    messages.init(message_size, count);
+
+    std::vector<jstd::digest160> expected(count);
+    jstd::sha1::sha1_digest_batch_scalar(messages.data.data(), messages.length.data(), expected.data(), count);
+
+    std::vector<jstd::digest160> none;
+    run_one("scalar", jstd::sha1::sha1_digest_batch_scalar, messages, message_size, none);
+#if JSTD_HAVE_SHA1_AVX2
+    run_one("avx2_x8", jstd::sha1::sha1_digest_batch_avx2, messages, message_size, expected);
+#endif
+#if JSTD_HAVE_SHA1_NI
+    run_one("ni_x1", jstd::sha1::sha1_digest_batch_ni<1>, messages, message_size, expected);
+    run_one("ni_x2", jstd::sha1::sha1_digest_batch_ni<2>, messages, message_size, expected);
+    run_one("ni_x4", jstd::sha1::sha1_digest_batch_ni<4>, messages, message_size, expected);
+#endif
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t total_mb = kDefaultTotalMB;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            total_mb = static_cast<std::size_t>(value);
+    }
+
+    jstd::MtRandomGen::srand(20240815UL);
+
+    printf("JSTD_HAVE_SHA1_NI = %d, JSTD_HAVE_SHA1_AVX2 = %d, total = %" PRIuPTR " MB\n\n",
+           (int)JSTD_HAVE_SHA1_NI, (int)JSTD_HAVE_SHA1_AVX2, total_mb);
+    printf("%-8s %10s %10s %12s %12s\n", "method", "msg_size", "messages", "MB/s", "ns/msg");
+    printf("--------------------------------------------------------------\n");
+
+    static const std::size_t kMessageSizes[] = { 16, 32, 55, 64, 100, 256, 1024, 4096 };
+    for (std::size_t i = 0; i < sizeof(kMessageSizes) / sizeof(kMessageSizes[0]); i++) {
+        run_bench(kMessageSizes[i], total_mb * 1024 * 1024);
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
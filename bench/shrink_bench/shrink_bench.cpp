@@ -0,0 +1,250 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+//
+// shrink_bench: The RSS over time of a jstd::group15_flat_map that spikes and drains,
+//               with the min_load_factor() shrink policy and clear(false, true).
+//
+// Usage: shrink_bench [spike_size] [drain_size] [batches]
+//
+// Each batch inserts spike_size (default 4M) uint64 keys, erases them by key until
+// drain_size (default 4000) keys are left, then clears the map. The map is reused
+// by all the batches, like a per-batch map of a long-running service.
+//
+// The RSS (jtest::getCurrentRSS(), minus the RSS before the map is created) and
+// the bucket_count() are printed after each phase, for the configurations:
+//
+//   default:           min_load_factor(0), clear().
+//   min_lf:            min_load_factor(0.1), erase(key) shrinks the table.
+//   release:           min_load_factor(0), clear(false, true) releases the slot pages.
+//   min_lf + release:  both of them.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#if defined(__GLIBC__)
+#include <malloc.h>     // For mallopt(), malloc_trim()
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+#include <jstd/test/ReadRss.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultSpikeSize = 4 * 1000 * 1000;
+static const std::size_t kDefaultDrainSize = 4000;
+static const std::size_t kDefaultBatches = 3;
+#else
+static const std::size_t kDefaultSpikeSize = 64 * 1000;
+static const std::size_t kDefaultDrainSize = 1000;
+static const std::size_t kDefaultBatches = 2;
+#endif
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("shrink_bench");
+
+typedef std::uint64_t key_type;
+typedef std::uint64_t mapped_type;
+
+typedef jstd::group15_flat_map<key_type, mapped_type> map_type;
+
+struct Config {
+    const char *    name;
+    float           min_lf;
+    bool            release_pages;
+};
+
+static const Config kConfigs[] = {
+    { "default",          0.0f, false },
+    { "min_lf",           0.1f, false },
+    { "release",          0.0f, true  },
+    { "min_lf + release", 0.1f, true  }
+};
+
+static key_type make_key(std::size_t batch, std::size_t i)
+{
+    return (static_cast<key_type>(batch * 0x100000000ULL + i) * 0x9E3779B97F4A7C15ULL);
+}
+
+static void release_free_memory()
+{
+#if defined(__GLIBC__)
+    ::malloc_trim(0);
+#endif
+}
+
+static double to_MB(std::size_t rss, std::size_t rss_base)
+{
+    std::size_t bytes = (rss > rss_base) ? (rss - rss_base) : 0;
+    return (static_cast<double>(bytes) / (1024.0 * 1024.0));
+}
+
+static void print_phase(const Config & config, std::size_t batch, const char * phase,
+                        const map_type & map, std::size_t rss_base, double elapsed_ms)
+{
+    double rss_MB = to_MB(jtest::getCurrentRSS(), rss_base);
+    printf("%-18s %6" PRIuPTR " %-8s %10" PRIuPTR " %12" PRIuPTR " %10.1f %10.1f\n",
+           config.name, batch, phase, map.size(), map.bucket_count(), rss_MB, elapsed_ms);
+    ::fflush(stdout);
+
+    std::string report_name = std::string(config.name) + "/" + std::to_string(batch) + "/" + phase;
+    g_benchmark_report.addSample(report_name + "/rss", "MB", rss_MB);
+    g_benchmark_report.addSample(report_name + "/time", "ms", elapsed_ms);
+}
+
+void run_config(const Config & config, std::size_t spike_size, std::size_t drain_size, std::size_t batches)
+{
+    // The keys are allocated and touched before the base RSS.
+    std::vector<key_type> keys(spike_size, key_type(0));
+
+    release_free_memory();
+    std::size_t rss_base = jtest::getCurrentRSS();
+
+    jtest::StopWatch sw;
+
+    {
+        map_type map;
+        map.min_load_factor(config.min_lf);
+
+        for (std::size_t batch = 0; batch < batches; batch++) {
+            for (std::size_t i = 0; i < spike_size; i++) {
+                keys[i] = make_key(batch, i);
+            }
+
+            sw.start();
+            for (std::size_t i = 0; i < spike_size; i++) {
+                map.emplace(keys[i], mapped_type(i));
+            }
+            sw.stop();
+            print_phase(config, batch, "spike", map, rss_base, sw.getElapsedMillisec());
+
+            sw.start();
+            for (std::size_t i = drain_size; i < spike_size; i++) {
+                map.erase(keys[i]);
+            }
+            sw.stop();
+            print_phase(config, batch, "drain", map, rss_base, sw.getElapsedMillisec());
+
+            sw.start();
+            map.clear(false, config.release_pages);
+            sw.stop();
+            print_phase(config, batch, "clear", map, rss_base, sw.getElapsedMillisec());
+        }
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t spike_size = kDefaultSpikeSize;
+    std::size_t drain_size = kDefaultDrainSize;
+    std::size_t batches = kDefaultBatches;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            spike_size = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value >= 0)
+            drain_size = static_cast<std::size_t>(value);
+    }
+    if (argc > 3) {
+        long long value = ::atoll(argv[3]);
+        if (value > 0)
+            batches = static_cast<std::size_t>(value);
+    }
+    if (drain_size > spike_size)
+        drain_size = spike_size;
+
+#if defined(__GLIBC__)
+    // Use mmap() for the big blocks and trim the heap eagerly, otherwise the tables
+    // freed by the growth and the shrinking stay resident in the heap of glibc.
+    ::mallopt(M_MMAP_THRESHOLD, 64 * 1024);
+    ::mallopt(M_TRIM_THRESHOLD, 64 * 1024);
+#endif
+
+    printf("spike_size = %" PRIuPTR ", drain_size = %" PRIuPTR ", batches = %" PRIuPTR
+           ", sizeof(value_type) = %u bytes\n\n",
+           spike_size, drain_size, batches, (unsigned)sizeof(map_type::value_type));
+    printf("%-18s %6s %-8s %10s %12s %10s %10s\n",
+           "config", "batch", "phase", "size", "buckets", "rss (MB)", "time (ms)");
+    printf("---------------------------------------------------------------------------------\n");
+
+    for (std::size_t n = 0; n < sizeof(kConfigs) / sizeof(kConfigs[0]); n++) {
+        run_config(kConfigs[n], spike_size, drain_size, batches);
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
@@ -151,6 +151,10 @@
 #include <jstd/system/Console.h>
 #include <jstd/system/RandomGen.h>
 #include <jstd/test/StopWatch.h>
+#include <jstd/test/CycleTimer.h>
+#include <jstd/test/LatencyHistogram.h>
+#include <jstd/test/BenchmarkReport.h>
+#include <jstd/test/PerfCounters.h>
 #include <jstd/test/CPUWarmUp.h>
 #include <jstd/test/ProcessMemInfo.h>
 #include <jstd/test/ReadRss.h>
@@ -231,9 +235,14 @@ static std::size_t g_num_constructor = 0;
 #endif
 #endif
 
+// The hardware performance counters, scoped by jtest::PerfStopWatch in each test.
+static jtest::PerfCounters g_perf_counters;
+
 static inline
 void reset_counter()
 {
+    g_perf_counters.reset();
+
 #if USE_STAT_COUNTER
     g_num_hashes = 0;
     g_num_copies = 0;
@@ -1094,6 +1103,10 @@ void print_test_time(std::size_t checksum, double elapsedTime)
     printf("sum = %-10" PRIuPTR "  time: %8.3f ms\n", checksum, elapsedTime);
 }
 
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("time_hash_map");
+static std::string g_current_map_name;
+
 static void report_result(char const * title, double ut, double lf, std::size_t iters,
                           size_t start_memory, size_t end_memory) {
     // Construct heap growth report text if applicable
@@ -1117,6 +1130,14 @@ static void report_result(char const * title, double ut, double lf, std::size_t
     }
 #endif
 
+    g_benchmark_report.addSample(g_current_map_name + "/" + title, "ns/op", (ut * 1000000000.0 / iters));
+    for (std::size_t event = 0; event < jtest::PerfCounters::kEventCount; event++) {
+        if (g_perf_counters.has(event)) {
+            g_benchmark_report.addSample(g_current_map_name + "/" + title + "/" + jtest::PerfCounters::event_name(event),
+                                         "events/op", g_perf_counters.per_op(event, iters));
+        }
+    }
+
 #if (USE_STAT_COUNTER == 0)
     printf("%-32s %8.2f ns  lf=%0.3f  %s\n", title, (ut * 1000000000.0 / iters), lf, heap);
 #else
@@ -1132,6 +1153,10 @@ static void report_result(char const * title, double ut, double lf, std::size_t
            lf, heap);
   #endif
 #endif
+    if (g_perf_counters.is_available()) {
+        printf("%-32s %s\n", "", g_perf_counters.format_per_op(iters).c_str());
+    }
+    g_perf_counters.reset();
     ::fflush(stdout);
 }
 
@@ -1141,11 +1166,7 @@ void shuffle_vector(Vector & vector, int seed = 0) {
     // shuffle
     if (seed == 0)
         seed = 20200831;
-    jstd::MtRandomGen mtRandomGen(seed);
-    for (std::size_t n = vector.size(); n >= 2; n--) {
-        std::size_t rnd_idx = std::size_t(jstd::MtRandomGen::nextUInt()) % n;
-        std::swap(vector[n - 1], vector[rnd_idx]);
-    }
+    jstd::random_shuffle<jstd::Xoshiro256x4>(vector.begin(), vector.end(), static_cast<std::uint64_t>(seed));
 }
 
 /* The implementation of test routine */
@@ -1156,6 +1177,7 @@ static void measure_hashmap(const char * name, std::size_t obj_size,
                             std::size_t iters, bool is_stress_hash_function) {
     printf("%s (%" PRIuPTR " byte objects, %" PRIuPTR " byte ValueType, %" PRIuPTR " iterations):\n",
            name, obj_size, sizeof(typename MapType::value_type), iters);
+    g_current_map_name = std::string(name) + "/" + std::to_string(obj_size) + "_byte";
     if (1) printf("\n");
 
     //------------------------------------------------------------
@@ -1231,6 +1253,14 @@ static void measure_hashmap(const char * name, std::size_t obj_size,
     if (1) map_random_iterate<MapType>(iters, rndIndices);
     if (1) printf("\n");
 
+    if (1) map_random_find_insert<MapType>(iters, rndIndices, 0);
+    if (1) map_random_find_insert<MapType>(iters, rndIndices, 1);
+    if (1) map_random_find_insert<MapType>(iters, rndIndices, 2);
+    if (1) printf("\n");
+
+    if (1) map_random_latency<MapType>(iters, rndIndices);
+    if (1) printf("\n");
+
     //------------------------------------------------------------
 
 #ifndef _DEBUG
@@ -1547,6 +1577,8 @@ int main(int argc, char * argv[])
 
     jtest::CPU::warm_up(1000);
 
+    printf("Perf counters: %s\n\n", g_perf_counters.status().c_str());
+
     if (1) { std_hash_test(); }
     if (0) { is_noexcept_move_test(); }
     if (0) { need_store_hash_test(); }
@@ -1561,6 +1593,8 @@ int main(int argc, char * argv[])
 
     printf("-----------------------------------------------------------------------------\n\n");
 
+    g_benchmark_report.writeFromEnv();
+
 #if defined(_MSC_VER) && defined(_DEBUG)
     jstd::Console::ReadKey();
 #endif
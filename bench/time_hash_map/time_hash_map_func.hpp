@@ -10,7 +10,7 @@ static void map_serial_find(char const * title, std::size_t iters,
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
     mapped_type i;
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -68,7 +68,7 @@ static void map_serial_find_failed(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
     mapped_type i;
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -98,7 +98,7 @@ static void map_serial_find_empty(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
     mapped_type i;
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -133,7 +133,7 @@ static void map_serial_insert(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -165,7 +165,7 @@ static void map_serial_insert_predicted(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -196,7 +196,7 @@ static void map_serial_insert_replace(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -233,7 +233,7 @@ static void map_serial_emplace(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -265,7 +265,7 @@ static void map_serial_emplace_predicted(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -296,7 +296,7 @@ static void map_serial_emplace_replace(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -333,7 +333,7 @@ static void map_serial_operator(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -365,7 +365,7 @@ static void map_serial_operator_predicted(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -396,7 +396,7 @@ static void map_serial_operator_replace(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -430,7 +430,7 @@ static void map_serial_erase(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -464,7 +464,7 @@ static void map_serial_erase_failed(std::size_t iters) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -501,7 +501,7 @@ static void map_serial_toggle(std::size_t iters) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -532,7 +532,7 @@ static void map_serial_iterate(std::size_t iters) {
     typedef typename MapType::const_iterator    const_iterator;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     mapped_type r;
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -573,7 +573,7 @@ static void map_random_find(char const * title, std::size_t iters,
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
     mapped_type i;
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -631,7 +631,7 @@ static void map_random_find_failed(std::size_t iters, const Vector & indices) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
     mapped_type i;
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -661,7 +661,7 @@ static void map_random_find_empty(std::size_t iters, const Vector & indices) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
     mapped_type i;
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -696,7 +696,7 @@ static void map_random_insert(std::size_t iters, const Vector & indices) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -728,7 +728,7 @@ static void map_random_insert_predicted(std::size_t iters, const Vector & indice
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -759,7 +759,7 @@ static void map_random_insert_replace(std::size_t iters, const Vector & indices)
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -796,7 +796,7 @@ static void map_random_emplace(std::size_t iters, const Vector & indices) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -828,7 +828,7 @@ static void map_random_emplace_predicted(std::size_t iters, const Vector & indic
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -859,7 +859,7 @@ static void map_random_emplace_replace(std::size_t iters, const Vector & indices
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -896,7 +896,7 @@ static void map_random_operator(std::size_t iters, const Vector & indices) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -928,7 +928,7 @@ static void map_random_operator_predicted(std::size_t iters, const Vector & indi
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -960,7 +960,7 @@ static void map_random_operator_replace(std::size_t iters, const Vector & indice
 
     MapType hashmap;
 
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -994,7 +994,7 @@ static void map_random_erase(std::size_t iters, const Vector & indices) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -1028,7 +1028,7 @@ static void map_random_erase_failed(std::size_t iters, const Vector & indices) {
     typedef typename MapType::mapped_type mapped_type;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
     for (mapped_type i = 0; i < max_iters; i++) {
@@ -1065,7 +1065,7 @@ static void map_random_toggle(std::size_t iters, const Vector & indices) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         mapped_type max_iters = static_cast<mapped_type>(iters);
 
@@ -1090,6 +1090,106 @@ static void map_random_toggle(std::size_t iters, const Vector & indices) {
     }
 }
 
+//
+// The insert-after-miss helpers: use lazy_emplace() and find_or_prepare_insert() if
+// the map has them, otherwise fall back to find() + emplace(), the second probe of it
+// is what the one-probe APIs save.
+//
+template <class MapType, class Key, class Factory>
+static auto map_lazy_emplace(MapType & hashmap, const Key & key, Factory && factory, int)
+    -> decltype(hashmap.lazy_emplace(key, std::forward<Factory>(factory)).second) {
+    return hashmap.lazy_emplace(key, std::forward<Factory>(factory)).second;
+}
+
+template <class MapType, class Key, class Factory>
+static bool map_lazy_emplace(MapType & hashmap, const Key & key, Factory && factory, long) {
+    if (hashmap.find(key) == hashmap.end()) {
+        hashmap.emplace(key, factory());
+        return true;
+    }
+    return false;
+}
+
+template <class MapType, class Key, class Value>
+static auto map_prepare_insert_hint(MapType & hashmap, const Key & key, const Value & value, int)
+    -> decltype(hashmap.find_or_prepare_insert(key).second) {
+    auto result = hashmap.find_or_prepare_insert(key);
+    if (result.second) {
+        hashmap.emplace_hint(result.first, key, value);
+    }
+    return result.second;
+}
+
+template <class MapType, class Key, class Value>
+static bool map_prepare_insert_hint(MapType & hashmap, const Key & key, const Value & value, long) {
+    auto iter = hashmap.find(key);
+    if (iter == hashmap.end()) {
+        hashmap.emplace_hint(iter, key, value);
+        return true;
+    }
+    return false;
+}
+
+//
+// Insert after miss: half of the keys are already in the map,
+// the rest are inserted after a failed lookup.
+//
+template <class MapType, class Vector>
+static void map_random_find_insert(std::size_t iters, const Vector & indices, int mode) {
+    typedef typename MapType::mapped_type mapped_type;
+
+    static const char * const kTitles[] = {
+        "random_find + emplace",
+        "random_lazy_emplace",
+        "random_prepare_insert + hint"
+    };
+
+    std::size_t start = CurrentMemoryUsage();
+    MapType hashmap;
+    std::size_t r = 0;
+
+    mapped_type max_iters = static_cast<mapped_type>(iters);
+    for (mapped_type i = 0; i < max_iters; i += 2) {
+        hashmap.emplace(indices[i], i);
+    }
+
+    {
+        jtest::PerfStopWatch sw(g_perf_counters);
+
+        reset_counter();
+        sw.start();
+        if (mode == 0) {
+            for (mapped_type i = 0; i < max_iters; i++) {
+                if (hashmap.find(indices[i]) == hashmap.end()) {
+                    hashmap.emplace(indices[i], i);
+                    r++;
+                }
+            }
+        } else if (mode == 1) {
+            for (mapped_type i = 0; i < max_iters; i++) {
+                r += static_cast<std::size_t>(
+                    map_lazy_emplace(hashmap, indices[i], [i]() { return i; }, 0));
+            }
+        } else {
+            for (mapped_type i = 0; i < max_iters; i++) {
+                r += static_cast<std::size_t>(map_prepare_insert_hint(hashmap, indices[i], i, 0));
+            }
+        }
+        sw.stop();
+
+        double ut = sw.getElapsedSecond();
+        std::size_t finish = CurrentMemoryUsage();
+
+        __COMPILER_BARRIER();
+
+        // Ensure the HashMap is not destructed
+        ::srand(static_cast<unsigned int>(r + hashmap.size()));
+
+        double lf = hashmap.load_factor();
+        report_result(kTitles[mode], ut, lf, iters, start, finish);
+    }
+}
+
 template <class MapType, class Vector>
 static void map_random_iterate(std::size_t iters, const Vector & indices) {
     typedef typename MapType::mapped_type       mapped_type;
@@ -1097,7 +1197,7 @@ static void map_random_iterate(std::size_t iters, const Vector & indices) {
 
     MapType hashmap;
 
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     mapped_type r;
 
     mapped_type max_iters = static_cast<mapped_type>(iters);
@@ -1136,7 +1236,7 @@ template <class MapType>
 static void stress_hash_function(std::size_t desired_insertions,
                                  std::size_t map_size,
                                  std::size_t stride) {
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::uint32_t num_insertions = 0;
     // One measurement of user time (in seconds) is done for each iteration of
     // the outer loop.  The times are summed.
@@ -1173,6 +1273,58 @@ static void stress_hash_function(std::size_t desired_insertions,
     }
 }
 
+//
+// Per-op latency (rdtscp cycles), report p50/p99/p99.9/max instead of the average,
+// the rehash spikes of insert and the long probe sequences only show up in the tail.
+//
+template <class MapType, class Vector>
+static void map_random_latency(std::size_t iters, const Vector & indices) {
+    typedef typename MapType::mapped_type mapped_type;
+    typedef jtest::CycleTimer::cycle_t cycle_t;
+
+    MapType hashmap;
+    jtest::LatencyHistogram histogram;
+    std::size_t r = 1;
+
+    mapped_type max_iters = static_cast<mapped_type>(iters);
+
+    // Insert into an empty map, include all of the rehash.
+    for (mapped_type i = 0; i < max_iters; i++) {
+        cycle_t start_cycles = jtest::CycleTimer::begin_cycles();
+        hashmap.emplace(indices[i], i);
+        histogram.record(jtest::CycleTimer::end_cycles() - start_cycles);
+    }
+    jtest::print_latency_percentiles("random_insert latency", histogram);
+
+    histogram.reset();
+    for (mapped_type i = 0; i < max_iters; i++) {
+        cycle_t start_cycles = jtest::CycleTimer::begin_cycles();
+        r ^= static_cast<std::size_t>(hashmap.find(indices[i]) != hashmap.end());
+        histogram.record(jtest::CycleTimer::end_cycles() - start_cycles);
+    }
+    jtest::print_latency_percentiles("random_find latency", histogram);
+
+    histogram.reset();
+    for (mapped_type i = max_iters; i < max_iters * 2; i++) {
+        cycle_t start_cycles = jtest::CycleTimer::begin_cycles();
+        r ^= static_cast<std::size_t>(hashmap.find(i) != hashmap.end());
+        histogram.record(jtest::CycleTimer::end_cycles() - start_cycles);
+    }
+    jtest::print_latency_percentiles("random_find_failed latency", histogram);
+
+    histogram.reset();
+    for (mapped_type i = 0; i < max_iters; i++) {
+        cycle_t start_cycles = jtest::CycleTimer::begin_cycles();
+        hashmap.erase(indices[i]);
+        histogram.record(jtest::CycleTimer::end_cycles() - start_cycles);
+    }
+    jtest::print_latency_percentiles("random_erase latency", histogram);
+    ::fflush(stdout);
+
+    // keep compiler from optimizing away r (we never call rand())
+    ::srand(static_cast<unsigned int>(r + hashmap.size()));
+}
+
 template <class MapType>
 static void stress_hash_function(std::size_t num_inserts) {
     static const std::size_t kMapSizes [] = { 256, 1024 };
@@ -152,6 +152,10 @@
 #include <jstd/system/Console.h>
 #include <jstd/system/RandomGen.h>
 #include <jstd/test/StopWatch.h>
+#include <jstd/test/CycleTimer.h>
+#include <jstd/test/LatencyHistogram.h>
+#include <jstd/test/BenchmarkReport.h>
+#include <jstd/test/PerfCounters.h>
 #include <jstd/test/CPUWarmUp.h>
 #include <jstd/test/ProcessMemInfo.h>
 #include <jstd/test/ReadRss.h>
@@ -232,9 +236,14 @@ static std::size_t g_num_constructor = 0;
 #endif
 #endif
 
+// The hardware performance counters, scoped by jtest::PerfStopWatch in each test.
+static jtest::PerfCounters g_perf_counters;
+
 static inline
 void reset_counter()
 {
+    g_perf_counters.reset();
+
 #if USE_STAT_COUNTER
     g_num_hashes = 0;
     g_num_copies = 0;
@@ -496,6 +505,10 @@ void print_test_time(std::size_t checksum, double elapsedTime)
     printf(" %-36s  sum = %-10" PRIuPTR "  time: %8.3f ms\n", name.c_str(), checksum, elapsedTime);
 }
 
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("time_hash_map_new");
+static std::string g_current_map_name;
+
 static void report_result(char const * title, double ut, double lf, std::size_t iters,
                           size_t start_memory, size_t end_memory) {
     // Construct heap growth report text if applicable
@@ -519,6 +532,14 @@ static void report_result(char const * title, double ut, double lf, std::size_t
     }
 #endif
 
+    g_benchmark_report.addSample(g_current_map_name + "/" + title, "ns/op", (ut * 1000000000.0 / iters));
+    for (std::size_t event = 0; event < jtest::PerfCounters::kEventCount; event++) {
+        if (g_perf_counters.has(event)) {
+            g_benchmark_report.addSample(g_current_map_name + "/" + title + "/" + jtest::PerfCounters::event_name(event),
+                                         "events/op", g_perf_counters.per_op(event, iters));
+        }
+    }
+
 #if (USE_STAT_COUNTER == 0)
     printf("%-32s %8.2f ns  lf=%0.3f  %s\n", title, (ut * 1000000000.0 / iters), lf, heap);
 #else
@@ -534,6 +555,10 @@ static void report_result(char const * title, double ut, double lf, std::size_t
            lf, heap);
   #endif
 #endif
+    if (g_perf_counters.is_available()) {
+        printf("%-32s %s\n", "", g_perf_counters.format_per_op(iters).c_str());
+    }
+    g_perf_counters.reset();
     ::fflush(stdout);
 }
 
@@ -565,6 +590,7 @@ void measure_hashmap(const char * name, std::size_t obj_size,
 
     printf("%s<K, V> (%" PRIuPTR " byte objects, %" PRIuPTR " byte ValueType, %" PRIuPTR " iterations):\n",
            name, obj_size, sizeof(value_type), iters);
+    g_current_map_name = std::string(name) + "/" + std::to_string(obj_size) + "_byte";
 
     if (1) printf("\n");
 
@@ -639,6 +665,9 @@ void measure_hashmap(const char * name, std::size_t obj_size,
     if (1) map_random_iterate<MapType>(iters, rndIndices);
     if (1) printf("\n");
 
+    if (1) map_random_latency<MapType>(iters, rndIndices);
+    if (1) printf("\n");
+
     //------------------------------------------------------------
 
 #ifndef _DEBUG
@@ -1094,6 +1123,8 @@ int main(int argc, char * argv[])
 
     jtest::CPU::warm_up(1000);
 
+    printf("Perf counters: %s\n\n", g_perf_counters.status().c_str());
+
     if (1) { std_hash_test(); }
     if (0) { need_store_hash_test(); }
     if (0) { is_compatible_layout_test(); }
@@ -1107,6 +1138,8 @@ int main(int argc, char * argv[])
 
     printf("-----------------------------------------------------------------------------\n\n");
 
+    g_benchmark_report.writeFromEnv();
+
 #if defined(_MSC_VER) && defined(_DEBUG)
     jstd::Console::ReadKey();
 #endif
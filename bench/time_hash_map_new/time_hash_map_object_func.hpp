@@ -7,7 +7,7 @@
 template <class MapType, class PairVector, class KeyVector>
 static void map_serial_find_success(std::size_t iters, const PairVector & kvs, const KeyVector & keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
 
     for (std::size_t i = 0; i < iters; i++) {
@@ -33,7 +33,7 @@ static void map_serial_find_success(std::size_t iters, const PairVector & kvs, c
 template <class MapType, class PairVector, class KeyVector>
 static void map_random_find_success(std::size_t iters, const PairVector & kvs, const KeyVector & rnd_keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
 
     for (std::size_t i = 0; i < iters; i++) {
@@ -59,7 +59,7 @@ static void map_random_find_success(std::size_t iters, const PairVector & kvs, c
 template <class MapType, class PairVector, class KeyVector>
 static void map_find_failed(std::size_t iters, const PairVector & kvs, const KeyVector & miss_keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
 
     for (std::size_t i = 0; i < iters; i++) {
@@ -85,7 +85,7 @@ static void map_find_failed(std::size_t iters, const PairVector & kvs, const Key
 template <class MapType, class PairVector, class KeyVector>
 static void map_find_empty(std::size_t iters, const PairVector & kvs, const KeyVector & keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
 
     for (std::size_t i = 0; i < iters; i++) {
@@ -116,7 +116,7 @@ static void map_insert(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {    
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         reset_counter();
         sw.start();
@@ -144,7 +144,7 @@ static void map_insert_predicted(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {    
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         hashmap.rehash(iters);
 
@@ -171,7 +171,7 @@ static void map_insert_predicted(std::size_t iters, const PairVector & kvs) {
 template <class MapType, class PairVector>
 static void map_insert_replace(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap.insert(kvs[i]);
@@ -205,7 +205,7 @@ static void map_emplace(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {        
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         reset_counter();
         sw.start();
@@ -233,7 +233,7 @@ static void map_emplace_predicted(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {        
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         hashmap.rehash(iters);
 
@@ -260,7 +260,7 @@ static void map_emplace_predicted(std::size_t iters, const PairVector & kvs) {
 template <class MapType, class PairVector>
 static void map_emplace_replace(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap.emplace(kvs[i]);
@@ -294,7 +294,7 @@ static void map_try_emplace(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         reset_counter();
         sw.start();
@@ -322,7 +322,7 @@ static void map_try_emplace_predicted(std::size_t iters, const PairVector & kvs)
     MapType hashmap;
 
     {
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         hashmap.rehash(iters);
 
@@ -349,7 +349,7 @@ static void map_try_emplace_predicted(std::size_t iters, const PairVector & kvs)
 template <class MapType, class PairVector, class KeyVector>
 static void map_try_emplace_replace(std::size_t iters, const PairVector & kvs, const KeyVector & rnd_keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap.emplace(kvs[i].first, kvs[i].second);
@@ -383,7 +383,7 @@ static void map_operator(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {        
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         reset_counter();
         sw.start();
@@ -411,7 +411,7 @@ static void map_operator_predicted(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {        
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         hashmap.rehash(iters);
 
@@ -438,7 +438,7 @@ static void map_operator_predicted(std::size_t iters, const PairVector & kvs) {
 template <class MapType, class PairVector>
 static void map_operator_replace(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap[kvs[i].first] = kvs[i].second;
@@ -469,7 +469,7 @@ static void map_operator_replace(std::size_t iters, const PairVector & kvs) {
 template <class MapType, class PairVector>
 static void map_serial_erase(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap.emplace(kvs[i]);
@@ -501,7 +501,7 @@ static void map_serial_erase(std::size_t iters, const PairVector & kvs) {
 template <class MapType, class PairVector, class KeyVector>
 static void map_random_erase(std::size_t iters, const PairVector & kvs, const KeyVector & rnd_keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap.emplace(kvs[i]);
@@ -533,7 +533,7 @@ static void map_random_erase(std::size_t iters, const PairVector & kvs, const Ke
 template <class MapType, class PairVector, class KeyVector>
 static void map_erase_failed(std::size_t iters, const PairVector & kvs, const KeyVector & miss_keys) {
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
 
     for (std::size_t i = 0; i < iters; i++) {
         hashmap.emplace(kvs[i]);
@@ -567,7 +567,7 @@ static void map_toggle(std::size_t iters, const PairVector & kvs) {
     MapType hashmap;
 
     {        
-        jtest::StopWatch sw;
+        jtest::PerfStopWatch sw(g_perf_counters);
 
         reset_counter();
         sw.start();
@@ -596,7 +596,7 @@ static void map_iterate(std::size_t iters, const PairVector & kvs) {
     typedef typename MapType::const_iterator    const_iterator;
 
     MapType hashmap;
-    jtest::StopWatch sw;
+    jtest::PerfStopWatch sw(g_perf_counters);
     std::size_t r;
 
     for (std::size_t i = 0; i < iters; i++) {
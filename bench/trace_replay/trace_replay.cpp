@@ -0,0 +1,462 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// trace_replay: Replay an operation trace (find / insert / assign / erase) on the hash maps.
+//
+// Usage: trace_replay [trace_file]
+//        trace_replay --record [trace_file] [ops] [keys]
+//
+// The trace format is described in jstd/test/OpTrace.h, the traces are recorded by
+// jtest::TracingMap, which wraps any map and streams its operations to the trace file.
+//
+// Without a trace_file, or with --record, a synthetic trace is recorded first
+// (default: 4M ops over 1M keys, Zipfian(0.99) key repetition, 70% find, 15% insert,
+// 5% assign, 10% erase) by a TracingMap around std::unordered_map, and then replayed.
+//
+// Each map replays the same trace twice, the first time for the throughput and the memory,
+// the second time for the latency of each op by the rdtscp cycle timer:
+//
+//   Mops/s:      The ops per second of the whole trace.
+//   peak, final: The peak and final bytes allocated by the map (jtest::CountingAllocator),
+//                per live element at the end of the trace.
+//   p50 ~ max:   The latency percentiles of all ops, and of each kind of the ops.
+//
+// The integer traces are replayed on <std::uint64_t, std::uint64_t>, the byte-key traces
+// on <std::string, std::uint64_t>. If the trace has the value sizes, the mapped_type
+// is std::string, and each insert or assign creates a value of that size.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+// jstd::unordered_map (jstd/hashmap/unordered_map.h) is still a work in progress,
+// and it can not be compiled now, enable it when it's ready.
+#define USE_JSTD_UNORDERED_MAP      0
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/flat16_hash_map.h>
+#if USE_JSTD_UNORDERED_MAP
+#include <jstd/hashmap/unordered_map.h>
+#endif
+#include <jstd/system/RandomGen.h>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/CycleTimer.h>
+#include <jstd/test/LatencyHistogram.h>
+#include <jstd/test/CountingAllocator.h>
+#include <jstd/test/BenchmarkReport.h>
+#include <jstd/test/OpTrace.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultOps  = 4 * 1024 * 1024;
+static const std::size_t kDefaultKeys = 1024 * 1024;
+#else
+static const std::size_t kDefaultOps  = 64 * 1024;
+static const std::size_t kDefaultKeys = 16 * 1024;
+#endif
+
+static const char * kDefaultTraceFile = "trace_replay.jot";
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("trace_replay");
+
+typedef jtest::OpTraceReader::record_type record_type;
+
+//
+// Engines, all use jtest::CountingAllocator.
+//
+template <typename Key, typename Value>
+using allocator_t = jtest::CountingAllocator<std::pair<const Key, Value>>;
+
+template <typename K, typename V>
+struct std_unordered_map {
+    typedef std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "std::unordered_map"; }
+};
+
+#if USE_JSTD_UNORDERED_MAP
+template <typename K, typename V>
+struct jstd_unordered_map {
+    typedef jstd::unordered_map<K, V, std::hash<K>, std::equal_to<K>,
+                                jstd::default_layout_policy<K, V>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::unordered_map"; }
+};
+#endif // USE_JSTD_UNORDERED_MAP
+
+template <typename K, typename V>
+struct jstd_flat16_hash_map {
+    typedef jstd::flat16_hash_map<K, V, std::hash<K>, std::equal_to<K>,
+                                  jtest::CountingAllocator<std::pair<K, V>>> table_type;
+    static const char * name() { return "jstd::flat16_hash_map"; }
+};
+
+template <typename K, typename V>
+struct jstd_robin_hash_map {
+    typedef jstd::robin_hash_map<K, V, std::hash<K>, std::equal_to<K>,
+                                 jstd::default_layout_policy<K, V>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::robin_hash_map"; }
+};
+
+template <typename K, typename V>
+struct jstd_group16_flat_map {
+    typedef jstd::group16_flat_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::group16_flat_map"; }
+};
+
+template <typename K, typename V>
+struct jstd_group15_flat_map {
+    typedef jstd::group15_flat_map<K, V, std::hash<K>, std::equal_to<K>, allocator_t<K, V>> table_type;
+    static const char * name() { return "jstd::group15_flat_map"; }
+};
+
+//
+// The keys of the records, the record.key is the key itself or the id of the key table.
+//
+struct UInt64Keys {
+    typedef std::uint64_t key_type;
+
+    void init(const jtest::OpTraceReader &) {}
+
+    key_type operator [] (std::uint64_t key) const { return key; }
+};
+
+struct StringKeys {
+    typedef std::string key_type;
+
+    std::vector<std::string> keys;
+
+    void init(const jtest::OpTraceReader & trace) {
+        this->keys.clear();
+        this->keys.reserve(trace.key_table().size());
+        for (std::size_t i = 0; i < trace.key_table().size(); i++) {
+            this->keys.push_back(trace.key_table()[i].to_string());
+        }
+    }
+
+    const key_type & operator [] (std::uint64_t key_id) const {
+        return this->keys[static_cast<std::size_t>(key_id)];
+    }
+};
+
+//
+// The values of the records.
+//
+struct UInt64Values {
+    typedef std::uint64_t mapped_type;
+
+    static mapped_type make(const record_type & record, std::size_t i) {
+        JSTD_UNUSED(record);
+        return static_cast<mapped_type>(i);
+    }
+};
+
+struct StringValues {
+    typedef std::string mapped_type;
+
+    static mapped_type make(const record_type & record, std::size_t i) {
+        JSTD_UNUSED(i);
+        std::size_t size = (record.value_size != jtest::OpTrace::kNoValueSize) ? record.value_size : 0;
+        return std::string(size, 'v');
+    }
+};
+
+template <typename Map, typename KeyTable, typename ValueMaker>
+JSTD_FORCED_INLINE
+std::size_t replay_one(Map & map, const KeyTable & keys, const record_type & record, std::size_t i)
+{
+    switch (record.op) {
+        case jtest::OpTrace::kFind:
+            return (map.find(keys[record.key]) != map.end()) ? 1 : 0;
+        case jtest::OpTrace::kInsert:
+            return map.emplace(keys[record.key], ValueMaker::make(record, i)).second ? 1 : 0;
+        case jtest::OpTrace::kAssign:
+            return map.insert_or_assign(keys[record.key], ValueMaker::make(record, i)).second ? 1 : 0;
+        case jtest::OpTrace::kErase:
+            return map.erase(keys[record.key]);
+        default:
+            return 0;
+    }
+}
+
+template <template <typename, typename> class Engine, typename KeyTable, typename ValueMaker>
+void replay_trace(const jtest::OpTraceReader & trace, const KeyTable & keys)
+{
+    typedef typename KeyTable::key_type         key_type;
+    typedef typename ValueMaker::mapped_type    mapped_type;
+    typedef typename Engine<key_type, mapped_type>::table_type table_type;
+
+    const char * map_name = Engine<key_type, mapped_type>::name();
+    const std::vector<record_type> & records = trace.records();
+    std::size_t num_ops = records.size();
+
+    //
+    // Pass 1: throughput and memory.
+    //
+    std::size_t alloc_before = jtest::AllocCounter::current_bytes();
+    jtest::AllocCounter::reset_peak();
+
+    std::size_t checksum = 0;
+    std::size_t final_size;
+    std::size_t final_bytes;
+    std::size_t peak_bytes;
+    double elapsed_ns;
+    {
+        table_type map;
+        jtest::StopWatch sw;
+        sw.start();
+        for (std::size_t i = 0; i < num_ops; i++) {
+            checksum += replay_one<table_type, KeyTable, ValueMaker>(map, keys, records[i], i);
+        }
+        sw.stop();
+        elapsed_ns = sw.getElapsedNanosec();
+
+        final_size = map.size();
+        final_bytes = jtest::AllocCounter::current_bytes() - alloc_before + sizeof(table_type);
+        peak_bytes = jtest::AllocCounter::peak_bytes() - alloc_before + sizeof(table_type);
+    }
+
+    //
+    // Pass 2: the latency of each op.
+    //
+    jtest::LatencyHistogram all_ops;
+    jtest::LatencyHistogram per_op[jtest::OpTrace::kOpTypeCount];
+    {
+        table_type map;
+        for (std::size_t i = 0; i < num_ops; i++) {
+            const record_type & record = records[i];
+            jtest::CycleTimer::cycle_t start = jtest::CycleTimer::begin_cycles();
+            checksum += replay_one<table_type, KeyTable, ValueMaker>(map, keys, record, i);
+            jtest::CycleTimer::cycle_t stop = jtest::CycleTimer::end_cycles();
+            all_ops.record(stop - start);
+            per_op[record.op].record(stop - start);
+        }
+    }
+
+    double mops = static_cast<double>(num_ops) / (elapsed_ns / 1000.0);
+    double live = static_cast<double>((final_size != 0) ? final_size : 1);
+
+    printf("%-24s %10.2f %10" PRIuPTR " %12.2f %12.2f   (checksum = %" PRIuPTR ")\n",
+           map_name, mops, final_size, peak_bytes / live, final_bytes / live, checksum);
+    jtest::print_latency_percentiles("    all", all_ops);
+    for (std::size_t op = 0; op < jtest::OpTrace::kOpTypeCount; op++) {
+        if (!per_op[op].empty()) {
+            std::string title = std::string("    ") + jtest::OpTrace::op_name(op);
+            jtest::print_latency_percentiles(title.c_str(), per_op[op]);
+        }
+    }
+    printf("\n");
+    ::fflush(stdout);
+
+    std::string report_name = std::string(map_name);
+    g_benchmark_report.addSample(report_name + "/throughput", "Mops/s", mops);
+    g_benchmark_report.addSample(report_name + "/peak", "bytes/elem", peak_bytes / live);
+    g_benchmark_report.addSample(report_name + "/final", "bytes/elem", final_bytes / live);
+    g_benchmark_report.addSample(report_name + "/p50", "ns/op",
+                                 jtest::CycleTimer::cycles_to_nanosec(all_ops.percentile(50.0)));
+    g_benchmark_report.addSample(report_name + "/p99", "ns/op",
+                                 jtest::CycleTimer::cycles_to_nanosec(all_ops.percentile(99.0)));
+    g_benchmark_report.addSample(report_name + "/p99.9", "ns/op",
+                                 jtest::CycleTimer::cycles_to_nanosec(all_ops.percentile(99.9)));
+}
+
+template <typename KeyTable, typename ValueMaker>
+void replay_all(const jtest::OpTraceReader & trace)
+{
+    KeyTable keys;
+    keys.init(trace);
+
+    printf("%-24s %10s %10s %12s %12s\n", "map", "Mops/s", "size", "peak/elem", "final/elem");
+    printf("--------------------------------------------------------------------------\n");
+
+    replay_trace<std_unordered_map,     KeyTable, ValueMaker>(trace, keys);
+#if USE_JSTD_UNORDERED_MAP
+    replay_trace<jstd_unordered_map,    KeyTable, ValueMaker>(trace, keys);
+#endif
+    replay_trace<jstd_flat16_hash_map,  KeyTable, ValueMaker>(trace, keys);
+    replay_trace<jstd_robin_hash_map,   KeyTable, ValueMaker>(trace, keys);
+    replay_trace<jstd_group16_flat_map, KeyTable, ValueMaker>(trace, keys);
+    replay_trace<jstd_group15_flat_map, KeyTable, ValueMaker>(trace, keys);
+}
+
+// splitmix64, the keys are unique for the different ranks.
+static std::uint64_t make_key(std::uint64_t rank)
+{
+    std::uint64_t z = rank + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31));
+}
+
+//
+// Record a synthetic trace by the TracingMap, the keys are Zipfian distributed.
+//
+static bool record_synthetic_trace(const std::string & filename, std::size_t num_ops, std::size_t num_keys)
+{
+    typedef std::unordered_map<std::uint64_t, std::uint64_t> map_type;
+
+    map_type map;
+    jtest::OpTraceWriter writer;
+    jtest::TracingMap<map_type> tracing_map(map, writer);
+    if (!tracing_map.open_trace(filename))
+        return false;
+
+    jstd::ZipfianKeyGenerator<jstd::XoshiroRandomGen> key_gen(num_keys, 0.99);
+
+    jtest::StopWatch sw;
+    sw.start();
+    for (std::size_t i = 0; i < num_ops; i++) {
+        std::uint64_t key = make_key(key_gen.next());
+        std::uint32_t dice = jstd::XoshiroRandomGen::nextUInt32() % 100;
+        if (dice < 70)
+            tracing_map.find(key);
+        else if (dice < 85)
+            tracing_map.emplace(key, std::uint64_t(i));
+        else if (dice < 90)
+            tracing_map.insert_or_assign(key, std::uint64_t(i));
+        else
+            tracing_map.erase(key);
+    }
+    sw.stop();
+    writer.close();
+
+    printf("Recorded %" PRIuPTR " ops over %" PRIuPTR " keys to \"%s\", %.2f ns/op (with recording).\n\n",
+           num_ops, num_keys, filename.c_str(), sw.getElapsedNanosec() / num_ops);
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    std::string filename;
+    bool need_record = false;
+    std::size_t num_ops = kDefaultOps;
+    std::size_t num_keys = kDefaultKeys;
+
+    int arg = 1;
+    if (arg < argc && ::strcmp(argv[arg], "--record") == 0) {
+        need_record = true;
+        arg++;
+    }
+    if (arg < argc) {
+        filename = argv[arg++];
+    } else {
+        filename = kDefaultTraceFile;
+        need_record = true;
+    }
+    if (arg < argc) {
+        long long value = ::atoll(argv[arg++]);
+        if (value > 0)
+            num_ops = static_cast<std::size_t>(value);
+    }
+    if (arg < argc) {
+        long long value = ::atoll(argv[arg++]);
+        if (value > 0)
+            num_keys = static_cast<std::size_t>(value);
+    }
+
+    jstd::XoshiroRandomGen::srand(20241205ULL);
+
+    if (need_record) {
+        if (!record_synthetic_trace(filename, num_ops, num_keys)) {
+            printf("Can't create the trace file \"%s\".\n", filename.c_str());
+            return 1;
+        }
+    }
+
+    jtest::OpTraceReader trace;
+    if (!trace.load(filename)) {
+        printf("Can't load the trace file \"%s\".\n", filename.c_str());
+        return 1;
+    }
+
+    printf("trace: \"%s\", %" PRIuPTR " ops, %" PRIuPTR " bytes, %.2f bytes/op, key = %s, value_size = %s\n\n",
+           filename.c_str(), trace.size(), trace.file_size(),
+           static_cast<double>(trace.file_size()) / (trace.size() ? trace.size() : 1),
+           (trace.key_format() == jtest::OpTrace::kKeyBytes) ? "bytes" : "uint64",
+           trace.has_value_size() ? "yes" : "no");
+
+    if (trace.key_format() == jtest::OpTrace::kKeyBytes) {
+        if (trace.has_value_size())
+            replay_all<StringKeys, StringValues>(trace);
+        else
+            replay_all<StringKeys, UInt64Values>(trace);
+    } else {
+        if (trace.has_value_size())
+            replay_all<UInt64Keys, StringValues>(trace);
+        else
+            replay_all<UInt64Keys, UInt64Values>(trace);
+    }
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
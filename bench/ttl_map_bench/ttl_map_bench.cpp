@@ -0,0 +1,374 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2020-2024 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+//
+//
+// ttl_map_bench: The session table workload, jstd::expiring_flat_map (lazy expiry)
+//                vs. jstd::group15_flat_map with the timestamps and a full scan per tick.
+//
+// Usage: ttl_map_bench [operations] [ops_per_tick] [ttl]
+//
+// The sessions are created, looked up (and touched), and logged out at random, the clock
+// ticks once per ops_per_tick operations, and a session expires after ttl ticks without
+// a touch. The mix is 20% create, 72% lookup + touch, 8% logout.
+//
+// For each table, the ns per operation, the median, p99 and max time of a tick (the operations
+// between two ticks and the expiry work, in microseconds), and the final size and the slot capacity
+// are recorded. The max tick is usually a rehash of the growing table, for all tables.
+//
+// Set JTEST_CSV_OUT or JTEST_JSON_OUT to save the results, see jstd/test/BenchmarkReport.h.
+//
+
+#ifdef _MSC_VER
+#include <jstd/basic/vld.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <jstd/basic/stddef.h>
+#include <jstd/basic/stdint.h>
+#include <jstd/basic/inttypes.h>
+
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/expiring_flat_map.hpp>
+#include <jstd/test/StopWatch.h>
+#include <jstd/test/BenchmarkReport.h>
+
+#ifndef _DEBUG
+static const std::size_t kDefaultOperations = 16 * 1024 * 1024;
+#else
+static const std::size_t kDefaultOperations = 512 * 1024;
+#endif
+
+static const std::size_t kDefaultOpsPerTick = 16 * 1024;
+static const std::uint32_t kDefaultTTL = 30;
+
+// The lookups pick a session from the most recent created sessions.
+static const std::size_t kRecentWindow = 256 * 1024;
+
+// The machine-readable results, see JTEST_JSON_OUT and JTEST_CSV_OUT.
+static jtest::BenchmarkReport g_benchmark_report("ttl_map_bench");
+
+struct session_t {
+    std::uint64_t user_id;
+    std::uint64_t last_seen;
+    std::uint32_t flags;
+
+    session_t(std::uint64_t id = 0, std::uint64_t seen = 0)
+        : user_id(id), last_seen(seen), flags(0) {}
+};
+
+enum OpType {
+    kOpCreate,
+    kOpLookup,
+    kOpLogout
+};
+
+struct Operation {
+    std::uint64_t   key;
+    std::uint32_t   type;
+    std::uint32_t   tick;
+};
+
+static inline
+std::uint64_t splitmix64(std::uint64_t z)
+{
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (z ^ (z >> 31));
+}
+
+static void make_operations(std::vector<Operation> & ops, std::size_t count, std::size_t ops_per_tick)
+{
+    std::vector<std::uint64_t> recent(kRecentWindow, 0);
+    std::uint64_t session_count = 0;
+    std::uint64_t state = 20240101ull;
+
+    ops.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint64_t rand = splitmix64(state++);
+        std::uint32_t dice = static_cast<std::uint32_t>(rand % 100);
+        Operation & op = ops[i];
+        op.tick = static_cast<std::uint32_t>(i / ops_per_tick);
+        if (dice < 20 || session_count == 0) {
+            op.type = kOpCreate;
+            op.key = splitmix64(session_count ^ 0x5555555555555555ull);
+            recent[session_count % kRecentWindow] = op.key;
+            session_count++;
+        } else {
+            std::size_t window = (session_count < kRecentWindow) ? session_count : kRecentWindow;
+            op.type = (dice < 92) ? kOpLookup : kOpLogout;
+            op.key = recent[(rand >> 32) % window];
+        }
+    }
+}
+
+struct TableResult {
+    double      ns_per_op;
+    double      median_tick_us;
+    double      p99_tick_us;
+    double      max_tick_us;
+    std::size_t hits;
+    std::size_t final_size;
+    std::size_t slot_capacity;
+};
+
+//
+// The session table of today: the timestamp is stored in the value,
+// and all the expired sessions are erased by a full scan at each tick.
+//
+class scan_session_table {
+public:
+    struct entry_type {
+        std::uint64_t   expire_time;
+        session_t       session;
+
+        entry_type(std::uint64_t expire, const session_t & s) : expire_time(expire), session(s) {}
+    };
+
+    typedef jstd::group15_flat_map<std::uint64_t, entry_type> map_type;
+
+private:
+    map_type        map_;
+    std::uint64_t   now_;
+    std::uint64_t   ttl_;
+
+public:
+    explicit scan_session_table(std::uint32_t ttl) : now_(0), ttl_(ttl) {}
+
+    std::size_t size() const { return this->map_.size(); }
+    std::size_t slot_capacity() const { return this->map_.slot_capacity(); }
+
+    void tick(std::uint32_t now) {
+        this->now_ = now;
+        std::uint64_t current = this->now_;
+        this->map_.erase_if_in_groups(0, this->map_.group_capacity(),
+            [current](const map_type::value_type & value) {
+                return (value.second.expire_time <= current);
+            });
+    }
+
+    void create(std::uint64_t key) {
+        this->map_.insert_or_assign(key, entry_type(this->now_ + this->ttl_, session_t(key, this->now_)));
+    }
+
+    bool lookup(std::uint64_t key) {
+        auto iter = this->map_.find(key);
+        if (iter != this->map_.end() && iter->second.expire_time > this->now_) {
+            iter->second.expire_time = this->now_ + this->ttl_;
+            iter->second.session.last_seen = this->now_;
+            return true;
+        }
+        return false;
+    }
+
+    void logout(std::uint64_t key) {
+        this->map_.erase(key);
+    }
+};
+
+template <std::size_t ReclaimGroups>
+class lazy_session_table {
+public:
+    typedef jstd::expiring_flat_map<std::uint64_t, session_t> map_type;
+
+private:
+    map_type map_;
+
+public:
+    explicit lazy_session_table(std::uint32_t ttl) : map_(ttl) {
+        this->map_.set_reclaim_groups(ReclaimGroups);
+    }
+
+    std::size_t size() const { return this->map_.size(); }
+    std::size_t slot_capacity() const { return this->map_.slot_capacity(); }
+
+    void tick(std::uint32_t now) {
+        this->map_.set_now(now);
+    }
+
+    void create(std::uint64_t key) {
+        this->map_.insert_or_assign(key, session_t(key, this->map_.now()));
+    }
+
+    bool lookup(std::uint64_t key) {
+        session_t * session = this->map_.find(key);
+        if (session != nullptr) {
+            this->map_.touch(key);
+            session->last_seen = this->map_.now();
+            return true;
+        }
+        return false;
+    }
+
+    void logout(std::uint64_t key) {
+        this->map_.erase(key);
+    }
+};
+
+static double percentile(std::vector<double> values, double ratio)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    std::size_t index = static_cast<std::size_t>(ratio * static_cast<double>(values.size() - 1) + 0.5);
+    return values[index];
+}
+
+template <typename Table>
+static TableResult run_operations(const std::vector<Operation> & ops, std::uint32_t ttl)
+{
+    Table table(ttl);
+    TableResult result;
+    result.hits = 0;
+
+    std::vector<double> tick_times;
+    tick_times.reserve(ops.size() / 1024 + 1);
+
+    jtest::StopWatch sw, tick_sw;
+    sw.start();
+    tick_sw.start();
+    std::uint32_t tick = 0;
+    table.tick(0);
+    for (std::size_t i = 0; i < ops.size(); i++) {
+        const Operation & op = ops[i];
+        if (op.tick != tick) {
+            tick = op.tick;
+            table.tick(tick);
+            tick_sw.stop();
+            tick_times.push_back(tick_sw.getElapsedMicrosec());
+            tick_sw.start();
+        }
+        switch (op.type) {
+        case kOpCreate:
+            table.create(op.key);
+            break;
+        case kOpLookup:
+            result.hits += table.lookup(op.key) ? 1 : 0;
+            break;
+        default:
+            table.logout(op.key);
+            break;
+        }
+    }
+    sw.stop();
+
+    result.ns_per_op = sw.getElapsedNanosec() / static_cast<double>(ops.size());
+    result.median_tick_us = jtest::stats::median(tick_times);
+    result.p99_tick_us = percentile(tick_times, 0.99);
+    result.max_tick_us = percentile(tick_times, 1.0);
+    result.final_size = table.size();
+    result.slot_capacity = table.slot_capacity();
+    return result;
+}
+
+static void report_result(const char * name, const TableResult & result, const TableResult & base)
+{
+    printf("  %-38s %7.2f ns/op   speedup = %5.2fx   tick: median = %7.1f us, p99 = %7.1f us, max = %8.1f us\n",
+           name, result.ns_per_op, base.ns_per_op / result.ns_per_op,
+           result.median_tick_us, result.p99_tick_us, result.max_tick_us);
+    printf("  %-38s hits = %" PRIuPTR ", size = %" PRIuPTR ", slot_capacity = %" PRIuPTR "\n\n",
+           "", result.hits, result.final_size, result.slot_capacity);
+
+    std::string report_name = name;
+    g_benchmark_report.addSample(report_name + "/time", "ns/op", result.ns_per_op);
+    g_benchmark_report.addSample(report_name + "/median_tick", "us", result.median_tick_us);
+    g_benchmark_report.addSample(report_name + "/p99_tick", "us", result.p99_tick_us);
+}
+
+int main(int argc, char * argv[])
+{
+    std::size_t operations = kDefaultOperations;
+    std::size_t ops_per_tick = kDefaultOpsPerTick;
+    std::uint32_t ttl = kDefaultTTL;
+    if (argc > 1) {
+        long long value = ::atoll(argv[1]);
+        if (value > 0)
+            operations = static_cast<std::size_t>(value);
+    }
+    if (argc > 2) {
+        long long value = ::atoll(argv[2]);
+        if (value > 0)
+            ops_per_tick = static_cast<std::size_t>(value);
+    }
+    if (argc > 3) {
+        long long value = ::atoll(argv[3]);
+        if (value > 0)
+            ttl = static_cast<std::uint32_t>(value);
+    }
+
+    printf("ttl_map_bench: operations = %" PRIuPTR ", ops_per_tick = %" PRIuPTR ", ttl = %u ticks\n\n",
+           operations, ops_per_tick, ttl);
+
+    std::vector<Operation> ops;
+    make_operations(ops, operations, ops_per_tick);
+
+    TableResult scan_result = run_operations<scan_session_table>(ops, ttl);
+    TableResult lazy1_result = run_operations< lazy_session_table<1> >(ops, ttl);
+    TableResult lazy2_result = run_operations< lazy_session_table<2> >(ops, ttl);
+
+    report_result("group15_flat_map + full scan per tick", scan_result, scan_result);
+    report_result("expiring_flat_map (reclaim 1 group)", lazy1_result, scan_result);
+    report_result("expiring_flat_map (reclaim 2 groups)", lazy2_result, scan_result);
+
+    g_benchmark_report.writeFromEnv();
+    return 0;
+}
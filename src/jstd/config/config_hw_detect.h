@@ -1,24 +1,19 @@
-#define OS_LINUX   1
-#define ARCH_X86_64        1
-#define C_GCC      1
-#define __64BIT__  1
-#define FUNDERSCORE        
-#define SKYLAKEX
+#define OS_LINUX	1
+#define ARCH_X86_64	1
+#define C_GCC	1
+#define __64BIT__	1
+#define FUNDERSCORE	
+#define COOPERLAKE
 #define L1_CODE_SIZE 32768
 #define L1_CODE_ASSOCIATIVE 8
 #define L1_CODE_LINESIZE 64
-#define L1_DATA_SIZE 32768
-#define L1_DATA_ASSOCIATIVE 8
+#define L1_DATA_SIZE 49152
+#define L1_DATA_ASSOCIATIVE 12
 #define L1_DATA_LINESIZE 64
-#define L2_SIZE 262144
-#define L2_ASSOCIATIVE 8
+#define L2_SIZE 2097152
+#define L2_ASSOCIATIVE 7
 #define L2_LINESIZE 64
-#define ITB_SIZE 2097152
-#define ITB_ASSOCIATIVE 0
-#define ITB_ENTRIES 8
-#define DTB_SIZE 4096
-#define DTB_ASSOCIATIVE 4
-#define DTB_DEFAULT_ENTRIES 64
+#define DTB_DEFAULT_ENTRIES 32
 #define HAVE_CMOV
 #define HAVE_MMX
 #define HAVE_SSE
@@ -29,10 +24,13 @@
 #define HAVE_SSE4_2
 #define HAVE_AVX
 #define HAVE_AVX2
-//#define HAVE_AVX512VL
+#define HAVE_AVX512VL
+#define HAVE_AVX512BF16
+#define HAVE_AMXBF16
 #define HAVE_FMA3
 #define HAVE_CFLUSH
 #define HAVE_HIT 1
-#define NUM_SHAREDCACHE 2
-#define NUM_CORES 2
-#define CORE_SKYLAKEX
\ No newline at end of file
+#define NUM_SHAREDCACHE 1
+#define NUM_CORES 1
+#define CORE_bulldozer
+#define CHAR_CORENAME "bulldozer"
@@ -0,0 +1,21 @@
+
+#ifndef JSTD_CONFIG_VERSION_H
+#define JSTD_CONFIG_VERSION_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "jstd/basic/macros.h"
+
+// Per
+#define JSTD_VERSION_MAJOR      1
+#define JSTD_VERSION_MINOR      0
+#define JSTD_VERSION_PATCH      2
+
+#define JSTD_VERSION_STR        JSTD_TO_DOT3(JSTD_VERSION_MAJOR, JSTD_VERSION_MINOR, JSTD_VERSION_PATCH)
+#define JSTD_VERSION            JSTD_TO_VER3(JSTD_VERSION_MAJOR, JSTD_VERSION_MINOR, JSTD_VERSION_PATCH)
+
+#define JSTD_BUILD_DATE         "2024-12-05"
+
+#endif // JSTD_CONFIG_VERSION_H
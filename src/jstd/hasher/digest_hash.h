@@ -0,0 +1,135 @@
+
+#ifndef JSTD_HASHER_DIGEST_HASH_H
+#define JSTD_HASHER_DIGEST_HASH_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "jstd/basic/stddef.h"
+#include "jstd/basic/stdint.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memcpy(), std::memcmp()
+#include <type_traits>
+
+//
+// The hashers of the keys that are already uniformly distributed, e.g. the message
+// digests (MD5, SHA-1, SHA-256), the UUIDs, and the 64-bit IDs hashed upstream.
+//
+// prehashed_hash<T> and digest_slice_hash<Key> are marked as avalanching
+// (typedef std::true_type is_avalanching), see jstd::detail::hash_is_avalanching<Hash>,
+// so the hash tables take the index and the ctrl hash directly from the hash code,
+// and skip the second mixing on every probe. The keys MUST already be uniformly hashed:
+// the small or sequential keys (e.g. the auto-increment IDs) all fall into a few
+// home slots, the tables become quadratic, or fail on the engines that take
+// the index from the high bits. Use identity_hash<T> for such integer keys.
+//
+
+namespace jstd {
+
+//
+// jstd::digest<N>: A N bytes message digest, digest128 (MD5, UUID),
+// digest160 (SHA-1) and digest256 (SHA-256).
+//
+template <std::size_t N>
+struct digest {
+    static constexpr std::size_t kSize = N;
+
+    std::uint8_t bytes[N];
+
+    std::uint8_t * data() noexcept { return this->bytes; }
+    const std::uint8_t * data() const noexcept { return this->bytes; }
+
+    static constexpr std::size_t size() noexcept { return N; }
+
+    friend inline bool operator == (const digest & lhs, const digest & rhs) noexcept {
+        return (std::memcmp(lhs.bytes, rhs.bytes, N) == 0);
+    }
+
+    friend inline bool operator != (const digest & lhs, const digest & rhs) noexcept {
+        return (std::memcmp(lhs.bytes, rhs.bytes, N) != 0);
+    }
+
+    friend inline bool operator < (const digest & lhs, const digest & rhs) noexcept {
+        return (std::memcmp(lhs.bytes, rhs.bytes, N) < 0);
+    }
+};
+
+typedef digest<16>  digest128;
+typedef digest<20>  digest160;
+typedef digest<32>  digest256;
+
+//
+// jstd::identity_hash<T>: The integer key itself is the hash code.
+//
+// Like std::hash<T> of the integers on most STL, it's not avalanching,
+// so the tables still mix it, and any integer keys are fine.
+//
+template <typename T>
+struct identity_hash {
+    static_assert((std::is_integral<T>::value || std::is_enum<T>::value),
+                  "jstd::identity_hash<T>: T must be an integral or enum type.");
+
+    typedef T               argument_type;
+    typedef std::size_t     result_type;
+
+    result_type operator () (const T & key) const noexcept {
+        return static_cast<result_type>(key);
+    }
+};
+
+//
+// jstd::prehashed_hash<T>: The integer key itself is the hash code, and it's avalanching.
+//
+// Precondition: the keys must already be uniformly hashed (e.g. the 64-bit IDs
+// hashed upstream), all the bits are used as is. Never use it for the small or
+// sequential integers, use identity_hash<T> or std::hash<T> instead.
+//
+template <typename T>
+struct prehashed_hash {
+    static_assert((std::is_integral<T>::value || std::is_enum<T>::value),
+                  "jstd::prehashed_hash<T>: T must be an integral or enum type.");
+
+    typedef T               argument_type;
+    typedef std::size_t     result_type;
+    typedef std::true_type  is_avalanching;
+
+    result_type operator () (const T & key) const noexcept {
+        return static_cast<result_type>(key);
+    }
+};
+
+//
+// jstd::digest_slice_hash<Key, Offset>: The hash code is the sizeof(std::size_t) bytes
+// of the key at the Offset, e.g. the first 8 bytes of a SHA-1 digest.
+//
+template <typename Key, std::size_t Offset = 0>
+struct digest_slice_hash {
+    static_assert(std::is_trivially_copyable<Key>::value,
+                  "jstd::digest_slice_hash<Key>: Key must be trivially copyable.");
+    static_assert(((Offset + sizeof(std::size_t)) <= sizeof(Key)),
+                  "jstd::digest_slice_hash<Key>: The slice is out of the range of Key.");
+
+    typedef Key             argument_type;
+    typedef std::size_t     result_type;
+    typedef std::true_type  is_avalanching;
+
+    result_type operator () (const Key & key) const noexcept {
+        result_type hash_code;
+        std::memcpy(&hash_code, reinterpret_cast<const char *>(&key) + Offset, sizeof(hash_code));
+        return hash_code;
+    }
+};
+
+template <std::size_t N>
+using digest_hash = digest_slice_hash<digest<N>>;
+
+typedef digest_hash<16>     digest128_hash;
+typedef digest_hash<20>     digest160_hash;
+typedef digest_hash<32>     digest256_hash;
+
+} // namespace jstd
+
+#endif // JSTD_HASHER_DIGEST_HASH_H
@@ -256,7 +256,7 @@ static size_t int_hash_crc32(size_t value)
     return intel_int_crc32_x86(value);
   #endif
 #else
-    return hashes::Times31(value, sizeof(value));
+    return hashes::Times31((const char *)&value, sizeof(value));
 #endif
 }
 
@@ -265,7 +265,7 @@ static size_t simple_int_hash_crc32(size_t value)
 #ifdef __SSE4_2__
     return intel_simple_int_crc32(value);
 #else
-    return hashes::Times31(value, sizeof(value));
+    return hashes::Times31((const char *)&value, sizeof(value));
 #endif
 }
 
@@ -0,0 +1,68 @@
+
+#ifndef JSTD_HASHER_HASH_TRAITS_H
+#define JSTD_HASHER_HASH_TRAITS_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <type_traits>
+
+#include "jstd/traits/type_traits.h"
+
+//
+// The traits of the hash functions, they are used by the hashers and the hash tables,
+// so they live in the hasher layer.
+//
+namespace jstd {
+namespace detail {
+
+namespace hash_detail {
+
+template <typename IsAvalanching>
+struct avalanching_value
+{
+    static constexpr bool value = IsAvalanching::value;
+};
+
+/* may be explicitly marked as DEPRECATED in the future */
+template <>
+struct avalanching_value<void>
+{
+    static constexpr bool value = true;
+};
+
+template <typename Hash, typename = void>
+struct hash_is_avalanching_impl : std::false_type{};
+
+template <typename Hash>
+struct hash_is_avalanching_impl<Hash, jstd::void_t<typename Hash::is_avalanching>>
+    : std::integral_constant<bool, avalanching_value<typename Hash::is_avalanching>::value>
+{};
+
+/* Hash::is_avalanching is not a type: compile error downstream */
+template <typename Hash>
+struct hash_is_avalanching_impl<Hash, typename std::enable_if<((void)Hash::is_avalanching, true)>::type>
+{};
+
+} // namespace hash_detail
+
+/*
+ * Each trait can be partially specialized by users for concrete hash functions
+ * when actual characterization differs from default.
+ */
+
+/* 
+ * hash_is_avalanching<Hash>::value is:
+ *   - false if Hash::is_avalanching is not present.
+ *   - Hash::is_avalanching::value if this is present and constexpr-convertible to a bool.
+ *   - true if Hash::is_avalanching is void (deprecated).
+ *   - ill-formed otherwise.
+ */
+template <typename Hash>
+struct hash_is_avalanching : hash_detail::hash_is_avalanching_impl<Hash>::type {};
+
+} // namespace detail
+} // namespace jstd
+
+#endif // JSTD_HASHER_HASH_TRAITS_H
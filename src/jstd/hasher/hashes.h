@@ -31,6 +31,7 @@
 #include "jstd/traits/type_traits.h"
 #include "jstd/support/BitUtils.h"
 #include "jstd/support/Power2.h"
+#include "jstd/hasher/hash_traits.h"
 
 #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX64) || defined(_M_AMD64))
   #include <intrin.h>
@@ -1679,6 +1680,9 @@ public:
 
     static constexpr size_type kWordLength = sizeof(std::size_t) * CHAR_BIT;
 
+    // The hash code of an avalanching hasher is used as is, without the second mixing.
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hasher>::value;
+
 private:
     std::uint8_t shift_;
 
@@ -1694,14 +1698,18 @@ public:
 
     template <typename Key>
     size_type get_hash_code(const Key & key) const noexcept {
-        size_type hash_code = static_cast<size_type>(FibonacciHash<Hasher>()(key));
+        size_type hash_code;
+        if (kIsAvalanching)
+            hash_code = static_cast<size_type>(Hasher()(key));
+        else
+            hash_code = static_cast<size_type>(FibonacciHash<Hasher>()(key));
         return hash_code;
     }
 
     template <typename Key>
     size_type index_for_hash(size_type hash_code, size_type /* mask */) const noexcept {
         static constexpr bool isExcludedType = is_excluded_type<Key>::value;
-        if (!isExcludedType) {
+        if (!isExcludedType && !kIsAvalanching) {
             hash_code = static_cast<size_type>(
                 hashes::fibonacci_hash(static_cast<std::size_t>(hash_code))
             );
@@ -1742,6 +1750,9 @@ public:
 
     static constexpr size_type kWordLength = sizeof(std::size_t) * CHAR_BIT;
 
+    // The hash code of an avalanching hasher is used as is, without the second mixing.
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hasher>::value;
+
 private:
     std::uint8_t shift_;
 
@@ -1757,14 +1768,18 @@ public:
 
     template <typename Key>
     size_type get_hash_code(const Key & key) const noexcept {
-        size_type hash_code = static_cast<size_type>(MumHash<Hasher>()(key));
+        size_type hash_code;
+        if (kIsAvalanching)
+            hash_code = static_cast<size_type>(Hasher()(key));
+        else
+            hash_code = static_cast<size_type>(MumHash<Hasher>()(key));
         return hash_code;
     }
 
     template <typename Key>
     size_type index_for_hash(size_type hash_code, size_type /* mask */) const noexcept {
         static constexpr bool isExcludedType = is_excluded_type<Key>::value;
-        if (!isExcludedType) {
+        if (!isExcludedType && !kIsAvalanching) {
             hash_code = static_cast<size_type>(
                 hashes::mum_hash(static_cast<std::size_t>(hash_code))
             );
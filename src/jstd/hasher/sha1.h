@@ -11,6 +11,9 @@
 #include "jstd/basic/stdsize.h"
 
 #include <assert.h>
+#include <string.h>     // For memcpy(), memset()
+
+#include "jstd/hasher/digest_hash.h"
 
 #ifdef _MSC_VER
 #include <nmmintrin.h>  // For SSE 4.2
@@ -535,6 +538,536 @@ static uint32_t sha1_x86(const char * data, size_t length)
     return sha1_x86(s_sha1_state, data, length);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////
+
+//
+// The standard SHA-1 digest (FIPS 180-4, with the padding), for the content keys.
+//
+//   sha1_digest(data, length, digest):
+//       One message.
+//
+//   sha1_digest_batch(data[], length[], digests[], count):
+//       Many independent messages. The SHA-1 of a message is a long dependency chain
+//       of rounds, so the batch keeps N messages in flight, one per lane, and interleaves
+//       their rounds. When a lane finishes a message, it takes the next one, so the lanes
+//       stay busy even if the messages have different lengths.
+//
+//       AVX2:    8 lanes, the classic multi-buffer SHA-1, one message per 32-bit element.
+//       SHA-NI:  2 (or 4) lanes, interleave the _mm_sha1rnds4_epu32() chains of the messages.
+//       Scalar:  1 lane, if neither of them is available.
+//
+// The backends can also be called directly (e.g. for the benchmark),
+// sha1_digest_batch_ni<N>() and sha1_digest_batch_avx2() exist only if
+// JSTD_HAVE_SHA1_NI and JSTD_HAVE_SHA1_AVX2 are 1.
+//
+
+#ifndef JSTD_HAVE_SHA1_NI
+#if defined(__SHA__) && defined(__SSSE3__)
+#define JSTD_HAVE_SHA1_NI       1
+#else
+#define JSTD_HAVE_SHA1_NI       0
+#endif
+#endif // JSTD_HAVE_SHA1_NI
+
+#ifndef JSTD_HAVE_SHA1_AVX2
+#if defined(__AVX2__)
+#define JSTD_HAVE_SHA1_AVX2     1
+#else
+#define JSTD_HAVE_SHA1_AVX2     0
+#endif
+#endif // JSTD_HAVE_SHA1_AVX2
+
+static const size_t kSha1BlockSize = 64;
+static const size_t kSha1DigestSize = 20;
+
+static const uint32_t kSha1InitState[5] = {
+    0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U
+};
+
+// The input block of the idle lanes, their results are discarded.
+alignas(64)
+static const uint8_t s_sha1_zero_block[kSha1BlockSize] = { 0 };
+
+static inline
+uint32_t sha1_load_be32(const uint8_t * data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8)  |  (uint32_t)data[3];
+}
+
+static inline
+void sha1_store_be32(uint8_t * data, uint32_t value)
+{
+    data[0] = (uint8_t)(value >> 24);
+    data[1] = (uint8_t)(value >> 16);
+    data[2] = (uint8_t)(value >> 8);
+    data[3] = (uint8_t)(value);
+}
+
+static inline
+uint32_t sha1_rotl32(uint32_t value, int shift)
+{
+    return ((value << shift) | (value >> (32 - shift)));
+}
+
+//
+// The message cursor of a lane: the full blocks are read from the message in place,
+// the last one or two blocks are the tail bytes with the padding and the bit length.
+//
+struct sha1_lane {
+    const uint8_t * data;
+    size_t          index;
+    size_t          block;
+    size_t          full_blocks;
+    size_t          total_blocks;
+    alignas(16) uint8_t tail[kSha1BlockSize * 2];
+
+    void start(const char * message, size_t length, size_t message_index) {
+        this->data = (const uint8_t *)message;
+        this->index = message_index;
+        this->block = 0;
+        this->full_blocks = length / kSha1BlockSize;
+
+        size_t rest = length % kSha1BlockSize;
+        size_t tail_blocks = (rest < (kSha1BlockSize - 8)) ? 1 : 2;
+        this->total_blocks = this->full_blocks + tail_blocks;
+
+        if (rest != 0)
+            memcpy((void *)this->tail, (const void *)(this->data + this->full_blocks * kSha1BlockSize), rest);
+        this->tail[rest] = 0x80;
+        memset((void *)(this->tail + rest + 1), 0, tail_blocks * kSha1BlockSize - 8 - (rest + 1));
+
+        uint64_t bit_length = (uint64_t)length * 8;
+        uint8_t * length_ptr = this->tail + tail_blocks * kSha1BlockSize - 8;
+        sha1_store_be32(length_ptr + 0, (uint32_t)(bit_length >> 32));
+        sha1_store_be32(length_ptr + 4, (uint32_t)(bit_length));
+    }
+
+    void stop() {
+        this->block = 0;
+        this->total_blocks = 0;
+    }
+
+    bool is_active() const { return (this->block < this->total_blocks); }
+
+    const uint8_t * next_block() {
+        assert(this->is_active());
+        size_t block_index = this->block++;
+        if (block_index < this->full_blocks)
+            return (this->data + block_index * kSha1BlockSize);
+        else
+            return (this->tail + (block_index - this->full_blocks) * kSha1BlockSize);
+    }
+};
+
+//
+// Scalar
+//
+static void sha1_compress_scalar(uint32_t state[5], const uint8_t * block)
+{
+    uint32_t W[80];
+    for (size_t i = 0; i < 16; i++) {
+        W[i] = sha1_load_be32(block + i * 4);
+    }
+    for (size_t i = 16; i < 80; i++) {
+        W[i] = sha1_rotl32(W[i - 3] ^ W[i - 8] ^ W[i - 14] ^ W[i - 16], 1);
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+    for (size_t i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = d ^ (b & (c ^ d));
+            k = 0x5A827999U;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1U;
+        } else if (i < 60) {
+            f = (b & c) | (d & (b | c));
+            k = 0x8F1BBCDCU;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6U;
+        }
+        uint32_t temp = sha1_rotl32(a, 5) + f + e + k + W[i];
+        e = d;
+        d = c;
+        c = sha1_rotl32(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+static void sha1_digest_scalar(const char * data, size_t length, jstd::digest160 & digest)
+{
+    sha1_lane lane;
+    lane.start(data, length, 0);
+
+    uint32_t state[5];
+    memcpy((void *)state, (const void *)kSha1InitState, sizeof(state));
+    while (lane.is_active()) {
+        sha1_compress_scalar(state, lane.next_block());
+    }
+    for (size_t i = 0; i < 5; i++) {
+        sha1_store_be32(digest.bytes + i * 4, state[i]);
+    }
+}
+
+static void sha1_digest_batch_scalar(const char * const * data, const size_t * length,
+                                     jstd::digest160 * digests, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        sha1_digest_scalar(data[i], length[i], digests[i]);
+    }
+}
+
+#if JSTD_HAVE_SHA1_NI
+
+//
+// SHA-NI, see: https://github.com/noloader/SHA-Intrinsics/blob/master/sha1-x86.c
+//
+// The 4 rounds J (0 <= J < 20) of N lanes, the message words are msg[J % 4],
+// sha1_x86() above is the same sequence of one lane, written out.
+//
+template <int J, size_t N>
+static JSTD_FORCED_INLINE
+void sha1_ni_rounds4(__m128i (&abcd)[N], __m128i (&e0)[N], __m128i (&e1)[N], __m128i (&msg)[4][N])
+{
+#if defined(__AVX__)
+    // The compiler may spill the lanes with the ymm/zmm moves, see sha1_ni_compress().
+    if (N > 1)
+        _mm256_zeroupper();
+#endif
+    for (size_t i = 0; i < N; i++) {
+        __m128i & e_this = ((J & 1) == 0) ? e0[i] : e1[i];
+        __m128i & e_next = ((J & 1) == 0) ? e1[i] : e0[i];
+        if (J == 0)
+            e_this = _mm_add_epi32(e_this, msg[0][i]);
+        else
+            e_this = _mm_sha1nexte_epu32(e_this, msg[J % 4][i]);
+        e_next = abcd[i];
+        if (J >= 3 && J <= 18)
+            msg[(J + 1) % 4][i] = _mm_sha1msg2_epu32(msg[(J + 1) % 4][i], msg[J % 4][i]);
+        abcd[i] = _mm_sha1rnds4_epu32(abcd[i], e_this, J / 5);
+        if (J >= 1 && J <= 16)
+            msg[(J + 3) % 4][i] = _mm_sha1msg1_epu32(msg[(J + 3) % 4][i], msg[J % 4][i]);
+        if (J >= 2 && J <= 17)
+            msg[(J + 2) % 4][i] = _mm_xor_si128(msg[(J + 2) % 4][i], msg[J % 4][i]);
+    }
+}
+
+template <size_t N>
+static JSTD_FORCED_INLINE
+void sha1_ni_compress(__m128i (&abcd)[N], __m128i (&e0)[N], const uint8_t * const (&blocks)[N])
+{
+    const __m128i kByteSwap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd_save[N], e0_save[N], e1[N];
+    __m128i msg[4][N];
+
+#if defined(__AVX__)
+    // The SHA-NI instructions only have the legacy SSE encoding, they are very slow
+    // if the upper bits of the ymm/zmm registers are dirty (e.g. by the inlined memset(),
+    // or the ymm/zmm moves that the compiler merges from the __m128i array copies).
+    _mm256_zeroupper();
+#endif
+
+    for (size_t i = 0; i < N; i++) {
+        abcd_save[i] = abcd[i];
+        e0_save[i] = e0[i];
+        for (size_t j = 0; j < 4; j++) {
+            msg[j][i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks[i] + j * 16)), kByteSwap);
+        }
+    }
+
+    sha1_ni_rounds4< 0>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 1>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 2>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 3>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 4>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 5>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 6>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 7>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 8>(abcd, e0, e1, msg);
+    sha1_ni_rounds4< 9>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<10>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<11>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<12>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<13>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<14>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<15>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<16>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<17>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<18>(abcd, e0, e1, msg);
+    sha1_ni_rounds4<19>(abcd, e0, e1, msg);
+
+    for (size_t i = 0; i < N; i++) {
+        e0[i] = _mm_sha1nexte_epu32(e0[i], e0_save[i]);
+        abcd[i] = _mm_add_epi32(abcd[i], abcd_save[i]);
+    }
+}
+
+template <size_t N>
+static void sha1_digest_batch_ni(const char * const * data, const size_t * length,
+                                 jstd::digest160 * digests, size_t count)
+{
+    const __m128i kByteSwap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    const __m128i kInitABCD = _mm_set_epi32((int)kSha1InitState[0], (int)kSha1InitState[1],
+                                            (int)kSha1InitState[2], (int)kSha1InitState[3]);
+    const __m128i kInitE0 = _mm_set_epi32((int)kSha1InitState[4], 0, 0, 0);
+
+    sha1_lane lanes[N];
+    __m128i abcd[N], e0[N];
+    const uint8_t * blocks[N];
+
+    size_t next = 0, active = 0;
+    for (size_t i = 0; i < N; i++) {
+        if (next < count) {
+            lanes[i].start(data[next], length[next], next);
+            next++;
+            active++;
+        } else {
+            lanes[i].stop();
+        }
+        abcd[i] = kInitABCD;
+        e0[i] = kInitE0;
+    }
+
+    while (active > 0) {
+        for (size_t i = 0; i < N; i++) {
+            blocks[i] = lanes[i].is_active() ? lanes[i].next_block() : s_sha1_zero_block;
+        }
+
+        sha1_ni_compress<N>(abcd, e0, blocks);
+
+        for (size_t i = 0; i < N; i++) {
+            if (blocks[i] != s_sha1_zero_block && !lanes[i].is_active()) {
+                // The ABCD words are in the reversed order, the full byte swap makes them big-endian.
+                jstd::digest160 & digest = digests[lanes[i].index];
+                _mm_storeu_si128((__m128i *)digest.bytes, _mm_shuffle_epi8(abcd[i], kByteSwap));
+                sha1_store_be32(digest.bytes + 16, (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(e0[i], 12)));
+
+                if (next < count) {
+                    lanes[i].start(data[next], length[next], next);
+                    next++;
+                } else {
+                    active--;
+                }
+                abcd[i] = kInitABCD;
+                e0[i] = kInitE0;
+            }
+        }
+    }
+}
+
+#endif // JSTD_HAVE_SHA1_NI
+
+#if JSTD_HAVE_SHA1_AVX2
+
+//
+// AVX2 multi-buffer: 8 lanes, the state word and the message word of lane i
+// are in the 32-bit element i of the registers.
+//
+static JSTD_FORCED_INLINE
+__m256i sha1_avx2_rotl(__m256i value, int shift)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(value, shift), _mm256_srli_epi32(value, 32 - shift));
+}
+
+// Transpose the 8 x 8 matrix of 32-bit words, row i to column i.
+static JSTD_FORCED_INLINE
+void sha1_avx2_transpose8x8(__m256i (&rows)[8])
+{
+    __m256i t0 = _mm256_unpacklo_epi32(rows[0], rows[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(rows[0], rows[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(rows[2], rows[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(rows[2], rows[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(rows[4], rows[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(rows[4], rows[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(rows[6], rows[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(rows[6], rows[7]);
+
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    rows[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    rows[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    rows[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    rows[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    rows[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    rows[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    rows[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    rows[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+static JSTD_FORCED_INLINE
+void sha1_avx2_compress(__m256i (&state)[5], const uint8_t * const (&blocks)[8])
+{
+    const __m256i kByteSwap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                              12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    __m256i W[16];
+    for (size_t half = 0; half < 2; half++) {
+        __m256i rows[8];
+        for (size_t i = 0; i < 8; i++) {
+            rows[i] = _mm256_loadu_si256((const __m256i *)(blocks[i] + half * 32));
+        }
+        sha1_avx2_transpose8x8(rows);
+        for (size_t i = 0; i < 8; i++) {
+            W[half * 8 + i] = _mm256_shuffle_epi8(rows[i], kByteSwap);
+        }
+    }
+
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    for (size_t t = 0; t < 80; t++) {
+        __m256i w;
+        if (t < 16) {
+            w = W[t];
+        } else {
+            w = _mm256_xor_si256(_mm256_xor_si256(W[(t - 3) & 15], W[(t - 8) & 15]),
+                                 _mm256_xor_si256(W[(t - 14) & 15], W[t & 15]));
+            w = sha1_avx2_rotl(w, 1);
+            W[t & 15] = w;
+        }
+
+        __m256i f, k;
+        if (t < 20) {
+            f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+            k = _mm256_set1_epi32(0x5A827999);
+        } else if (t < 40) {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = _mm256_set1_epi32(0x6ED9EBA1);
+        } else if (t < 60) {
+            f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+            k = _mm256_set1_epi32((int)0x8F1BBCDCU);
+        } else {
+            f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            k = _mm256_set1_epi32((int)0xCA62C1D6U);
+        }
+
+        __m256i temp = _mm256_add_epi32(_mm256_add_epi32(sha1_avx2_rotl(a, 5), f),
+                                        _mm256_add_epi32(_mm256_add_epi32(e, k), w));
+        e = d;
+        d = c;
+        c = sha1_avx2_rotl(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] = _mm256_add_epi32(state[0], a);
+    state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c);
+    state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e);
+}
+
+static void sha1_digest_batch_avx2(const char * const * data, const size_t * length,
+                                   jstd::digest160 * digests, size_t count)
+{
+    static const size_t kLanes = 8;
+
+    sha1_lane lanes[kLanes];
+    __m256i state[5];
+    const uint8_t * blocks[kLanes];
+    alignas(32) uint32_t words[5][kLanes];
+
+    for (size_t j = 0; j < 5; j++) {
+        state[j] = _mm256_set1_epi32((int)kSha1InitState[j]);
+    }
+
+    size_t next = 0, active = 0;
+    for (size_t i = 0; i < kLanes; i++) {
+        if (next < count) {
+            lanes[i].start(data[next], length[next], next);
+            next++;
+            active++;
+        } else {
+            lanes[i].stop();
+        }
+    }
+
+    while (active > 0) {
+        for (size_t i = 0; i < kLanes; i++) {
+            blocks[i] = lanes[i].is_active() ? lanes[i].next_block() : s_sha1_zero_block;
+        }
+
+        sha1_avx2_compress(state, blocks);
+
+        bool has_done = false;
+        for (size_t i = 0; i < kLanes; i++) {
+            if (blocks[i] != s_sha1_zero_block && !lanes[i].is_active()) {
+                has_done = true;
+                break;
+            }
+        }
+        if (likely(!has_done))
+            continue;
+
+        for (size_t j = 0; j < 5; j++) {
+            _mm256_store_si256((__m256i *)words[j], state[j]);
+        }
+        for (size_t i = 0; i < kLanes; i++) {
+            if (blocks[i] != s_sha1_zero_block && !lanes[i].is_active()) {
+                jstd::digest160 & digest = digests[lanes[i].index];
+                for (size_t j = 0; j < 5; j++) {
+                    sha1_store_be32(digest.bytes + j * 4, words[j][i]);
+                    words[j][i] = kSha1InitState[j];
+                }
+
+                if (next < count) {
+                    lanes[i].start(data[next], length[next], next);
+                    next++;
+                } else {
+                    active--;
+                }
+            }
+        }
+        for (size_t j = 0; j < 5; j++) {
+            state[j] = _mm256_load_si256((const __m256i *)words[j]);
+        }
+    }
+}
+
+#endif // JSTD_HAVE_SHA1_AVX2
+
+static void sha1_digest(const char * data, size_t length, jstd::digest160 & digest)
+{
+#if JSTD_HAVE_SHA1_NI
+    sha1_digest_batch_ni<1>(&data, &length, &digest, 1);
+#else
+    sha1_digest_scalar(data, length, digest);
+#endif
+}
+
+//
+// The AVX2 8 lanes is faster than SHA-NI on the big cores, whose sha1rnds4 is pipelined
+// well enough that one message already saturates it. The interleaved SHA-NI is for the
+// CPUs without AVX2 (e.g. the Atom cores), whose sha1rnds4 has a long latency.
+//
+static void sha1_digest_batch(const char * const * data, const size_t * length,
+                              jstd::digest160 * digests, size_t count)
+{
+#if JSTD_HAVE_SHA1_AVX2
+    sha1_digest_batch_avx2(data, length, digests, count);
+#elif JSTD_HAVE_SHA1_NI
+    sha1_digest_batch_ni<2>(data, length, digests, count);
+#else
+    sha1_digest_batch_scalar(data, length, digests, count);
+#endif
+}
+
 } // namespace sha1
 } // namespace jstd
 
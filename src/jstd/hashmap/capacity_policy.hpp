@@ -0,0 +1,311 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_CAPACITY_POLICY_HPP
+#define JSTD_HASHMAP_CAPACITY_POLICY_HPP
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>    // For std::max()
+#include <type_traits>
+
+#include <assert.h>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/hasher/hashes.h"
+#include "jstd/support/Power2.h"
+
+namespace jstd {
+
+/*
+ * The capacity policies: How a hash table rounds up the requested capacity,
+ * how it grows, and how it maps a hash value to a slot index.
+ *
+ *   static constexpr bool kIsPow2;
+ *
+ *   static size_type round_up(size_type capacity, size_type min_capacity);
+ *   static size_type next_capacity(size_type capacity);
+ *   static bool is_valid(size_type capacity);
+ *
+ *   void commit(size_type capacity);   // The table is re-created with this capacity.
+ *   void reset();                      // The table is freed.
+ *
+ *   size_type index_for_hash(size_type hash, size_type mask) const;
+ *
+ *   // The hash is already avalanched (hash_is_avalanching<Hash>), skip the mixing if any.
+ *   size_type index_for_avalanched_hash(size_type hash, size_type mask) const;
+ *
+ *   // The index is taken from the high bits of an avalanched hash, the ctrl hash
+ *   // of the tables should be taken from the low bits then, and vice versa.
+ *   static constexpr bool kIndexUsesHighBits;
+ *
+ * The mask is (capacity - 1), the pow2 policy only needs it, the other policies
+ * use the precomputed state of commit().
+ *
+ * pow2_capacity_policy (default): capacity = pow2::round_up(n), grows 2x,
+ *   index = (hash & mask). When a table needs a bit more than a power of 2,
+ *   it gets (almost) twice the memory it needs.
+ *
+ * prime_capacity_policy: the capacity is the next prime, grows ~1.5x,
+ *   index = (hash % capacity). The modulo uses Lemire's "fastmod" (direct
+ *   computation of the remainder by a precomputed 64-bit magic number),
+ *   it costs two multiplications instead of a division. All the bits of
+ *   the hash are used, so it's safe with the identity hashers (std::hash<int>).
+ *
+ * fastrange_capacity_policy: the capacity is a multiple of 16, grows ~1.5x,
+ *   index = (hash * capacity) >> 64 (Lemire's multiply-shift range reduction).
+ *   It uses the high bits of the hash, so the hash is folded and multiplied by
+ *   the golden ratio first (Fibonacci hashing) to spread the low bits to the high bits.
+ *
+ * See: Daniel Lemire, Owen Kaser, Nathan Kurz,
+ *      "Faster Remainder by Direct Computation", 2019.
+ *      Daniel Lemire, "Fast Random Integer Generation in an Interval", 2019.
+ */
+
+namespace detail {
+
+static inline
+std::uint64_t mul_hi64(std::uint64_t multiplicand, std::uint64_t multiplier) noexcept
+{
+    return hashes::uint128_mul(multiplicand, multiplier).high;
+}
+
+} // namespace detail
+
+struct pow2_capacity_policy {
+    typedef std::size_t     size_type;
+
+    static constexpr bool kIsPow2 = true;
+    static constexpr bool kIndexUsesHighBits = false;
+
+    pow2_capacity_policy() noexcept {}
+
+    static size_type round_up(size_type capacity, size_type min_capacity) noexcept {
+        size_type new_capacity = (std::max)(capacity, min_capacity);
+        if (!pow2::is_pow2(new_capacity)) {
+            new_capacity = pow2::round_up<size_type>(new_capacity);
+        }
+        return new_capacity;
+    }
+
+    static size_type next_capacity(size_type capacity) noexcept {
+        return (capacity * 2);
+    }
+
+    static bool is_valid(size_type capacity) noexcept {
+        return pow2::is_pow2(capacity);
+    }
+
+    void commit(size_type capacity) noexcept {
+        JSTD_UNUSED(capacity);
+    }
+
+    void reset() noexcept {}
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(size_type hash, size_type mask) const noexcept {
+        return (hash & mask);
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_avalanched_hash(size_type hash, size_type mask) const noexcept {
+        return (hash & mask);
+    }
+};
+
+struct prime_capacity_policy {
+    typedef std::size_t     size_type;
+
+    static constexpr bool kIsPow2 = false;
+    static constexpr bool kIndexUsesHighBits = false;
+
+    // The largest prime less than 2^32, the fastmod of 32-bit is exact below it.
+    static constexpr std::uint64_t kMaxFastModPrime = 4294967291ull;
+
+private:
+    std::uint64_t   magic_;
+    size_type       capacity_;
+
+public:
+    prime_capacity_policy() noexcept : magic_(0), capacity_(1) {}
+
+    static bool is_prime(size_type n) noexcept {
+        if (n < 4)
+            return (n >= 2);
+        if ((n % 2) == 0 || (n % 3) == 0)
+            return false;
+        for (size_type i = 5; i <= n / i; i += 6) {
+            if ((n % i) == 0 || (n % (i + 2)) == 0)
+                return false;
+        }
+        return true;
+    }
+
+    // Only be called when the table is re-created, the trial division is cheap
+    // against the rehashing: about 64K divisions at most for 32-bit capacities.
+    static size_type next_prime(size_type n) noexcept {
+        if (n <= 2)
+            return 2;
+        n |= 1;
+        while (!is_prime(n)) {
+            n += 2;
+        }
+        return n;
+    }
+
+    static size_type round_up(size_type capacity, size_type min_capacity) noexcept {
+        size_type new_capacity = (std::max)(capacity, min_capacity);
+        return next_prime(new_capacity);
+    }
+
+    static size_type next_capacity(size_type capacity) noexcept {
+        return next_prime(capacity + capacity / 2);
+    }
+
+    static bool is_valid(size_type capacity) noexcept {
+        return is_prime(capacity);
+    }
+
+    void commit(size_type capacity) noexcept {
+        assert(capacity > 2);
+        this->capacity_ = capacity;
+        if (std::uint64_t(capacity) <= kMaxFastModPrime)
+            this->magic_ = std::uint64_t(-1) / std::uint64_t(capacity) + 1;
+        else
+            this->magic_ = 0;
+    }
+
+    void reset() noexcept {
+        this->magic_ = 0;
+        this->capacity_ = 1;
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(size_type hash, size_type mask) const noexcept {
+        JSTD_UNUSED(mask);
+        if (likely(this->magic_ != 0)) {
+            // Fold the hash to 32 bits, the fastmod of 32-bit needs the 64-bit magic only.
+            std::uint32_t hash32 = static_cast<std::uint32_t>(std::uint64_t(hash) ^ (std::uint64_t(hash) >> 32));
+            std::uint64_t low_bits = this->magic_ * hash32;
+            return static_cast<size_type>(detail::mul_hi64(low_bits, this->capacity_));
+        } else {
+            return (hash % this->capacity_);
+        }
+    }
+
+    // The modulo uses all the bits of the hash, there is nothing to skip.
+    JSTD_FORCED_INLINE
+    size_type index_for_avalanched_hash(size_type hash, size_type mask) const noexcept {
+        return this->index_for_hash(hash, mask);
+    }
+};
+
+struct fastrange_capacity_policy {
+    typedef std::size_t     size_type;
+
+    static constexpr bool kIsPow2 = false;
+    static constexpr bool kIndexUsesHighBits = true;
+
+    static constexpr size_type kGranularity = 16;
+    static constexpr std::uint64_t kGoldenRatio64 = 11400714819323198485ull;
+
+private:
+    size_type   capacity_;
+
+public:
+    fastrange_capacity_policy() noexcept : capacity_(1) {}
+
+    static size_type round_up(size_type capacity, size_type min_capacity) noexcept {
+        size_type new_capacity = (std::max)(capacity, min_capacity);
+        return ((new_capacity + kGranularity - 1) / kGranularity * kGranularity);
+    }
+
+    static size_type next_capacity(size_type capacity) noexcept {
+        return round_up(capacity + capacity / 2, kGranularity);
+    }
+
+    static bool is_valid(size_type capacity) noexcept {
+        return ((capacity % kGranularity) == 0);
+    }
+
+    void commit(size_type capacity) noexcept {
+        assert(capacity > 0);
+        this->capacity_ = capacity;
+    }
+
+    void reset() noexcept {
+        this->capacity_ = 1;
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(size_type hash, size_type mask) const noexcept {
+        JSTD_UNUSED(mask);
+        // Fold the high bits first, the keys of (i * golden_ratio) would be
+        // a badly clustered Weyl sequence after multiplying the golden ratio again.
+        std::uint64_t mixed = (std::uint64_t(hash) ^ (std::uint64_t(hash) >> 32)) * kGoldenRatio64;
+        return static_cast<size_type>(detail::mul_hi64(mixed, this->capacity_));
+    }
+
+    // The high bits of an avalanched hash are good enough, skip the folding and the multiplication.
+    // It relies on hash_is_avalanching<Hash>: the small hashes all map to the index 0.
+    JSTD_FORCED_INLINE
+    size_type index_for_avalanched_hash(size_type hash, size_type mask) const noexcept {
+        JSTD_UNUSED(mask);
+        std::uint64_t hash64 = std::uint64_t(hash) << (64 - sizeof(size_type) * 8);
+        return static_cast<size_type>(detail::mul_hi64(hash64, this->capacity_));
+    }
+};
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_CAPACITY_POLICY_HPP
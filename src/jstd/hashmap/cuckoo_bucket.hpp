@@ -0,0 +1,186 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_CUCKOO_BUCKET_HPP
+#define JSTD_HASHMAP_CUCKOO_BUCKET_HPP
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include <assert.h>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/support/BitUtils.h"
+
+#if defined(JSTD_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace jstd {
+
+/*
+ * cuckoo_bucket<4 or 8>: The tags (fingerprints) of a bucket of cuckoo_flat_map.
+ *
+ * Each slot has an 8-bit tag, 0 is an empty slot, the used slots have a tag in [1, 255].
+ * The tags of a bucket are a 32-bit or 64-bit word, so a bucket is matched by one SSE2
+ * compare (or a SWAR compare without SSE2), the same as a group of the group tables.
+ */
+template <std::size_t BucketWidth>
+class JSTD_DLL cuckoo_bucket
+{
+public:
+    static_assert(((BucketWidth == 4) || (BucketWidth == 8)),
+                  "cuckoo_bucket<N>: The bucket width must be 4 or 8.");
+
+    typedef std::size_t     size_type;
+    typedef typename std::conditional<(BucketWidth == 8), std::uint64_t, std::uint32_t>::type
+                            word_type;
+
+    static constexpr size_type kBucketWidth = BucketWidth;
+    static constexpr std::uint8_t kEmptyTag = 0;
+    static constexpr std::uint32_t kFullMask = (std::uint32_t(1) << BucketWidth) - 1;
+
+private:
+    alignas(word_type) std::uint8_t tags_[kBucketWidth];
+
+public:
+    void init() noexcept {
+        ::memset(this->tags_, kEmptyTag, sizeof(this->tags_));
+    }
+
+    std::uint8_t tag(size_type pos) const noexcept {
+        assert(pos < kBucketWidth);
+        return this->tags_[pos];
+    }
+
+    bool is_empty(size_type pos) const noexcept {
+        return (this->tag(pos) == kEmptyTag);
+    }
+
+    bool is_used(size_type pos) const noexcept {
+        return (this->tag(pos) != kEmptyTag);
+    }
+
+    void set_tag(size_type pos, std::uint8_t tag) noexcept {
+        assert(pos < kBucketWidth);
+        assert(tag != kEmptyTag);
+        this->tags_[pos] = tag;
+    }
+
+    void set_empty(size_type pos) noexcept {
+        assert(pos < kBucketWidth);
+        this->tags_[pos] = kEmptyTag;
+    }
+
+    word_type word() const noexcept {
+        word_type tags;
+        ::memcpy(&tags, this->tags_, sizeof(tags));
+        return tags;
+    }
+
+    // One bit per slot, the bit is set if the tag of the slot is equal to tag.
+    JSTD_FORCED_INLINE
+    std::uint32_t match_tag(std::uint8_t tag) const noexcept {
+#if defined(JSTD_HAVE_SSE2)
+        __m128i tag_bits;
+        if (kBucketWidth == 8)
+            tag_bits = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(this->tags_));
+        else
+            tag_bits = _mm_cvtsi32_si128(static_cast<int>(this->word()));
+        __m128i match_mask = _mm_cmpeq_epi8(tag_bits, _mm_set1_epi8(static_cast<char>(tag)));
+        return (static_cast<std::uint32_t>(_mm_movemask_epi8(match_mask)) & kFullMask);
+#else
+        return cuckoo_bucket::match_word(static_cast<std::uint64_t>(this->word()), tag);
+#endif
+    }
+
+    JSTD_FORCED_INLINE
+    std::uint32_t match_empty() const noexcept {
+        return this->match_tag(kEmptyTag);
+    }
+
+    JSTD_FORCED_INLINE
+    std::uint32_t match_used() const noexcept {
+        return (~this->match_empty() & kFullMask);
+    }
+
+    size_type used_count() const noexcept {
+        return static_cast<size_type>(BitUtils::popcnt32(this->match_used()));
+    }
+
+    bool is_full() const noexcept {
+        return (this->match_empty() == 0);
+    }
+
+#if !defined(JSTD_HAVE_SSE2)
+private:
+    //
+    // SWAR: The high bit of each byte of (~(((x & 0x7F..) + 0x7F..) | x | 0x7F..)) is set
+    // only if the byte of x is zero, there are no false positives. Then the multiply
+    // gathers the 8 high bits into the top byte.
+    //
+    static std::uint32_t match_word(std::uint64_t tags, std::uint8_t tag) noexcept {
+        static const std::uint64_t kLowBits7 = 0x7F7F7F7F7F7F7F7FULL;
+        std::uint64_t x = tags ^ (0x0101010101010101ULL * tag);
+        std::uint64_t zeros = ~(((x & kLowBits7) + kLowBits7) | x | kLowBits7);
+        std::uint64_t bits = ((zeros >> 7) * 0x0102040810204080ULL) >> 56;
+        return (static_cast<std::uint32_t>(bits) & kFullMask);
+    }
+#endif
+};
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_CUCKOO_BUCKET_HPP
@@ -0,0 +1,1311 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_CUCKOO_FLAT_MAP_HPP
+#define JSTD_HASHMAP_CUCKOO_FLAT_MAP_HPP
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>               // For std::allocator<T>
+#include <functional>           // For std::hash<Key>
+#include <initializer_list>
+#include <iterator>             // For std::forward_iterator_tag
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>
+#include <tuple>                // For std::forward_as_tuple()
+#include <limits>
+#include <stdexcept>
+
+#include <assert.h>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/hasher/hashes.h"
+#include "jstd/support/BitUtils.h"
+#include "jstd/support/CPUPrefetch.h"
+#include "jstd/traits/type_traits.h"
+
+#include "jstd/hashmap/detail/hashmap_traits.h"
+#include "jstd/hashmap/flat_map_type_policy.hpp"
+#include "jstd/hashmap/flat_map_slot_policy.hpp"
+#include "jstd/hashmap/slot_policy_traits.h"
+#include "jstd/hashmap/cuckoo_bucket.hpp"
+#include "jstd/hashmap/hash_token.hpp"
+
+namespace jstd {
+
+//
+// The iterator of cuckoo_flat_map, it walks the tags and the slots side by side.
+// The tags array ends with a sentinel bucket of the used tags, so the increment
+// needs no bound check, and end() is the position of the sentinel.
+//
+template <typename HashMap, typename T>
+class cuckoo_flat_map_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+
+    using hashmap_type = HashMap;
+    using slot_type = typename HashMap::slot_type;
+    using size_type = typename HashMap::size_type;
+    using difference_type = typename HashMap::difference_type;
+
+    using opp_value_type = typename std::conditional<std::is_const<T>::value,
+                                                     typename std::remove_const<T>::type,
+                                                     const T>::type;
+    using opp_iterator = cuckoo_flat_map_iterator<HashMap, opp_value_type>;
+
+    static constexpr std::uint8_t kEmptyTag = HashMap::bucket_type::kEmptyTag;
+
+private:
+    const std::uint8_t * tag_;
+    const slot_type *    slot_;
+
+    friend class cuckoo_flat_map_iterator<HashMap, opp_value_type>;
+    friend HashMap;
+
+public:
+    cuckoo_flat_map_iterator() noexcept : tag_(nullptr), slot_(nullptr) {}
+    cuckoo_flat_map_iterator(const std::uint8_t * tag, const slot_type * slot) noexcept
+        : tag_(tag), slot_(slot) {}
+
+    // Only the iterator can be converted to the const_iterator.
+    template <typename U, typename std::enable_if<
+              std::is_const<T>::value && std::is_same<U, opp_value_type>::value>::type * = nullptr>
+    cuckoo_flat_map_iterator(const cuckoo_flat_map_iterator<HashMap, U> & src) noexcept
+        : tag_(src.tag_), slot_(src.slot_) {}
+
+    cuckoo_flat_map_iterator(const cuckoo_flat_map_iterator & src) noexcept = default;
+    cuckoo_flat_map_iterator & operator = (const cuckoo_flat_map_iterator & rhs) noexcept = default;
+
+    friend inline bool operator == (const cuckoo_flat_map_iterator & lhs,
+                                    const cuckoo_flat_map_iterator & rhs) noexcept {
+        return (lhs.slot_ == rhs.slot_);
+    }
+
+    friend inline bool operator != (const cuckoo_flat_map_iterator & lhs,
+                                    const cuckoo_flat_map_iterator & rhs) noexcept {
+        return (lhs.slot_ != rhs.slot_);
+    }
+
+    cuckoo_flat_map_iterator & operator ++ () noexcept {
+        this->increment();
+        return *this;
+    }
+
+    cuckoo_flat_map_iterator operator ++ (int) noexcept {
+        cuckoo_flat_map_iterator copy(*this);
+        this->increment();
+        return copy;
+    }
+
+    reference operator * () const noexcept {
+        return const_cast<reference>(this->slot_->value);
+    }
+
+    pointer operator -> () const noexcept {
+        return std::addressof(this->operator*());
+    }
+
+    slot_type * slot() const noexcept {
+        return const_cast<slot_type *>(this->slot_);
+    }
+
+private:
+    void increment() noexcept {
+        assert(this->tag_ != nullptr);
+        do {
+            ++this->tag_;
+            ++this->slot_;
+        } while (*this->tag_ == kEmptyTag);
+    }
+};
+
+/*
+ * cuckoo_flat_map<K, V, ..., BucketWidth>: The bucketized cuckoo hash map,
+ * for the large maps that the memory is more important than the insert speed.
+ *
+ * Each key has two candidate buckets of BucketWidth (4 or 8) slots, a lookup probes at most
+ * two buckets by the SIMD match of the 8-bit tags (see cuckoo_bucket), so the table can run
+ * at about 95% load factor. The default max load factor is 0.95 (8-way) or 0.93 (4-way),
+ * the group tables stop at 0.875 and robin_hash_map stops at 0.6.
+ *
+ * The two hash functions use the mixers of jstd/hasher/hashes.h, the partial-key cuckoo
+ * hashing (like the cuckoo filter):
+ *
+ *   hash   = hash_token<Hash>::mix_hash(Hash(key))        // hashes::mum_mul_mix()
+ *   index1 = hash & bucket_mask
+ *   tag    = (the top 8 bits of hash), 0 is mapped to 1
+ *   index2 = (index1 ^ (hashes::mum_hash(tag) | 1)) & bucket_mask
+ *
+ * So the alternate bucket of an entry is computed from its bucket index and its tag only,
+ * the displacement never rehashes the keys and reads the tags array only.
+ *
+ * When both buckets are full, a breadth-first search over the tags finds the shortest path
+ * of displacements to an empty slot (at most kMaxSearchNodes buckets), then the entries are
+ * moved along the path. If there is no path, the table grows.
+ *
+ * The slots are moved by the displacements, so the iterators and the references
+ * are invalidated by the insertions, like the other flat maps.
+ */
+template <typename Key, typename Value,
+          typename Hash = std::hash< typename std::remove_const<Key>::type >,
+          typename KeyEqual = std::equal_to< typename std::remove_const<Key>::type >,
+          typename Allocator = std::allocator< std::pair<const typename std::remove_const<Key>::type,
+                                                         typename std::remove_const<Value>::type> >,
+          std::size_t BucketWidth = 8>
+class JSTD_DLL cuckoo_flat_map
+{
+public:
+    typedef flat_map_type_policy<Key, Value>    type_policy;
+    typedef std::size_t                         size_type;
+    typedef std::intptr_t                       ssize_type;
+    typedef std::ptrdiff_t                      difference_type;
+
+    typedef typename type_policy::key_type      key_type;
+    typedef typename type_policy::mapped_type   mapped_type;
+    typedef typename type_policy::value_type    value_type;
+    typedef typename type_policy::init_type     init_type;
+    typedef typename type_policy::element_type  element_type;
+    typedef Hash                                hasher;
+    typedef KeyEqual                            key_equal;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>
+                                                allocator_type;
+
+    typedef value_type &                        reference;
+    typedef value_type const &                  const_reference;
+
+    typedef typename std::allocator_traits<allocator_type>::pointer         pointer;
+    typedef typename std::allocator_traits<allocator_type>::const_pointer   const_pointer;
+
+    typedef cuckoo_bucket<BucketWidth>          bucket_type;
+
+    using this_type = cuckoo_flat_map<Key, Value, Hash, KeyEqual, Allocator, BucketWidth>;
+
+    using slot_type = map_slot_type<key_type, mapped_type>;
+    using slot_policy_t = flat_map_slot_policy<slot_type>;
+    using SlotPolicyTraits = slot_policy_traits<slot_policy_t>;
+
+    using iterator       = cuckoo_flat_map_iterator<this_type, value_type>;
+    using const_iterator = cuckoo_flat_map_iterator<this_type, const value_type>;
+
+    static constexpr size_type kBucketWidth = bucket_type::kBucketWidth;
+    static constexpr size_type kMinBucketCount = 2;
+
+    static constexpr float kMinLoadFactorF = 0.5f;
+    static constexpr float kMaxLoadFactorF = 1.0f;
+    static constexpr float kDefaultLoadFactorF = (kBucketWidth == 8) ? 0.95f : 0.93f;
+    // Default load factor = 243 / 256 = 0.949 (8-way), 238 / 256 = 0.930 (4-way)
+    static constexpr size_type kLoadFactorAmplify = 256;
+    static constexpr size_type kDefaultMaxLoadFactor =
+        static_cast<size_type>((double)kLoadFactorAmplify * (double)kDefaultLoadFactorF + 0.5);
+
+    // The limits of the breadth-first search of a displacement path.
+    static constexpr size_type kMaxSearchNodes = 512;
+    static constexpr size_type kMaxSearchDepth = 8;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+    using bucket_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<bucket_type>;
+    using slot_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>;
+
+    using BucketAllocTraits = typename std::allocator_traits<allocator_type>::template rebind_traits<bucket_type>;
+    using SlotAllocTraits = typename std::allocator_traits<allocator_type>::template rebind_traits<slot_type>;
+
+    // A bucket in the breadth-first search: the entry at (parent's bucket, pos) moves to this bucket.
+    struct search_node {
+        size_type       bucket;
+        std::int32_t    parent;
+        std::uint8_t    pos;
+        std::uint8_t    depth;
+    };
+
+    bucket_type *           buckets_;
+    slot_type *             slots_;
+    size_type               bucket_mask_;
+    size_type               slot_size_;
+    size_type               slot_threshold_;
+    size_type               mlf_;
+    size_type               displace_count_;
+
+    hasher                  hasher_;
+    key_equal               key_equal_;
+    allocator_type          allocator_;
+    bucket_allocator_type   bucket_allocator_;
+    slot_allocator_type     slot_allocator_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    cuckoo_flat_map() : cuckoo_flat_map(0) {}
+
+    explicit cuckoo_flat_map(size_type capacity, hasher const & hash = hasher(),
+                             key_equal const & pred = key_equal(),
+                             allocator_type const & allocator = allocator_type())
+        : buckets_(nullptr), slots_(nullptr), bucket_mask_(0), slot_size_(0),
+          slot_threshold_(0), mlf_(kDefaultMaxLoadFactor), displace_count_(0),
+          hasher_(hash), key_equal_(pred), allocator_(allocator),
+          bucket_allocator_(allocator), slot_allocator_(allocator) {
+        if (capacity != 0) {
+            this->create_table(this->calc_bucket_count(capacity));
+        }
+    }
+
+    cuckoo_flat_map(size_type capacity, allocator_type const & allocator)
+        : cuckoo_flat_map(capacity, hasher(), key_equal(), allocator) {
+    }
+
+    cuckoo_flat_map(size_type capacity, hasher const & hash, allocator_type const & allocator)
+        : cuckoo_flat_map(capacity, hash, key_equal(), allocator) {
+    }
+
+    template <typename InputIterator>
+    cuckoo_flat_map(InputIterator first, InputIterator last, allocator_type const & allocator)
+        : cuckoo_flat_map(first, last, size_type(0), hasher(), key_equal(), allocator) {
+    }
+
+    explicit cuckoo_flat_map(allocator_type const & allocator)
+        : cuckoo_flat_map(0, allocator) {
+    }
+
+    template <typename Iterator>
+    cuckoo_flat_map(Iterator first, Iterator last, size_type capacity = 0,
+                    hasher const & hash = hasher(), key_equal const & pred = key_equal(),
+                    allocator_type const & allocator = allocator_type())
+        : cuckoo_flat_map(capacity, hash, pred, allocator) {
+        this->insert(first, last);
+    }
+
+    template <typename Iterator>
+    cuckoo_flat_map(Iterator first, Iterator last, size_type capacity, allocator_type const & allocator)
+        : cuckoo_flat_map(first, last, capacity, hasher(), key_equal(), allocator) {
+    }
+
+    template <typename Iterator>
+    cuckoo_flat_map(Iterator first, Iterator last, size_type capacity,
+                    hasher const & hash, allocator_type const & allocator)
+        : cuckoo_flat_map(first, last, capacity, hash, key_equal(), allocator) {
+    }
+
+    cuckoo_flat_map(cuckoo_flat_map const & other)
+        : cuckoo_flat_map(other, std::allocator_traits<allocator_type>::
+                                 select_on_container_copy_construction(other.get_allocator())) {
+    }
+
+    cuckoo_flat_map(cuckoo_flat_map const & other, allocator_type const & allocator)
+        : cuckoo_flat_map(0, other.hash_function(), other.key_eq(), allocator) {
+        this->mlf_ = other.mlf_;
+        this->copy_slots_from(other);
+    }
+
+    cuckoo_flat_map(cuckoo_flat_map && other) noexcept
+        : buckets_(other.buckets_), slots_(other.slots_), bucket_mask_(other.bucket_mask_),
+          slot_size_(other.slot_size_), slot_threshold_(other.slot_threshold_),
+          mlf_(other.mlf_), displace_count_(other.displace_count_),
+          hasher_(std::move(other.hasher_)), key_equal_(std::move(other.key_equal_)),
+          allocator_(std::move(other.allocator_)),
+          bucket_allocator_(std::move(other.bucket_allocator_)),
+          slot_allocator_(std::move(other.slot_allocator_)) {
+        other.reset_table();
+    }
+
+    cuckoo_flat_map(cuckoo_flat_map && other, allocator_type const & allocator)
+        : cuckoo_flat_map(0, other.hash_function(), other.key_eq(), allocator) {
+        this->mlf_ = other.mlf_;
+        if (this->allocator_ == other.allocator_) {
+            this->swap_table(other);
+        } else {
+            this->reserve(other.size());
+            for (iterator iter = other.begin(); iter != other.end(); ++iter) {
+                this->insert(type_policy::move(*iter));
+            }
+            other.clear();
+        }
+    }
+
+    cuckoo_flat_map(std::initializer_list<value_type> ilist,
+                    size_type capacity = 0, hasher const & hash = hasher(),
+                    key_equal const & pred = key_equal(),
+                    allocator_type const & allocator = allocator_type())
+        : cuckoo_flat_map(ilist.begin(), ilist.end(), capacity, hash, pred, allocator) {
+    }
+
+    cuckoo_flat_map(std::initializer_list<value_type> ilist, allocator_type const & allocator)
+        : cuckoo_flat_map(ilist, size_type(0), hasher(), key_equal(), allocator) {
+    }
+
+    cuckoo_flat_map(std::initializer_list<value_type> init, size_type capacity,
+                    allocator_type const & allocator)
+        : cuckoo_flat_map(init, capacity, hasher(), key_equal(), allocator) {
+    }
+
+    cuckoo_flat_map(std::initializer_list<value_type> init, size_type capacity,
+                    hasher const & hash, allocator_type const & allocator)
+        : cuckoo_flat_map(init, capacity, hash, key_equal(), allocator) {
+    }
+
+    ~cuckoo_flat_map() {
+        this->destroy();
+    }
+
+    cuckoo_flat_map & operator = (cuckoo_flat_map const & other) {
+        if (std::addressof(other) != this) {
+            this_type tmp(other);
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    cuckoo_flat_map & operator = (cuckoo_flat_map && other) noexcept {
+        if (std::addressof(other) != this) {
+            this_type tmp(std::move(other));
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    cuckoo_flat_map & operator = (std::initializer_list<value_type> il) {
+        this->clear();
+        this->insert(il.begin(), il.end());
+        return *this;
+    }
+
+    ///
+    /// Observers
+    ///
+    allocator_type get_allocator() const noexcept {
+        return this->allocator_;
+    }
+
+    hasher hash_function() const noexcept {
+        return this->hasher_;
+    }
+
+    key_equal key_eq() const noexcept {
+        return this->key_equal_;
+    }
+
+    static const char * name() noexcept {
+        return ((kBucketWidth == 8) ? "jstd::cuckoo_flat_map<8>" : "jstd::cuckoo_flat_map<4>");
+    }
+
+    ///
+    /// Iterators
+    ///
+    iterator begin() noexcept {
+        return this->iterator_at(this->first_used_index());
+    }
+
+    iterator end() noexcept {
+        return this->iterator_at(this->slot_capacity());
+    }
+
+    const_iterator begin() const noexcept {
+        return this->iterator_at(this->first_used_index());
+    }
+
+    const_iterator end() const noexcept {
+        return this->iterator_at(this->slot_capacity());
+    }
+
+    const_iterator cbegin() const noexcept { return this->begin(); }
+    const_iterator cend() const noexcept { return this->end(); }
+
+    ///
+    /// Capacity
+    ///
+    bool empty() const noexcept { return (this->size() == 0); }
+    size_type size() const noexcept { return this->slot_size_; }
+    size_type capacity() const noexcept { return this->slot_capacity(); }
+
+    size_type max_size() const noexcept {
+        return (std::numeric_limits<difference_type>::max)() / sizeof(slot_type);
+    }
+
+    size_type slot_size() const noexcept { return this->slot_size_; }
+    size_type slot_capacity() const noexcept { return (this->bucket_count() * kBucketWidth); }
+    size_type slot_threshold() const noexcept { return this->slot_threshold_; }
+
+    size_type bucket_mask() const noexcept { return this->bucket_mask_; }
+
+    bool is_valid() const noexcept { return (this->buckets_ != nullptr); }
+    bool is_empty() const noexcept { return (this->size() == 0); }
+
+    // The bytes of the buckets (tags) and the slots, include the sentinel bucket.
+    size_type memory_size() const noexcept {
+        return (this->is_valid() ? ((this->bucket_count() + 1) * sizeof(bucket_type) +
+                                    this->slot_capacity() * sizeof(slot_type)) : 0);
+    }
+
+    // The number of the entries moved by the displacements, for the statistics.
+    size_type displace_count() const noexcept { return this->displace_count_; }
+
+    ///
+    /// Bucket interface
+    ///
+    size_type bucket_size(size_type n) const noexcept {
+        assert(n < this->bucket_count());
+        return this->bucket_at(n)->used_count();
+    }
+
+    size_type bucket_count() const noexcept {
+        return (this->is_valid() ? (this->bucket_mask_ + 1) : 0);
+    }
+
+    size_type max_bucket_count() const noexcept {
+        return (this->max_size() / kBucketWidth);
+    }
+
+    // The primary bucket of the key, the key may be stored in its alternate bucket.
+    size_type bucket(const key_type & key) const {
+        return this->index_for_hash(this->hash_for(key));
+    }
+
+    ///
+    /// Hash policy
+    ///
+    float load_factor() const noexcept {
+        return ((this->slot_capacity() != 0) ?
+                ((float)this->size() / (float)this->slot_capacity()) : 0.0f);
+    }
+
+    float max_load_factor() const noexcept {
+        return ((float)this->mlf_ / (float)kLoadFactorAmplify);
+    }
+
+    void max_load_factor(float mlf) {
+        if (mlf < kMinLoadFactorF)
+            mlf = kMinLoadFactorF;
+        if (mlf > kMaxLoadFactorF)
+            mlf = kMaxLoadFactorF;
+        this->mlf_ = static_cast<size_type>((double)kLoadFactorAmplify * (double)mlf + 0.5);
+        if (this->is_valid()) {
+            this->slot_threshold_ = this->calc_slot_threshold(this->bucket_count());
+            if (this->size() > this->slot_threshold_) {
+                this->rehash_impl(this->calc_bucket_count(this->size()));
+            }
+        }
+    }
+
+    void reserve(size_type new_capacity) {
+        size_type new_bucket_count = this->calc_bucket_count(new_capacity);
+        if (new_bucket_count > this->bucket_count()) {
+            this->rehash_impl(new_bucket_count);
+        }
+    }
+
+    void rehash(size_type new_capacity) {
+        if (new_capacity < this->size())
+            new_capacity = this->size();
+        size_type new_bucket_count = this->calc_bucket_count(new_capacity);
+        if (new_bucket_count != this->bucket_count()) {
+            this->rehash_impl(new_bucket_count);
+        }
+    }
+
+    void shrink_to_fit() {
+        this->rehash(this->size());
+    }
+
+    ///
+    /// Lookup
+    ///
+    size_type count(const key_type & key) const {
+        return (this->contains(key) ? 1 : 0);
+    }
+
+    bool contains(const key_type & key) const {
+        return (this->find_index(key) != npos);
+    }
+
+    mapped_type & at(const key_type & key) {
+        size_type slot_index = this->find_index(key);
+        if (slot_index != npos) {
+            return this->slot_at(slot_index)->value.second;
+        }
+        throw std::out_of_range("key was not found in cuckoo_flat_map");
+    }
+
+    const mapped_type & at(const key_type & key) const {
+        size_type slot_index = this->find_index(key);
+        if (slot_index != npos) {
+            return this->slot_at(slot_index)->value.second;
+        }
+        throw std::out_of_range("key was not found in cuckoo_flat_map");
+    }
+
+    JSTD_FORCED_INLINE
+    mapped_type & operator [] (const key_type & key) {
+        return this->try_emplace_impl(key).first->second;
+    }
+
+    JSTD_FORCED_INLINE
+    mapped_type & operator [] (key_type && key) {
+        return this->try_emplace_impl(std::move(key)).first->second;
+    }
+
+    JSTD_FORCED_INLINE
+    iterator find(const key_type & key) {
+        size_type slot_index = this->find_index(key);
+        return ((slot_index != npos) ? this->iterator_at(slot_index) : this->end());
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator find(const key_type & key) const {
+        size_type slot_index = this->find_index(key);
+        return ((slot_index != npos) ? this->iterator_at(slot_index) : this->end());
+    }
+
+    ///
+    /// Modifiers
+    ///
+    void clear() noexcept {
+        if (this->is_valid()) {
+            if (this->size() != 0) {
+                this->destroy_slots();
+            }
+            for (size_type bucket_index = 0; bucket_index <= this->bucket_mask_; bucket_index++) {
+                this->buckets_[bucket_index].init();
+            }
+            this->slot_size_ = 0;
+        }
+    }
+
+    ///
+    /// insert(value)
+    ///
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert(const value_type & value) {
+        return this->try_emplace_impl(value.first, value.second);
+    }
+
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert(value_type && value) {
+        return this->try_emplace_impl(value.first, std::move(value.second));
+    }
+
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert(const init_type & value) {
+        return this->try_emplace_impl(value.first, value.second);
+    }
+
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert(init_type && value) {
+        return this->try_emplace_impl(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename P, typename std::enable_if<
+              (!jstd::is_same_ex<P, value_type>::value && !jstd::is_same_ex<P, init_type>::value) &&
+              std::is_constructible<init_type, P &&>::value>::type * = nullptr>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert(P && value) {
+        init_type init_value(std::forward<P>(value));
+        return this->try_emplace_impl(std::move(init_value.first), std::move(init_value.second));
+    }
+
+    JSTD_FORCED_INLINE
+    iterator insert(const_iterator hint, const value_type & value) {
+        return this->insert(value).first;
+    }
+
+    JSTD_FORCED_INLINE
+    iterator insert(const_iterator hint, value_type && value) {
+        return this->insert(std::move(value)).first;
+    }
+
+    JSTD_FORCED_INLINE
+    iterator insert(const_iterator hint, const init_type & value) {
+        return this->insert(value).first;
+    }
+
+    JSTD_FORCED_INLINE
+    iterator insert(const_iterator hint, init_type && value) {
+        return this->insert(std::move(value)).first;
+    }
+
+    template <typename InputIter>
+    void insert(InputIter first, InputIter last) {
+        for (; first != last; ++first) {
+            this->insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert(ilist.begin(), ilist.end());
+    }
+
+    ///
+    /// insert_or_assign(key, value)
+    ///
+    template <typename MappedT>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert_or_assign(const key_type & key, MappedT && value) {
+        return this->insert_or_assign_impl(key, std::forward<MappedT>(value));
+    }
+
+    template <typename MappedT>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert_or_assign(key_type && key, MappedT && value) {
+        return this->insert_or_assign_impl(std::move(key), std::forward<MappedT>(value));
+    }
+
+    template <typename MappedT>
+    JSTD_FORCED_INLINE
+    iterator insert_or_assign(const_iterator hint, const key_type & key, MappedT && value) {
+        return this->insert_or_assign_impl(key, std::forward<MappedT>(value)).first;
+    }
+
+    template <typename MappedT>
+    JSTD_FORCED_INLINE
+    iterator insert_or_assign(const_iterator hint, key_type && key, MappedT && value) {
+        return this->insert_or_assign_impl(std::move(key), std::forward<MappedT>(value)).first;
+    }
+
+    ///
+    /// emplace(args...)
+    ///
+    /// The key must be known before the slot is chosen, so the arguments
+    /// are constructed to an init_type first, unless it's (key, mapped).
+    ///
+    template <typename KeyT, typename MappedT, typename std::enable_if<
+              (jstd::is_same_ex<KeyT, key_type>::value)>::type * = nullptr>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> emplace(KeyT && key, MappedT && value) {
+        return this->try_emplace_impl(std::forward<KeyT>(key), std::forward<MappedT>(value));
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> emplace(Args && ... args) {
+        init_type value(std::forward<Args>(args)...);
+        return this->try_emplace_impl(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    iterator emplace_hint(const_iterator hint, Args && ... args) {
+        return this->emplace(std::forward<Args>(args)...).first;
+    }
+
+    ///
+    /// try_emplace(key, args...)
+    ///
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const key_type & key, Args && ... args) {
+        return this->try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(key_type && key, Args && ... args) {
+        return this->try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    iterator try_emplace(const_iterator hint, const key_type & key, Args && ... args) {
+        return this->try_emplace_impl(key, std::forward<Args>(args)...).first;
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    iterator try_emplace(const_iterator hint, key_type && key, Args && ... args) {
+        return this->try_emplace_impl(std::move(key), std::forward<Args>(args)...).first;
+    }
+
+    ///
+    /// erase(key)
+    ///
+    JSTD_FORCED_INLINE
+    size_type erase(const key_type & key) {
+        size_type slot_index = this->find_index(key);
+        if (slot_index != npos) {
+            this->erase_index(slot_index);
+            return 1;
+        }
+        return 0;
+    }
+
+    // The erasure doesn't move the other entries, returns the next iterator.
+    JSTD_FORCED_INLINE
+    iterator erase(iterator pos) {
+        size_type slot_index = this->index_of(pos);
+        this->erase_index(slot_index);
+        ++pos;
+        return pos;
+    }
+
+    JSTD_FORCED_INLINE
+    iterator erase(const_iterator pos) {
+        return this->erase(iterator(pos.tag_, pos.slot_));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        iterator iter(first.tag_, first.slot_);
+        while (iter != last) {
+            iter = this->erase(iter);
+        }
+        return iter;
+    }
+
+    void swap(this_type & other) noexcept {
+        using std::swap;
+        this->swap_table(other);
+        swap(this->mlf_, other.mlf_);
+        swap(this->hasher_, other.hasher_);
+        swap(this->key_equal_, other.key_equal_);
+        swap(this->allocator_, other.allocator_);
+        swap(this->bucket_allocator_, other.bucket_allocator_);
+        swap(this->slot_allocator_, other.slot_allocator_);
+    }
+
+    friend void swap(this_type & lhs, this_type & rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+private:
+    size_type calc_slot_threshold(size_type bucket_count) const noexcept {
+        return (bucket_count * kBucketWidth * this->mlf_ / kLoadFactorAmplify);
+    }
+
+    size_type calc_bucket_count(size_type capacity) const noexcept {
+        if (capacity == 0)
+            return 0;
+        size_type min_slots = (capacity * kLoadFactorAmplify + this->mlf_ - 1) / this->mlf_;
+        size_type min_buckets = (min_slots + kBucketWidth - 1) / kBucketWidth;
+        size_type bucket_count = kMinBucketCount;
+        while (bucket_count < min_buckets) {
+            bucket_count *= 2;
+        }
+        // The slot threshold must be able to hold the capacity.
+        while (this->calc_slot_threshold(bucket_count) < capacity) {
+            bucket_count *= 2;
+        }
+        return bucket_count;
+    }
+
+    JSTD_FORCED_INLINE
+    bucket_type * bucket_at(size_type bucket_index) noexcept {
+        assert(bucket_index <= this->bucket_mask_);
+        return (this->buckets_ + bucket_index);
+    }
+
+    JSTD_FORCED_INLINE
+    const bucket_type * bucket_at(size_type bucket_index) const noexcept {
+        assert(bucket_index <= this->bucket_mask_);
+        return (this->buckets_ + bucket_index);
+    }
+
+    JSTD_FORCED_INLINE
+    slot_type * slot_at(size_type slot_index) noexcept {
+        assert(slot_index < this->slot_capacity());
+        return (this->slots_ + slot_index);
+    }
+
+    JSTD_FORCED_INLINE
+    const slot_type * slot_at(size_type slot_index) const noexcept {
+        assert(slot_index < this->slot_capacity());
+        return (this->slots_ + slot_index);
+    }
+
+    const std::uint8_t * tags() const noexcept {
+        return reinterpret_cast<const std::uint8_t *>(this->buckets_);
+    }
+
+    JSTD_FORCED_INLINE
+    iterator iterator_at(size_type slot_index) noexcept {
+        return { this->tags() + slot_index, this->slots_ + slot_index };
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator iterator_at(size_type slot_index) const noexcept {
+        return { this->tags() + slot_index, this->slots_ + slot_index };
+    }
+
+    size_type index_of(const iterator & pos) const noexcept {
+        assert(pos.slot_ >= this->slots_ && pos.slot_ < (this->slots_ + this->slot_capacity()));
+        return static_cast<size_type>(pos.slot_ - this->slots_);
+    }
+
+    size_type first_used_index() const noexcept {
+        if (this->size() != 0) {
+            for (size_type bucket_index = 0; bucket_index <= this->bucket_mask_; bucket_index++) {
+                std::uint32_t used_mask = this->bucket_at(bucket_index)->match_used();
+                if (used_mask != 0) {
+                    return (bucket_index * kBucketWidth + BitUtils::bsf32(used_mask));
+                }
+            }
+        }
+        return this->slot_capacity();
+    }
+
+    JSTD_FORCED_INLINE
+    std::size_t hash_for(const key_type & key) const
+        noexcept(noexcept(this->hasher_(key))) {
+        return hash_token<Hash>::mix_hash(static_cast<std::size_t>(this->hasher_(key)));
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(std::size_t key_hash) const noexcept {
+        return (static_cast<size_type>(key_hash) & this->bucket_mask_);
+    }
+
+    // Use the high bits for the tag, the low bits are the bucket index.
+    JSTD_FORCED_INLINE
+    static std::uint8_t tag_for_hash(std::size_t key_hash) noexcept {
+        std::uint8_t tag = static_cast<std::uint8_t>(key_hash >> (sizeof(std::size_t) * 8 - 8));
+        return static_cast<std::uint8_t>(tag + static_cast<std::uint8_t>(tag == bucket_type::kEmptyTag));
+    }
+
+    // The alternate bucket, index1 and index2 are the alternate buckets of each other.
+    // The offset is odd, so index2 is not equal to index1.
+    JSTD_FORCED_INLINE
+    size_type alt_index(size_type bucket_index, std::uint8_t tag) const noexcept {
+        size_type offset = static_cast<size_type>(hashes::mum_hash(static_cast<std::size_t>(tag))) | 1;
+        return ((bucket_index ^ offset) & this->bucket_mask_);
+    }
+
+    JSTD_FORCED_INLINE
+    size_type find_in_bucket(const key_type & key, size_type bucket_index, std::uint8_t tag) const {
+        const bucket_type * bucket = this->bucket_at(bucket_index);
+        std::uint32_t match_mask = bucket->match_tag(tag);
+        while (match_mask != 0) {
+            size_type slot_index = bucket_index * kBucketWidth + BitUtils::bsf32(match_mask);
+            const slot_type * slot = this->slot_at(slot_index);
+            if (likely(this->key_equal_(key, slot->value.first))) {
+                return slot_index;
+            }
+            match_mask = BitUtils::clearLowBit32(match_mask);
+        }
+        return npos;
+    }
+
+    JSTD_FORCED_INLINE
+    size_type find_index(const key_type & key) const {
+        if (likely(this->size() != 0)) {
+            return this->find_index(key, this->hash_for(key));
+        }
+        return npos;
+    }
+
+    JSTD_FORCED_INLINE
+    size_type find_index(const key_type & key, std::size_t key_hash) const {
+        size_type index1 = this->index_for_hash(key_hash);
+        std::uint8_t tag = this->tag_for_hash(key_hash);
+        size_type index2 = this->alt_index(index1, tag);
+        Prefetch_Read_T0((const void *)this->bucket_at(index2));
+        size_type slot_index = this->find_in_bucket(key, index1, tag);
+        if (likely(slot_index != npos)) {
+            return slot_index;
+        }
+        return this->find_in_bucket(key, index2, tag);
+    }
+
+    //
+    // Find an empty slot for the hash, the primary bucket first, then the alternate bucket,
+    // then the displacements. The tag of the slot is not set yet. Returns npos if it fails.
+    //
+    size_type find_empty_to_insert(std::size_t key_hash) {
+        size_type index1 = this->index_for_hash(key_hash);
+        std::uint32_t empty_mask = this->bucket_at(index1)->match_empty();
+        if (likely(empty_mask != 0)) {
+            return (index1 * kBucketWidth + BitUtils::bsf32(empty_mask));
+        }
+
+        size_type index2 = this->alt_index(index1, this->tag_for_hash(key_hash));
+        empty_mask = this->bucket_at(index2)->match_empty();
+        if (likely(empty_mask != 0)) {
+            return (index2 * kBucketWidth + BitUtils::bsf32(empty_mask));
+        }
+
+        return this->cuckoo_search(index1, index2);
+    }
+
+    static bool is_on_path(const search_node * nodes, std::int32_t node_index, size_type bucket_index) noexcept {
+        while (node_index >= 0) {
+            if (nodes[node_index].bucket == bucket_index)
+                return true;
+            node_index = nodes[node_index].parent;
+        }
+        return false;
+    }
+
+    //
+    // The breadth-first search over the tags: for each entry of a full bucket, check whether
+    // its alternate bucket has an empty slot, otherwise enqueue the alternate bucket.
+    // The buckets on the path are distinct, so the moves don't interfere with each other.
+    //
+    size_type cuckoo_search(size_type index1, size_type index2) {
+        search_node nodes[kMaxSearchNodes];
+        size_type head = 0, tail = 0;
+        nodes[tail++] = { index1, -1, 0, 0 };
+        nodes[tail++] = { index2, -1, 0, 0 };
+
+        while (head < tail) {
+            const search_node & node = nodes[head];
+            const bucket_type * bucket = this->bucket_at(node.bucket);
+            assert(bucket->is_full());
+            for (size_type i = 0; i < kBucketWidth; i++) {
+                // Rotate the first position, so the paths spread over the slots.
+                size_type pos = (i + head) % kBucketWidth;
+                size_type alt_bucket = this->alt_index(node.bucket, bucket->tag(pos));
+                std::uint32_t empty_mask = this->bucket_at(alt_bucket)->match_empty();
+                if (empty_mask != 0) {
+                    size_type empty_index = alt_bucket * kBucketWidth + BitUtils::bsf32(empty_mask);
+                    return this->displace_path(nodes, head, pos, empty_index);
+                }
+                if ((tail < kMaxSearchNodes) && (node.depth < kMaxSearchDepth) &&
+                    !this_type::is_on_path(nodes, static_cast<std::int32_t>(head), alt_bucket)) {
+                    nodes[tail++] = { alt_bucket, static_cast<std::int32_t>(head),
+                                      static_cast<std::uint8_t>(pos),
+                                      static_cast<std::uint8_t>(node.depth + 1) };
+                }
+            }
+            head++;
+        }
+        return npos;
+    }
+
+    //
+    // Move the entry at (node's bucket, pos) to the empty slot, then move each entry
+    // on the path to the hole left by its child. Returns the hole in the root bucket.
+    //
+    size_type displace_path(const search_node * nodes, size_type node_index,
+                            size_type pos, size_type empty_index) {
+        size_type dest_index = empty_index;
+        size_type src_index = nodes[node_index].bucket * kBucketWidth + pos;
+        for (;;) {
+            this->move_slot(dest_index, src_index);
+            const search_node & node = nodes[node_index];
+            if (node.parent < 0)
+                break;
+            dest_index = src_index;
+            src_index = nodes[node.parent].bucket * kBucketWidth + node.pos;
+            node_index = static_cast<size_type>(node.parent);
+        }
+        return src_index;
+    }
+
+    void move_slot(size_type dest_index, size_type src_index) {
+        bucket_type * dest_bucket = this->bucket_at(dest_index / kBucketWidth);
+        bucket_type * src_bucket = this->bucket_at(src_index / kBucketWidth);
+        assert(dest_bucket->is_empty(dest_index % kBucketWidth));
+        assert(src_bucket->is_used(src_index % kBucketWidth));
+        SlotPolicyTraits::transfer(&this->slot_allocator_, this->slot_at(dest_index), this->slot_at(src_index));
+        dest_bucket->set_tag(dest_index % kBucketWidth, src_bucket->tag(src_index % kBucketWidth));
+        src_bucket->set_empty(src_index % kBucketWidth);
+        this->displace_count_++;
+    }
+
+    // Returns an empty slot for the hash, grows the table if it's necessary.
+    size_type prepare_insert(std::size_t key_hash) {
+        for (;;) {
+            if (likely(this->slot_size_ < this->slot_threshold_)) {
+                size_type slot_index = this->find_empty_to_insert(key_hash);
+                if (likely(slot_index != npos)) {
+                    return slot_index;
+                }
+            }
+            this->grow();
+        }
+    }
+
+    void grow() {
+        size_type new_bucket_count;
+        if (this->is_valid())
+            new_bucket_count = this->bucket_count() * 2;
+        else
+            new_bucket_count = this->calc_bucket_count(1);
+        this->rehash_impl(new_bucket_count);
+    }
+
+    template <typename KeyT, typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace_impl(KeyT && key, Args && ... args) {
+        std::size_t key_hash = this->hash_for(key);
+        if (likely(this->size() != 0)) {
+            size_type slot_index = this->find_index(key, key_hash);
+            if (slot_index != npos) {
+                return { this->iterator_at(slot_index), false };
+            }
+        }
+
+        size_type slot_index = this->prepare_insert(key_hash);
+        SlotPolicyTraits::construct(&this->slot_allocator_, this->slot_at(slot_index),
+                                    std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<KeyT>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        this->bucket_at(slot_index / kBucketWidth)->set_tag(slot_index % kBucketWidth,
+                                                            this->tag_for_hash(key_hash));
+        this->slot_size_++;
+        return { this->iterator_at(slot_index), true };
+    }
+
+    template <typename KeyT, typename MappedT>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> insert_or_assign_impl(KeyT && key, MappedT && value) {
+        std::pair<iterator, bool> result = this->try_emplace_impl(std::forward<KeyT>(key),
+                                                                  std::forward<MappedT>(value));
+        if (!result.second) {
+            result.first->second = std::forward<MappedT>(value);
+        }
+        return result;
+    }
+
+    void erase_index(size_type slot_index) {
+        assert(slot_index < this->slot_capacity());
+        bucket_type * bucket = this->bucket_at(slot_index / kBucketWidth);
+        assert(bucket->is_used(slot_index % kBucketWidth));
+        SlotPolicyTraits::destroy(&this->slot_allocator_, this->slot_at(slot_index));
+        bucket->set_empty(slot_index % kBucketWidth);
+        assert(this->slot_size_ > 0);
+        this->slot_size_--;
+    }
+
+    // The tags and the slots of new_bucket_count buckets, the tags are initialized.
+    void allocate_table(size_type new_bucket_count, bucket_type *& buckets, slot_type *& slots) {
+        assert(new_bucket_count >= kMinBucketCount);
+        // The last bucket is the sentinel of the iterators.
+        buckets = BucketAllocTraits::allocate(this->bucket_allocator_, new_bucket_count + 1);
+        try {
+            slots = SlotAllocTraits::allocate(this->slot_allocator_, new_bucket_count * kBucketWidth);
+        } catch (...) {
+            BucketAllocTraits::deallocate(this->bucket_allocator_, buckets, new_bucket_count + 1);
+            throw;
+        }
+
+        for (size_type bucket_index = 0; bucket_index < new_bucket_count; bucket_index++) {
+            buckets[bucket_index].init();
+        }
+        for (size_type pos = 0; pos < kBucketWidth; pos++) {
+            buckets[new_bucket_count].set_tag(pos, 0xFF);
+        }
+    }
+
+    void deallocate_table(size_type bucket_count, bucket_type * buckets, slot_type * slots) noexcept {
+        BucketAllocTraits::deallocate(this->bucket_allocator_, buckets, bucket_count + 1);
+        SlotAllocTraits::deallocate(this->slot_allocator_, slots, bucket_count * kBucketWidth);
+    }
+
+    void create_table(size_type new_bucket_count) {
+        assert(!this->is_valid());
+        this->allocate_table(new_bucket_count, this->buckets_, this->slots_);
+        this->bucket_mask_ = new_bucket_count - 1;
+        this->slot_size_ = 0;
+        this->slot_threshold_ = this->calc_slot_threshold(new_bucket_count);
+    }
+
+    //
+    // Move all entries to a table of new_bucket_count buckets (0 means to release the table).
+    // If an entry can not be placed, the new table grows again (recursively) before the rest.
+    //
+    void rehash_impl(size_type new_bucket_count) {
+        assert(new_bucket_count == 0 || new_bucket_count >= kMinBucketCount);
+        bucket_type * old_buckets = this->buckets_;
+        slot_type * old_slots = this->slots_;
+        size_type old_bucket_count = this->bucket_count();
+        size_type old_size = this->size();
+
+        if (new_bucket_count == 0) {
+            assert(old_size == 0);
+            if (old_buckets != nullptr) {
+                this->deallocate_table(old_bucket_count, old_buckets, old_slots);
+                this->reset_table();
+            }
+            return;
+        }
+
+        this->buckets_ = nullptr;
+        this->slots_ = nullptr;
+        try {
+            this->create_table(new_bucket_count);
+        } catch (...) {
+            this->buckets_ = old_buckets;
+            this->slots_ = old_slots;
+            throw;
+        }
+
+        if (old_buckets != nullptr) {
+            for (size_type bucket_index = 0; bucket_index < old_bucket_count; bucket_index++) {
+                std::uint32_t used_mask = old_buckets[bucket_index].match_used();
+                while (used_mask != 0) {
+                    size_type pos = BitUtils::bsf32(used_mask);
+                    used_mask = BitUtils::clearLowBit32(used_mask);
+                    slot_type * old_slot = old_slots + bucket_index * kBucketWidth + pos;
+
+                    std::size_t key_hash = this->hash_for(old_slot->value.first);
+                    size_type slot_index;
+                    while ((slot_index = this->find_empty_to_insert(key_hash)) == npos) {
+                        this->rehash_impl(this->bucket_count() * 2);
+                    }
+                    SlotPolicyTraits::transfer(&this->slot_allocator_, this->slot_at(slot_index), old_slot);
+                    this->bucket_at(slot_index / kBucketWidth)->set_tag(slot_index % kBucketWidth,
+                                                                        this->tag_for_hash(key_hash));
+                    this->slot_size_++;
+                }
+            }
+            assert(this->size() == old_size);
+            this->deallocate_table(old_bucket_count, old_buckets, old_slots);
+        }
+        (void)old_size;
+    }
+
+    // Copy the entries to the same positions, other has the same hasher.
+    void copy_slots_from(const this_type & other) {
+        if (!other.is_valid())
+            return;
+        this->create_table(other.bucket_count());
+        for (size_type bucket_index = 0; bucket_index <= other.bucket_mask_; bucket_index++) {
+            const bucket_type * other_bucket = other.bucket_at(bucket_index);
+            std::uint32_t used_mask = other_bucket->match_used();
+            while (used_mask != 0) {
+                size_type pos = BitUtils::bsf32(used_mask);
+                used_mask = BitUtils::clearLowBit32(used_mask);
+                size_type slot_index = bucket_index * kBucketWidth + pos;
+                try {
+                    SlotPolicyTraits::construct(&this->slot_allocator_, this->slot_at(slot_index),
+                                                other.slot_at(slot_index));
+                } catch (...) {
+                    this->destroy();
+                    throw;
+                }
+                this->bucket_at(bucket_index)->set_tag(pos, other_bucket->tag(pos));
+                this->slot_size_++;
+            }
+        }
+    }
+
+    void destroy_slots() noexcept {
+        for (size_type bucket_index = 0; bucket_index <= this->bucket_mask_; bucket_index++) {
+            std::uint32_t used_mask = this->bucket_at(bucket_index)->match_used();
+            while (used_mask != 0) {
+                size_type pos = BitUtils::bsf32(used_mask);
+                used_mask = BitUtils::clearLowBit32(used_mask);
+                SlotPolicyTraits::destroy(&this->slot_allocator_,
+                                          this->slot_at(bucket_index * kBucketWidth + pos));
+            }
+        }
+    }
+
+    void destroy() noexcept {
+        if (this->is_valid()) {
+            if (this->size() != 0) {
+                this->destroy_slots();
+            }
+            this->deallocate_table(this->bucket_count(), this->buckets_, this->slots_);
+            this->reset_table();
+        }
+    }
+
+    void reset_table() noexcept {
+        this->buckets_ = nullptr;
+        this->slots_ = nullptr;
+        this->bucket_mask_ = 0;
+        this->slot_size_ = 0;
+        this->slot_threshold_ = 0;
+    }
+
+    void swap_table(this_type & other) noexcept {
+        using std::swap;
+        swap(this->buckets_, other.buckets_);
+        swap(this->slots_, other.slots_);
+        swap(this->bucket_mask_, other.bucket_mask_);
+        swap(this->slot_size_, other.slot_size_);
+        swap(this->slot_threshold_, other.slot_threshold_);
+        swap(this->displace_count_, other.displace_count_);
+    }
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc, std::size_t BucketWidth>
+inline
+void swap(cuckoo_flat_map<Key, Value, Hash, KeyEqual, Alloc, BucketWidth> & lhs,
+          cuckoo_flat_map<Key, Value, Hash, KeyEqual, Alloc, BucketWidth> & rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace jstd
+
+///////////////////////////////////////////////////////////
+// std extensions: std::erase_if()
+///////////////////////////////////////////////////////////
+
+namespace std {
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc,
+          std::size_t BucketWidth, typename Pred>
+typename jstd::cuckoo_flat_map<Key, Value, Hash, KeyEqual, Alloc, BucketWidth>::size_type
+inline
+erase_if(jstd::cuckoo_flat_map<Key, Value, Hash, KeyEqual, Alloc, BucketWidth> & hash_map, Pred pred)
+{
+    auto old_size = hash_map.size();
+
+    auto iter = hash_map.begin();
+    while (iter != hash_map.end()) {
+        if (pred(*iter))
+            iter = hash_map.erase(iter);
+        else
+            ++iter;
+    }
+
+    return (old_size - hash_map.size());
+}
+
+} // namespace std
+
+#endif // JSTD_HASHMAP_CUCKOO_FLAT_MAP_HPP
@@ -0,0 +1,414 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_EXPIRING_FLAT_MAP_HPP
+#define JSTD_HASHMAP_EXPIRING_FLAT_MAP_HPP
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>               // For std::allocator<T>
+#include <functional>           // For std::hash<Key>
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/hashmap/group15_flat_map.hpp"
+
+namespace jstd {
+
+/*
+ * expiring_flat_map<K, V>: A group15_flat_map whose entries expire after a time to live (TTL).
+ *
+ * The time is a coarse epoch counter driven by the caller, e.g. advance() once per second,
+ * each slot stores a 32-bit expiry epoch beside the value, instead of a 64-bit timestamp.
+ * The epochs are compared by the wrapping difference, so the counter may overflow.
+ *
+ * The expiry is lazy:
+ *
+ *   - A lookup treats an expired entry as missing, and the non-const find() erases it.
+ *   - An insertion treats the expired entries on its probe path as empty: the expired entry
+ *     of the same key is overwritten in place, and so is an expired entry of another key,
+ *     in a full group before the first empty slot, or in any group once the table reaches
+ *     its growth threshold. So the table only grows if the probe path has no expired entry.
+ *   - Each insertion reclaims the expired entries of a bounded number of groups
+ *     (reclaim_groups(), default is 1) at a cursor that sweeps the groups round and round,
+ *     and expire_some(budget) does the same work explicitly, e.g. from an idle loop.
+ *
+ * So there is no full scan that stalls the caller, the expired entries that are not reclaimed
+ * yet are still counted by size(), and a sweep of the groups takes group_capacity() insertions.
+ */
+template <typename Key, typename Value,
+          typename Hash = std::hash< typename std::remove_const<Key>::type >,
+          typename KeyEqual = std::equal_to< typename std::remove_const<Key>::type >,
+          typename Allocator = std::allocator< std::pair<const typename std::remove_const<Key>::type,
+                                                         typename std::remove_const<Value>::type> > >
+class JSTD_DLL expiring_flat_map
+{
+public:
+    typedef typename std::remove_const<Key>::type   key_type;
+    typedef typename std::remove_const<Value>::type mapped_type;
+
+    typedef std::size_t                             size_type;
+    typedef std::intptr_t                           ssize_type;
+    typedef std::ptrdiff_t                          difference_type;
+
+    typedef Hash                                    hasher;
+    typedef KeyEqual                                key_equal;
+    typedef Allocator                               allocator_type;
+
+    typedef std::uint32_t                           epoch_type;
+
+    //
+    // The mapped value of the underlying map, the expiry epoch and the value.
+    //
+    struct entry_type {
+        epoch_type  expire_epoch;
+        mapped_type value;
+
+        template <typename ... Args>
+        explicit entry_type(epoch_type epoch, Args && ... args)
+            : expire_epoch(epoch), value(std::forward<Args>(args)...) {}
+    };
+
+    typedef std::pair<const key_type, entry_type>   value_type;
+
+    typedef group15_flat_map<key_type, entry_type, Hash, KeyEqual,
+        typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>>
+                                                    map_type;
+
+    using this_type = expiring_flat_map<Key, Value, Hash, KeyEqual, Allocator>;
+
+    static constexpr epoch_type kDefaultTTL = 60;
+    static constexpr size_type kDefaultReclaimGroups = 1;
+
+private:
+    map_type    map_;
+    epoch_type  now_;
+    epoch_type  ttl_;
+    size_type   reclaim_groups_;
+    size_type   reclaim_cursor_;
+    size_type   expired_count_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    explicit expiring_flat_map(epoch_type ttl = kDefaultTTL, size_type capacity = 0,
+                               hasher const & hash = hasher(),
+                               key_equal const & pred = key_equal(),
+                               allocator_type const & allocator = allocator_type())
+        : map_(capacity, hash, pred, allocator), now_(0), ttl_((ttl != 0) ? ttl : 1),
+          reclaim_groups_(kDefaultReclaimGroups), reclaim_cursor_(0), expired_count_(0) {
+    }
+
+    expiring_flat_map(this_type const & other) = default;
+    expiring_flat_map(this_type && other) = default;
+
+    ~expiring_flat_map() = default;
+
+    this_type & operator = (this_type const & other) = default;
+    this_type & operator = (this_type && other) = default;
+
+    ///
+    /// Clock
+    ///
+    epoch_type now() const noexcept { return this->now_; }
+
+    // The epoch must not go backward.
+    void set_now(epoch_type now) noexcept { this->now_ = now; }
+    void advance(epoch_type ticks = 1) noexcept { this->now_ += ticks; }
+
+    epoch_type ttl() const noexcept { return this->ttl_; }
+    void set_ttl(epoch_type ttl) noexcept { this->ttl_ = (ttl != 0) ? ttl : 1; }
+
+    // The number of groups reclaimed by each insertion.
+    size_type reclaim_groups() const noexcept { return this->reclaim_groups_; }
+    void set_reclaim_groups(size_type group_count) noexcept { this->reclaim_groups_ = group_count; }
+
+    bool is_expired(const entry_type & entry) const noexcept {
+        return (static_cast<std::int32_t>(entry.expire_epoch - this->now_) <= 0);
+    }
+
+    ///
+    /// Observers
+    ///
+    hasher hash_function() const { return this->map_.hash_function(); }
+    key_equal key_eq() const { return this->map_.key_eq(); }
+    allocator_type get_allocator() const noexcept { return this->map_.get_allocator(); }
+
+    // The underlying map, the expired entries that are not reclaimed yet are included.
+    const map_type & map() const noexcept { return this->map_; }
+
+    ///
+    /// Capacity
+    ///
+    bool empty() const noexcept { return this->map_.empty(); }
+    size_type size() const noexcept { return this->map_.size(); }
+
+    size_type slot_capacity() const noexcept { return this->map_.slot_capacity(); }
+    size_type group_capacity() const noexcept { return this->map_.group_capacity(); }
+    float load_factor() const noexcept { return this->map_.load_factor(); }
+
+    // The total number of the expired entries that have been reclaimed.
+    size_type expired_count() const noexcept { return this->expired_count_; }
+
+    void reserve(size_type new_capacity) {
+        this->map_.reserve(new_capacity);
+    }
+
+    ///
+    /// Lookup
+    ///
+    mapped_type * find(const key_type & key) {
+        auto iter = this->map_.find(key);
+        if (iter != this->map_.end()) {
+            if (likely(!this->is_expired(iter->second))) {
+                return &iter->second.value;
+            }
+            this->map_.erase(iter);
+            this->expired_count_++;
+        }
+        return nullptr;
+    }
+
+    const mapped_type * find(const key_type & key) const {
+        auto iter = this->map_.find(key);
+        if (iter != this->map_.end() && !this->is_expired(iter->second)) {
+            return &iter->second.value;
+        }
+        return nullptr;
+    }
+
+    bool contains(const key_type & key) const {
+        return (this->find(key) != nullptr);
+    }
+
+    size_type count(const key_type & key) const {
+        return (this->contains(key) ? 1 : 0);
+    }
+
+    // The epochs left before the key expires, or 0 if the key is missing or expired.
+    epoch_type time_to_live(const key_type & key) const {
+        auto iter = this->map_.find(key);
+        if (iter != this->map_.end() && !this->is_expired(iter->second)) {
+            return (iter->second.expire_epoch - this->now_);
+        }
+        return 0;
+    }
+
+    // Extend the expiry of a live entry to (now + ttl), returns false if it's missing or expired.
+    bool touch(const key_type & key) {
+        return this->touch(key, this->ttl_);
+    }
+
+    bool touch(const key_type & key, epoch_type ttl) {
+        auto iter = this->map_.find(key);
+        if (iter != this->map_.end() && !this->is_expired(iter->second)) {
+            iter->second.expire_epoch = this->now_ + ((ttl != 0) ? ttl : 1);
+            return true;
+        }
+        return false;
+    }
+
+    ///
+    /// Modifiers
+    ///
+
+    //
+    // Insert the key with the default TTL if it's missing or expired, returns { value, true },
+    // otherwise returns { value, false } and the expiry is not changed.
+    //
+    template <typename ... Args>
+    std::pair<mapped_type *, bool> try_emplace(const key_type & key, Args && ... args) {
+        return this->try_emplace_with_ttl(this->ttl_, key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    std::pair<mapped_type *, bool> try_emplace_with_ttl(epoch_type ttl, const key_type & key, Args && ... args) {
+        this->reclaim_step();
+
+        epoch_type expire_epoch = this->now_ + ((ttl != 0) ? ttl : 1);
+        size_type old_size = this->map_.size();
+        auto result = this->map_.try_emplace_reuse_if(expired_pred{this->now_}, key,
+                                                      expire_epoch, std::forward<Args>(args)...);
+        entry_type & entry = result.first->second;
+        if (result.second) {
+            this->count_if_reused(old_size);
+            return { &entry.value, true };
+        }
+        if (this->is_expired(entry)) {
+            // Reuse the slot of the expired entry.
+            entry.value = mapped_type(std::forward<Args>(args)...);
+            entry.expire_epoch = expire_epoch;
+            this->expired_count_++;
+            return { &entry.value, true };
+        }
+        return { &entry.value, false };
+    }
+
+    //
+    // Insert or assign the value, the expiry is set to (now + ttl) in both cases.
+    //
+    template <typename MappedT>
+    std::pair<mapped_type *, bool> insert_or_assign(const key_type & key, MappedT && value) {
+        return this->insert_or_assign_with_ttl(this->ttl_, key, std::forward<MappedT>(value));
+    }
+
+    template <typename MappedT>
+    std::pair<mapped_type *, bool> insert_or_assign_with_ttl(epoch_type ttl, const key_type & key,
+                                                             MappedT && value) {
+        this->reclaim_step();
+
+        epoch_type expire_epoch = this->now_ + ((ttl != 0) ? ttl : 1);
+        size_type old_size = this->map_.size();
+        auto result = this->map_.try_emplace_reuse_if(expired_pred{this->now_}, key,
+                                                      expire_epoch, std::forward<MappedT>(value));
+        entry_type & entry = result.first->second;
+        if (result.second) {
+            this->count_if_reused(old_size);
+            return { &entry.value, true };
+        }
+        bool is_expired = this->is_expired(entry);
+        entry.value = std::forward<MappedT>(value);
+        entry.expire_epoch = expire_epoch;
+        if (is_expired) {
+            this->expired_count_++;
+        }
+        return { &entry.value, is_expired };
+    }
+
+    size_type erase(const key_type & key) {
+        return this->map_.erase(key);
+    }
+
+    //
+    // Reclaim the expired entries in at most group_budget groups from the cursor,
+    // returns the number of reclaimed entries.
+    //
+    size_type expire_some(size_type group_budget) {
+        size_type group_count = this->map_.group_capacity();
+        if (group_budget > group_count)
+            group_budget = group_count;
+
+        size_type num_expired = this->map_.erase_if_in_groups(this->reclaim_cursor_, group_budget,
+                                                              expired_pred{this->now_});
+        this->reclaim_cursor_ = (this->reclaim_cursor_ + group_budget) % group_count;
+        this->expired_count_ += num_expired;
+        return num_expired;
+    }
+
+    // Reclaim all the expired entries.
+    size_type expire_all() {
+        return this->expire_some(this->map_.group_capacity());
+    }
+
+    void clear() {
+        this->map_.clear();
+        this->reclaim_cursor_ = 0;
+    }
+
+    void swap(this_type & other) {
+        using std::swap;
+        this->map_.swap(other.map_);
+        swap(this->now_, other.now_);
+        swap(this->ttl_, other.ttl_);
+        swap(this->reclaim_groups_, other.reclaim_groups_);
+        swap(this->reclaim_cursor_, other.reclaim_cursor_);
+        swap(this->expired_count_, other.expired_count_);
+    }
+
+    // Visit the live entries: visitor(key, value, expire_epoch).
+    template <typename Visitor>
+    void for_each(Visitor && visitor) const {
+        for (auto iter = this->map_.begin(); iter != this->map_.end(); ++iter) {
+            if (!this->is_expired(iter->second)) {
+                visitor(iter->first, iter->second.value, iter->second.expire_epoch);
+            }
+        }
+    }
+
+private:
+    // Whether an entry of the underlying map is expired at the epoch now.
+    struct expired_pred {
+        epoch_type now;
+
+        bool operator () (const value_type & value) const noexcept {
+            return (static_cast<std::int32_t>(value.second.expire_epoch - now) <= 0);
+        }
+    };
+
+    // A new entry that doesn't change the size has overwritten an expired entry of another key.
+    JSTD_FORCED_INLINE
+    void count_if_reused(size_type old_size) noexcept {
+        if (this->map_.size() == old_size) {
+            this->expired_count_++;
+        }
+    }
+
+    JSTD_FORCED_INLINE
+    void reclaim_step() {
+        if (this->reclaim_groups_ != 0 && !this->map_.empty()) {
+            this->expire_some(this->reclaim_groups_);
+        }
+    }
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+inline void swap(expiring_flat_map<Key, Value, Hash, KeyEqual, Allocator> & lhs,
+                 expiring_flat_map<Key, Value, Hash, KeyEqual, Allocator> & rhs) {
+    lhs.swap(rhs);
+}
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_EXPIRING_FLAT_MAP_HPP
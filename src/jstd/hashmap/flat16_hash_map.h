@@ -74,6 +74,7 @@
 #include "jstd/utility/utility.h"
 #include "jstd/hasher/hashes.h"
 #include "jstd/hasher/hash_crc32.h"
+#include "jstd/hashmap/detail/hashmap_traits.h"
 #include "jstd/support/BitUtils.h"
 #include "jstd/support/Power2.h"
 #include "jstd/support/BitVec.h"
@@ -116,6 +117,9 @@ public:
 
     static constexpr bool kUseIndexSalt = false;
 
+    // The hash code of an avalanching hasher is used directly, the second hash is skipped.
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hash>::value;
+
     static constexpr size_type npos = size_type(-1);
 
     static constexpr size_type kControlHashMask = 0x0000007Ful;
@@ -143,6 +147,12 @@ public:
     static constexpr std::uint32_t kDefaultLoadFactorRevInt =
             std::uint32_t(1.0f / kDefaultLoadFactor * kLoadFactorAmplify);
 
+    // When the [DeletedEntry] slots are more than (1 / kMaxDeletedRatioRev) of capacity,
+    // the next insertion drops them in place (no resize).
+    static constexpr size_type kMaxDeletedRatioRev = 8;
+    // The tables of this capacity or less are never purged, grow it instead.
+    static constexpr size_type kMinPurgeCapacity = 32;
+
 #if defined(__GNUC__) || (defined(__clang__) && !defined(_MSC_VER))
     static constexpr bool isGccOrClang = true;
 #else
@@ -1293,6 +1303,48 @@ public:
         this->rehash_impl<true, false>(new_capacity);
     }
 
+    //
+    // Drop all the [DeletedEntry] slots in place, without resize.
+    // It's called automatically by the insertion when there are too many [DeletedEntry],
+    // all the iterators are invalidated.
+    //
+    void purge_deleted() {
+        if (this->slot_deleted() != 0) {
+            this->drop_deleted_no_grow();
+        }
+    }
+
+    // The number of groups that find(key) probed, for diagnostics.
+    size_type probe_length(const key_type & key) const {
+        hash_code_t hash_code = this->get_hash(key);
+        hash_code_t hash_code_2nd = this->get_second_hash(hash_code);
+        std::uint8_t ctrl_hash = this->get_ctrl_hash(hash_code_2nd);
+        size_type slot_index = this->index_for(hash_code);
+        size_type start_slot = slot_index;
+        size_type length = 0;
+        do {
+            const group_type & group = this->get_group(slot_index);
+            std::uint32_t mask16 = group.matchHash(ctrl_hash);
+            size_type start_index = slot_index;
+            length++;
+            while (mask16 != 0) {
+                size_type pos = BitUtils::bsf32(mask16);
+                mask16 = BitUtils::clearLowBit32(mask16);
+                size_type index = this->round_index(start_index + pos);
+                const slot_type & target = this->get_slot(index);
+                if (this->key_equal_(target.value.first, key)) {
+                    return length;
+                }
+            }
+            if (group.hasAnyEmpty()) {
+                return length;
+            }
+            slot_index = this->slot_next_group(slot_index);
+        } while (slot_index != start_slot);
+
+        return length;
+    }
+
     void swap(flat16_hash_map & other) {
         if (&other != this) {
             this->swap_impl(other);
@@ -1535,6 +1587,9 @@ private:
     }
 
     inline hash_code_t get_second_hash(hash_code_t value) const noexcept {
+        // The index uses the low bits, take the ctrl hash from the high bits.
+        if (kIsAvalanching)
+            return (hash_code_t)((size_type)value >> (sizeof(size_type) * 8 - 8));
 #if 1
         return (size_type)hashes::simple_int_hash_crc32((size_type)value);
 #else
@@ -1853,10 +1908,20 @@ private:
         return (this->left_empties_ <= 0);
     }
 
+    inline bool need_purge() const {
+        return ((this->slot_capacity() > kMinPurgeCapacity) &&
+                (this->slot_deleted() >= this->slot_capacity() / kMaxDeletedRatioRev));
+    }
+
+    // Dropping the [DeletedEntry] in place is enough if the size is less than
+    // 25/32 of the slot threshold, otherwise grow it.
+    inline bool can_purge_no_grow() const {
+        return ((this->slot_capacity() > kMinPurgeCapacity) &&
+                (this->slot_size() * 32 <= this->slot_threshold() * 25));
+    }
+
     void reorder_or_grow_if_necessary() {
-        size_type slot_deleted;
-        if ((this->slot_capacity() > size_type(32)) &&
-            (slot_deleted = this->slot_deleted() >= this->slot_capacity() / 8)) {
+        if (this->need_purge() || this->can_purge_no_grow()) {
             // Reorder slot and no grow
             this->drop_deleted_no_grow();
         } else {
@@ -2120,6 +2185,9 @@ private:
         //       mark target as USED
         //       repeat procedure for current slot with moved from element (target)
 
+        // Note: "in the same group" means in the same probe window relative to
+        // the probe start of the element, not the distance of the two slots.
+
         // Convert all [Deleted] to [Empty], and [Used] to [Deleted].
         this->convent_all_slots();
 
@@ -2128,15 +2196,18 @@ private:
 
         for (size_type index = 0; index < this->slot_capacity(); index++) {
             ctrl_type * ctrl = this->control_at(index);
-            if (ctrl->isDeleted()) {
+            // Only the [Deleted] slots (the old [Used] slots) need to be reinserted.
+            if (!ctrl->isDeleted()) {
                 continue;
             }
             slot_type * slot = this->slot_at(index);
             std::uint8_t ctrl_hash;
-            size_type target = this->find_first_non_used_slot(slot->value.first, ctrl_hash);
-            intptr_t distance = intptr_t(index - target);
-            if (distance < intptr_t(kGroupWidth) && distance >= 0) {
-                // If the distance of old index and new index is less than kGroupWidth,
+            size_type first_slot;
+            size_type target = this->find_first_non_used_slot(slot->value.first, ctrl_hash, first_slot);
+            size_type old_window = ((index - first_slot) & this->slot_mask()) / kGroupWidth;
+            size_type new_window = ((target - first_slot) & this->slot_mask()) / kGroupWidth;
+            if (old_window == new_window) {
+                // If the old index and new index are in the same probe window,
                 // we don't need to move it because it's already in the best position.
                 ctrl->setUsed(ctrl_hash);
                 this->setUsedMirrorCtrl(index, ctrl_hash);
@@ -2168,6 +2239,8 @@ private:
             }
         }
 
+        // Restore the end of mark in the mirror control bytes.
+        this->template copy_and_mirror_controls<true>();
         this->reset_left_empties();
     }
 
@@ -2235,13 +2308,15 @@ private:
     }
 
     JSTD_FORCED_INLINE
-    size_type find_first_non_used_slot(const key_type & key, std::uint8_t & o_ctrl_hash) {
+    size_type find_first_non_used_slot(const key_type & key, std::uint8_t & o_ctrl_hash,
+                                       size_type & o_first_slot) {
         hash_code_t hash_code = this->get_hash(key);
         hash_code_t hash_code_2nd = this->get_second_hash(hash_code);
         std::uint8_t ctrl_hash = this->get_ctrl_hash(hash_code_2nd);
         size_type slot_index = this->index_for(hash_code);
         size_type first_slot = slot_index;
         o_ctrl_hash = ctrl_hash;
+        o_first_slot = first_slot;
 
         // Find the first empty or deleted slot and insert
         do {
@@ -2392,8 +2467,9 @@ private:
             slot_index = this->slot_next_group(slot_index);
         } while (slot_index != first_slot);
 
-        if (this->need_grow() || (last_slot == npos)) {
-            // The size of slot reach the slot threshold or hashmap is full.
+        if (this->need_grow() || (last_slot == npos) || this->need_purge()) {
+            // The size of slot reach the slot threshold, hashmap is full,
+            // or there are too many [DeletedEntry] slots.
             this->reorder_or_grow_if_necessary();
 
             return this->find_and_prepare_insert(key, ctrl_hash);
@@ -2745,27 +2821,33 @@ private:
         // Increment the left empties first, and decrement it when is setDeleted().
         this->left_empties_++;
 
-        const group_type & group = this->get_group(start_slot);
-        if (group.hasAnyEmpty()) {
+        // The slot can be set to [EmptyEntry] only if no probe window containing it
+        // has ever been full. A window containing index starts in [index - 15, index],
+        // so it's true if the run of the non-empty slots around index is shorter
+        // than kGroupWidth. If the capacity <= kGroupWidth, the first probe window
+        // already covers all slots.
+        bool was_never_full = true;
+        if (this->slot_capacity() > kGroupWidth) {
+            size_type prev_slot = (start_slot - kGroupWidth) & this->slot_mask();
+            std::uint32_t maskEmptyBefore = this->get_group(prev_slot).matchEmpty();
+            std::uint32_t maskEmptyAfter  = this->get_group(start_slot).matchEmpty();
+            if (maskEmptyBefore != 0 && maskEmptyAfter != 0) {
+                size_type used_before = (kGroupWidth - 1) - BitUtils::bsr32(maskEmptyBefore);
+                size_type used_after  = BitUtils::bsf32(maskEmptyAfter);
+                was_never_full = ((used_before + used_after) < kGroupWidth);
+            } else {
+                was_never_full = false;
+            }
+        }
+
+        if (was_never_full) {
             control.setEmpty();
             this->setUnusedMirrorCtrl(index, kEmptyEntry);
         } else {
-            size_type slot_index = this->slot_next_group(start_slot);
-            if (slot_index != start_slot) {
-                const group_type & group = this->get_group(slot_index);
-                if (!group.isAllEmpty()) {
-                    // Decrement the left empties when is setDeleted().
-                    this->left_empties_--;
-                    control.setDeleted();
-                    this->setUnusedMirrorCtrl(index, kDeletedEntry);
-                } else {
-                    control.setEmpty();
-                    this->setUnusedMirrorCtrl(index, kEmptyEntry);
-                }
-            } else {
-                control.setEmpty();
-                this->setUnusedMirrorCtrl(index, kEmptyEntry);
-            }
+            // Decrement the left empties when is setDeleted().
+            this->left_empties_--;
+            control.setDeleted();
+            this->setUnusedMirrorCtrl(index, kDeletedEntry);
         }
 
         // Destroy slot
@@ -0,0 +1,753 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_FLAT_LRU_CACHE_HPP
+#define JSTD_HASHMAP_FLAT_LRU_CACHE_HPP
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>               // For std::allocator<T>
+#include <functional>           // For std::hash<Key>
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>
+#include <tuple>                // For std::forward_as_tuple()
+
+#include <assert.h>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/support/BitUtils.h"
+#include "jstd/support/CPUPrefetch.h"
+
+#include "jstd/hashmap/flat_map_group16.hpp"
+#include "jstd/hashmap/group_quadratic_prober.hpp"
+#include "jstd/hashmap/hash_token.hpp"
+
+namespace jstd {
+
+/*
+ * flat_lru_cache<K, V>: A fixed-capacity cache with the CLOCK (second chance) eviction,
+ * an approximation of LRU, on the open addressing layout of group16_flat_table.
+ *
+ * The table is allocated once for the capacity and never grows. Each group of 16 slots
+ * (flat_map_group16) has a 16-bit reference mask beside it, one bit per slot:
+ *
+ *   - A hit (find(), get(), insert_or_assign() of an existing key) sets the bit of the slot.
+ *   - When the cache is full, the clock hand sweeps the groups, the victims of a group are
+ *     (group->match_used() & ~ref_mask), one of them is evicted and the hand moves to
+ *     the next group. If there is no victim, the reference bits of the group are cleared
+ *     (the second chance) and the hand moves on.
+ *
+ * So there is no linked list, a hit is one OR to the mask, and an eviction scans
+ * 16 slots per SIMD compare, it's at most one round of the groups.
+ *
+ * The ctrl bytes of group16 are 7 bits hash and 1 bit overflow, there are no spare bits
+ * for the recency, that is why the reference masks are stored in a separate array.
+ *
+ * The erasures leave the overflow bits behind, like group16_flat_table, each erasure that
+ * may have caused an overflow lowers the slot threshold. When the size reaches the threshold,
+ * the overflow bits are recomputed in place, the entries are not moved.
+ *
+ * The pointers returned by find(), get() and try_emplace() are valid until the next insertion.
+ */
+template <typename Key, typename Value,
+          typename Hash = std::hash< typename std::remove_const<Key>::type >,
+          typename KeyEqual = std::equal_to< typename std::remove_const<Key>::type >,
+          typename Allocator = std::allocator< std::pair<const typename std::remove_const<Key>::type,
+                                                         typename std::remove_const<Value>::type> > >
+class JSTD_DLL flat_lru_cache
+{
+public:
+    typedef typename std::remove_const<Key>::type   key_type;
+    typedef typename std::remove_const<Value>::type mapped_type;
+    typedef std::pair<const key_type, mapped_type>  value_type;
+
+    typedef std::size_t                             size_type;
+    typedef std::intptr_t                           ssize_type;
+    typedef std::ptrdiff_t                          difference_type;
+
+    typedef Hash                                    hasher;
+    typedef KeyEqual                                key_equal;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>
+                                                    allocator_type;
+
+    typedef value_type &                            reference;
+    typedef value_type const &                      const_reference;
+
+    typedef value_type *                            pointer;
+    typedef value_type const *                      const_pointer;
+
+    typedef group16_meta_ctrl                       ctrl_type;
+    typedef flat_map_group16<ctrl_type>             group_type;
+    typedef group_quadratic_prober                  prober_type;
+    typedef std::uint16_t                           ref_mask_t;
+
+    using this_type = flat_lru_cache<Key, Value, Hash, KeyEqual, Allocator>;
+
+    static constexpr size_type kGroupWidth = group_type::kGroupWidth;
+    static constexpr std::uint8_t kEmptySlot = group_type::kEmptySlot;
+
+    // The slot threshold = 224 / 256 = 0.875, the same as group16_flat_table.
+    static constexpr size_type kLoadFactorAmplify = 256;
+    static constexpr size_type kMaxLoadFactor = 224;
+    // The capacity of the cache uses 70% of the slots at most, the rest is the room
+    // of the overflow drift before an in-place rebuild.
+    static constexpr size_type kCapacityLoadFactor = 179;
+
+    static_assert((kGroupWidth == sizeof(ref_mask_t) * 8), "The reference mask must have one bit per slot.");
+
+private:
+    typedef std::allocator_traits<allocator_type>   AllocTraits;
+    typedef typename AllocTraits::template rebind_alloc<group_type>     group_allocator_type;
+    typedef typename AllocTraits::template rebind_alloc<ref_mask_t>     ref_allocator_type;
+    typedef std::allocator_traits<group_allocator_type>                 GroupAllocTraits;
+    typedef std::allocator_traits<ref_allocator_type>                   RefAllocTraits;
+
+    group_type *            groups_;
+    ref_mask_t *            refs_;
+    value_type *            slots_;
+    size_type               group_mask_;
+    size_type               size_;
+    size_type               capacity_;
+    size_type               slot_threshold_;
+    size_type               clock_hand_;
+
+    size_type               hit_count_;
+    size_type               miss_count_;
+    size_type               evict_count_;
+    size_type               rebuild_count_;
+
+    hasher                  hasher_;
+    key_equal               key_equal_;
+    allocator_type          allocator_;
+    group_allocator_type    group_allocator_;
+    ref_allocator_type      ref_allocator_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    explicit flat_lru_cache(size_type capacity,
+                            hasher const & hash = hasher(),
+                            key_equal const & pred = key_equal(),
+                            allocator_type const & allocator = allocator_type())
+        : groups_(nullptr), refs_(nullptr), slots_(nullptr), group_mask_(0),
+          size_(0), capacity_((capacity != 0) ? capacity : 1), slot_threshold_(0), clock_hand_(0),
+          hit_count_(0), miss_count_(0), evict_count_(0), rebuild_count_(0),
+          hasher_(hash), key_equal_(pred),
+          allocator_(allocator), group_allocator_(allocator), ref_allocator_(allocator) {
+        size_type group_count = this_type::calc_group_count(this->capacity_);
+        this->allocate_table(group_count, this->groups_, this->refs_, this->slots_);
+        this->group_mask_ = group_count - 1;
+        this->slot_threshold_ = this->calc_slot_threshold();
+    }
+
+    flat_lru_cache(this_type const & other) = delete;
+
+    flat_lru_cache(this_type && other) noexcept
+        : groups_(other.groups_), refs_(other.refs_), slots_(other.slots_),
+          group_mask_(other.group_mask_), size_(other.size_), capacity_(other.capacity_),
+          slot_threshold_(other.slot_threshold_), clock_hand_(other.clock_hand_),
+          hit_count_(other.hit_count_), miss_count_(other.miss_count_),
+          evict_count_(other.evict_count_), rebuild_count_(other.rebuild_count_),
+          hasher_(std::move(other.hasher_)), key_equal_(std::move(other.key_equal_)),
+          allocator_(std::move(other.allocator_)),
+          group_allocator_(std::move(other.group_allocator_)),
+          ref_allocator_(std::move(other.ref_allocator_)) {
+        other.groups_ = nullptr;
+        other.refs_ = nullptr;
+        other.slots_ = nullptr;
+        other.group_mask_ = 0;
+        other.size_ = 0;
+        other.slot_threshold_ = 0;
+        other.clock_hand_ = 0;
+    }
+
+    ~flat_lru_cache() {
+        this->destroy();
+    }
+
+    this_type & operator = (this_type const & other) = delete;
+
+    this_type & operator = (this_type && other) noexcept {
+        if (std::addressof(other) != this) {
+            this_type tmp(std::move(other));
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->allocator_;
+    }
+
+    ///
+    /// Observers
+    ///
+    hasher hash_function() const {
+        return this->hasher_;
+    }
+
+    key_equal key_eq() const {
+        return this->key_equal_;
+    }
+
+    ///
+    /// Capacity
+    ///
+    bool empty() const noexcept { return (this->size() == 0); }
+    size_type size() const noexcept { return this->size_; }
+
+    // The maximum number of entries, the cache evicts an entry to insert a new one when it's full.
+    size_type capacity() const noexcept { return this->capacity_; }
+
+    size_type group_capacity() const noexcept { return (this->group_mask_ + 1); }
+    size_type slot_capacity() const noexcept { return (this->group_capacity() * kGroupWidth); }
+    size_type slot_threshold() const noexcept { return this->slot_threshold_; }
+
+    float load_factor() const noexcept {
+        return ((float)this->size() / (float)this->slot_capacity());
+    }
+
+    // The bytes of the groups, the reference masks and the slots.
+    size_type memory_size() const noexcept {
+        return (this->group_capacity() * (sizeof(group_type) + sizeof(ref_mask_t)) +
+                this->slot_capacity() * sizeof(value_type));
+    }
+
+    ///
+    /// Statistics
+    ///
+    size_type hit_count() const noexcept { return this->hit_count_; }
+    size_type miss_count() const noexcept { return this->miss_count_; }
+    size_type evict_count() const noexcept { return this->evict_count_; }
+    size_type rebuild_count() const noexcept { return this->rebuild_count_; }
+
+    double hit_ratio() const noexcept {
+        size_type total = this->hit_count_ + this->miss_count_;
+        return ((total != 0) ? ((double)this->hit_count_ / (double)total) : 0.0);
+    }
+
+    void reset_stats() noexcept {
+        this->hit_count_ = 0;
+        this->miss_count_ = 0;
+        this->evict_count_ = 0;
+        this->rebuild_count_ = 0;
+    }
+
+    ///
+    /// Lookup
+    ///
+
+    // Find the key and mark it as referenced, the hit and miss are counted.
+    pointer find(const key_type & key) {
+        size_type slot_index = this->find_index(key);
+        if (likely(slot_index != this->slot_capacity())) {
+            this->hit_count_++;
+            this->set_referenced(slot_index);
+            return this->slot_at(slot_index);
+        } else {
+            this->miss_count_++;
+            return nullptr;
+        }
+    }
+
+    mapped_type * get(const key_type & key) {
+        pointer value = this->find(key);
+        return ((value != nullptr) ? &value->second : nullptr);
+    }
+
+    // Find the key without touching the reference bit and the statistics.
+    const_pointer peek(const key_type & key) const {
+        size_type slot_index = this->find_index(key);
+        return ((slot_index != this->slot_capacity()) ? this->slot_at(slot_index) : nullptr);
+    }
+
+    bool contains(const key_type & key) const {
+        return (this->find_index(key) != this->slot_capacity());
+    }
+
+    size_type count(const key_type & key) const {
+        return (this->contains(key) ? 1 : 0);
+    }
+
+    // Whether the entry of the key is referenced since the clock hand passed it.
+    bool is_referenced(const key_type & key) const {
+        size_type slot_index = this->find_index(key);
+        if (slot_index != this->slot_capacity()) {
+            size_type group_index = slot_index / kGroupWidth;
+            size_type pos = slot_index % kGroupWidth;
+            return ((this->refs_[group_index] & (ref_mask_t(1) << pos)) != 0);
+        }
+        return false;
+    }
+
+    ///
+    /// Modifiers
+    ///
+
+    //
+    // Insert the key if it does not exist, evict an entry first if the cache is full.
+    // If the key exists, mark it as referenced and return { entry, false }.
+    //
+    template <typename ... Args>
+    std::pair<pointer, bool> try_emplace(const key_type & key, Args && ... args) {
+        return this->emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    std::pair<pointer, bool> try_emplace(key_type && key, Args && ... args) {
+        return this->emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<pointer, bool> insert(const value_type & value) {
+        return this->emplace_impl(value.first, value.second);
+    }
+
+    std::pair<pointer, bool> insert(value_type && value) {
+        return this->emplace_impl(value.first, std::move(value.second));
+    }
+
+    template <typename MappedT>
+    std::pair<pointer, bool> insert_or_assign(const key_type & key, MappedT && value) {
+        std::pair<pointer, bool> result = this->emplace_impl(key, std::forward<MappedT>(value));
+        if (!result.second) {
+            result.first->second = std::forward<MappedT>(value);
+        }
+        return result;
+    }
+
+    template <typename MappedT>
+    std::pair<pointer, bool> insert_or_assign(key_type && key, MappedT && value) {
+        std::pair<pointer, bool> result = this->emplace_impl(std::move(key), std::forward<MappedT>(value));
+        if (!result.second) {
+            result.first->second = std::forward<MappedT>(value);
+        }
+        return result;
+    }
+
+    size_type erase(const key_type & key) {
+        size_type slot_index = this->find_index(key);
+        if (slot_index != this->slot_capacity()) {
+            this->erase_index(slot_index);
+            return 1;
+        }
+        return 0;
+    }
+
+    // Evict an entry by the CLOCK policy, returns false if the cache is empty.
+    bool evict() {
+        if (this->size() != 0) {
+            this->evict_one();
+            return true;
+        }
+        return false;
+    }
+
+    void clear() {
+        if (this->size() != 0) {
+            for (size_type group_index = 0; group_index <= this->group_mask_; group_index++) {
+                group_type * group = this->group_at(group_index);
+                std::uint32_t used_mask = group->match_used();
+                while (used_mask != 0) {
+                    size_type pos = BitUtils::bsf32(used_mask);
+                    used_mask = BitUtils::clearLowBit32(used_mask);
+                    AllocTraits::destroy(this->allocator_, this->slot_at(group_index * kGroupWidth + pos));
+                }
+            }
+        }
+        for (size_type group_index = 0; group_index <= this->group_mask_; group_index++) {
+            this->groups_[group_index].init();
+            this->refs_[group_index] = 0;
+        }
+        this->size_ = 0;
+        this->slot_threshold_ = this->calc_slot_threshold();
+        this->clock_hand_ = 0;
+    }
+
+    void swap(this_type & other) noexcept {
+        using std::swap;
+        swap(this->groups_, other.groups_);
+        swap(this->refs_, other.refs_);
+        swap(this->slots_, other.slots_);
+        swap(this->group_mask_, other.group_mask_);
+        swap(this->size_, other.size_);
+        swap(this->capacity_, other.capacity_);
+        swap(this->slot_threshold_, other.slot_threshold_);
+        swap(this->clock_hand_, other.clock_hand_);
+        swap(this->hit_count_, other.hit_count_);
+        swap(this->miss_count_, other.miss_count_);
+        swap(this->evict_count_, other.evict_count_);
+        swap(this->rebuild_count_, other.rebuild_count_);
+        swap(this->hasher_, other.hasher_);
+        swap(this->key_equal_, other.key_equal_);
+        swap(this->allocator_, other.allocator_);
+        swap(this->group_allocator_, other.group_allocator_);
+        swap(this->ref_allocator_, other.ref_allocator_);
+    }
+
+    // Visit all entries, in the slot order.
+    template <typename Visitor>
+    void for_each(Visitor && visitor) const {
+        for (size_type group_index = 0; group_index <= this->group_mask_; group_index++) {
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t used_mask = group->match_used();
+            while (used_mask != 0) {
+                size_type pos = BitUtils::bsf32(used_mask);
+                used_mask = BitUtils::clearLowBit32(used_mask);
+                const value_type & value = *this->slot_at(group_index * kGroupWidth + pos);
+                visitor(value);
+            }
+        }
+    }
+
+private:
+    static size_type calc_group_count(size_type capacity) noexcept {
+        size_type min_slots = (capacity * kLoadFactorAmplify + kCapacityLoadFactor - 1) / kCapacityLoadFactor;
+        size_type min_groups = (min_slots + kGroupWidth - 1) / kGroupWidth;
+        size_type group_count = 1;
+        while (group_count < min_groups) {
+            group_count *= 2;
+        }
+        return group_count;
+    }
+
+    size_type calc_slot_threshold() const noexcept {
+        size_type slot_threshold = this->slot_capacity() * kMaxLoadFactor / kLoadFactorAmplify;
+        assert(slot_threshold > this->capacity_);
+        return slot_threshold;
+    }
+
+    JSTD_FORCED_INLINE
+    group_type * group_at(size_type group_index) noexcept {
+        assert(group_index <= this->group_mask_);
+        return (this->groups_ + group_index);
+    }
+
+    JSTD_FORCED_INLINE
+    const group_type * group_at(size_type group_index) const noexcept {
+        assert(group_index <= this->group_mask_);
+        return (this->groups_ + group_index);
+    }
+
+    JSTD_FORCED_INLINE
+    pointer slot_at(size_type slot_index) noexcept {
+        assert(slot_index < this->slot_capacity());
+        return (this->slots_ + slot_index);
+    }
+
+    JSTD_FORCED_INLINE
+    const_pointer slot_at(size_type slot_index) const noexcept {
+        assert(slot_index < this->slot_capacity());
+        return (this->slots_ + slot_index);
+    }
+
+    JSTD_FORCED_INLINE
+    void set_referenced(size_type slot_index) noexcept {
+        this->refs_[slot_index / kGroupWidth] |= static_cast<ref_mask_t>(1U << (slot_index % kGroupWidth));
+    }
+
+    JSTD_FORCED_INLINE
+    std::size_t hash_for(const key_type & key) const
+        noexcept(noexcept(this->hasher_(key))) {
+        return hash_token<Hash>::mix_hash(static_cast<std::size_t>(this->hasher_(key)));
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(std::size_t key_hash) const noexcept {
+        return (static_cast<size_type>(key_hash) & this->group_mask_);
+    }
+
+    // Use the high bits for the ctrl hash, the low bits are the group index.
+    JSTD_FORCED_INLINE
+    std::uint8_t ctrl_for_hash(std::size_t key_hash) const noexcept {
+        return ctrl_type::reduced_hash(key_hash >> (sizeof(std::size_t) * 8 - 8));
+    }
+
+    JSTD_FORCED_INLINE
+    size_type find_index(const key_type & key) const {
+        std::size_t key_hash = this->hash_for(key);
+        return this->find_index(key, this->index_for_hash(key_hash), this->ctrl_for_hash(key_hash));
+    }
+
+    size_type find_index(const key_type & key, size_type group_index, std::uint8_t ctrl_hash) const {
+        prober_type prober(group_index);
+
+        do {
+            group_index = prober.get();
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t match_mask = group->match_hash(ctrl_hash);
+            if (match_mask != 0) {
+                const value_type * slot_base = this->slots_ + group_index * kGroupWidth;
+                if (sizeof(value_type) <= 16) {
+                    Prefetch_Read_T0((const void *)slot_base);
+                }
+                do {
+                    size_type match_pos = static_cast<size_type>(BitUtils::bsf32(match_mask));
+                    const value_type * slot = slot_base + match_pos;
+                    if (likely(this->key_equal_(key, slot->first))) {
+                        return (group_index * kGroupWidth + match_pos);
+                    }
+                    match_mask = BitUtils::clearLowBit32(match_mask);
+                } while (match_mask != 0);
+            }
+
+            // If it's not overflow, means it hasn't been found.
+            if (likely(group->is_not_overflow(ctrl_hash % kGroupWidth))) {
+                return this->slot_capacity();
+            }
+        } while (prober.next_bucket(this->group_mask_));
+
+        return this->slot_capacity();
+    }
+
+    static size_type find_empty_to_insert(group_type * groups, size_type group_mask,
+                                          size_type group_index, std::uint8_t ctrl_hash) {
+        prober_type prober(group_index);
+
+        do {
+            group_index = prober.get();
+            group_type * group = groups + group_index;
+            std::uint32_t empty_mask = group->match_empty();
+            if (empty_mask != 0) {
+                size_type empty_pos = BitUtils::bsf32(empty_mask);
+                assert(group->is_empty(empty_pos));
+                group->set_used(empty_pos, ctrl_hash);
+                return (group_index * kGroupWidth + empty_pos);
+            } else {
+                // If it's not overflow, set the overflow bit.
+                group->set_overflow(ctrl_hash % kGroupWidth);
+            }
+        } while (prober.next_bucket(group_mask));
+
+        // The slot threshold is always less than the slot capacity.
+        assert(false);
+        return ((group_mask + 1) * kGroupWidth);
+    }
+
+    template <typename KeyT, typename ... Args>
+    std::pair<pointer, bool> emplace_impl(KeyT && key, Args && ... args) {
+        std::size_t key_hash = this->hash_for(key);
+        size_type group_index = this->index_for_hash(key_hash);
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+
+        size_type slot_index = this->find_index(key, group_index, ctrl_hash);
+        if (slot_index != this->slot_capacity()) {
+            this->set_referenced(slot_index);
+            return { this->slot_at(slot_index), false };
+        }
+
+        if (this->size() >= this->capacity()) {
+            this->evict_one();
+        }
+        if (unlikely(this->size() >= this->slot_threshold())) {
+            // Too many overflow bits are left by the erasures.
+            this->rebuild();
+        }
+
+        slot_index = this_type::find_empty_to_insert(this->groups_, this->group_mask_,
+                                                     group_index, ctrl_hash);
+        pointer slot = this->slot_at(slot_index);
+        try {
+            AllocTraits::construct(this->allocator_, slot, std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<KeyT>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            this->group_at(slot_index / kGroupWidth)->set_empty(slot_index % kGroupWidth);
+            throw;
+        }
+        this->set_referenced(slot_index);
+        this->size_++;
+        return { slot, true };
+    }
+
+    void erase_index(size_type slot_index) {
+        assert(slot_index < this->slot_capacity());
+        size_type group_index = slot_index / kGroupWidth;
+        size_type pos = slot_index % kGroupWidth;
+        group_type * group = this->group_at(group_index);
+
+        // If the group has overflowed with this ctrl hash, the entry may have pushed
+        // another key out, the overflow bit can't be cleared, see group16_flat_table.
+        bool maybe_overflow = group->is_overflow(group->value(pos) % kGroupWidth);
+        assert(this->slot_threshold_ > 0);
+        this->slot_threshold_ -= static_cast<size_type>(maybe_overflow);
+
+        group->set_empty(pos);
+        this->refs_[group_index] &= static_cast<ref_mask_t>(~(1U << pos));
+        AllocTraits::destroy(this->allocator_, this->slot_at(slot_index));
+        assert(this->size_ > 0);
+        this->size_--;
+    }
+
+    //
+    // The CLOCK sweep over the groups: the victims of a group are the used and unreferenced slots,
+    // if there is no victim, clear the reference bits of the group (the second chance) and move
+    // to the next group.
+    //
+    // At most one entry is evicted per visit of a group, then the hand moves on. If the hand
+    // evicted all the victims of a group at once, the empty slots would be clustered behind
+    // the hand, and the inserts to the full groups would overflow far.
+    //
+    void evict_one() {
+        assert(this->size() != 0);
+        size_type group_index = this->clock_hand_;
+
+        for (;;) {
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t used_mask = group->match_used();
+            std::uint32_t victim_mask = used_mask & ~static_cast<std::uint32_t>(this->refs_[group_index]);
+            if (victim_mask != 0) {
+                // Rotate the first position, so the victims of a group are evicted in turn.
+                size_type offset = this->evict_count_ % kGroupWidth;
+                std::uint32_t rotated_mask = ((victim_mask >> offset) | (victim_mask << (kGroupWidth - offset)));
+                size_type pos = (BitUtils::bsf32(rotated_mask) + offset) % kGroupWidth;
+
+                this->erase_index(group_index * kGroupWidth + pos);
+                this->evict_count_++;
+                this->clock_hand_ = (group_index + 1) & this->group_mask_;
+                return;
+            }
+
+            this->refs_[group_index] &= static_cast<ref_mask_t>(~used_mask);
+            group_index = (group_index + 1) & this->group_mask_;
+        }
+    }
+
+    //
+    // Recompute the overflow bits in place, to clear the overflow bits left by the erasures.
+    // The entries are not moved, so the reference bits and the clock hand are kept.
+    //
+    // The overflow bit (ctrl_hash % 16) is set in each group on the probe path from
+    // the home group of an entry to the group where the entry is stored.
+    //
+    void rebuild() {
+        size_type group_count = this->group_capacity();
+        ctrl_type * ctrls = reinterpret_cast<ctrl_type *>(this->groups_);
+        for (size_type i = 0; i < group_count * kGroupWidth; i++) {
+            ctrls[i].set_value(ctrl_type::hash_bits(ctrls[i].value()));
+        }
+
+        for (size_type group_index = 0; group_index < group_count; group_index++) {
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t used_mask = group->match_used();
+            while (used_mask != 0) {
+                size_type pos = BitUtils::bsf32(used_mask);
+                used_mask = BitUtils::clearLowBit32(used_mask);
+
+                std::size_t key_hash = this->hash_for(this->slot_at(group_index * kGroupWidth + pos)->first);
+                size_type home_index = this->index_for_hash(key_hash);
+                if (home_index != group_index) {
+                    size_type overflow_pos = this->ctrl_for_hash(key_hash) % kGroupWidth;
+                    prober_type prober(home_index);
+                    do {
+                        ctrl_type * ctrl = &ctrls[prober.get() * kGroupWidth + overflow_pos];
+                        ctrl->set_value(ctrl->value() | ctrl_type::kOverflowMask);
+                        prober.next_bucket(this->group_mask_);
+                    } while (prober.get() != group_index);
+                }
+            }
+        }
+
+        this->slot_threshold_ = this->calc_slot_threshold();
+        this->rebuild_count_++;
+    }
+
+    void allocate_table(size_type group_count, group_type *& groups,
+                        ref_mask_t *& refs, value_type *& slots) {
+        groups = GroupAllocTraits::allocate(this->group_allocator_, group_count);
+        try {
+            refs = RefAllocTraits::allocate(this->ref_allocator_, group_count);
+            try {
+                slots = AllocTraits::allocate(this->allocator_, group_count * kGroupWidth);
+            } catch (...) {
+                RefAllocTraits::deallocate(this->ref_allocator_, refs, group_count);
+                throw;
+            }
+        } catch (...) {
+            GroupAllocTraits::deallocate(this->group_allocator_, groups, group_count);
+            throw;
+        }
+
+        for (size_type group_index = 0; group_index < group_count; group_index++) {
+            groups[group_index].init();
+            refs[group_index] = 0;
+        }
+    }
+
+    void deallocate_table(size_type group_count, group_type * groups,
+                          ref_mask_t * refs, value_type * slots) noexcept {
+        GroupAllocTraits::deallocate(this->group_allocator_, groups, group_count);
+        RefAllocTraits::deallocate(this->ref_allocator_, refs, group_count);
+        AllocTraits::deallocate(this->allocator_, slots, group_count * kGroupWidth);
+    }
+
+    void destroy() noexcept {
+        if (this->groups_ != nullptr) {
+            this->clear();
+            this->deallocate_table(this->group_capacity(), this->groups_, this->refs_, this->slots_);
+            this->groups_ = nullptr;
+            this->refs_ = nullptr;
+            this->slots_ = nullptr;
+        }
+    }
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+inline void swap(flat_lru_cache<Key, Value, Hash, KeyEqual, Allocator> & lhs,
+                 flat_lru_cache<Key, Value, Hash, KeyEqual, Allocator> & rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_FLAT_LRU_CACHE_HPP
@@ -52,6 +52,7 @@
 #pragma once
 
 #include <cstdint>
+#include <climits>              // For CHAR_BIT
 #include <assert.h>
 
 #include "jstd/basic/stddef.h"
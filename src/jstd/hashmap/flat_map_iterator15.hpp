@@ -143,7 +143,7 @@ public:
             if (this->group_->is_empty(this->pos_))
                 continue;
             if (unlikely(this->group_->is_sentinel(this->pos_)))
-                this->slot_ = nullptr;
+                this->set_end();
             return;
         }
 
@@ -155,7 +155,7 @@ public:
                     this->pos_ = static_cast<size_type>(used_pos);
                     this->slot_ += static_cast<difference_type>(used_pos);
                 } else {
-                    this->slot_ = nullptr;
+                    this->set_end();
                 }
                 return;
             }
@@ -177,7 +177,7 @@ public:
             if (this->group_->is_empty(this->pos_))
                 continue;
             if (unlikely(this->group_->is_sentinel(this->pos_)))
-                this->slot_ = nullptr;
+                this->set_end();
             return;
         }
 
@@ -189,7 +189,7 @@ public:
                     this->pos_ = static_cast<size_type>(used_pos);
                     this->slot_ -= (kGroupSize - 1) - static_cast<difference_type>(used_pos);
                 } else {
-                    this->slot_ = nullptr;
+                    this->set_end();
                 }
                 return;
             }
@@ -200,6 +200,13 @@ public:
     }
 
 protected:
+    // Same as the default constructor, so that it can be equal to end().
+    inline void set_end() noexcept {
+        this->group_ = nullptr;
+        this->pos_ = 0;
+        this->slot_ = nullptr;
+    }
+
     const group_type *  group_;
     size_type           pos_;
     const slot_type *   slot_;
@@ -0,0 +1,728 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_FROZEN_MAP_HPP
+#define JSTD_HASHMAP_FROZEN_MAP_HPP
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>               // For std::allocator<T>
+#include <functional>           // For std::hash<Key>
+#include <iterator>
+#include <initializer_list>
+#include <algorithm>            // For std::sort(), std::max()
+#include <vector>
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>
+#include <limits>               // For std::numeric_limits<T>
+#include <stdexcept>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/hasher/hashes.h"
+
+namespace jstd {
+
+/*
+ * frozen_map<K, V>: A read-only map built once from a set of keys, by a minimal perfect hash.
+ *
+ * The perfect hash is PTHash-style: the keys are split into buckets of about kBucketLoad keys,
+ * and each bucket has a 32-bit pilot, so that the position of each key:
+ *
+ *     position = reduce(mix(hash(key) ^ (pilot[bucket(key)] * C)), size)
+ *
+ * is unique in [0, size). The buckets are placed from the largest to the smallest,
+ * and the pilot of a bucket is the first one that all its keys land in free slots.
+ *
+ * The values are stored densely with 100% load factor, and a lookup costs at most
+ * two cache misses: the pilot, and the slot that it is compared against.
+ *
+ * The keys that have the same hash code (of Hash) with another key can't be separated
+ * by any pilot, they are stored after the perfect hash slots, and only searched
+ * when the key in the perfect hash slot is not equal. It's empty for a good 64-bit hash.
+ *
+ * Use jstd::freeze(map) to build it from a jstd map (or any map with the same interface).
+ */
+template <typename Key, typename Value,
+          typename Hash = std::hash< typename std::remove_const<Key>::type >,
+          typename KeyEqual = std::equal_to< typename std::remove_const<Key>::type >,
+          typename Allocator = std::allocator< std::pair<const typename std::remove_const<Key>::type,
+                                                         typename std::remove_const<Value>::type> > >
+class JSTD_DLL frozen_map
+{
+public:
+    typedef typename std::remove_const<Key>::type   key_type;
+    typedef typename std::remove_const<Value>::type mapped_type;
+    typedef std::pair<const key_type, mapped_type>  value_type;
+
+    typedef std::size_t                             size_type;
+    typedef std::intptr_t                           ssize_type;
+    typedef std::ptrdiff_t                          difference_type;
+
+    typedef Hash                                    hasher;
+    typedef KeyEqual                                key_equal;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>
+                                                    allocator_type;
+
+    typedef value_type &                            reference;
+    typedef value_type const &                      const_reference;
+
+    typedef value_type *                            pointer;
+    typedef value_type const *                      const_pointer;
+
+    // The slots are dense, so the iterators are the plain pointers.
+    typedef value_type *                            iterator;
+    typedef value_type const *                      const_iterator;
+
+    typedef std::uint32_t                           pilot_type;
+    typedef std::uint64_t                           hash_code_t;
+
+    using this_type = frozen_map<Key, Value, Hash, KeyEqual, Allocator>;
+
+    // The average number of keys in a bucket, the pilots cost 32 / kBucketLoad bits per key.
+    static constexpr size_type kBucketLoad = 4;
+
+    // The maximum number of times to reseed the perfect hash before giving up.
+    static constexpr size_type kMaxSeedRetries = 16;
+
+    static constexpr hash_code_t kDefaultSeed = 0x2545F4914F6CDD1Dull;
+
+private:
+    typedef std::allocator_traits<allocator_type>   AllocTraits;
+    typedef typename AllocTraits::template rebind_alloc<pilot_type>     pilot_allocator_type;
+    typedef std::allocator_traits<pilot_allocator_type>                 PilotAllocTraits;
+
+    static constexpr hash_code_t kPilotMultiplier = 0x9E3779B97F4A7C15ull;
+    static constexpr hash_code_t kMixMultiplier   = 0xD6E8FEB86659FD93ull;
+
+    // 60% of 2^32.
+    static constexpr std::uint32_t kDenseKeysThreshold = 0x9999999Au;
+
+    value_type *            slots_;
+    pilot_type *            pilots_;
+    size_type               slot_size_;
+    size_type               mph_size_;
+    size_type               pilot_size_;
+    size_type               dense_buckets_;
+    hash_code_t             seed_;
+
+    hasher                  hasher_;
+    key_equal               key_equal_;
+    allocator_type          allocator_;
+    pilot_allocator_type    pilot_allocator_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    explicit frozen_map(hasher const & hash = hasher(),
+                        key_equal const & pred = key_equal(),
+                        allocator_type const & allocator = allocator_type())
+        : slots_(nullptr), pilots_(nullptr),
+          slot_size_(0), mph_size_(0), pilot_size_(0), dense_buckets_(0), seed_(kDefaultSeed),
+          hasher_(hash), key_equal_(pred),
+          allocator_(allocator), pilot_allocator_(allocator) {
+    }
+
+    explicit frozen_map(allocator_type const & allocator)
+        : frozen_map(hasher(), key_equal(), allocator) {
+    }
+
+    //
+    // Build from a range of forward iterators of value_type (or pair<key_type, mapped_type>),
+    // if a key appears more than once, the first one is kept.
+    //
+    template <typename ForwardIterator>
+    frozen_map(ForwardIterator first, ForwardIterator last,
+               hasher const & hash = hasher(),
+               key_equal const & pred = key_equal(),
+               allocator_type const & allocator = allocator_type())
+        : frozen_map(hash, pred, allocator) {
+        this->build(first, last);
+    }
+
+    frozen_map(std::initializer_list<value_type> init_list,
+               hasher const & hash = hasher(),
+               key_equal const & pred = key_equal(),
+               allocator_type const & allocator = allocator_type())
+        : frozen_map(init_list.begin(), init_list.end(), hash, pred, allocator) {
+    }
+
+    frozen_map(const frozen_map & other)
+        : slots_(nullptr), pilots_(nullptr),
+          slot_size_(0), mph_size_(0), pilot_size_(0), dense_buckets_(0), seed_(other.seed_),
+          hasher_(other.hasher_), key_equal_(other.key_equal_),
+          allocator_(AllocTraits::select_on_container_copy_construction(other.allocator_)),
+          pilot_allocator_(this->allocator_) {
+        this->copy_from(other);
+    }
+
+    frozen_map(frozen_map && other) noexcept
+        : slots_(other.slots_), pilots_(other.pilots_),
+          slot_size_(other.slot_size_), mph_size_(other.mph_size_),
+          pilot_size_(other.pilot_size_), dense_buckets_(other.dense_buckets_), seed_(other.seed_),
+          hasher_(std::move(other.hasher_)), key_equal_(std::move(other.key_equal_)),
+          allocator_(std::move(other.allocator_)),
+          pilot_allocator_(std::move(other.pilot_allocator_)) {
+        other.slots_ = nullptr;
+        other.pilots_ = nullptr;
+        other.slot_size_ = 0;
+        other.mph_size_ = 0;
+        other.pilot_size_ = 0;
+        other.dense_buckets_ = 0;
+    }
+
+    ~frozen_map() {
+        this->destroy();
+    }
+
+    frozen_map & operator = (const frozen_map & other) {
+        if (&other != this) {
+            frozen_map tmp(other);
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    frozen_map & operator = (frozen_map && other) noexcept {
+        if (&other != this) {
+            frozen_map tmp(std::move(other));
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    ///
+    /// Observers
+    ///
+    allocator_type get_allocator() const noexcept {
+        return this->allocator_;
+    }
+
+    hasher hash_function() const noexcept {
+        return this->hasher_;
+    }
+
+    key_equal key_eq() const noexcept {
+        return this->key_equal_;
+    }
+
+    static const char * name() noexcept {
+        return "jstd::frozen_map<K, V>";
+    }
+
+    ///
+    /// Iterators
+    ///
+    iterator begin() noexcept { return this->slots_; }
+    iterator end() noexcept { return this->slots_ + this->slot_size_; }
+
+    const_iterator begin() const noexcept { return this->slots_; }
+    const_iterator end() const noexcept { return this->slots_ + this->slot_size_; }
+
+    const_iterator cbegin() const noexcept { return this->begin(); }
+    const_iterator cend() const noexcept { return this->end(); }
+
+    ///
+    /// Capacity
+    ///
+    bool empty() const noexcept { return (this->slot_size_ == 0); }
+    size_type size() const noexcept { return this->slot_size_; }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(UINT32_MAX);
+    }
+
+    // The number of keys that are placed by the perfect hash.
+    size_type mph_size() const noexcept { return this->mph_size_; }
+    // The number of keys that have a duplicate hash code, see the comment of the class.
+    size_type collision_size() const noexcept { return (this->slot_size_ - this->mph_size_); }
+    size_type pilot_size() const noexcept { return this->pilot_size_; }
+
+    // The bytes of the slots and the pilots, without the heap memory owned by the keys and values.
+    size_type memory_size() const noexcept {
+        return (this->slot_size_ * sizeof(value_type) + this->pilot_size_ * sizeof(pilot_type));
+    }
+
+    ///
+    /// Hash policy
+    ///
+    size_type bucket_count() const noexcept { return this->slot_size_; }
+    float load_factor() const noexcept { return (this->slot_size_ != 0) ? 1.0f : 0.0f; }
+    hash_code_t seed() const noexcept { return this->seed_; }
+
+    ///
+    /// Lookup
+    ///
+    JSTD_FORCED_INLINE
+    iterator find(const key_type & key) {
+        return (this->slots_ + this->find_index(key));
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator find(const key_type & key) const {
+        return (this->slots_ + this->find_index(key));
+    }
+
+    JSTD_FORCED_INLINE
+    size_type count(const key_type & key) const {
+        return (this->find_index(key) != this->slot_size_) ? 1 : 0;
+    }
+
+    JSTD_FORCED_INLINE
+    bool contains(const key_type & key) const {
+        return (this->find_index(key) != this->slot_size_);
+    }
+
+    mapped_type & at(const key_type & key) {
+        size_type index = this->find_index(key);
+        if (index != this->slot_size_) {
+            return this->slots_[index].second;
+        }
+        throw std::out_of_range("key was not found in frozen_map");
+    }
+
+    const mapped_type & at(const key_type & key) const {
+        size_type index = this->find_index(key);
+        if (index != this->slot_size_) {
+            return this->slots_[index].second;
+        }
+        throw std::out_of_range("key was not found in frozen_map");
+    }
+
+    JSTD_FORCED_INLINE
+    std::pair<iterator, iterator> equal_range(const key_type & key) {
+        iterator iter = this->find(key);
+        return { iter, (iter != this->end()) ? (iter + 1) : iter };
+    }
+
+    JSTD_FORCED_INLINE
+    std::pair<const_iterator, const_iterator> equal_range(const key_type & key) const {
+        const_iterator iter = this->find(key);
+        return { iter, (iter != this->end()) ? (iter + 1) : iter };
+    }
+
+    ///
+    /// Modifiers
+    ///
+    void clear() noexcept {
+        this->destroy();
+    }
+
+    void swap(frozen_map & other) noexcept {
+        using std::swap;
+        swap(this->slots_, other.slots_);
+        swap(this->pilots_, other.pilots_);
+        swap(this->slot_size_, other.slot_size_);
+        swap(this->mph_size_, other.mph_size_);
+        swap(this->pilot_size_, other.pilot_size_);
+        swap(this->dense_buckets_, other.dense_buckets_);
+        swap(this->seed_, other.seed_);
+        swap(this->hasher_, other.hasher_);
+        swap(this->key_equal_, other.key_equal_);
+        swap(this->allocator_, other.allocator_);
+        swap(this->pilot_allocator_, other.pilot_allocator_);
+    }
+
+private:
+    JSTD_FORCED_INLINE
+    hash_code_t hash_for(const key_type & key) const {
+        hash_code_t hash_code = static_cast<hash_code_t>(this->hasher_(key));
+        return hashes::mum_mul_mix64(hash_code ^ this->seed_, kPilotMultiplier);
+    }
+
+    static JSTD_FORCED_INLINE
+    std::uint32_t reduce(std::uint32_t value, size_type range) noexcept {
+        // Lemire's fastrange, range is less than 2^32.
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(value) * range) >> 32);
+    }
+
+    //
+    // The skewed bucket assignment of PTHash: 60% of the keys are mapped to 30% of the buckets,
+    // so there are more large buckets that are placed while the table is still sparse.
+    //
+    JSTD_FORCED_INLINE
+    size_type bucket_for_hash(hash_code_t hash) const noexcept {
+        // Branchless, the branch is taken 60% of the time, it's unpredictable.
+        bool is_dense = (static_cast<std::uint32_t>(hash >> 32) < kDenseKeysThreshold);
+        size_type first_bucket = is_dense ? 0 : this->dense_buckets_;
+        size_type num_buckets  = is_dense ? this->dense_buckets_ : (this->pilot_size_ - this->dense_buckets_);
+        return first_bucket + reduce(static_cast<std::uint32_t>(hash), num_buckets);
+    }
+
+    static JSTD_FORCED_INLINE
+    size_type position_for_hash(hash_code_t hash, pilot_type pilot, size_type range) noexcept {
+        hash_code_t mixed = (hash ^ (pilot * kPilotMultiplier)) * kMixMultiplier;
+        return reduce(static_cast<std::uint32_t>(mixed >> 32), range);
+    }
+
+    JSTD_FORCED_INLINE
+    size_type find_index(const key_type & key) const {
+        if (likely(this->mph_size_ != 0)) {
+            hash_code_t hash = this->hash_for(key);
+            pilot_type pilot = this->pilots_[this->bucket_for_hash(hash)];
+            size_type pos = position_for_hash(hash, pilot, this->mph_size_);
+            if (likely(this->key_equal_(this->slots_[pos].first, key))) {
+                return pos;
+            }
+            if (likely(this->mph_size_ == this->slot_size_)) {
+                return this->slot_size_;
+            }
+            for (pos = this->mph_size_; pos < this->slot_size_; pos++) {
+                if (this->key_equal_(this->slots_[pos].first, key)) {
+                    return pos;
+                }
+            }
+        }
+        return this->slot_size_;
+    }
+
+    void destroy() noexcept {
+        if (this->slots_ != nullptr) {
+            for (size_type i = 0; i < this->slot_size_; i++) {
+                AllocTraits::destroy(this->allocator_, &this->slots_[i]);
+            }
+            AllocTraits::deallocate(this->allocator_, this->slots_, this->slot_size_);
+            this->slots_ = nullptr;
+        }
+        if (this->pilots_ != nullptr) {
+            PilotAllocTraits::deallocate(this->pilot_allocator_, this->pilots_, this->pilot_size_);
+            this->pilots_ = nullptr;
+        }
+        this->slot_size_ = 0;
+        this->mph_size_ = 0;
+        this->pilot_size_ = 0;
+        this->dense_buckets_ = 0;
+    }
+
+    void copy_from(const frozen_map & other) {
+        if (other.slot_size_ == 0)
+            return;
+
+        // The pilots are owned by *this only after the slots are constructed,
+        // the copy constructor doesn't call destroy() if a slot copy throws.
+        pilot_type * pilots = PilotAllocTraits::allocate(this->pilot_allocator_, other.pilot_size_);
+        if (other.pilot_size_ != 0) {
+            std::copy(other.pilots_, other.pilots_ + other.pilot_size_, pilots);
+        }
+
+        const value_type * const src_slots = other.slots_;
+        try {
+            this->construct_slots(other.slot_size_, [src_slots](size_type index) -> const value_type & {
+                return src_slots[index];
+            });
+        } catch (...) {
+            PilotAllocTraits::deallocate(this->pilot_allocator_, pilots, other.pilot_size_);
+            throw;
+        }
+
+        this->pilots_ = pilots;
+        this->pilot_size_ = other.pilot_size_;
+        this->dense_buckets_ = other.dense_buckets_;
+        this->mph_size_ = other.mph_size_;
+    }
+
+    //
+    // Allocate the slots and construct slot[i] from source(i) in order,
+    // all the constructed slots are destroyed if one of them throws.
+    //
+    template <typename SourceFn>
+    void construct_slots(size_type slot_size, SourceFn && source) {
+        value_type * slots = AllocTraits::allocate(this->allocator_, slot_size);
+        size_type index = 0;
+        try {
+            for (; index < slot_size; index++) {
+                AllocTraits::construct(this->allocator_, &slots[index], source(index));
+            }
+        } catch (...) {
+            while (index > 0) {
+                index--;
+                AllocTraits::destroy(this->allocator_, &slots[index]);
+            }
+            AllocTraits::deallocate(this->allocator_, slots, slot_size);
+            throw;
+        }
+        this->slots_ = slots;
+        this->slot_size_ = slot_size;
+    }
+
+    struct key_hash {
+        hash_code_t hash;
+        size_type   index;
+    };
+
+    template <typename ForwardIterator>
+    void build(ForwardIterator first, ForwardIterator last) {
+        typedef typename std::iterator_traits<ForwardIterator>::iterator_category iterator_category;
+        static_assert(std::is_base_of<std::forward_iterator_tag, iterator_category>::value,
+                      "frozen_map<K, V>: The input iterator must be a forward iterator.");
+
+        std::vector<ForwardIterator> sources;
+        for (ForwardIterator iter = first; iter != last; ++iter) {
+            sources.push_back(iter);
+        }
+        if (sources.empty())
+            return;
+        if (sources.size() > this->max_size()) {
+            throw std::length_error("frozen_map: too many keys");
+        }
+
+        // The raw hash codes of Hash, sorted, to remove the duplicate keys
+        // and find the keys that have a duplicate hash code.
+        std::vector<key_hash> raw_hashes(sources.size());
+        for (size_type i = 0; i < sources.size(); i++) {
+            raw_hashes[i].hash = static_cast<hash_code_t>(this->hasher_((*sources[i]).first));
+            raw_hashes[i].index = i;
+        }
+        std::sort(raw_hashes.begin(), raw_hashes.end(), [](const key_hash & lhs, const key_hash & rhs) {
+            return (lhs.hash < rhs.hash) || ((lhs.hash == rhs.hash) && (lhs.index < rhs.index));
+        });
+
+        std::vector<size_type> mph_keys;
+        std::vector<size_type> collision_keys;
+        mph_keys.reserve(sources.size());
+        for (size_type first_dup = 0; first_dup < raw_hashes.size(); ) {
+            size_type last_dup = first_dup + 1;
+            while (last_dup < raw_hashes.size() && raw_hashes[last_dup].hash == raw_hashes[first_dup].hash) {
+                last_dup++;
+            }
+            mph_keys.push_back(raw_hashes[first_dup].index);
+            for (size_type i = first_dup + 1; i < last_dup; i++) {
+                size_type index = raw_hashes[i].index;
+                bool is_duplicate = false;
+                for (size_type j = first_dup; j < i; j++) {
+                    if (this->key_equal_((*sources[raw_hashes[j].index]).first, (*sources[index]).first)) {
+                        is_duplicate = true;
+                        break;
+                    }
+                }
+                if (!is_duplicate) {
+                    collision_keys.push_back(index);
+                }
+            }
+            first_dup = last_dup;
+        }
+        std::vector<key_hash>().swap(raw_hashes);
+
+        size_type mph_size = mph_keys.size();
+        size_type pilot_size = (mph_size + kBucketLoad - 1) / kBucketLoad;
+
+        std::vector<pilot_type> pilots;
+        std::vector<size_type> positions;
+        hash_code_t seed = this->seed_;
+        bool is_ok = false;
+        for (size_type retry = 0; retry < kMaxSeedRetries; retry++) {
+            if (this->search_pilots(sources, mph_keys, seed, pilot_size, pilots, positions)) {
+                is_ok = true;
+                break;
+            }
+            seed = hashes::mum_mul_mix64(seed + kPilotMultiplier, kMixMultiplier);
+        }
+        if (!is_ok) {
+            throw std::runtime_error("frozen_map: can not build the minimal perfect hash");
+        }
+
+        // positions[pos] is the source index of the key that's placed at pos.
+        for (size_type i = 0; i < collision_keys.size(); i++) {
+            positions.push_back(collision_keys[i]);
+        }
+
+        pilot_type * new_pilots = PilotAllocTraits::allocate(this->pilot_allocator_, pilot_size);
+        std::copy(pilots.begin(), pilots.end(), new_pilots);
+
+        try {
+            this->construct_slots(positions.size(), [&sources, &positions](size_type index)
+                                                    -> decltype(*sources[0]) {
+                return *sources[positions[index]];
+            });
+        } catch (...) {
+            PilotAllocTraits::deallocate(this->pilot_allocator_, new_pilots, pilot_size);
+            throw;
+        }
+
+        this->pilots_ = new_pilots;
+        this->pilot_size_ = pilot_size;
+        this->mph_size_ = mph_size;
+        this->seed_ = seed;
+    }
+
+    //
+    // Search the pilot of each bucket, from the largest bucket to the smallest.
+    // Returns false if a bucket can't be placed in a reasonable number of tries,
+    // then the caller will retry with another seed.
+    //
+    template <typename ForwardIterator>
+    bool search_pilots(const std::vector<ForwardIterator> & sources,
+                       const std::vector<size_type> & mph_keys,
+                       hash_code_t seed, size_type pilot_size,
+                       std::vector<pilot_type> & pilots,
+                       std::vector<size_type> & positions) {
+        size_type mph_size = mph_keys.size();
+        this->seed_ = seed;
+        this->pilot_size_ = pilot_size;
+        this->dense_buckets_ = pilot_size * 3 / 10;
+
+        std::vector<hash_code_t> hashes(mph_size);
+        std::vector<size_type> bucket_first(pilot_size + 1, 0);
+        for (size_type i = 0; i < mph_size; i++) {
+            hashes[i] = this->hash_for((*sources[mph_keys[i]]).first);
+            bucket_first[this->bucket_for_hash(hashes[i]) + 1]++;
+        }
+
+        // Counting sort the keys by bucket.
+        size_type max_bucket_size = 0;
+        for (size_type bucket = 0; bucket < pilot_size; bucket++) {
+            max_bucket_size = (std::max)(max_bucket_size, bucket_first[bucket + 1]);
+            bucket_first[bucket + 1] += bucket_first[bucket];
+        }
+        std::vector<size_type> bucket_keys(mph_size);
+        {
+            std::vector<size_type> cursor(bucket_first.begin(), bucket_first.end() - 1);
+            for (size_type i = 0; i < mph_size; i++) {
+                size_type bucket = this->bucket_for_hash(hashes[i]);
+                bucket_keys[cursor[bucket]++] = i;
+            }
+        }
+
+        // Counting sort the buckets by size, the largest first.
+        std::vector<size_type> size_first(max_bucket_size + 2, 0);
+        for (size_type bucket = 0; bucket < pilot_size; bucket++) {
+            size_type bucket_size = bucket_first[bucket + 1] - bucket_first[bucket];
+            size_first[max_bucket_size - bucket_size + 1]++;
+        }
+        for (size_type i = 0; i <= max_bucket_size; i++) {
+            size_first[i + 1] += size_first[i];
+        }
+        std::vector<size_type> bucket_order(pilot_size);
+        for (size_type bucket = 0; bucket < pilot_size; bucket++) {
+            size_type bucket_size = bucket_first[bucket + 1] - bucket_first[bucket];
+            bucket_order[size_first[max_bucket_size - bucket_size]++] = bucket;
+        }
+
+        // The occupied slots, a bitmap is small enough to stay in the L2 cache,
+        // the last buckets need a lot of tries when the table is almost full.
+        std::vector<std::uint64_t> used_bitmap((mph_size + 63) / 64, 0);
+        positions.assign(mph_size, 0);
+        pilots.assign(pilot_size, 0);
+
+        // A single key needs about (mph_size / free slots) tries, so it's enough.
+        // A pilot must fit in pilot_type, the wrapped pilots would only repeat the
+        // tries, so give up at the end of pilot_type and let the caller reseed.
+        const std::uint64_t max_pilot_tries =
+            static_cast<std::uint64_t>((std::numeric_limits<pilot_type>::max)()) + 1;
+        const std::uint64_t max_tries = (std::min)(static_cast<std::uint64_t>(mph_size) * 64 + 1024,
+                                                   max_pilot_tries);
+        std::vector<size_type> taken(max_bucket_size);
+
+        for (size_type order = 0; order < pilot_size; order++) {
+            size_type bucket = bucket_order[order];
+            size_type key_first = bucket_first[bucket];
+            size_type key_last = bucket_first[bucket + 1];
+            size_type bucket_size = key_last - key_first;
+            if (bucket_size == 0)
+                break;
+
+            std::uint64_t pilot = 0;
+            for (; pilot < max_tries; pilot++) {
+                size_type num_taken = 0;
+                for (size_type k = key_first; k < key_last; k++) {
+                    size_type pos = position_for_hash(hashes[bucket_keys[k]],
+                                                      static_cast<pilot_type>(pilot), mph_size);
+                    std::uint64_t bit = std::uint64_t(1) << (pos % 64);
+                    if ((used_bitmap[pos / 64] & bit) != 0)
+                        break;
+                    used_bitmap[pos / 64] |= bit;
+                    taken[num_taken++] = pos;
+                }
+                if (num_taken == bucket_size)
+                    break;
+                // Rollback, includes the keys of this bucket that collide with each other.
+                for (size_type t = 0; t < num_taken; t++) {
+                    used_bitmap[taken[t] / 64] &= ~(std::uint64_t(1) << (taken[t] % 64));
+                }
+            }
+            if (pilot >= max_tries)
+                return false;
+
+            pilots[bucket] = static_cast<pilot_type>(pilot);
+            for (size_type t = 0; t < bucket_size; t++) {
+                positions[taken[t]] = mph_keys[bucket_keys[key_first + t]];
+            }
+        }
+        return true;
+    }
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+inline void swap(frozen_map<Key, Value, Hash, KeyEqual, Allocator> & lhs,
+                 frozen_map<Key, Value, Hash, KeyEqual, Allocator> & rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+//
+// Build a frozen_map from a map, with the same hasher, key_equal and allocator.
+//
+template <typename Map>
+inline
+frozen_map<typename Map::key_type, typename Map::mapped_type,
+           typename Map::hasher, typename Map::key_equal, typename Map::allocator_type>
+freeze(const Map & map) {
+    typedef frozen_map<typename Map::key_type, typename Map::mapped_type,
+                       typename Map::hasher, typename Map::key_equal,
+                       typename Map::allocator_type> frozen_map_type;
+    typedef typename frozen_map_type::allocator_type allocator_type;
+    return frozen_map_type(map.begin(), map.end(), map.hash_function(), map.key_eq(),
+                           allocator_type(map.get_allocator()));
+}
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_FROZEN_MAP_HPP
@@ -0,0 +1,1085 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_GROUP15_COW_FLAT_MAP_HPP
+#define JSTD_HASHMAP_GROUP15_COW_FLAT_MAP_HPP
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>              // For std::memcpy()
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>               // For std::allocator<T>
+#include <functional>           // For std::hash<Key>
+#include <initializer_list>
+#include <iterator>             // For std::forward_iterator_tag
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>
+#include <tuple>                // For std::forward_as_tuple()
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+
+#include <assert.h>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/support/BitUtils.h"
+
+#include "jstd/hashmap/flat_map_type_policy.hpp"
+#include "jstd/hashmap/flat_map_slot_policy.hpp"
+#include "jstd/hashmap/slot_policy_traits.h"
+#include "jstd/hashmap/flat_map_group15.hpp"
+#include "jstd/hashmap/group_quadratic_prober.hpp"
+#include "jstd/hashmap/hash_token.hpp"
+
+namespace jstd {
+
+//
+// The iterator of group15_cow_flat_map, a position is (group index, pos in the group).
+// The values can't be modified by the iterators, because the slot may be shared
+// by a snapshot, end() is (group_capacity, 0).
+//
+template <typename HashMap>
+class group15_cow_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+
+    using value_type = const typename HashMap::value_type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+    using hashmap_type = HashMap;
+    using slot_type = typename HashMap::slot_type;
+    using size_type = typename HashMap::size_type;
+    using difference_type = typename HashMap::difference_type;
+
+private:
+    const hashmap_type * hashmap_;
+    size_type            group_index_;
+    size_type            pos_;
+
+    friend HashMap;
+
+public:
+    group15_cow_iterator() noexcept : hashmap_(nullptr), group_index_(0), pos_(0) {}
+    group15_cow_iterator(const hashmap_type * hashmap, size_type group_index, size_type pos) noexcept
+        : hashmap_(hashmap), group_index_(group_index), pos_(pos) {}
+
+    group15_cow_iterator(const group15_cow_iterator & src) noexcept = default;
+    group15_cow_iterator & operator = (const group15_cow_iterator & rhs) noexcept = default;
+
+    friend inline bool operator == (const group15_cow_iterator & lhs,
+                                    const group15_cow_iterator & rhs) noexcept {
+        return (lhs.group_index_ == rhs.group_index_) && (lhs.pos_ == rhs.pos_);
+    }
+
+    friend inline bool operator != (const group15_cow_iterator & lhs,
+                                    const group15_cow_iterator & rhs) noexcept {
+        return (lhs.group_index_ != rhs.group_index_) || (lhs.pos_ != rhs.pos_);
+    }
+
+    group15_cow_iterator & operator ++ () noexcept {
+        this->increment();
+        return *this;
+    }
+
+    group15_cow_iterator operator ++ (int) noexcept {
+        group15_cow_iterator copy(*this);
+        this->increment();
+        return copy;
+    }
+
+    reference operator * () const noexcept {
+        return this->hashmap_->slot_at(this->group_index_, this->pos_)->value;
+    }
+
+    pointer operator -> () const noexcept {
+        return std::addressof(this->operator*());
+    }
+
+    size_type group_index() const noexcept { return this->group_index_; }
+    size_type pos() const noexcept { return this->pos_; }
+
+private:
+    void increment() noexcept {
+        assert(this->hashmap_ != nullptr);
+        // The used slots after pos_ in this group, then the next groups.
+        std::uint32_t used_mask = this->hashmap_->group_at(this->group_index_)->match_used();
+        used_mask &= ~((std::uint32_t(2) << this->pos_) - 1);
+        while (used_mask == 0) {
+            this->group_index_++;
+            if (this->group_index_ >= this->hashmap_->group_capacity()) {
+                this->pos_ = 0;
+                return;
+            }
+            used_mask = this->hashmap_->group_at(this->group_index_)->match_used();
+        }
+        this->pos_ = static_cast<size_type>(BitUtils::bsf32(used_mask));
+    }
+};
+
+template <typename HashMap>
+class group15_cow_snapshot;
+
+/*
+ * group15_cow_flat_map<K, V>: A group15 flat map whose copies and snapshots share the storage,
+ * and copy it on write, by pages.
+ *
+ * The groups and the slots are not two arrays, but fixed-size pages of kPageGroups groups
+ * and their slots (a page of <uint64_t, uint64_t> is 1 KB of groups and 15 KB of slots).
+ * Each page has a reference count. A copy or a snapshot() only copies the page table
+ * and adds a reference to each page, so it costs one pointer per 960 entries.
+ * Before a write to a page, the writer checks the count: if the page is shared, it
+ * copies the page first and drops its reference to the old one. So the writes after
+ * a snapshot pay for the pages that they touch only, and the snapshot keeps the old ones.
+ *
+ * The lookup and the insertion are the same as group15_flat_map (a ctrl byte per slot,
+ * SSE2 group match, quadratic probe of the groups), plus one load of the page pointer.
+ * A rehash builds new pages, and the snapshots keep the old ones alive.
+ *
+ * Because a slot may be shared, the iterators are read-only (like std::set), and the
+ * values are modified by operator [], insert_or_assign(), or the non-const at().
+ * The references returned by them are invalidated by the next copy or snapshot().
+ *
+ * Threads: a snapshot may be read by another thread while the map is modified,
+ * the page counts are atomic. The map itself is not thread-safe, snapshot() must be
+ * called by the writer (or under its lock).
+ */
+template <typename Key, typename Value,
+          typename Hash = std::hash< typename std::remove_const<Key>::type >,
+          typename KeyEqual = std::equal_to< typename std::remove_const<Key>::type >,
+          typename Allocator = std::allocator< std::pair<const typename std::remove_const<Key>::type,
+                                                         typename std::remove_const<Value>::type> > >
+class JSTD_DLL group15_cow_flat_map
+{
+public:
+    typedef flat_map_type_policy<Key, Value>    type_policy;
+    typedef std::size_t                         size_type;
+    typedef std::intptr_t                       ssize_type;
+    typedef std::ptrdiff_t                      difference_type;
+
+    typedef typename type_policy::key_type      key_type;
+    typedef typename type_policy::mapped_type   mapped_type;
+    typedef typename type_policy::value_type    value_type;
+    typedef typename type_policy::init_type     init_type;
+    typedef typename type_policy::element_type  element_type;
+    typedef Hash                                hasher;
+    typedef KeyEqual                            key_equal;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>
+                                                allocator_type;
+
+    typedef value_type &                        reference;
+    typedef value_type const &                  const_reference;
+
+    using this_type = group15_cow_flat_map<Key, Value, Hash, KeyEqual, Allocator>;
+
+    using ctrl_type = group15_meta_ctrl;
+    using group_type = flat_map_group15<group15_meta_ctrl>;
+    using prober_type = group_quadratic_prober;
+
+    using slot_type = map_slot_type<key_type, mapped_type>;
+    using slot_policy_t = flat_map_slot_policy<slot_type>;
+    using SlotPolicyTraits = slot_policy_traits<slot_policy_t>;
+
+    using iterator       = group15_cow_iterator<this_type>;
+    using const_iterator = group15_cow_iterator<this_type>;
+    using snapshot_type  = group15_cow_snapshot<this_type>;
+
+    static constexpr size_type kGroupSize  = group_type::kGroupSize;
+    static constexpr size_type kGroupWidth = group_type::kGroupWidth;
+
+    // The groups of a page, must be a power of 2. The small tables have one smaller page.
+    static constexpr size_type kPageGroups = 64;
+    static constexpr size_type kPageAlignment = 64;
+
+    static constexpr size_type kMinGroupCapacity = 2;
+
+    static constexpr float kDefaultLoadFactorF = 0.875f;
+    // Default load factor = 224 / 256 = 0.875
+    static constexpr size_type kLoadFactorAmplify = 256;
+    static constexpr size_type kDefaultMaxLoadFactor =
+        static_cast<size_type>((double)kLoadFactorAmplify * (double)kDefaultLoadFactorF + 0.5);
+
+    static constexpr bool kIsSlotTrivialDestructor =
+            (std::is_trivially_destructible<key_type>::value &&
+             std::is_trivially_destructible<mapped_type>::value);
+
+    static_assert((kPageGroups & (kPageGroups - 1)) == 0, "kPageGroups must be a power of 2");
+    static_assert(alignof(slot_type) <= kPageAlignment, "The alignment of slot_type is too large");
+
+private:
+    friend class group15_cow_iterator<this_type>;
+
+    struct alignas(kPageAlignment) page_block {
+        unsigned char bytes[kPageAlignment];
+    };
+
+    // The header of a page, the groups and then the slots follow it.
+    struct page_type {
+        std::atomic<size_type> refs;
+
+        page_type() noexcept : refs(1) {}
+    };
+
+    using page_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<page_block>;
+    using slot_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>;
+    using page_ptr_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<page_type *>;
+
+    using PageAllocTraits = typename std::allocator_traits<allocator_type>::template rebind_traits<page_block>;
+
+    using page_list = std::vector<page_type *, page_ptr_allocator_type>;
+
+    page_list               pages_;
+    size_type               group_mask_;
+    size_type               page_groups_;
+    size_type               page_shift_;
+    size_type               slot_size_;
+    size_type               slot_threshold_;
+    size_type               copied_pages_;
+
+    hasher                  hasher_;
+    key_equal               key_equal_;
+    allocator_type          allocator_;
+    page_allocator_type     page_allocator_;
+    slot_allocator_type     slot_allocator_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    group15_cow_flat_map() : group15_cow_flat_map(0) {}
+
+    explicit group15_cow_flat_map(size_type capacity, hasher const & hash = hasher(),
+                                  key_equal const & pred = key_equal(),
+                                  allocator_type const & allocator = allocator_type())
+        : pages_(page_ptr_allocator_type(allocator)), group_mask_(0), page_groups_(0), page_shift_(0),
+          slot_size_(0), slot_threshold_(0), copied_pages_(0),
+          hasher_(hash), key_equal_(pred), allocator_(allocator),
+          page_allocator_(allocator), slot_allocator_(allocator) {
+        if (capacity != 0) {
+            this->reserve(capacity);
+        }
+    }
+
+    template <typename Iterator>
+    group15_cow_flat_map(Iterator first, Iterator last, size_type capacity = 0,
+                         hasher const & hash = hasher(), key_equal const & pred = key_equal(),
+                         allocator_type const & allocator = allocator_type())
+        : group15_cow_flat_map(capacity, hash, pred, allocator) {
+        this->insert(first, last);
+    }
+
+    group15_cow_flat_map(std::initializer_list<value_type> ilist,
+                         size_type capacity = 0, hasher const & hash = hasher(),
+                         key_equal const & pred = key_equal(),
+                         allocator_type const & allocator = allocator_type())
+        : group15_cow_flat_map(ilist.begin(), ilist.end(), capacity, hash, pred, allocator) {
+    }
+
+    //
+    // The copy shares all the pages with other, the pages are copied by the first write
+    // of either map.
+    //
+    group15_cow_flat_map(group15_cow_flat_map const & other)
+        : pages_(other.pages_), group_mask_(other.group_mask_), page_groups_(other.page_groups_),
+          page_shift_(other.page_shift_), slot_size_(other.slot_size_),
+          slot_threshold_(other.slot_threshold_), copied_pages_(0),
+          hasher_(other.hasher_), key_equal_(other.key_equal_), allocator_(other.allocator_),
+          page_allocator_(other.page_allocator_), slot_allocator_(other.slot_allocator_) {
+        for (size_type i = 0; i < this->pages_.size(); i++) {
+            this->pages_[i]->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    group15_cow_flat_map(group15_cow_flat_map && other) noexcept
+        : pages_(std::move(other.pages_)), group_mask_(other.group_mask_),
+          page_groups_(other.page_groups_), page_shift_(other.page_shift_),
+          slot_size_(other.slot_size_), slot_threshold_(other.slot_threshold_),
+          copied_pages_(other.copied_pages_),
+          hasher_(std::move(other.hasher_)), key_equal_(std::move(other.key_equal_)),
+          allocator_(std::move(other.allocator_)),
+          page_allocator_(std::move(other.page_allocator_)),
+          slot_allocator_(std::move(other.slot_allocator_)) {
+        other.pages_.clear();
+        other.reset_table();
+    }
+
+    ~group15_cow_flat_map() {
+        this->destroy();
+    }
+
+    group15_cow_flat_map & operator = (group15_cow_flat_map const & other) {
+        if (std::addressof(other) != this) {
+            this_type tmp(other);
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    group15_cow_flat_map & operator = (group15_cow_flat_map && other) noexcept {
+        if (std::addressof(other) != this) {
+            this_type tmp(std::move(other));
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    ///
+    /// Observers
+    ///
+    allocator_type get_allocator() const noexcept {
+        return this->allocator_;
+    }
+
+    hasher hash_function() const noexcept {
+        return this->hasher_;
+    }
+
+    key_equal key_eq() const noexcept {
+        return this->key_equal_;
+    }
+
+    static const char * name() noexcept {
+        return "jstd::group15_cow_flat_map";
+    }
+
+    ///
+    /// Iterators
+    ///
+    const_iterator begin() const noexcept {
+        return this->first_used_iterator();
+    }
+
+    const_iterator end() const noexcept {
+        return { this, this->group_capacity(), 0 };
+    }
+
+    const_iterator cbegin() const noexcept { return this->begin(); }
+    const_iterator cend() const noexcept { return this->end(); }
+
+    ///
+    /// Capacity
+    ///
+    bool empty() const noexcept { return (this->size() == 0); }
+    size_type size() const noexcept { return this->slot_size_; }
+    size_type capacity() const noexcept { return this->slot_capacity(); }
+
+    size_type max_size() const noexcept {
+        return (std::numeric_limits<difference_type>::max)() / sizeof(slot_type);
+    }
+
+    size_type slot_size() const noexcept { return this->slot_size_; }
+    size_type slot_capacity() const noexcept { return (this->group_capacity() * kGroupSize); }
+    size_type slot_threshold() const noexcept { return this->slot_threshold_; }
+
+    size_type group_mask() const noexcept { return this->group_mask_; }
+    size_type group_capacity() const noexcept {
+        return (this->pages_.empty() ? 0 : (this->group_mask_ + 1));
+    }
+
+    bool is_valid() const noexcept { return !this->pages_.empty(); }
+
+    float load_factor() const noexcept {
+        return (this->slot_capacity() != 0) ? ((float)this->size() / this->slot_capacity()) : 0.0f;
+    }
+
+    ///
+    /// Pages
+    ///
+    size_type page_count() const noexcept { return this->pages_.size(); }
+    size_type page_groups() const noexcept { return this->page_groups_; }
+    size_type page_bytes() const noexcept { return this_type::page_blocks(this->page_groups_) * sizeof(page_block); }
+
+    // The number of the pages that are shared with a copy or a snapshot.
+    size_type shared_page_count() const noexcept {
+        size_type shared_pages = 0;
+        for (size_type i = 0; i < this->pages_.size(); i++) {
+            shared_pages += (this->pages_[i]->refs.load(std::memory_order_relaxed) != 1);
+        }
+        return shared_pages;
+    }
+
+    // The total number of the pages that have been copied on write.
+    size_type copied_pages() const noexcept { return this->copied_pages_; }
+
+    ///
+    /// Snapshot
+    ///
+    /// A read-only copy that shares the pages, see group15_cow_snapshot.
+    ///
+    snapshot_type snapshot() const {
+        return snapshot_type(*this);
+    }
+
+    void reserve(size_type new_capacity) {
+        size_type new_group_capacity = this->calc_group_capacity(new_capacity);
+        if (new_group_capacity > this->group_capacity()) {
+            this->rehash_impl(new_group_capacity);
+        }
+    }
+
+    void rehash(size_type new_capacity) {
+        size_type min_capacity = (std::max)(new_capacity, this->size());
+        size_type new_group_capacity = this->calc_group_capacity(min_capacity);
+        if (new_group_capacity != this->group_capacity()) {
+            this->rehash_impl(new_group_capacity);
+        }
+    }
+
+    ///
+    /// Lookup
+    ///
+    size_type count(const key_type & key) const {
+        size_type group_index, pos;
+        return (this->find_position(key, group_index, pos) ? 1 : 0);
+    }
+
+    bool contains(const key_type & key) const {
+        size_type group_index, pos;
+        return this->find_position(key, group_index, pos);
+    }
+
+    const_iterator find(const key_type & key) const {
+        size_type group_index, pos;
+        if (this->find_position(key, group_index, pos))
+            return { this, group_index, pos };
+        else
+            return this->end();
+    }
+
+    const mapped_type & at(const key_type & key) const {
+        size_type group_index, pos;
+        if (this->find_position(key, group_index, pos)) {
+            return this->slot_at(group_index, pos)->value.second;
+        }
+        throw std::out_of_range("key was not found in group15_cow_flat_map");
+    }
+
+    // The page of the key is copied first if it's shared.
+    mapped_type & at(const key_type & key) {
+        size_type group_index, pos;
+        if (this->find_position(key, group_index, pos)) {
+            return this->mutable_slot_at(group_index, pos)->value.second;
+        }
+        throw std::out_of_range("key was not found in group15_cow_flat_map");
+    }
+
+    mapped_type & operator [] (const key_type & key) {
+        const_iterator iter = this->try_emplace_impl(key).first;
+        return this->mutable_slot_at(iter.group_index_, iter.pos_)->value.second;
+    }
+
+    mapped_type & operator [] (key_type && key) {
+        const_iterator iter = this->try_emplace_impl(std::move(key)).first;
+        return this->mutable_slot_at(iter.group_index_, iter.pos_)->value.second;
+    }
+
+    ///
+    /// Modifiers
+    ///
+    void clear() noexcept {
+        this->destroy();
+    }
+
+    std::pair<iterator, bool> insert(const value_type & value) {
+        return this->try_emplace_impl(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type && value) {
+        return this->try_emplace_impl(value.first, std::move(value.second));
+    }
+
+    std::pair<iterator, bool> insert(const init_type & value) {
+        return this->try_emplace_impl(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(init_type && value) {
+        return this->try_emplace_impl(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename InputIter>
+    void insert(InputIter first, InputIter last) {
+        for (; first != last; ++first) {
+            this->insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert(ilist.begin(), ilist.end());
+    }
+
+    template <typename MappedT>
+    std::pair<iterator, bool> insert_or_assign(const key_type & key, MappedT && value) {
+        return this->insert_or_assign_impl(key, std::forward<MappedT>(value));
+    }
+
+    template <typename MappedT>
+    std::pair<iterator, bool> insert_or_assign(key_type && key, MappedT && value) {
+        return this->insert_or_assign_impl(std::move(key), std::forward<MappedT>(value));
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> emplace(Args && ... args) {
+        init_type value(std::forward<Args>(args)...);
+        return this->try_emplace_impl(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> try_emplace(const key_type & key, Args && ... args) {
+        return this->try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> try_emplace(key_type && key, Args && ... args) {
+        return this->try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    size_type erase(const key_type & key) {
+        size_type group_index, pos;
+        if (this->find_position(key, group_index, pos)) {
+            this->erase_at(group_index, pos);
+            return 1;
+        }
+        return 0;
+    }
+
+    // The erasure doesn't move the other entries, returns the next iterator.
+    iterator erase(const_iterator pos) {
+        this->erase_at(pos.group_index_, pos.pos_);
+        ++pos;
+        return pos;
+    }
+
+    void swap(this_type & other) noexcept {
+        using std::swap;
+        swap(this->pages_, other.pages_);
+        swap(this->group_mask_, other.group_mask_);
+        swap(this->page_groups_, other.page_groups_);
+        swap(this->page_shift_, other.page_shift_);
+        swap(this->slot_size_, other.slot_size_);
+        swap(this->slot_threshold_, other.slot_threshold_);
+        swap(this->copied_pages_, other.copied_pages_);
+        swap(this->hasher_, other.hasher_);
+        swap(this->key_equal_, other.key_equal_);
+        swap(this->allocator_, other.allocator_);
+        swap(this->page_allocator_, other.page_allocator_);
+        swap(this->slot_allocator_, other.slot_allocator_);
+    }
+
+    friend void swap(this_type & lhs, this_type & rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+private:
+    ///
+    /// Page layout
+    ///
+    static size_type page_groups_bytes(size_type page_groups) noexcept {
+        size_type groups_bytes = page_groups * sizeof(group_type);
+        return ((groups_bytes + kPageAlignment - 1) / kPageAlignment * kPageAlignment);
+    }
+
+    static size_type page_blocks(size_type page_groups) noexcept {
+        size_type bytes = kPageAlignment + this_type::page_groups_bytes(page_groups) +
+                          page_groups * kGroupSize * sizeof(slot_type);
+        return ((bytes + sizeof(page_block) - 1) / sizeof(page_block));
+    }
+
+    static group_type * page_groups_of(page_type * page) noexcept {
+        return reinterpret_cast<group_type *>(reinterpret_cast<unsigned char *>(page) + kPageAlignment);
+    }
+
+    static const group_type * page_groups_of(const page_type * page) noexcept {
+        return reinterpret_cast<const group_type *>(reinterpret_cast<const unsigned char *>(page) + kPageAlignment);
+    }
+
+    static slot_type * page_slots_of(page_type * page, size_type page_groups) noexcept {
+        return reinterpret_cast<slot_type *>(reinterpret_cast<unsigned char *>(page) + kPageAlignment +
+                                             this_type::page_groups_bytes(page_groups));
+    }
+
+    static const slot_type * page_slots_of(const page_type * page, size_type page_groups) noexcept {
+        return reinterpret_cast<const slot_type *>(reinterpret_cast<const unsigned char *>(page) + kPageAlignment +
+                                                   this_type::page_groups_bytes(page_groups));
+    }
+
+    JSTD_FORCED_INLINE
+    const group_type * group_at(size_type group_index) const noexcept {
+        assert(group_index < this->group_capacity());
+        const page_type * page = this->pages_[group_index >> this->page_shift_];
+        return (this_type::page_groups_of(page) + (group_index & (this->page_groups_ - 1)));
+    }
+
+    JSTD_FORCED_INLINE
+    const slot_type * slot_at(size_type group_index, size_type pos) const noexcept {
+        assert(group_index < this->group_capacity());
+        const page_type * page = this->pages_[group_index >> this->page_shift_];
+        return (this_type::page_slots_of(page, this->page_groups_) +
+                (group_index & (this->page_groups_ - 1)) * kGroupSize + pos);
+    }
+
+    //
+    // The page of the group, for a write. If the page is shared with a copy or a snapshot,
+    // it's replaced by a private copy first.
+    //
+    JSTD_FORCED_INLINE
+    page_type * mutable_page_at(size_type group_index) {
+        size_type page_index = group_index >> this->page_shift_;
+        page_type * page = this->pages_[page_index];
+        // Acquire: the reads of the last other owner are done before we write to the page.
+        if (likely(page->refs.load(std::memory_order_acquire) == 1))
+            return page;
+        else
+            return this->copy_page(page_index);
+    }
+
+    JSTD_FORCED_INLINE
+    group_type * mutable_group_at(size_type group_index) {
+        page_type * page = this->mutable_page_at(group_index);
+        return (this_type::page_groups_of(page) + (group_index & (this->page_groups_ - 1)));
+    }
+
+    JSTD_FORCED_INLINE
+    slot_type * mutable_slot_at(size_type group_index, size_type pos) {
+        page_type * page = this->mutable_page_at(group_index);
+        return (this_type::page_slots_of(page, this->page_groups_) +
+                (group_index & (this->page_groups_ - 1)) * kGroupSize + pos);
+    }
+
+    const_iterator first_used_iterator() const noexcept {
+        if (this->size() != 0) {
+            for (size_type group_index = 0; group_index < this->group_capacity(); group_index++) {
+                std::uint32_t used_mask = this->group_at(group_index)->match_used();
+                if (used_mask != 0) {
+                    return { this, group_index, static_cast<size_type>(BitUtils::bsf32(used_mask)) };
+                }
+            }
+        }
+        return this->end();
+    }
+
+    ///
+    /// Pages
+    ///
+    page_type * allocate_page() {
+        page_block * blocks = PageAllocTraits::allocate(this->page_allocator_,
+                                                      this_type::page_blocks(this->page_groups_));
+        page_type * page = new (static_cast<void *>(blocks)) page_type();
+        group_type * groups = this_type::page_groups_of(page);
+        for (size_type i = 0; i < this->page_groups_; i++) {
+            groups[i].init();
+        }
+        return page;
+    }
+
+    void deallocate_page(page_type * page, size_type page_groups) noexcept {
+        page->~page_type();
+        PageAllocTraits::deallocate(this->page_allocator_, reinterpret_cast<page_block *>(page),
+                                    this_type::page_blocks(page_groups));
+    }
+
+    void destroy_page_slots(page_type * page, size_type page_groups) noexcept {
+        if (!kIsSlotTrivialDestructor) {
+            const group_type * groups = this_type::page_groups_of(page);
+            slot_type * slots = this_type::page_slots_of(page, page_groups);
+            for (size_type i = 0; i < page_groups; i++) {
+                std::uint32_t used_mask = groups[i].match_used();
+                while (used_mask != 0) {
+                    size_type pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                    used_mask = BitUtils::clearLowBit32(used_mask);
+                    SlotPolicyTraits::destroy(&this->slot_allocator_, slots + i * kGroupSize + pos);
+                }
+            }
+        }
+    }
+
+    // Drop a reference to the page, the last owner destroys it.
+    void release_page(page_type * page, size_type page_groups) noexcept {
+        if (page->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->destroy_page_slots(page, page_groups);
+            this->deallocate_page(page, page_groups);
+        }
+    }
+
+    //
+    // Copy on write: replace the shared page by a private copy, and drop the reference
+    // to the shared one.
+    //
+    JSTD_NO_INLINE
+    page_type * copy_page(size_type page_index) {
+        page_type * old_page = this->pages_[page_index];
+        page_type * new_page = this->allocate_page();
+
+        const group_type * old_groups = this_type::page_groups_of(old_page);
+        group_type * new_groups = this_type::page_groups_of(new_page);
+        const slot_type * old_slots = this_type::page_slots_of(old_page, this->page_groups_);
+        slot_type * new_slots = this_type::page_slots_of(new_page, this->page_groups_);
+
+        size_type i = 0;
+        try {
+            for (; i < this->page_groups_; i++) {
+                std::uint32_t used_mask = old_groups[i].match_used();
+                while (used_mask != 0) {
+                    size_type pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                    used_mask = BitUtils::clearLowBit32(used_mask);
+                    size_type slot_index = i * kGroupSize + pos;
+                    SlotPolicyTraits::construct(&this->slot_allocator_, new_slots + slot_index,
+                                                old_slots + slot_index);
+                    new_groups[i].set_used(pos, old_groups[i].value(pos));
+                }
+                // The overflow bits.
+                std::memcpy((void *)&new_groups[i], (const void *)&old_groups[i], sizeof(group_type));
+            }
+        } catch (...) {
+            // The ctrl bytes of the new page mark the constructed slots.
+            this->destroy_page_slots(new_page, this->page_groups_);
+            this->deallocate_page(new_page, this->page_groups_);
+            throw;
+        }
+
+        this->pages_[page_index] = new_page;
+        this->release_page(old_page, this->page_groups_);
+        this->copied_pages_++;
+        return new_page;
+    }
+
+    void destroy() noexcept {
+        for (size_type i = 0; i < this->pages_.size(); i++) {
+            this->release_page(this->pages_[i], this->page_groups_);
+        }
+        this->pages_.clear();
+        this->reset_table();
+    }
+
+    void reset_table() noexcept {
+        this->group_mask_ = 0;
+        this->page_groups_ = 0;
+        this->page_shift_ = 0;
+        this->slot_size_ = 0;
+        this->slot_threshold_ = 0;
+    }
+
+    ///
+    /// Hash
+    ///
+    size_type calc_slot_threshold(size_type group_capacity) const noexcept {
+        return (group_capacity * kGroupSize * kDefaultMaxLoadFactor / kLoadFactorAmplify);
+    }
+
+    size_type calc_group_capacity(size_type capacity) const noexcept {
+        if (capacity == 0)
+            return 0;
+        size_type group_capacity = kMinGroupCapacity;
+        while (this->calc_slot_threshold(group_capacity) < capacity) {
+            group_capacity *= 2;
+        }
+        return group_capacity;
+    }
+
+    JSTD_FORCED_INLINE
+    std::size_t hash_for(const key_type & key) const
+        noexcept(noexcept(this->hasher_(key))) {
+        return hash_token<Hash>::mix_hash(static_cast<std::size_t>(this->hasher_(key)));
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(std::size_t key_hash) const noexcept {
+        return (static_cast<size_type>(key_hash) & this->group_mask_);
+    }
+
+    // The index uses the low bits, take the ctrl hash from the high bits.
+    JSTD_FORCED_INLINE
+    static std::uint8_t ctrl_for_hash(std::size_t key_hash) noexcept {
+        return ctrl_type::reduced_hash(key_hash >> (sizeof(std::size_t) * 8 - 8));
+    }
+
+    ///
+    /// Lookup and insertion
+    ///
+    JSTD_FORCED_INLINE
+    bool find_position(const key_type & key, size_type & group_index, size_type & pos) const {
+        if (unlikely(this->size() == 0))
+            return false;
+        return this->find_position(key, this->hash_for(key), group_index, pos);
+    }
+
+    JSTD_FORCED_INLINE
+    bool find_position(const key_type & key, std::size_t key_hash,
+                       size_type & group_index, size_type & pos) const {
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+        prober_type prober(this->index_for_hash(key_hash));
+        do {
+            group_index = prober.get();
+            // Load the page pointer once for the group and its slots.
+            const page_type * page = this->pages_[group_index >> this->page_shift_];
+            size_type page_group = group_index & (this->page_groups_ - 1);
+            const group_type * group = this_type::page_groups_of(page) + page_group;
+            std::uint32_t match_mask = group->match_hash(ctrl_hash);
+            if (match_mask != 0) {
+                const slot_type * slots = this_type::page_slots_of(page, this->page_groups_) + page_group * kGroupSize;
+                do {
+                    pos = static_cast<size_type>(BitUtils::bsf32(match_mask));
+                    if (likely(this->key_equal_(key, slots[pos].value.first))) {
+                        return true;
+                    }
+                    match_mask = BitUtils::clearLowBit32(match_mask);
+                } while (match_mask != 0);
+            }
+            // If it's not overflow, means it hasn't been found.
+            if (likely(group->is_not_overflow(ctrl_hash))) {
+                return false;
+            }
+        } while (prober.next_bucket(this->group_mask_));
+
+        return false;
+    }
+
+    //
+    // Find an empty slot for the hash, the overflow bits of the full groups on the way
+    // are set, only a group that doesn't have the bit yet is written (and copied).
+    //
+    void find_empty_to_insert(std::size_t key_hash, size_type & group_index, size_type & pos) {
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+        prober_type prober(this->index_for_hash(key_hash));
+        do {
+            group_index = prober.get();
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t empty_mask = group->match_empty();
+            if (empty_mask != 0) {
+                pos = static_cast<size_type>(BitUtils::bsf32(empty_mask));
+                return;
+            }
+            if (group->is_not_overflow(ctrl_hash)) {
+                this->mutable_group_at(group_index)->set_overflow(ctrl_hash);
+            }
+        } while (prober.next_bucket(this->group_mask_));
+
+        // The slot threshold is less than the slot capacity.
+        assert(false);
+    }
+
+    template <typename KeyT, typename ... Args>
+    std::pair<iterator, bool> try_emplace_impl(KeyT && key, Args && ... args) {
+        std::size_t key_hash = this->hash_for(key);
+        size_type group_index = 0, pos = 0;
+        if (likely(this->size() != 0)) {
+            if (this->find_position(key, key_hash, group_index, pos)) {
+                return { iterator(this, group_index, pos), false };
+            }
+        }
+
+        if (unlikely(this->slot_size_ >= this->slot_threshold_)) {
+            size_type new_group_capacity = this->is_valid() ? (this->group_capacity() * 2) : kMinGroupCapacity;
+            this->rehash_impl(new_group_capacity);
+        }
+
+        this->find_empty_to_insert(key_hash, group_index, pos);
+        page_type * page = this->mutable_page_at(group_index);
+        size_type page_group = group_index & (this->page_groups_ - 1);
+        slot_type * slot = this_type::page_slots_of(page, this->page_groups_) + page_group * kGroupSize + pos;
+        SlotPolicyTraits::construct(&this->slot_allocator_, slot,
+                                    std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<KeyT>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        this_type::page_groups_of(page)[page_group].set_used(pos, this->ctrl_for_hash(key_hash));
+        this->slot_size_++;
+        return { iterator(this, group_index, pos), true };
+    }
+
+    template <typename KeyT, typename MappedT>
+    std::pair<iterator, bool> insert_or_assign_impl(KeyT && key, MappedT && value) {
+        std::pair<iterator, bool> result = this->try_emplace_impl(std::forward<KeyT>(key),
+                                                                  std::forward<MappedT>(value));
+        if (!result.second) {
+            slot_type * slot = this->mutable_slot_at(result.first.group_index_, result.first.pos_);
+            slot->value.second = std::forward<MappedT>(value);
+        }
+        return result;
+    }
+
+    void erase_at(size_type group_index, size_type pos) {
+        page_type * page = this->mutable_page_at(group_index);
+        size_type page_group = group_index & (this->page_groups_ - 1);
+        group_type * group = this_type::page_groups_of(page) + page_group;
+        assert(group->is_used(pos));
+        // Like group15_flat_map, a slot of an overflowed group is not counted as free again.
+        if (group->is_overflow(group->value(pos))) {
+            assert(this->slot_threshold_ > 0);
+            this->slot_threshold_--;
+        }
+        SlotPolicyTraits::destroy(&this->slot_allocator_,
+            this_type::page_slots_of(page, this->page_groups_) + page_group * kGroupSize + pos);
+        group->set_empty(pos);
+        assert(this->slot_size_ > 0);
+        this->slot_size_--;
+    }
+
+    //
+    // Move all entries to new pages of new_group_capacity groups. The entries of a private
+    // page are moved, and the entries of a shared page are copied, the sharers keep it.
+    //
+    void rehash_impl(size_type new_group_capacity) {
+        assert(new_group_capacity >= this->calc_group_capacity(this->size()));
+        page_list old_pages(page_ptr_allocator_type(this->allocator_));
+        old_pages.swap(this->pages_);
+        size_type old_page_groups = this->page_groups_;
+        size_type old_size = this->slot_size_;
+
+        this->reset_table();
+        if (new_group_capacity == 0) {
+            assert(old_size == 0);
+            for (size_type i = 0; i < old_pages.size(); i++) {
+                this->release_page(old_pages[i], old_page_groups);
+            }
+            return;
+        }
+
+        this->group_mask_ = new_group_capacity - 1;
+        this->page_groups_ = (std::min)(new_group_capacity, kPageGroups);
+        this->page_shift_ = static_cast<size_type>(BitUtils::bsf64(static_cast<std::uint64_t>(this->page_groups_)));
+        this->slot_threshold_ = this->calc_slot_threshold(new_group_capacity);
+
+        size_type page_count = new_group_capacity / this->page_groups_;
+        this->pages_.reserve(page_count);
+        for (size_type i = 0; i < page_count; i++) {
+            this->pages_.push_back(this->allocate_page());
+        }
+
+        for (size_type i = 0; i < old_pages.size(); i++) {
+            page_type * old_page = old_pages[i];
+            bool is_private = (old_page->refs.load(std::memory_order_acquire) == 1);
+            const group_type * old_groups = this_type::page_groups_of(old_page);
+            slot_type * old_slots = this_type::page_slots_of(old_page, old_page_groups);
+            for (size_type g = 0; g < old_page_groups; g++) {
+                std::uint32_t used_mask = old_groups[g].match_used();
+                while (used_mask != 0) {
+                    size_type pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                    used_mask = BitUtils::clearLowBit32(used_mask);
+                    slot_type * old_slot = old_slots + g * kGroupSize + pos;
+                    std::size_t key_hash = this->hash_for(old_slot->value.first);
+                    size_type group_index = 0, new_pos = 0;
+                    this->find_empty_to_insert(key_hash, group_index, new_pos);
+                    page_type * page = this->pages_[group_index >> this->page_shift_];
+                    size_type page_group = group_index & (this->page_groups_ - 1);
+                    slot_type * new_slot = this_type::page_slots_of(page, this->page_groups_) +
+                                           page_group * kGroupSize + new_pos;
+                    if (is_private)
+                        SlotPolicyTraits::transfer(&this->slot_allocator_, new_slot, old_slot);
+                    else
+                        SlotPolicyTraits::construct(&this->slot_allocator_, new_slot,
+                                                    static_cast<const slot_type *>(old_slot));
+                    this_type::page_groups_of(page)[page_group].set_used(new_pos, this->ctrl_for_hash(key_hash));
+                    this->slot_size_++;
+                }
+            }
+            if (is_private)
+                this->deallocate_page(old_page, old_page_groups);
+            else
+                this->release_page(old_page, old_page_groups);
+        }
+        assert(this->slot_size_ == old_size);
+    }
+};
+
+/*
+ * group15_cow_snapshot<Map>: A point-in-time, read-only view of a group15_cow_flat_map.
+ *
+ * It shares the pages with the map, the map copies a page before it writes to it,
+ * so the snapshot never changes. It costs one pointer and one atomic increment per page
+ * to take, and keeps the old version of the pages alive until it's destroyed.
+ */
+template <typename HashMap>
+class group15_cow_snapshot
+{
+public:
+    typedef HashMap                                 map_type;
+    typedef typename map_type::size_type            size_type;
+    typedef typename map_type::key_type             key_type;
+    typedef typename map_type::mapped_type          mapped_type;
+    typedef typename map_type::value_type           value_type;
+    typedef typename map_type::const_iterator       const_iterator;
+    typedef typename map_type::const_iterator       iterator;
+
+private:
+    map_type map_;
+
+public:
+    group15_cow_snapshot() {}
+    explicit group15_cow_snapshot(const map_type & map) : map_(map) {}
+
+    group15_cow_snapshot(const group15_cow_snapshot & src) = default;
+    group15_cow_snapshot(group15_cow_snapshot && src) = default;
+
+    group15_cow_snapshot & operator = (const group15_cow_snapshot & rhs) = default;
+    group15_cow_snapshot & operator = (group15_cow_snapshot && rhs) = default;
+
+    bool empty() const noexcept { return this->map_.empty(); }
+    size_type size() const noexcept { return this->map_.size(); }
+    size_type page_count() const noexcept { return this->map_.page_count(); }
+
+    const_iterator begin() const noexcept { return this->map_.begin(); }
+    const_iterator end() const noexcept { return this->map_.end(); }
+    const_iterator cbegin() const noexcept { return this->map_.begin(); }
+    const_iterator cend() const noexcept { return this->map_.end(); }
+
+    size_type count(const key_type & key) const { return this->map_.count(key); }
+    bool contains(const key_type & key) const { return this->map_.contains(key); }
+    const_iterator find(const key_type & key) const { return this->map_.find(key); }
+    const mapped_type & at(const key_type & key) const { return this->map_.at(key); }
+
+    // Release the pages, the snapshot is empty after it.
+    void reset() noexcept { this->map_.clear(); }
+};
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_GROUP15_COW_FLAT_MAP_HPP
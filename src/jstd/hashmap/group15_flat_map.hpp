@@ -110,6 +110,8 @@ public:
     typedef typename table_type::iterator       iterator;
     typedef typename table_type::const_iterator const_iterator;
 
+    typedef typename table_type::hash_token     hash_token;
+
     using this_type = group15_flat_map<Key, Value, Hash, KeyEqual, Allocator>;
 
 private:
@@ -294,6 +296,10 @@ public:
 
     void max_load_factor(float mlf) { table_.max_load_factor(mlf); }
 
+    float min_load_factor() const { return table_.min_load_factor(); }
+
+    void min_load_factor(float min_lf) { table_.min_load_factor(min_lf); }
+
     ///
     /// Hash policy
     ///
@@ -309,6 +315,10 @@ public:
         table_.shrink_to_fit(read_only);
     }
 
+    bool shrink_if_necessary() {
+        return table_.shrink_if_necessary();
+    }
+
     ///
     /// Lookup
     ///
@@ -379,12 +389,58 @@ public:
         return table_.find(key);
     }
 
+    ///
+    /// find_interleaved(keys, n, out, group_width)
+    ///
+    /// out[i] = find(keys[i]), with up to group_width lookups in flight,
+    /// see group15_flat_table::find_interleaved().
+    ///
+    template <typename KeyT>
+    JSTD_FORCED_INLINE
+    void find_interleaved(const KeyT * keys, size_type n, iterator * out,
+                          size_type group_width = table_type::kDefaultInterleavedWidth) {
+        table_.find_interleaved(keys, n, out, group_width);
+    }
+
+    template <typename KeyT>
+    JSTD_FORCED_INLINE
+    void find_interleaved(const KeyT * keys, size_type n, const_iterator * out,
+                          size_type group_width = table_type::kDefaultInterleavedWidth) const {
+        table_.find_interleaved(keys, n, out, group_width);
+    }
+
+    ///
+    /// Hash token: make_token(key), prefetch(token), find(key, token)
+    ///
+    /// Compute the hash of a key once, and reuse it in the maps that share the hasher,
+    /// see jstd::hash_token<Hash>.
+    ///
+    JSTD_FORCED_INLINE
+    hash_token make_token(const key_type & key) const {
+        return table_.make_token(key);
+    }
+
+    JSTD_FORCED_INLINE
+    void prefetch(const hash_token & token) const noexcept {
+        table_.prefetch(token);
+    }
+
+    JSTD_FORCED_INLINE
+    iterator find(const key_type & key, const hash_token & token) {
+        return table_.find(key, token);
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator find(const key_type & key, const hash_token & token) const {
+        return table_.find(key, token);
+    }
+
     ///
     /// Modifiers
     ///
     JSTD_FORCED_INLINE
-    void clear(bool need_destroy = false) noexcept {
-        table_.clear(need_destroy);
+    void clear(bool need_destroy = false, bool release_pages = false) noexcept {
+        table_.clear(need_destroy, release_pages);
     }
 
     ///
@@ -422,22 +478,22 @@ public:
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, const value_type & value) {
-        return table_.emplace(value).first;
+        return table_.insert(hint, value);
     }
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, value_type && value) {
-        return table_.emplace(std::move(value)).first;
+        return table_.insert(hint, std::move(value));
     }
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, const init_type & value) {
-        return table_.emplace(value).first;
+        return table_.insert(hint, value);
     }
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, init_type && value) {
-        return table_.emplace(std::move(value)).first;
+        return table_.insert(hint, std::move(value));
     }
 
     template <typename P, typename std::enable_if<
@@ -447,7 +503,7 @@ public:
                 std::is_constructible<init_type,  P &&>::value)>::type * = nullptr>
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, P && value) {
-        return table_.emplace(hint, std::forward<P>(value)).first;
+        return table_.insert(hint, std::forward<P>(value));
     }
 
     template <typename InputIter>
@@ -468,13 +524,13 @@ public:
     template <typename MappedT>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> insert_or_assign(const key_type & key, MappedT && value) {
-        return this->emplace_impl<true>(key, std::forward<MappedT>(value));
+        return table_.insert_or_assign(key, std::forward<MappedT>(value));
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> insert_or_assign(key_type && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value));
+        return table_.insert_or_assign(std::move(key), std::forward<MappedT>(value));
     }
 
     template <typename KeyT, typename MappedT, typename std::enable_if<
@@ -484,19 +540,19 @@ public:
               !std::is_convertible<KeyT, const_iterator>::value>::type * = nullptr>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> insert_or_assign(KeyT && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value));
+        return table_.insert_or_assign(std::forward<KeyT>(key), std::forward<MappedT>(value));
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, const key_type & key, MappedT && value) {
-        return this->emplace_impl<true>(key, std::forward<MappedT>(value))->first;
+        return table_.insert_or_assign(hint, key, std::forward<MappedT>(value));
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, key_type && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value))->first;
+        return table_.insert_or_assign(hint, std::move(key), std::forward<MappedT>(value));
     }
 
     template <typename KeyT, typename MappedT, typename std::enable_if<
@@ -506,7 +562,7 @@ public:
               !std::is_convertible<KeyT, const_iterator>::value>::type * = nullptr>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, KeyT && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value))->first;
+        return table_.insert_or_assign(hint, std::forward<KeyT>(key), std::forward<MappedT>(value));
     }
 
     ///
@@ -521,7 +577,35 @@ public:
     template <typename ... Args>
     JSTD_FORCED_INLINE
     iterator emplace_hint(const_iterator hint, Args && ... args) {
-        return table_.emplace(std::forward<Args>(args)...).first;
+        return table_.emplace_hint(hint, std::forward<Args>(args)...);
+    }
+
+    ///
+    /// find_or_prepare_insert(key)
+    ///
+    /// Find the key, or prepare a hint for emplace_hint(hint, key, ...) and insert(hint, value),
+    /// see group15_flat_table::find_or_prepare_insert().
+    ///
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> find_or_prepare_insert(const key_type & key) {
+        return table_.find_or_prepare_insert(key);
+    }
+
+    ///
+    /// lazy_emplace(key, factory)
+    ///
+    /// Inserts { key, factory() } with only one probe, if the key does not exist.
+    ///
+    template <typename Factory>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> lazy_emplace(const key_type & key, Factory && factory) {
+        return table_.lazy_emplace(key, std::forward<Factory>(factory));
+    }
+
+    template <typename Factory>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> lazy_emplace(key_type && key, Factory && factory) {
+        return table_.lazy_emplace(std::move(key), std::forward<Factory>(factory));
     }
 
     ///
@@ -546,7 +630,8 @@ public:
                             !std::is_convertible<key_type, KeyT &&>::value) &&
                             !std::is_same<key_type, KeyT>::value &&
                             !std::is_convertible<KeyT, iterator>::value &&
-                            !std::is_convertible<KeyT, const_iterator>::value,
+                            !std::is_convertible<KeyT, const_iterator>::value &&
+                            !jstd::is_hash_token_arg<KeyT>::value,
                              std::pair<iterator, bool> >::type
     try_emplace(KeyT && key, Args && ... args) {
         return table_.try_emplace(std::forward<KeyT>(key), std::forward<Args>(args)...);
@@ -555,17 +640,30 @@ public:
     // For compatibility with versions below C++17 that do not support T::is_transparent
     template <typename KeyT, typename ... Args>
     JSTD_FORCED_INLINE
-    typename std::enable_if<!jstd::are_transparent<KeyT, Hash, KeyEqual>::value ||
-                            (std::is_convertible<key_type, const KeyT &>::value ||
-                             std::is_convertible<key_type, KeyT &&>::value) &&
-                            !std::is_same<key_type, KeyT>::value &&
-                            !std::is_convertible<KeyT, iterator>::value &&
-                            !std::is_convertible<KeyT, const_iterator>::value,
+    typename std::enable_if<(!jstd::are_transparent<KeyT, Hash, KeyEqual>::value ||
+                             (std::is_convertible<key_type, const KeyT &>::value ||
+                              std::is_convertible<key_type, KeyT &&>::value) &&
+                             !std::is_same<key_type, KeyT>::value &&
+                             !std::is_convertible<KeyT, iterator>::value &&
+                             !std::is_convertible<KeyT, const_iterator>::value) &&
+                            !jstd::is_hash_token_arg<KeyT>::value,
                              std::pair<iterator, bool> >::type
     try_emplace(KeyT && key, Args && ... args) {
         return table_.try_emplace(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, const key_type & key, Args && ... args) {
+        return table_.try_emplace(token, key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, key_type && key, Args && ... args) {
+        return table_.try_emplace(token, std::move(key), std::forward<Args>(args)...);
+    }
+
     template <typename ... Args>
     JSTD_FORCED_INLINE
     iterator try_emplace(const_iterator hint, const key_type & key, Args && ... args) {
@@ -605,6 +703,15 @@ public:
         return table_.try_emplace(hint, std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    // Claims the first empty or reusable(value) slot on the probe path, see group15_flat_table.
+    template <typename Reusable, typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace_reuse_if(Reusable && reusable, const key_type & key,
+                                                   Args && ... args) {
+        return table_.try_emplace_reuse_if(std::forward<Reusable>(reusable), key,
+                                           std::forward<Args>(args)...);
+    }
+
     ///
     /// erase(key)
     ///
@@ -614,15 +721,21 @@ public:
     }
 
     JSTD_FORCED_INLINE
-    size_type erase(iterator pos) {
+    iterator erase(iterator pos) {
         return table_.erase(pos);
     }
 
     JSTD_FORCED_INLINE
-    size_type erase(const_iterator pos) {
+    iterator erase(const_iterator pos) {
         return table_.erase(pos);
     }
 
+    template <typename Pred>
+    JSTD_FORCED_INLINE
+    size_type erase_if_in_groups(size_type first_group, size_type group_count, Pred && pred) {
+        return table_.erase_if_in_groups(first_group, group_count, std::forward<Pred>(pred));
+    }
+
     JSTD_FORCED_INLINE
     iterator erase(iterator first, iterator last) {
         if (likely(first.hashmap() == this)) {
@@ -654,6 +767,25 @@ public:
         return num_deleted;
     }
 
+    ///
+    /// Comparison: equals(other), diff(other, on_added, on_removed, on_changed)
+    ///
+    /// See group15_flat_table::equals() and group15_flat_table::diff().
+    ///
+    JSTD_FORCED_INLINE
+    bool equals(const this_type & other) const {
+        return table_.equals(other.table_);
+    }
+
+    template <typename OnAdded, typename OnRemoved, typename OnChanged>
+    JSTD_FORCED_INLINE
+    size_type diff(const this_type & other, OnAdded && on_added,
+                   OnRemoved && on_removed, OnChanged && on_changed) const {
+        return table_.diff(other.table_, std::forward<OnAdded>(on_added),
+                           std::forward<OnRemoved>(on_removed),
+                           std::forward<OnChanged>(on_changed));
+    }
+
     JSTD_FORCED_INLINE
     void swap(this_type & other) {
         table_.swap(other.table_);
@@ -682,6 +814,39 @@ void swap(group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & lhs,
     lhs.swap(rhs);
 }
 
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc>
+inline
+bool operator == (const group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & lhs,
+                  const group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & rhs)
+{
+    return lhs.equals(rhs);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc>
+inline
+bool operator != (const group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & lhs,
+                  const group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & rhs)
+{
+    return !lhs.equals(rhs);
+}
+
+/**
+ * Reports the changes from @c old_map to @c new_map: on_added(value), on_removed(value)
+ * and on_changed(old_value, new_value). Returns the number of changes.
+ */
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc,
+          typename OnAdded, typename OnRemoved, typename OnChanged>
+inline
+typename group15_flat_map<Key, Value, Hash, KeyEqual, Alloc>::size_type
+diff(const group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & old_map,
+     const group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & new_map,
+     OnAdded && on_added, OnRemoved && on_removed, OnChanged && on_changed)
+{
+    return old_map.diff(new_map, std::forward<OnAdded>(on_added),
+                        std::forward<OnRemoved>(on_removed),
+                        std::forward<OnChanged>(on_changed));
+}
+
 } // namespace jstd
 
 ///////////////////////////////////////////////////////////
@@ -722,6 +887,7 @@ erase_if(jstd::group15_flat_map<Key, Value, Hash, KeyEqual, Alloc> & hash_map, P
             hash_map.erase(iter);
         }
     }
+    hash_map.shrink_if_necessary();
 
     return (old_size - hash_map.size());
 }
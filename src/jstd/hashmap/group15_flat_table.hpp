@@ -53,6 +53,7 @@
 
 #define NOMINMAX
 #include <stdint.h>
+#include <string.h>         // For memcmp()
 
 #include <cstdint>
 #include <memory>           // For std::allocator<T>
@@ -72,10 +73,12 @@
 
 #include "jstd/hasher/hashes.h"
 #include "jstd/utility/utility.h"
+#include "jstd/memory/release_pages.h"
 
 #include "jstd/hashmap/flat_map_iterator15.hpp"
 #include "jstd/hashmap/flat_map_group15.hpp"
 #include "jstd/hashmap/group_quadratic_prober.hpp"
+#include "jstd/hashmap/hash_token.hpp"
 
 #include "jstd/hashmap/detail/hashmap_traits.h"
 
@@ -128,6 +131,7 @@ public:
     static constexpr bool kEnableExchange = true;
 
     static constexpr bool kIsTransparent = (jstd::is_transparent<Hash>::value && jstd::is_transparent<KeyEqual>::value);
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hash>::value;
     static constexpr bool kIsLayoutCompatible = jstd::is_layout_compatible_kv<key_type, mapped_type>::value;
 
     static constexpr size_type npos = static_cast<size_type>(-1);
@@ -213,6 +217,8 @@ public:
 
     using locator_t = flat_map_locator15<this_type, kIsIndirectKV>;
 
+    using hash_token = jstd::hash_token<Hash>;
+
     static constexpr size_type kDefaultCapacity = 0;
     // kMinCapacity must be >= (kGroupWidth * 2)
     static constexpr size_type kMinCapacity = kGroupWidth * 2;
@@ -229,8 +235,22 @@ public:
     static constexpr size_type kDefaultMaxLoadFactor =
         static_cast<size_type>((double)kLoadFactorAmplify * (double)kDefaultLoadFactorF + 0.5);
 
+    // The max min_load_factor() is max_load_factor() / 4, the load factor after a shrink
+    // is in (mlf / 2, mlf], so a shrunk table won't shrink or grow again immediately.
+    static constexpr size_type kMinLoadFactorDivisor = 4;
+
+    // clear(false, true) only releases the pages of the slots larger than it, in bytes.
+    static constexpr size_type kMinReleasePagesBytes = 256 * 1024;
+
     static constexpr size_type kSkipGroupsLimit = 5;
 
+    // The prefetch distance (in lookups) of find_interleaved().
+    static constexpr size_type kDefaultInterleavedWidth = 8;
+    static constexpr size_type kMaxInterleavedWidth = 32;
+
+    // The number of lookups in flight of equals() and diff().
+    static constexpr size_type kDiffBatchSize = 16;
+
     using group_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<group_type>;
     using slot_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>;
 
@@ -253,6 +273,7 @@ private:
     size_type       index_shift_;
 #endif
     size_type       mlf_;
+    size_type       min_lf_;
 #if GROUP15_USE_SEPARATE_SLOTS
     group_type *    groups_alloc_;
 #endif
@@ -286,6 +307,7 @@ public:
           index_shift_(kWordLength - 1),
 #endif
           mlf_(kDefaultMaxLoadFactor),
+          min_lf_(0),
 #if GROUP15_USE_SEPARATE_SLOTS
           groups_alloc_(nullptr),
 #endif
@@ -316,6 +338,7 @@ public:
         index_shift_(kWordLength - 1),
 #endif
         mlf_(other.mlf_),
+        min_lf_(other.min_lf_),
 #if GROUP15_USE_SEPARATE_SLOTS
         groups_alloc_(nullptr),
 #endif
@@ -348,6 +371,7 @@ public:
         index_shift_(jstd::exchange(other.index_shift_, kWordLength - 1)),
 #endif
         mlf_(jstd::exchange(other.mlf_, kDefaultMaxLoadFactor)),
+        min_lf_(jstd::exchange(other.min_lf_, 0)),
 #if GROUP15_USE_SEPARATE_SLOTS
         groups_alloc_(jstd::exchange(other.groups_alloc_, nullptr)),
 #endif
@@ -372,6 +396,7 @@ public:
         index_shift_(kWordLength - 1),
 #endif
         mlf_(kDefaultMaxLoadFactor),
+        min_lf_(0),
 #if GROUP15_USE_SEPARATE_SLOTS
         groups_alloc_(nullptr),
 #endif
@@ -586,6 +611,7 @@ public:
             mlf = kMaxLoadFactorF;
         size_type mlf_int = static_cast<size_type>((float)kLoadFactorAmplify * mlf);
         this->mlf_ = mlf_int;
+        this->min_lf_ = (std::min)(this->min_lf_, this->mlf_ / kMinLoadFactorDivisor);
 
         size_type new_capacity = this->shrink_to_fit_capacity(this->ctrl_capacity());
         size_type new_ctrl_capacity = this->calc_capacity(new_capacity);
@@ -594,6 +620,21 @@ public:
         }
     }
 
+    //
+    // erase(key) shrinks the table when load_factor() drops below min_load_factor(),
+    // 0.0 (the default) means never shrink. It's limited in [0, max_load_factor() / 4].
+    //
+    float min_load_factor() const {
+        return ((float)this->min_lf_ / kLoadFactorAmplify);
+    }
+
+    void min_load_factor(float min_lf) {
+        if (min_lf < 0.0f)
+            min_lf = 0.0f;
+        size_type min_lf_int = static_cast<size_type>((float)kLoadFactorAmplify * min_lf);
+        this->min_lf_ = (std::min)(min_lf_int, this->mlf_ / kMinLoadFactorDivisor);
+    }
+
     ///
     /// Pointers
     ///
@@ -766,13 +807,75 @@ public:
         return { locator };
     }
 
+    ///
+    /// find_interleaved(keys, n, out, group_width)
+    ///
+    /// Batched lookup: out[i] = find(keys[i]), i = [0, n).
+    ///
+    /// Each lookup is a chain of dependent cache misses: the ctrl group, then the slot line.
+    /// Like AMAC (Asynchronous Memory Access Chaining), the lookups are interleaved: each hop
+    /// of a lookup is prefetched group_width lookups ahead of its use, so the misses of up to
+    /// group_width * 2 lookups overlap. It only pays off when the table is larger than the LLC,
+    /// group_width = 8 ~ 16 is a good start.
+    ///
+    template <typename KeyT>
+    void find_interleaved(const KeyT * keys, size_type n, iterator * out,
+                          size_type group_width = kDefaultInterleavedWidth) {
+        this->find_interleaved_impl(keys, n, out, group_width);
+    }
+
+    template <typename KeyT>
+    void find_interleaved(const KeyT * keys, size_type n, const_iterator * out,
+                          size_type group_width = kDefaultInterleavedWidth) const {
+        this->find_interleaved_impl(keys, n, out, group_width);
+    }
+
+    ///
+    /// Hash token: make_token(key), prefetch(token), find(key, token)
+    ///
+    /// The token must be made from the same key, see jstd::hash_token<Hash>.
+    ///
+    JSTD_FORCED_INLINE
+    hash_token make_token(const key_type & key) const {
+        return hash_token(this->raw_hash_for(key));
+    }
+
+    JSTD_FORCED_INLINE
+    void prefetch(const hash_token & token) const noexcept {
+        size_type group_index = this->index_for_hash(this->hash_for_token(token));
+        Prefetch_Read_T0((const void *)this->group_at(group_index));
+    }
+
+    JSTD_FORCED_INLINE
+    iterator find(const key_type & key, const hash_token & token) {
+        return const_cast<const this_type *>(this)->find(key, token);
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator find(const key_type & key, const hash_token & token) const {
+        assert(token == this->make_token(key));
+        std::size_t key_hash = this->hash_for_token(token);
+        size_type group_index = this->index_for_hash(key_hash);
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+        locator_t locator = this->find_impl(key, group_index, ctrl_hash);
+        return { locator };
+    }
+
     ///
     /// Modifiers
     ///
+    //
+    // clear(false, true): Keep the capacity, but return the pages of the slots to the OS,
+    // they are faulted in again by the next insertions. The groups are kept, because
+    // they must be reset to empty anyway, and they are small (one byte per slot).
+    //
     JSTD_FORCED_INLINE
-    void clear(bool need_destroy = false) noexcept {
+    void clear(bool need_destroy = false, bool release_pages = false) noexcept {
         if (!need_destroy) {
             this->clear_data();
+            if (release_pages) {
+                this->release_slot_pages();
+            }
         } else {
             this->destroy<true>();
         }
@@ -814,22 +917,22 @@ public:
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, const value_type & value) {
-        return this->emplace_impl<false>(value).first;
+        return this->emplace_hint_impl(hint, value);
     }
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, value_type && value) {
-        return this->emplace_impl<false>(std::move(value)).first;
+        return this->emplace_hint_impl(hint, std::move(value));
     }
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, const init_type & value) {
-        return this->emplace_impl<false>(value).first;
+        return this->emplace_hint_impl(hint, value);
     }
 
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, init_type && value) {
-        return this->emplace_impl<false>(std::move(value)).first;
+        return this->emplace_hint_impl(hint, std::move(value));
     }
 
     template <typename P, typename std::enable_if<
@@ -839,7 +942,7 @@ public:
                 std::is_constructible<init_type,  P &&>::value)>::type * = nullptr>
     JSTD_FORCED_INLINE
     iterator insert(const_iterator hint, P && value) {
-        return this->emplace_impl<false>(std::forward<P>(value)).first;
+        return this->emplace_hint_impl(hint, std::forward<P>(value));
     }
 
     template <typename InputIter>
@@ -878,19 +981,19 @@ public:
     template <typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, const key_type & key, MappedT && value) {
-        return this->emplace_impl<true>(key, std::forward<MappedT>(value))->first;
+        return this->emplace_impl<true>(key, std::forward<MappedT>(value)).first;
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, key_type && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value))->first;
+        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value)).first;
     }
 
     template <typename KeyT, typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, KeyT && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value))->first;
+        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value)).first;
     }
 
     ///
@@ -902,10 +1005,72 @@ public:
         return this->emplace_impl<false>(std::forward<Args>(args)...);
     }
 
+    ///
+    /// emplace_hint(hint, args...)
+    ///
+    /// The hint is used if it's the iterator returned by find_or_prepare_insert(key),
+    /// or an iterator to the element with the same key, otherwise it's ignored.
+    /// The group and the pos of the hint are validated against the groups of this table,
+    /// and the slot is derived from them, so a stale or unrelated hint is never dereferenced
+    /// outside of this table, it's only used if it's still right for the key.
+    ///
     template <typename ... Args>
     JSTD_FORCED_INLINE
     iterator emplace_hint(const_iterator hint, Args && ... args) {
-        return this->emplace_impl<false>(std::forward<Args>(args)...).first;
+        return this->emplace_hint_impl(hint, std::forward<Args>(args)...);
+    }
+
+    ///
+    /// find_or_prepare_insert(key)
+    ///
+    /// Returns { iterator, false } if the key exists, otherwise returns { hint, true },
+    /// and the table has grown if necessary, so the value can be built after the lookup
+    /// and inserted by emplace_hint(hint, key, ...) or insert(hint, value) without
+    /// probing again. The hint is invalidated by any other modification of the table,
+    /// then emplace_hint() falls back to the normal insertion.
+    ///
+    std::pair<iterator, bool> find_or_prepare_insert(const key_type & key) {
+        std::size_t key_hash = this->hash_for(key);
+        size_type group_index = this->index_for_hash(key_hash);
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+
+        locator_t locator = this->find_impl(key, group_index, ctrl_hash);
+        if (locator.slot() != nullptr) {
+            return { locator, kIsExists };
+        }
+
+        if (unlikely(this->need_grow())) {
+            this->grow_if_necessary();
+            group_index = this->index_for_hash(key_hash);
+        }
+
+        // Only an empty slot in the home group can be used as a hint.
+        const group_type * group = this->group_at(group_index);
+        std::uint32_t empty_mask = group->match_empty();
+        if (likely(empty_mask != 0)) {
+            size_type empty_pos = static_cast<size_type>(BitUtils::bsf32(empty_mask));
+            const slot_type * slot = this->slots() + group_index * kGroupSize + empty_pos;
+            return { locator_t(group, empty_pos, slot), kNeedInsert };
+        }
+        return { locator_t(), kNeedInsert };
+    }
+
+    ///
+    /// lazy_emplace(key, factory)
+    ///
+    /// Inserts { key, factory() } if the key does not exist, with only one probe,
+    /// factory() is not called if the key already exists.
+    ///
+    template <typename Factory>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> lazy_emplace(const key_type & key, Factory && factory) {
+        return this->lazy_emplace_impl(key, std::forward<Factory>(factory));
+    }
+
+    template <typename Factory>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> lazy_emplace(key_type && key, Factory && factory) {
+        return this->lazy_emplace_impl(std::move(key), std::forward<Factory>(factory));
     }
 
     ///
@@ -923,12 +1088,28 @@ public:
         return this->try_emplace_impl(std::move(key), std::forward<Args>(args)...);
     }
 
-    template <typename KeyT, typename ... Args>
+    template <typename KeyT, typename ... Args,
+              typename std::enable_if<!jstd::is_hash_token_arg<KeyT>::value>::type * = nullptr>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> try_emplace(KeyT && key, Args && ... args) {
         return this->try_emplace_impl(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, const key_type & key, Args && ... args) {
+        assert(token == this->make_token(key));
+        return this->try_emplace_with_hash(this->hash_for_token(token), key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, key_type && key, Args && ... args) {
+        assert(token == this->make_token(key));
+        return this->try_emplace_with_hash(this->hash_for_token(token), std::move(key),
+                                           std::forward<Args>(args)...);
+    }
+
     template <typename ... Args>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> try_emplace(const_iterator hint, const key_type & key, Args && ... args) {
@@ -953,6 +1134,9 @@ public:
     JSTD_FORCED_INLINE
     size_type erase(const key_type & key) {
         size_type num_deleted = this->find_and_erase(key);
+        if (unlikely(this->need_shrink())) {
+            this->shrink_if_necessary();
+        }
         return num_deleted;
     }
 
@@ -969,6 +1153,162 @@ public:
         return this->erase(iterator(pos));
     }
 
+    //
+    // erase(iterator) never shrinks, because it would invalidate the returned iterator.
+    // Call it after a loop of erase(iterator) to apply the min_load_factor().
+    // Returns true if the table is shrunk.
+    //
+    JSTD_NO_INLINE
+    bool shrink_if_necessary() {
+        if (this->need_shrink()) {
+            size_type new_capacity = this->shrink_to_fit_capacity(this->size());
+            this->rehash_impl<true>(new_capacity);
+            return true;
+        }
+        return false;
+    }
+
+    //
+    // Erase the entries that satisfy pred(value) in the groups [first_group, first_group + group_count),
+    // the group index wraps around the group capacity. Returns the number of erased entries.
+    //
+    // It's used to clean up a table incrementally, a bounded number of groups per call.
+    //
+    template <typename Pred>
+    size_type erase_if_in_groups(size_type first_group, size_type group_count, Pred && pred) {
+        size_type num_deleted = 0;
+        if (this->size() != 0) {
+            group_count = (std::min)(group_count, this->group_capacity());
+            for (size_type i = 0; i < group_count; i++) {
+                size_type group_index = (first_group + i) & this->group_mask();
+                group_type * group = this->group_at(group_index);
+                std::uint32_t used_mask = group->match_used();
+                while (used_mask != 0) {
+                    size_type used_pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                    used_mask = BitUtils::clearLowBit32(used_mask);
+                    if (unlikely(group->is_sentinel(used_pos)))
+                        break;
+                    slot_type * slot = this->slot_at(group_index * kGroupSize + used_pos);
+                    if (pred(slot->value)) {
+                        locator_t locator(group, used_pos, slot);
+                        this->erase_index(locator);
+                        num_deleted++;
+                    }
+                }
+            }
+        }
+        return num_deleted;
+    }
+
+    //
+    // Like try_emplace(key, args...), but if the key does not exist, a used slot on the probe path
+    // of the key that satisfies reusable(value) can be claimed for the new entry: the first group
+    // of the probe path that has an empty slot or a reusable slot is used. The reusable entry is
+    // destroyed, so the size is not changed, and the table doesn't need to grow.
+    //
+    // It's used to overwrite the stale entries in place (e.g. the expired entries), the caller can
+    // compare size() before and after the call to know if an entry was reused.
+    //
+    template <typename Reusable, typename ... Args>
+    std::pair<iterator, bool> try_emplace_reuse_if(Reusable && reusable, const key_type & key,
+                                                   Args && ... args) {
+        std::size_t key_hash = this->hash_for(key);
+        size_type group_index = this->index_for_hash(key_hash);
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+
+        locator_t locator = this->find_impl(key, group_index, ctrl_hash);
+        if (locator.slot() != nullptr) {
+            return { locator, kIsExists };
+        }
+
+        locator = this->find_reusable_to_insert(reusable, group_index, ctrl_hash);
+        if (locator.slot() == nullptr) {
+            // There is no reusable slot, and the table is full or reaches the slot threshold.
+            this->grow_if_necessary();
+
+            group_index = this->index_for_hash(key_hash);
+            locator = this->find_empty_to_insert(key, group_index, ctrl_hash);
+        }
+
+        slot_type * slot = locator.slot();
+        assert(slot != nullptr);
+        assert(slot < this->last_slot());
+        SlotPolicyTraits::construct(&this->slot_allocator_, slot,
+                                    std::piecewise_construct,
+                                    std::forward_as_tuple(key),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        this->slot_size_++;
+        return { locator, kNeedInsert };
+    }
+
+    ///
+    /// Comparison: equals(other), diff(other, on_added, on_removed, on_changed)
+    ///
+    //
+    // Two tables are equal if they have the same keys, and the mapped values of each key
+    // are equal (operator ==). The sizes are compared first.
+    //
+    // The used slots of this table are walked group by group, and looked up in the other
+    // table in batches of kDiffBatchSize, the groups of a batch are prefetched before
+    // the first lookup. If both tables have the same capacity, a group that is
+    // byte-for-byte identical (memcmp) with the group of the same index in the other table
+    // most likely holds the same keys at the same positions, so its slots are paired
+    // directly, without any lookup. In a group that differs, only the slots whose ctrl byte
+    // differs are looked up. It's the common case of a copy of a table that was changed
+    // a little.
+    //
+    bool equals(const this_type & other) const {
+        if (this->size() != other.size())
+            return false;
+        if (std::addressof(other) == this || this->size() == 0)
+            return true;
+
+        return this->match_slots(other, [](const slot_type * slot, const slot_type * other_slot) -> bool {
+            return ((other_slot != nullptr) && (slot->value.second == other_slot->value.second));
+        });
+    }
+
+    //
+    // Reports the changes from this table (the old one) to the other table (the new one):
+    //
+    //   on_added(value):              the key is only in the other table.
+    //   on_removed(value):            the key is only in this table.
+    //   on_changed(value, new_value): the key is in both tables, but the mapped values are different.
+    //
+    // Returns the number of changes.
+    //
+    template <typename OnAdded, typename OnRemoved, typename OnChanged>
+    size_type diff(const this_type & other, OnAdded && on_added,
+                   OnRemoved && on_removed, OnChanged && on_changed) const {
+        size_type num_changes = 0;
+        if (std::addressof(other) == this)
+            return num_changes;
+
+        if (this->size() != 0) {
+            this->match_slots(other, [&](const slot_type * slot, const slot_type * other_slot) -> bool {
+                if (other_slot == nullptr) {
+                    on_removed(slot->value);
+                    num_changes++;
+                } else if (!(slot->value.second == other_slot->value.second)) {
+                    on_changed(slot->value, other_slot->value);
+                    num_changes++;
+                }
+                return true;
+            });
+        }
+        if (other.size() != 0) {
+            // The keys that are in both tables have been reported, only look for the added keys.
+            other.match_slots(*this, [&](const slot_type * slot, const slot_type * other_slot) -> bool {
+                if (other_slot == nullptr) {
+                    on_added(slot->value);
+                    num_changes++;
+                }
+                return true;
+            });
+        }
+        return num_changes;
+    }
+
     JSTD_FORCED_INLINE
     void swap(this_type & other) {
         if (std::addressof(other) != this) {
@@ -1237,6 +1577,12 @@ private:
         return new_capacity;
     }
 
+    // If min_lf_ is 0, it's always false.
+    inline bool need_shrink() const noexcept {
+        return ((this->slot_size_ * kLoadFactorAmplify < this->slot_capacity_ * this->min_lf_) &&
+                (this->ctrl_capacity() > kMinCapacity));
+    }
+
     static inline bool is_positive(size_type value) noexcept {
         return (static_cast<intptr_t>(value) >= 0);
     }
@@ -1287,8 +1633,11 @@ private:
         return (size_type)((std::uintptr_t)this->ctrls() >> 12);
     }
 
+    //
+    // The hash code of the hasher, before the avalanche mixing.
+    //
     JSTD_FORCED_INLINE
-    std::size_t hash_for(const key_type & key) const
+    std::size_t raw_hash_for(const key_type & key) const
         noexcept(noexcept(this->hasher_(key))) {
 #if GROUP15_USE_HASH_POLICY
         std::size_t key_hash = static_cast<std::size_t>(this->hash_policy_.get_hash_code(key));
@@ -1302,12 +1651,29 @@ private:
   #else
         std::size_t key_hash = static_cast<std::size_t>(this->hasher_(key));
   #endif
-        if (!jstd::detail::hash_is_avalanching<Hash>::value)
-            key_hash = hashes::mum_mul_mix(key_hash);
 #endif
         return key_hash;
     }
 
+    JSTD_FORCED_INLINE
+    std::size_t hash_for(const key_type & key) const
+        noexcept(noexcept(this->hasher_(key))) {
+#if GROUP15_USE_HASH_POLICY
+        return this->raw_hash_for(key);
+#else
+        return hash_token::mix_hash(this->raw_hash_for(key));
+#endif
+    }
+
+    JSTD_FORCED_INLINE
+    std::size_t hash_for_token(const hash_token & token) const noexcept {
+#if GROUP15_USE_HASH_POLICY
+        return token.hash();
+#else
+        return token.mixed_hash();
+#endif
+    }
+
     //
     // Do the index hash on the basis of hash code for the index_for_hash().
     //
@@ -1327,10 +1693,15 @@ private:
     std::size_t ctrl_hasher(std::size_t key_hash) const noexcept {
 #if (GROUP15_USE_HASH_POLICY != 0) || (GROUP15_USE_INDEX_SHIFT != 0)
         return key_hash;
-#elif 1
+#else
+        // The index uses the low bits, take the ctrl hash from the high bits.
+        if (kIsAvalanching)
+            return (key_hash >> (sizeof(std::size_t) * 8 - 8));
+  #if 1
         return (size_type)hashes::fibonacci_hash(key_hash);
-#elif 0
+  #else
         return (size_type)hashes::mum_hash(key_hash);
+  #endif
 #endif
     }
 
@@ -1521,7 +1892,19 @@ private:
     void clear_data() {
         // Note!!: clear_slots() need use this->ctrls(), so must clear slots first.
         this->clear_slots();
-        this->clear_groups(this->groups(), this->group_capacity());
+        if (this->groups() != this_type::default_empty_groups()) {
+            this->clear_groups(this->groups(), this->group_capacity());
+            // The sentinel mark was cleared, and erase() has decreased the threshold.
+            this->set_sentinel_mark(this->groups(), this->group_capacity());
+            this->slot_threshold_ = this->calc_slot_threshold(this->slot_capacity());
+        }
+    }
+
+    void release_slot_pages() noexcept {
+        size_type slot_bytes = this->slot_capacity() * sizeof(slot_type);
+        if ((this->slots_ != nullptr) && (slot_bytes >= kMinReleasePagesBytes)) {
+            jstd::release_pages(static_cast<void *>(this->slots_), slot_bytes);
+        }
     }
 
     JSTD_FORCED_INLINE
@@ -1605,6 +1988,7 @@ private:
         if (this->slots() != nullptr && other.slots() != nullptr) {
             copy_groups_array_from(other);
             copy_slots_array_from(other);
+            this->slot_size_ = other.slot_size_;
         } else {
             assert(false);
         }
@@ -1652,7 +2036,7 @@ private:
          */
         std::memcpy(
             reinterpret_cast<unsigned char *>(this->slots()),
-            reinterpret_cast<unsigned char *>(other.slots()),
+            reinterpret_cast<const unsigned char *>(other.slots()),
             other.slot_capacity() * sizeof(slot_type));
     }
 
@@ -1804,7 +2188,7 @@ private:
          */
         std::memcpy(
             reinterpret_cast<unsigned char *>(this->slots()),
-            reinterpret_cast<unsigned char *>(other.slots()),
+            reinterpret_cast<const unsigned char *>(other.slots()),
             other.slot_capacity() * sizeof(slot_type));
 
         // Reset all of other slots
@@ -2195,6 +2579,147 @@ private:
         return {};
     }
 
+    //
+    // The precomputed probe start of a lookup in find_interleaved().
+    //
+    struct interleaved_probe {
+        size_type       group_index;
+        std::uint8_t    ctrl_hash;
+    };
+
+    //
+    // A software pipeline of three stages, the distance between the stages is group_width:
+    //
+    //   stage 1: keys[i]: hash it, and prefetch the ctrl group.
+    //   stage 2: keys[i - group_width]: match the ctrl group, and prefetch the first candidate slot.
+    //   stage 3: keys[i - group_width * 2]: find_impl() from the precomputed group, the group and
+    //            the slot are in cache now, only the rare overflow groups are probed synchronously.
+    //
+    template <typename KeyT, typename Iterator>
+    void find_interleaved_impl(const KeyT * keys, size_type n, Iterator * out,
+                               size_type group_width) const {
+        // The probe of keys[i] is used until the stage 3 of keys[i], it must not be overwritten.
+        static constexpr size_type kProbeRingSize = kMaxInterleavedWidth * 4;
+        static constexpr size_type kProbeRingMask = kProbeRingSize - 1;
+
+        if (group_width < 1)
+            group_width = 1;
+        else if (group_width > kMaxInterleavedWidth)
+            group_width = kMaxInterleavedWidth;
+
+        interleaved_probe probes[kProbeRingSize];
+        const size_type distance = group_width;
+        const size_type total = n + distance * 2;
+        for (size_type i = 0; i < total; i++) {
+            if (likely(i < n)) {
+                std::size_t key_hash = this->hash_for(keys[i]);
+                interleaved_probe & probe = probes[i & kProbeRingMask];
+                probe.group_index = this->index_for_hash(key_hash);
+                probe.ctrl_hash = this->ctrl_for_hash(key_hash);
+                Prefetch_Read_T0((const void *)this->group_at(probe.group_index));
+            }
+            if (likely(i >= distance && (i - distance) < n)) {
+                const interleaved_probe & probe = probes[(i - distance) & kProbeRingMask];
+                const group_type * group = this->group_at(probe.group_index);
+                std::uint32_t match_mask = group->match_hash(probe.ctrl_hash);
+                if (match_mask != 0) {
+                    size_type match_pos = static_cast<size_type>(BitUtils::bsf32(match_mask));
+                    const slot_type * slot = this->slots() + probe.group_index * kGroupSize + match_pos;
+                    Prefetch_Read_T0((const void *)slot);
+                }
+            }
+            if (likely(i >= distance * 2)) {
+                size_type index = i - distance * 2;
+                const interleaved_probe & probe = probes[index & kProbeRingMask];
+                locator_t locator = this->find_impl(keys[index], probe.group_index, probe.ctrl_hash);
+                out[index] = Iterator(locator);
+            }
+        }
+    }
+
+    //
+    // Calls visitor(slot, other_slot) for each used slot of this table, other_slot is the slot
+    // of the same key in the other table, or nullptr if the other table doesn't contain it.
+    // Stops and returns false as soon as the visitor returns false.
+    //
+    template <typename Visitor>
+    bool match_slots(const this_type & other, Visitor && visitor) const {
+        const bool same_layout = (this->group_capacity() == other.group_capacity());
+
+        const slot_type * batch_slots[kDiffBatchSize];
+        std::size_t batch_hashes[kDiffBatchSize];
+        size_type batch_size = 0;
+
+        for (size_type group_index = 0; group_index < this->group_capacity(); group_index++) {
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t used_mask = group->match_used();
+            if (used_mask == 0)
+                continue;
+
+            const slot_type * slot_base = this->slots() + group_index * kGroupSize;
+            const slot_type * other_slot_base = nullptr;
+            const ctrl_type * ctrls = reinterpret_cast<const ctrl_type *>(group);
+            const ctrl_type * other_ctrls = nullptr;
+            bool is_same_group = false;
+            if (same_layout) {
+                const group_type * other_group = other.group_at(group_index);
+                other_ctrls = reinterpret_cast<const ctrl_type *>(other_group);
+                other_slot_base = other.slots() + group_index * kGroupSize;
+                is_same_group = (memcmp((const void *)group, (const void *)other_group, sizeof(group_type)) == 0);
+            }
+
+            do {
+                size_type used_pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                used_mask = BitUtils::clearLowBit32(used_mask);
+                if (unlikely(group->is_sentinel(used_pos)))
+                    break;
+                const slot_type * slot = slot_base + used_pos;
+                // The same ctrl byte at the same position, it's most likely the same key.
+                if (same_layout && (is_same_group || ctrls[used_pos].value() == other_ctrls[used_pos].value())) {
+                    const slot_type * other_slot = other_slot_base + used_pos;
+                    if (likely(this->key_equal_(slot->value.first, other_slot->value.first))) {
+                        if (!visitor(slot, other_slot))
+                            return false;
+                        continue;
+                    }
+                }
+
+                std::size_t key_hash = other.hash_for(slot->value.first);
+                Prefetch_Read_T0((const void *)other.group_at(other.index_for_hash(key_hash)));
+                batch_slots[batch_size] = slot;
+                batch_hashes[batch_size] = key_hash;
+                batch_size++;
+                if (batch_size == kDiffBatchSize) {
+                    if (!other.find_batch(batch_slots, batch_hashes, batch_size, visitor))
+                        return false;
+                    batch_size = 0;
+                }
+            } while (used_mask != 0);
+        }
+
+        if (batch_size != 0)
+            return other.find_batch(batch_slots, batch_hashes, batch_size, visitor);
+        else
+            return true;
+    }
+
+    //
+    // The second half of match_slots(): look up the keys of the slots of the other table,
+    // whose groups have been prefetched, and call visitor(slot, found_slot).
+    //
+    template <typename Visitor>
+    bool find_batch(const slot_type * const * slots, const std::size_t * key_hashes,
+                    size_type count, Visitor & visitor) const {
+        for (size_type i = 0; i < count; i++) {
+            size_type group_index = this->index_for_hash(key_hashes[i]);
+            std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hashes[i]);
+            locator_t locator = this->find_impl(slots[i]->value.first, group_index, ctrl_hash);
+            if (!visitor(slots[i], locator.slot()))
+                return false;
+        }
+        return true;
+    }
+
     void display_meta_datas(group_type * group) {
         ctrl_type * ctrl = reinterpret_cast<ctrl_type *>(group);
         printf("[");
@@ -2241,10 +2766,66 @@ private:
         return {};
     }
 
+    //
+    // Used in try_emplace_reuse_if(), walks the probe path until the first group that has
+    // an empty slot or a used slot that satisfies reusable(value). An empty slot is preferred,
+    // but it's only claimed if the table doesn't need to grow. A reusable entry is destroyed.
+    // Returns an empty locator if no slot is claimed.
+    //
+    template <typename Reusable>
+    JSTD_FORCED_INLINE
+    locator_t find_reusable_to_insert(Reusable & reusable, size_type group_index, std::uint8_t ctrl_hash) {
+        prober_type prober(group_index);
+
+        do {
+            group_index = prober.get();
+            group_type * group = this->group_at(group_index);
+            slot_type * slot_base = this->slots() + group_index * kGroupSize;
+            std::uint32_t empty_mask = group->match_empty();
+            if (empty_mask != 0) {
+                if (likely(!this->need_grow())) {
+                    std::uint32_t empty_pos = BitUtils::bsf32(empty_mask);
+                    assert(group->is_empty(empty_pos));
+                    group->set_used(empty_pos, ctrl_hash);
+                    return { group, empty_pos, slot_base + empty_pos };
+                }
+            }
+
+            std::uint32_t used_mask = group->match_used();
+            while (used_mask != 0) {
+                size_type used_pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                used_mask = BitUtils::clearLowBit32(used_mask);
+                if (unlikely(group->is_sentinel(used_pos)))
+                    break;
+                slot_type * slot = slot_base + used_pos;
+                if (reusable(slot->value)) {
+                    // The overflow bits of the probe path are kept, they are only hints.
+                    this->destroy_slot(slot);
+                    this->slot_size_--;
+                    group->set_used(used_pos, ctrl_hash);
+                    return { group, used_pos, slot };
+                }
+            }
+
+            if (empty_mask != 0) {
+                // The table needs to grow before the empty slot is claimed.
+                break;
+            }
+            group->set_overflow(ctrl_hash);
+        } while (prober.next_bucket(this->group_mask()));
+
+        return {};
+    }
+
     template <typename KeyT>
     JSTD_FORCED_INLINE
     std::pair<locator_t, bool> find_or_insert(const KeyT & key) {
-        std::size_t key_hash = this->hash_for(key);
+        return this->find_or_insert(key, this->hash_for(key));
+    }
+
+    template <typename KeyT>
+    JSTD_FORCED_INLINE
+    std::pair<locator_t, bool> find_or_insert(const KeyT & key, std::size_t key_hash) {
         size_type group_index = this->index_for_hash(key_hash);
         std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
 
@@ -2583,6 +3164,149 @@ private:
         return { locator, need_insert };
     }
 
+    template <typename KeyT, typename Factory>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> lazy_emplace_impl(KeyT && key, Factory && factory) {
+        auto find_info = this->find_or_insert(key);
+        locator_t & locator = find_info.first;
+        bool need_insert = find_info.second;
+        if (need_insert) {
+            // The key to be inserted is not exists.
+            slot_type * slot = locator.slot();
+            assert(slot != nullptr);
+            assert(slot < this->last_slot());
+            SlotPolicyTraits::construct(&this->slot_allocator_, slot,
+                                        std::piecewise_construct,
+                                        std::forward_as_tuple(std::forward<KeyT>(key)),
+                                        std::forward_as_tuple(factory()));
+            this->slot_size_++;
+        }
+        return { locator, need_insert };
+    }
+
+    //
+    // Like find_or_insert(key), but try the hint first. The hint is used if it's in this table, and:
+    //
+    //   1. It's an element with the same key, or
+    //   2. It's an empty slot in the home group of the key, the key is not in the
+    //      home group and the home group is not overflowed, that is the key does
+    //      not exist, and the table needn't grow.
+    //
+    template <typename KeyT>
+    JSTD_FORCED_INLINE
+    std::pair<locator_t, bool> find_or_insert_hint(const KeyT & key, const const_iterator & hint) {
+        std::size_t key_hash = this->hash_for(key);
+        // Only the group and the pos of the hint are used, and validated against this table,
+        // the slot of the hint is never read, it may be in a freed block of a stale hint.
+        const char * hint_group_addr = reinterpret_cast<const char *>(hint.group());
+        const char * first_group_addr = reinterpret_cast<const char *>(this->groups());
+        const char * last_group_addr = reinterpret_cast<const char *>(this->last_group());
+        size_type hint_pos = hint.pos();
+        if (hint_group_addr >= first_group_addr && hint_group_addr < last_group_addr &&
+            ((hint_group_addr - first_group_addr) % sizeof(group_type)) == 0 &&
+            hint_pos < kGroupSize) {
+            size_type hint_group_index = static_cast<size_type>(
+                (hint_group_addr - first_group_addr) / sizeof(group_type));
+            const group_type * hint_group = this->group_at(hint_group_index);
+            const slot_type * hint_slot = this->slots() + hint_group_index * kGroupSize + hint_pos;
+            if (hint_group->is_valid(hint_pos)) {
+                if (this->key_equal_(key, hint_slot->value.first)) {
+                    return { locator_t(hint_group, hint_pos, hint_slot), kIsExists };
+                }
+            } else {
+                size_type group_index = this->index_for_hash(key_hash);
+                std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+                if ((hint_group == this->group_at(group_index)) &&
+                    hint_group->is_empty(hint_pos) && !this->need_grow()) {
+                    std::uint32_t match_mask = hint_group->match_hash(ctrl_hash);
+                    const slot_type * slot_base = this->slots() + group_index * kGroupSize;
+                    while (match_mask != 0) {
+                        size_type match_pos = static_cast<size_type>(BitUtils::bsf32(match_mask));
+                        const slot_type * slot = slot_base + match_pos;
+                        if (this->key_equal_(key, slot->value.first)) {
+                            return { locator_t(hint_group, match_pos, slot), kIsExists };
+                        }
+                        match_mask = BitUtils::clearLowBit32(match_mask);
+                    }
+                    if (likely(hint_group->is_not_overflow(ctrl_hash))) {
+                        group_type * group = const_cast<group_type *>(hint_group);
+                        group->set_used(hint_pos, ctrl_hash);
+                        return { locator_t(hint_group, hint_pos, hint_slot), kNeedInsert };
+                    }
+                }
+            }
+        }
+        return this->find_or_insert(key, key_hash);
+    }
+
+    template <typename P, typename std::enable_if<
+              (jstd::is_same_ex<P, value_type>::value ||
+               jstd::is_same_ex<P, init_type >::value)>::type * = nullptr>
+    JSTD_FORCED_INLINE
+    iterator emplace_hint_impl(const const_iterator & hint, P && value) {
+        auto find_info = this->find_or_insert_hint(value.first, hint);
+        locator_t & locator = find_info.first;
+        bool need_insert = find_info.second;
+        if (need_insert) {
+            // The key to be inserted is not exists.
+            slot_type * slot = locator.slot();
+            assert(slot != nullptr);
+            assert(slot < this->last_slot());
+            SlotPolicyTraits::construct(&this->slot_allocator_, slot, std::forward<P>(value));
+            this->slot_size_++;
+        }
+        return { locator };
+    }
+
+    template <typename KeyT, typename std::enable_if<
+              jstd::is_same_ex<KeyT, key_type>::value>::type * = nullptr,
+              typename ... Args>
+    JSTD_FORCED_INLINE
+    iterator emplace_hint_impl(const const_iterator & hint, KeyT && key, Args && ... args) {
+        auto find_info = this->find_or_insert_hint(key, hint);
+        locator_t & locator = find_info.first;
+        bool need_insert = find_info.second;
+        if (need_insert) {
+            // The key to be inserted is not exists.
+            slot_type * slot = locator.slot();
+            assert(slot != nullptr);
+            assert(slot < this->last_slot());
+            SlotPolicyTraits::construct(&this->slot_allocator_, slot,
+                                        std::piecewise_construct,
+                                        std::forward_as_tuple(std::forward<KeyT>(key)),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+            this->slot_size_++;
+        }
+        return { locator };
+    }
+
+    // The other arguments, the hint is ignored.
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    iterator emplace_hint_impl(const const_iterator & hint, Args && ... args) {
+        return this->emplace_impl<false>(std::forward<Args>(args)...).first;
+    }
+
+    template <typename KeyT, typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace_with_hash(std::size_t key_hash, KeyT && key, Args && ... args) {
+        auto find_info = this->find_or_insert(key, key_hash);
+        locator_t & locator = find_info.first;
+        bool need_insert = find_info.second;
+        if (need_insert) {
+            // The key to be inserted is not exists.
+            slot_type * slot = locator.slot();
+            assert(slot != nullptr);
+            assert(slot < this->last_slot());
+            SlotPolicyTraits::construct(&this->slot_allocator_, slot,
+                                        std::piecewise_construct,
+                                        std::forward_as_tuple(std::forward<KeyT>(key)),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+            this->slot_size_++;
+        }
+        return { locator, need_insert };
+    }
+
     JSTD_FORCED_INLINE
     bool ctrl_is_last_bit(const locator_t & locator) const noexcept {
         const group_type * group = locator.group();
@@ -2657,6 +3381,7 @@ private:
         swap(this->index_shift_, other.index_shift_);
 #endif
         swap(this->mlf_, other.mlf_);
+        swap(this->min_lf_, other.min_lf_);
 #if GROUP15_USE_SEPARATE_SLOTS
         swap(this->groups_alloc_, other.groups_alloc_);
 #endif
@@ -0,0 +1,994 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_GROUP15_ORDERED_FLAT_MAP_HPP
+#define JSTD_HASHMAP_GROUP15_ORDERED_FLAT_MAP_HPP
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>             // For memset()
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>               // For std::allocator<T>
+#include <functional>           // For std::hash<Key>
+#include <initializer_list>
+#include <iterator>             // For std::forward_iterator_tag
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>
+#include <tuple>                // For std::forward_as_tuple()
+#include <limits>
+#include <stdexcept>
+
+#include <assert.h>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/support/BitUtils.h"
+
+#include "jstd/hashmap/flat_map_type_policy.hpp"
+#include "jstd/hashmap/flat_map_slot_policy.hpp"
+#include "jstd/hashmap/slot_policy_traits.h"
+#include "jstd/hashmap/flat_map_group15.hpp"
+#include "jstd/hashmap/group_quadratic_prober.hpp"
+#include "jstd/hashmap/hash_token.hpp"
+
+namespace jstd {
+
+//
+// The iterator of group15_ordered_flat_map, a pointer to the entry and the map, the erased
+// entries (the holes) are skipped up to the current end of the entries of the map, so an
+// iterator stays valid when the entries are appended without a reallocation.
+//
+template <typename HashMap, typename T, bool IsConst>
+class group15_ordered_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+
+    using value_type = typename std::conditional<IsConst, const T, T>::type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+    using entry_type = typename HashMap::entry_type;
+    using size_type = typename HashMap::size_type;
+    using difference_type = typename HashMap::difference_type;
+
+    using mutable_iterator = group15_ordered_iterator<HashMap, T, false>;
+
+private:
+    entry_type *        entry_;
+    const HashMap *     hashmap_;
+
+    friend HashMap;
+    friend class group15_ordered_iterator<HashMap, T, !IsConst>;
+
+public:
+    group15_ordered_iterator() noexcept : entry_(nullptr), hashmap_(nullptr) {}
+    group15_ordered_iterator(const entry_type * entry, const HashMap * hashmap) noexcept
+        : entry_(const_cast<entry_type *>(entry)), hashmap_(hashmap) {}
+
+    template <bool IsConst2, typename std::enable_if<IsConst && !IsConst2>::type * = nullptr>
+    group15_ordered_iterator(const group15_ordered_iterator<HashMap, T, IsConst2> & src) noexcept
+        : entry_(src.entry_), hashmap_(src.hashmap_) {}
+
+    group15_ordered_iterator(const group15_ordered_iterator & src) noexcept = default;
+    group15_ordered_iterator & operator = (const group15_ordered_iterator & rhs) noexcept = default;
+
+    friend inline bool operator == (const group15_ordered_iterator & lhs,
+                                    const group15_ordered_iterator & rhs) noexcept {
+        return (lhs.entry_ == rhs.entry_);
+    }
+
+    friend inline bool operator != (const group15_ordered_iterator & lhs,
+                                    const group15_ordered_iterator & rhs) noexcept {
+        return (lhs.entry_ != rhs.entry_);
+    }
+
+    group15_ordered_iterator & operator ++ () noexcept {
+        this->increment();
+        return *this;
+    }
+
+    group15_ordered_iterator operator ++ (int) noexcept {
+        group15_ordered_iterator copy(*this);
+        this->increment();
+        return copy;
+    }
+
+    reference operator * () const noexcept {
+        return this->entry_->slot.value;
+    }
+
+    pointer operator -> () const noexcept {
+        return std::addressof(this->entry_->slot.value);
+    }
+
+    entry_type * entry() const noexcept { return this->entry_; }
+    const HashMap * hashmap() const noexcept { return this->hashmap_; }
+
+private:
+    void increment() noexcept {
+        const entry_type * last = this->hashmap_->last_entry();
+        assert(this->entry_ != last);
+        do {
+            ++this->entry_;
+        } while (this->entry_ != last && HashMap::is_erased_entry(this->entry_));
+    }
+};
+
+/*
+ * group15_ordered_flat_map<K, V>: An insertion-ordered hash map, the entries are stored
+ * densely in an array in insertion order, and a group15 index maps the hash to the
+ * 32-bit position of the entry (like the compact dict of CPython).
+ *
+ * The entries: { hash, key, value }, the iteration is a linear scan of the entry array,
+ * it doesn't depend on the load factor of the index. An erased entry leaves a hole
+ * (its hash is kErasedHash), the holes are skipped by the iterators, and the positions
+ * of the other entries don't change, so erase() doesn't invalidate the other iterators.
+ *
+ * The index: a group15 group (the same ctrl bytes, probing and overflow bits as group15_flat_map)
+ * followed by the uint32_t entry positions of its 15 slots, 80 bytes per group, so the ctrl bytes
+ * and the position are usually in the same cache line, and a slot is 5 bytes instead of
+ * sizeof(value_type).
+ *
+ * When the entry array is full, the holes are compacted if they are at least 1/4 of the
+ * entries, otherwise the array grows 2 times. Either way the index is rebuilt from the
+ * stored hashes only, the keys are never hashed again. The index is also rebuilt when
+ * the erasures used up its overflow budget.
+ *
+ * The iterators and references are invalidated by an insertion that compacts or grows
+ * the entries, like std::vector, other insertions only append, so the iterators stay valid
+ * and see the new entries. An iterator refers to its map, swap() invalidates the iterators.
+ */
+template <typename Key, typename Value,
+          typename Hash = std::hash< typename std::remove_const<Key>::type >,
+          typename KeyEqual = std::equal_to< typename std::remove_const<Key>::type >,
+          typename Allocator = std::allocator< std::pair<const typename std::remove_const<Key>::type,
+                                                         typename std::remove_const<Value>::type> > >
+class JSTD_DLL group15_ordered_flat_map
+{
+public:
+    typedef flat_map_type_policy<Key, Value>    type_policy;
+    typedef std::size_t                         size_type;
+    typedef std::intptr_t                       ssize_type;
+    typedef std::ptrdiff_t                      difference_type;
+
+    typedef typename type_policy::key_type      key_type;
+    typedef typename type_policy::mapped_type   mapped_type;
+    typedef typename type_policy::value_type    value_type;
+    typedef typename type_policy::init_type     init_type;
+    typedef typename type_policy::element_type  element_type;
+    typedef Hash                                hasher;
+    typedef KeyEqual                            key_equal;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>
+                                                allocator_type;
+
+    typedef value_type &                        reference;
+    typedef value_type const &                  const_reference;
+
+    using this_type = group15_ordered_flat_map<Key, Value, Hash, KeyEqual, Allocator>;
+
+    using ctrl_type = group15_meta_ctrl;
+    using group_type = flat_map_group15<group15_meta_ctrl>;
+    using prober_type = group_quadratic_prober;
+
+    using slot_type = map_slot_type<key_type, mapped_type>;
+    using slot_policy_t = flat_map_slot_policy<slot_type>;
+    using SlotPolicyTraits = slot_policy_traits<slot_policy_t>;
+
+    // The position of an entry in the index.
+    using position_type = std::uint32_t;
+
+    struct entry_type {
+        std::size_t hash;
+        slot_type   slot;
+    };
+
+    struct index_group {
+        group_type    group;
+        position_type positions[group_type::kGroupSize];
+        position_type reserved;
+    };
+
+    using iterator       = group15_ordered_iterator<this_type, value_type, false>;
+    using const_iterator = group15_ordered_iterator<this_type, value_type, true>;
+
+    static constexpr size_type kGroupSize  = group_type::kGroupSize;
+    static constexpr size_type kGroupWidth = group_type::kGroupWidth;
+
+    static constexpr size_type kMinEntryCapacity = 8;
+    static constexpr size_type kMaxEntryCapacity =
+        static_cast<size_type>((std::numeric_limits<position_type>::max)());
+
+    // The hash of an erased entry, the hash of a key is never this value.
+    static constexpr std::size_t kErasedHash = static_cast<std::size_t>(-1);
+
+    static constexpr float kDefaultLoadFactorF = 0.875f;
+    // Default load factor = 224 / 256 = 0.875
+    static constexpr size_type kLoadFactorAmplify = 256;
+    static constexpr size_type kDefaultMaxLoadFactor =
+        static_cast<size_type>((double)kLoadFactorAmplify * (double)kDefaultLoadFactorF + 0.5);
+
+    static constexpr bool kIsSlotTrivialDestructor =
+            (std::is_trivially_destructible<key_type>::value &&
+             std::is_trivially_destructible<mapped_type>::value);
+
+private:
+    friend class group15_ordered_iterator<this_type, value_type, false>;
+    friend class group15_ordered_iterator<this_type, value_type, true>;
+
+    using entry_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<entry_type>;
+    using index_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<index_group>;
+    using slot_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>;
+
+    using EntryAllocTraits = typename std::allocator_traits<allocator_type>::template rebind_traits<entry_type>;
+    using IndexAllocTraits = typename std::allocator_traits<allocator_type>::template rebind_traits<index_group>;
+
+    entry_type *            entries_;
+    index_group *           index_;
+    size_type               entry_size_;        // The used entries, include the holes
+    size_type               entry_capacity_;
+    size_type               group_mask_;
+    size_type               slot_size_;
+    size_type               slot_threshold_;
+
+    hasher                  hasher_;
+    key_equal               key_equal_;
+    allocator_type          allocator_;
+    entry_allocator_type    entry_allocator_;
+    index_allocator_type    index_allocator_;
+    slot_allocator_type     slot_allocator_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    group15_ordered_flat_map() : group15_ordered_flat_map(0) {}
+
+    explicit group15_ordered_flat_map(size_type capacity, hasher const & hash = hasher(),
+                                      key_equal const & pred = key_equal(),
+                                      allocator_type const & allocator = allocator_type())
+        : entries_(nullptr), index_(nullptr),
+          entry_size_(0), entry_capacity_(0), group_mask_(0), slot_size_(0), slot_threshold_(0),
+          hasher_(hash), key_equal_(pred), allocator_(allocator), entry_allocator_(allocator),
+          index_allocator_(allocator), slot_allocator_(allocator) {
+        if (capacity != 0) {
+            this->reserve(capacity);
+        }
+    }
+
+    template <typename Iterator>
+    group15_ordered_flat_map(Iterator first, Iterator last, size_type capacity = 0,
+                             hasher const & hash = hasher(), key_equal const & pred = key_equal(),
+                             allocator_type const & allocator = allocator_type())
+        : group15_ordered_flat_map(capacity, hash, pred, allocator) {
+        this->insert(first, last);
+    }
+
+    group15_ordered_flat_map(std::initializer_list<value_type> ilist,
+                             size_type capacity = 0, hasher const & hash = hasher(),
+                             key_equal const & pred = key_equal(),
+                             allocator_type const & allocator = allocator_type())
+        : group15_ordered_flat_map(ilist.begin(), ilist.end(), capacity, hash, pred, allocator) {
+    }
+
+    // The copy is compacted, the entries keep their order.
+    group15_ordered_flat_map(group15_ordered_flat_map const & other)
+        : group15_ordered_flat_map(0, other.hasher_, other.key_equal_, other.allocator_) {
+        if (other.size() != 0) {
+            this->allocate_table(other.size());
+            this->copy_entries_from(other);
+            this->reindex();
+        }
+    }
+
+    group15_ordered_flat_map(group15_ordered_flat_map && other) noexcept
+        : entries_(other.entries_), index_(other.index_),
+          entry_size_(other.entry_size_), entry_capacity_(other.entry_capacity_),
+          group_mask_(other.group_mask_), slot_size_(other.slot_size_),
+          slot_threshold_(other.slot_threshold_),
+          hasher_(std::move(other.hasher_)), key_equal_(std::move(other.key_equal_)),
+          allocator_(std::move(other.allocator_)),
+          entry_allocator_(std::move(other.entry_allocator_)),
+          index_allocator_(std::move(other.index_allocator_)),
+          slot_allocator_(std::move(other.slot_allocator_)) {
+        other.reset_table();
+    }
+
+    ~group15_ordered_flat_map() {
+        this->destroy();
+    }
+
+    group15_ordered_flat_map & operator = (group15_ordered_flat_map const & other) {
+        if (std::addressof(other) != this) {
+            this_type tmp(other);
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    group15_ordered_flat_map & operator = (group15_ordered_flat_map && other) noexcept {
+        if (std::addressof(other) != this) {
+            this_type tmp(std::move(other));
+            this->swap(tmp);
+        }
+        return *this;
+    }
+
+    ///
+    /// Observers
+    ///
+    allocator_type get_allocator() const noexcept {
+        return this->allocator_;
+    }
+
+    hasher hash_function() const noexcept {
+        return this->hasher_;
+    }
+
+    key_equal key_eq() const noexcept {
+        return this->key_equal_;
+    }
+
+    static const char * name() noexcept {
+        return "jstd::group15_ordered_flat_map";
+    }
+
+    ///
+    /// Iterators
+    ///
+    iterator begin() noexcept {
+        return iterator(this->first_entry(), this);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this->first_entry(), this);
+    }
+
+    iterator end() noexcept {
+        return iterator(this->last_entry(), this);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this->last_entry(), this);
+    }
+
+    const_iterator cbegin() const noexcept { return this->begin(); }
+    const_iterator cend() const noexcept { return this->end(); }
+
+    ///
+    /// Capacity
+    ///
+    bool empty() const noexcept { return (this->size() == 0); }
+    size_type size() const noexcept { return this->slot_size_; }
+    size_type capacity() const noexcept { return this->entry_capacity_; }
+
+    size_type max_size() const noexcept {
+        return (std::min)(kMaxEntryCapacity,
+                          static_cast<size_type>((std::numeric_limits<difference_type>::max)() / sizeof(entry_type)));
+    }
+
+    size_type entry_size() const noexcept { return this->entry_size_; }
+    size_type entry_capacity() const noexcept { return this->entry_capacity_; }
+    size_type hole_count() const noexcept { return (this->entry_size_ - this->slot_size_); }
+
+    size_type slot_size() const noexcept { return this->slot_size_; }
+    size_type slot_capacity() const noexcept { return (this->group_capacity() * kGroupSize); }
+    size_type slot_threshold() const noexcept { return this->slot_threshold_; }
+
+    size_type group_mask() const noexcept { return this->group_mask_; }
+    size_type group_capacity() const noexcept {
+        return (this->index_ != nullptr) ? (this->group_mask_ + 1) : 0;
+    }
+
+    bool is_valid() const noexcept { return (this->entries_ != nullptr); }
+
+    float load_factor() const noexcept {
+        return (this->slot_capacity() != 0) ? ((float)this->size() / this->slot_capacity()) : 0.0f;
+    }
+
+    void reserve(size_type new_capacity) {
+        if (new_capacity > this->entry_capacity_) {
+            this->resize_entries(new_capacity);
+        }
+    }
+
+    void rehash(size_type new_capacity) {
+        size_type min_capacity = (std::max)(new_capacity, this->size());
+        if (min_capacity != this->entry_capacity_) {
+            this->resize_entries(min_capacity);
+        }
+    }
+
+    void shrink_to_fit() {
+        this->rehash(this->size());
+    }
+
+    //
+    // Remove the holes of the erased entries now, the entries keep their order.
+    //
+    void compact() {
+        if (this->hole_count() != 0) {
+            this->compact_entries();
+            this->reindex();
+        }
+    }
+
+    ///
+    /// Lookup
+    ///
+    size_type count(const key_type & key) const {
+        return (this->find_entry(key) != nullptr) ? 1 : 0;
+    }
+
+    bool contains(const key_type & key) const {
+        return (this->find_entry(key) != nullptr);
+    }
+
+    iterator find(const key_type & key) {
+        entry_type * entry = this->find_entry(key);
+        return (entry != nullptr) ? iterator(entry, this) : this->end();
+    }
+
+    const_iterator find(const key_type & key) const {
+        const entry_type * entry = this->find_entry(key);
+        return (entry != nullptr) ? const_iterator(entry, this) : this->end();
+    }
+
+    mapped_type & at(const key_type & key) {
+        entry_type * entry = this->find_entry(key);
+        if (entry != nullptr) {
+            return entry->slot.value.second;
+        }
+        throw std::out_of_range("key was not found in group15_ordered_flat_map");
+    }
+
+    const mapped_type & at(const key_type & key) const {
+        const entry_type * entry = this->find_entry(key);
+        if (entry != nullptr) {
+            return entry->slot.value.second;
+        }
+        throw std::out_of_range("key was not found in group15_ordered_flat_map");
+    }
+
+    mapped_type & operator [] (const key_type & key) {
+        return this->try_emplace_impl(key).first->second;
+    }
+
+    mapped_type & operator [] (key_type && key) {
+        return this->try_emplace_impl(std::move(key)).first->second;
+    }
+
+    ///
+    /// Modifiers
+    ///
+    void clear() noexcept {
+        this->destroy_entries();
+        this->entry_size_ = 0;
+        this->slot_size_ = 0;
+        if (this->index_ != nullptr) {
+            this->clear_index();
+        }
+    }
+
+    std::pair<iterator, bool> insert(const value_type & value) {
+        return this->try_emplace_impl(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type && value) {
+        return this->try_emplace_impl(value.first, std::move(value.second));
+    }
+
+    std::pair<iterator, bool> insert(const init_type & value) {
+        return this->try_emplace_impl(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(init_type && value) {
+        return this->try_emplace_impl(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename InputIter>
+    void insert(InputIter first, InputIter last) {
+        for (; first != last; ++first) {
+            this->insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        this->insert(ilist.begin(), ilist.end());
+    }
+
+    // An existing key keeps its position in the order.
+    template <typename MappedT>
+    std::pair<iterator, bool> insert_or_assign(const key_type & key, MappedT && value) {
+        return this->insert_or_assign_impl(key, std::forward<MappedT>(value));
+    }
+
+    template <typename MappedT>
+    std::pair<iterator, bool> insert_or_assign(key_type && key, MappedT && value) {
+        return this->insert_or_assign_impl(std::move(key), std::forward<MappedT>(value));
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> emplace(Args && ... args) {
+        init_type value(std::forward<Args>(args)...);
+        return this->try_emplace_impl(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> try_emplace(const key_type & key, Args && ... args) {
+        return this->try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> try_emplace(key_type && key, Args && ... args) {
+        return this->try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    size_type erase(const key_type & key) {
+        if (likely(this->size() != 0)) {
+            std::size_t key_hash = this->hash_for(key);
+            size_type group_index, pos;
+            if (this->find_index(key, key_hash, group_index, pos)) {
+                this->erase_at(group_index, pos);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    // The erasure only leaves a hole, returns the next iterator.
+    iterator erase(const_iterator pos) {
+        entry_type * entry = pos.entry_;
+        size_type group_index, index_pos;
+        bool is_found = this->find_index_of(entry, group_index, index_pos);
+        assert(is_found);
+        (void)is_found;
+        this->erase_at(group_index, index_pos);
+        iterator next(entry, this);
+        ++next;
+        return next;
+    }
+
+    void swap(this_type & other) noexcept {
+        using std::swap;
+        swap(this->entries_, other.entries_);
+        swap(this->index_, other.index_);
+        swap(this->entry_size_, other.entry_size_);
+        swap(this->entry_capacity_, other.entry_capacity_);
+        swap(this->group_mask_, other.group_mask_);
+        swap(this->slot_size_, other.slot_size_);
+        swap(this->slot_threshold_, other.slot_threshold_);
+        swap(this->hasher_, other.hasher_);
+        swap(this->key_equal_, other.key_equal_);
+        swap(this->allocator_, other.allocator_);
+        swap(this->entry_allocator_, other.entry_allocator_);
+        swap(this->index_allocator_, other.index_allocator_);
+        swap(this->slot_allocator_, other.slot_allocator_);
+    }
+
+    friend void swap(this_type & lhs, this_type & rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+private:
+    static bool is_erased_entry(const entry_type * entry) noexcept {
+        return (entry->hash == kErasedHash);
+    }
+
+    entry_type * first_entry() const noexcept {
+        entry_type * entry = this->entries_;
+        entry_type * last = this->last_entry();
+        while (entry != last && this_type::is_erased_entry(entry)) {
+            ++entry;
+        }
+        return entry;
+    }
+
+    entry_type * last_entry() const noexcept {
+        return (this->entries_ + this->entry_size_);
+    }
+
+    ///
+    /// Hash
+    ///
+    JSTD_FORCED_INLINE
+    std::size_t hash_for(const key_type & key) const
+        noexcept(noexcept(this->hasher_(key))) {
+        std::size_t key_hash = hash_token<Hash>::mix_hash(static_cast<std::size_t>(this->hasher_(key)));
+        // kErasedHash marks the holes, move the key hash off it.
+        return (likely(key_hash != kErasedHash) ? key_hash : (kErasedHash - 1));
+    }
+
+    JSTD_FORCED_INLINE
+    size_type index_for_hash(std::size_t key_hash) const noexcept {
+        return (static_cast<size_type>(key_hash) & this->group_mask_);
+    }
+
+    // The index uses the low bits, take the ctrl hash from the high bits.
+    JSTD_FORCED_INLINE
+    static std::uint8_t ctrl_for_hash(std::size_t key_hash) noexcept {
+        return ctrl_type::reduced_hash(key_hash >> (sizeof(std::size_t) * 8 - 8));
+    }
+
+    size_type calc_slot_threshold(size_type group_capacity) const noexcept {
+        return (group_capacity * kGroupSize * kDefaultMaxLoadFactor / kLoadFactorAmplify);
+    }
+
+    // The index never fills up before the entries.
+    size_type calc_group_capacity(size_type entry_capacity) const noexcept {
+        size_type group_capacity = 1;
+        while (this->calc_slot_threshold(group_capacity) < entry_capacity) {
+            group_capacity *= 2;
+        }
+        return group_capacity;
+    }
+
+    ///
+    /// Lookup
+    ///
+    JSTD_FORCED_INLINE
+    entry_type * find_entry(const key_type & key) const {
+        if (likely(this->size() != 0)) {
+            std::size_t key_hash = this->hash_for(key);
+            size_type group_index, pos;
+            if (this->find_index(key, key_hash, group_index, pos)) {
+                return (this->entries_ + this->index_[group_index].positions[pos]);
+            }
+        }
+        return nullptr;
+    }
+
+    JSTD_FORCED_INLINE
+    bool find_index(const key_type & key, std::size_t key_hash,
+                    size_type & group_index, size_type & pos) const {
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+        prober_type prober(this->index_for_hash(key_hash));
+        do {
+            group_index = prober.get();
+            const index_group * index = this->index_ + group_index;
+            const group_type * group = &index->group;
+            std::uint32_t match_mask = group->match_hash(ctrl_hash);
+            if (match_mask != 0) {
+                const position_type * positions = index->positions;
+                do {
+                    pos = static_cast<size_type>(BitUtils::bsf32(match_mask));
+                    const entry_type * entry = this->entries_ + positions[pos];
+                    if (likely(entry->hash == key_hash &&
+                               this->key_equal_(key, entry->slot.value.first))) {
+                        return true;
+                    }
+                    match_mask = BitUtils::clearLowBit32(match_mask);
+                } while (match_mask != 0);
+            }
+            // If it's not overflow, means it hasn't been found.
+            if (likely(group->is_not_overflow(ctrl_hash))) {
+                return false;
+            }
+        } while (prober.next_bucket(this->group_mask_));
+
+        return false;
+    }
+
+    // Find the index slot of an entry by its position, the key is not compared.
+    bool find_index_of(const entry_type * entry, size_type & group_index, size_type & pos) const {
+        position_type position = static_cast<position_type>(entry - this->entries_);
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(entry->hash);
+        prober_type prober(this->index_for_hash(entry->hash));
+        do {
+            group_index = prober.get();
+            const group_type * group = &this->index_[group_index].group;
+            std::uint32_t match_mask = group->match_hash(ctrl_hash);
+            while (match_mask != 0) {
+                pos = static_cast<size_type>(BitUtils::bsf32(match_mask));
+                if (this->index_[group_index].positions[pos] == position) {
+                    return true;
+                }
+                match_mask = BitUtils::clearLowBit32(match_mask);
+            }
+            if (group->is_not_overflow(ctrl_hash)) {
+                return false;
+            }
+        } while (prober.next_bucket(this->group_mask_));
+
+        return false;
+    }
+
+    // Find an empty index slot for the hash, and set the overflow bits of the full groups on the way.
+    void find_empty_to_insert(std::size_t key_hash, size_type & group_index, size_type & pos) noexcept {
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+        prober_type prober(this->index_for_hash(key_hash));
+        do {
+            group_index = prober.get();
+            group_type * group = &this->index_[group_index].group;
+            std::uint32_t empty_mask = group->match_empty();
+            if (empty_mask != 0) {
+                pos = static_cast<size_type>(BitUtils::bsf32(empty_mask));
+                return;
+            }
+            group->set_overflow(ctrl_hash);
+        } while (prober.next_bucket(this->group_mask_));
+
+        // The slot threshold is less than the slot capacity.
+        assert(false);
+    }
+
+    JSTD_FORCED_INLINE
+    void index_entry(std::size_t key_hash, position_type position) noexcept {
+        size_type group_index = 0, pos = 0;
+        this->find_empty_to_insert(key_hash, group_index, pos);
+        this->index_[group_index].group.set_used(pos, this->ctrl_for_hash(key_hash));
+        this->index_[group_index].positions[pos] = position;
+    }
+
+    ///
+    /// Insertion and erasure
+    ///
+    template <typename KeyT, typename ... Args>
+    std::pair<iterator, bool> try_emplace_impl(KeyT && key, Args && ... args) {
+        std::size_t key_hash = this->hash_for(key);
+        if (likely(this->size() != 0)) {
+            size_type group_index, pos;
+            if (this->find_index(key, key_hash, group_index, pos)) {
+                entry_type * entry = this->entries_ + this->index_[group_index].positions[pos];
+                return { iterator(entry, this), false };
+            }
+        }
+
+        if (unlikely(this->entry_size_ >= this->entry_capacity_)) {
+            this->make_room();
+        } else if (unlikely(this->slot_size_ >= this->slot_threshold_)) {
+            // The erasures used up the overflow budget of the index.
+            this->reindex();
+        }
+
+        entry_type * entry = this->entries_ + this->entry_size_;
+        SlotPolicyTraits::construct(&this->slot_allocator_, &entry->slot,
+                                    std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<KeyT>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        entry->hash = key_hash;
+        this->index_entry(key_hash, static_cast<position_type>(this->entry_size_));
+        this->entry_size_++;
+        this->slot_size_++;
+        return { iterator(entry, this), true };
+    }
+
+    template <typename KeyT, typename MappedT>
+    std::pair<iterator, bool> insert_or_assign_impl(KeyT && key, MappedT && value) {
+        std::pair<iterator, bool> result = this->try_emplace_impl(std::forward<KeyT>(key),
+                                                                  std::forward<MappedT>(value));
+        if (!result.second) {
+            result.first->second = std::forward<MappedT>(value);
+        }
+        return result;
+    }
+
+    void erase_at(size_type group_index, size_type pos) {
+        group_type * group = &this->index_[group_index].group;
+        assert(group->is_used(pos));
+        // Like group15_flat_map, a slot of an overflowed group is not counted as free again.
+        if (group->is_overflow(group->value(pos))) {
+            assert(this->slot_threshold_ > 0);
+            this->slot_threshold_--;
+        }
+        entry_type * entry = this->entries_ + this->index_[group_index].positions[pos];
+        SlotPolicyTraits::destroy(&this->slot_allocator_, &entry->slot);
+        entry->hash = kErasedHash;
+        group->set_empty(pos);
+        assert(this->slot_size_ > 0);
+        this->slot_size_--;
+    }
+
+    //
+    // The entries are full: compact the holes if they are at least 1/4 of the entries,
+    // otherwise grow the entries 2 times.
+    //
+    JSTD_NO_INLINE
+    void make_room() {
+        if (this->is_valid() && this->hole_count() >= (this->entry_size_ / 4) && this->hole_count() != 0) {
+            this->compact_entries();
+            this->reindex();
+        } else {
+            size_type new_capacity = this->is_valid() ? (this->entry_capacity_ * 2) : kMinEntryCapacity;
+            if (new_capacity > kMaxEntryCapacity) {
+                if (this->entry_capacity_ >= kMaxEntryCapacity)
+                    throw std::length_error("group15_ordered_flat_map: too many entries");
+                new_capacity = kMaxEntryCapacity;
+            }
+            this->resize_entries(new_capacity);
+        }
+    }
+
+    // Move the live entries to the front, in order.
+    void compact_entries() noexcept {
+        entry_type * dest = this->entries_;
+        entry_type * last = this->last_entry();
+        for (entry_type * entry = this->entries_; entry != last; ++entry) {
+            if (!this_type::is_erased_entry(entry)) {
+                if (dest != entry) {
+                    SlotPolicyTraits::transfer(&this->slot_allocator_, &dest->slot, &entry->slot);
+                    dest->hash = entry->hash;
+                }
+                ++dest;
+            }
+        }
+        this->entry_size_ = static_cast<size_type>(dest - this->entries_);
+        assert(this->entry_size_ == this->slot_size_);
+    }
+
+    void clear_index() noexcept {
+        for (size_type i = 0; i < this->group_capacity(); i++) {
+            this->index_[i].group.init();
+        }
+        this->slot_threshold_ = this->calc_slot_threshold(this->group_capacity());
+    }
+
+    // Rebuild the index from the stored hashes, the holes are skipped.
+    void reindex() noexcept {
+        this->clear_index();
+        for (size_type i = 0; i < this->entry_size_; i++) {
+            const entry_type * entry = this->entries_ + i;
+            if (!this_type::is_erased_entry(entry)) {
+                this->index_entry(entry->hash, static_cast<position_type>(i));
+            }
+        }
+    }
+
+    void allocate_table(size_type entry_capacity) {
+        assert(this->entries_ == nullptr);
+        size_type group_capacity = this->calc_group_capacity(entry_capacity);
+        entry_type * entries = EntryAllocTraits::allocate(this->entry_allocator_, entry_capacity);
+        index_group * index;
+        try {
+            index = IndexAllocTraits::allocate(this->index_allocator_, group_capacity);
+        } catch (...) {
+            EntryAllocTraits::deallocate(this->entry_allocator_, entries, entry_capacity);
+            throw;
+        }
+        this->entries_ = entries;
+        this->index_ = index;
+        this->entry_capacity_ = entry_capacity;
+        this->group_mask_ = group_capacity - 1;
+        this->clear_index();
+    }
+
+    //
+    // Move the live entries into a new entry array of new_capacity, in order, and build
+    // a new index of the matching size. The holes are dropped on the way.
+    //
+    void resize_entries(size_type new_capacity) {
+        new_capacity = (std::max)(new_capacity, kMinEntryCapacity);
+        if (new_capacity > kMaxEntryCapacity)
+            throw std::length_error("group15_ordered_flat_map: too many entries");
+
+        entry_type * old_entries = this->entries_;
+        index_group * old_index = this->index_;
+        size_type old_entry_size = this->entry_size_;
+        size_type old_entry_capacity = this->entry_capacity_;
+        size_type old_group_capacity = this->group_capacity();
+
+        this->entries_ = nullptr;
+        this->index_ = nullptr;
+        try {
+            this->allocate_table(new_capacity);
+        } catch (...) {
+            this->entries_ = old_entries;
+            this->index_ = old_index;
+            throw;
+        }
+
+        entry_type * dest = this->entries_;
+        for (size_type i = 0; i < old_entry_size; i++) {
+            entry_type * entry = old_entries + i;
+            if (!this_type::is_erased_entry(entry)) {
+                SlotPolicyTraits::transfer(&this->slot_allocator_, &dest->slot, &entry->slot);
+                dest->hash = entry->hash;
+                ++dest;
+            }
+        }
+        this->entry_size_ = static_cast<size_type>(dest - this->entries_);
+        assert(this->entry_size_ == this->slot_size_);
+        this->reindex();
+
+        if (old_entries != nullptr) {
+            EntryAllocTraits::deallocate(this->entry_allocator_, old_entries, old_entry_capacity);
+            IndexAllocTraits::deallocate(this->index_allocator_, old_index, old_group_capacity);
+        }
+    }
+
+    void copy_entries_from(const this_type & other) {
+        assert(this->entry_size_ == 0);
+        const entry_type * last = other.last_entry();
+        for (const entry_type * entry = other.entries_; entry != last; ++entry) {
+            if (!this_type::is_erased_entry(entry)) {
+                entry_type * dest = this->entries_ + this->entry_size_;
+                SlotPolicyTraits::construct(&this->slot_allocator_, &dest->slot, &entry->slot);
+                dest->hash = entry->hash;
+                this->entry_size_++;
+                this->slot_size_++;
+            }
+        }
+    }
+
+    void destroy_entries() noexcept {
+        if (!kIsSlotTrivialDestructor) {
+            entry_type * last = this->last_entry();
+            for (entry_type * entry = this->entries_; entry != last; ++entry) {
+                if (!this_type::is_erased_entry(entry)) {
+                    SlotPolicyTraits::destroy(&this->slot_allocator_, &entry->slot);
+                }
+            }
+        }
+    }
+
+    void destroy() noexcept {
+        if (this->entries_ != nullptr) {
+            this->destroy_entries();
+            EntryAllocTraits::deallocate(this->entry_allocator_, this->entries_, this->entry_capacity_);
+            IndexAllocTraits::deallocate(this->index_allocator_, this->index_, this->group_capacity());
+        }
+        this->reset_table();
+    }
+
+    void reset_table() noexcept {
+        this->entries_ = nullptr;
+        this->index_ = nullptr;
+        this->entry_size_ = 0;
+        this->entry_capacity_ = 0;
+        this->group_mask_ = 0;
+        this->slot_size_ = 0;
+        this->slot_threshold_ = 0;
+    }
+};
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_GROUP15_ORDERED_FLAT_MAP_HPP
@@ -110,6 +110,8 @@ public:
     typedef typename table_type::iterator       iterator;
     typedef typename table_type::const_iterator const_iterator;
 
+    typedef typename table_type::hash_token     hash_token;
+
     using this_type = group16_flat_map<Key, Value, Hash, KeyEqual, Allocator>;
 
 private:
@@ -379,6 +381,32 @@ public:
         return table_.find(key);
     }
 
+    ///
+    /// Hash token: make_token(key), prefetch(token), find(key, token)
+    ///
+    /// Compute the hash of a key once, and reuse it in the maps that share the hasher,
+    /// see jstd::hash_token<Hash>.
+    ///
+    JSTD_FORCED_INLINE
+    hash_token make_token(const key_type & key) const {
+        return table_.make_token(key);
+    }
+
+    JSTD_FORCED_INLINE
+    void prefetch(const hash_token & token) const noexcept {
+        table_.prefetch(token);
+    }
+
+    JSTD_FORCED_INLINE
+    iterator find(const key_type & key, const hash_token & token) {
+        return table_.find(key, token);
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator find(const key_type & key, const hash_token & token) const {
+        return table_.find(key, token);
+    }
+
     ///
     /// Modifiers
     ///
@@ -468,13 +496,13 @@ public:
     template <typename MappedT>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> insert_or_assign(const key_type & key, MappedT && value) {
-        return this->emplace_impl<true>(key, std::forward<MappedT>(value));
+        return table_.insert_or_assign(key, std::forward<MappedT>(value));
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> insert_or_assign(key_type && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value));
+        return table_.insert_or_assign(std::move(key), std::forward<MappedT>(value));
     }
 
     template <typename KeyT, typename MappedT, typename std::enable_if<
@@ -484,19 +512,19 @@ public:
               !std::is_convertible<KeyT, const_iterator>::value>::type * = nullptr>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> insert_or_assign(KeyT && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value));
+        return table_.insert_or_assign(std::forward<KeyT>(key), std::forward<MappedT>(value));
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, const key_type & key, MappedT && value) {
-        return this->emplace_impl<true>(key, std::forward<MappedT>(value))->first;
+        return table_.insert_or_assign(hint, key, std::forward<MappedT>(value));
     }
 
     template <typename MappedT>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, key_type && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value))->first;
+        return table_.insert_or_assign(hint, std::move(key), std::forward<MappedT>(value));
     }
 
     template <typename KeyT, typename MappedT, typename std::enable_if<
@@ -506,7 +534,7 @@ public:
               !std::is_convertible<KeyT, const_iterator>::value>::type * = nullptr>
     JSTD_FORCED_INLINE
     iterator insert_or_assign(const_iterator hint, KeyT && key, MappedT && value) {
-        return this->emplace_impl<true>(std::move(key), std::forward<MappedT>(value))->first;
+        return table_.insert_or_assign(hint, std::forward<KeyT>(key), std::forward<MappedT>(value));
     }
 
     ///
@@ -546,7 +574,8 @@ public:
                             !std::is_convertible<key_type, KeyT &&>::value) &&
                             !std::is_same<key_type, KeyT>::value &&
                             !std::is_convertible<KeyT, iterator>::value &&
-                            !std::is_convertible<KeyT, const_iterator>::value,
+                            !std::is_convertible<KeyT, const_iterator>::value &&
+                            !jstd::is_hash_token_arg<KeyT>::value,
                              std::pair<iterator, bool> >::type
     try_emplace(KeyT && key, Args && ... args) {
         return table_.try_emplace(std::forward<KeyT>(key), std::forward<Args>(args)...);
@@ -555,17 +584,30 @@ public:
     // For compatibility with versions below C++17 that do not support T::is_transparent
     template <typename KeyT, typename ... Args>
     JSTD_FORCED_INLINE
-    typename std::enable_if<!jstd::are_transparent<KeyT, Hash, KeyEqual>::value ||
-                            (std::is_convertible<key_type, const KeyT &>::value ||
-                             std::is_convertible<key_type, KeyT &&>::value) &&
-                            !std::is_same<key_type, KeyT>::value &&
-                            !std::is_convertible<KeyT, iterator>::value &&
-                            !std::is_convertible<KeyT, const_iterator>::value,
+    typename std::enable_if<(!jstd::are_transparent<KeyT, Hash, KeyEqual>::value ||
+                             (std::is_convertible<key_type, const KeyT &>::value ||
+                              std::is_convertible<key_type, KeyT &&>::value) &&
+                             !std::is_same<key_type, KeyT>::value &&
+                             !std::is_convertible<KeyT, iterator>::value &&
+                             !std::is_convertible<KeyT, const_iterator>::value) &&
+                            !jstd::is_hash_token_arg<KeyT>::value,
                              std::pair<iterator, bool> >::type
     try_emplace(KeyT && key, Args && ... args) {
         return table_.try_emplace(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, const key_type & key, Args && ... args) {
+        return table_.try_emplace(token, key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, key_type && key, Args && ... args) {
+        return table_.try_emplace(token, std::move(key), std::forward<Args>(args)...);
+    }
+
     template <typename ... Args>
     JSTD_FORCED_INLINE
     iterator try_emplace(const_iterator hint, const key_type & key, Args && ... args) {
@@ -654,6 +696,25 @@ public:
         return num_deleted;
     }
 
+    ///
+    /// Comparison: equals(other), diff(other, on_added, on_removed, on_changed)
+    ///
+    /// See group16_flat_table::equals() and group16_flat_table::diff().
+    ///
+    JSTD_FORCED_INLINE
+    bool equals(const this_type & other) const {
+        return table_.equals(other.table_);
+    }
+
+    template <typename OnAdded, typename OnRemoved, typename OnChanged>
+    JSTD_FORCED_INLINE
+    size_type diff(const this_type & other, OnAdded && on_added,
+                   OnRemoved && on_removed, OnChanged && on_changed) const {
+        return table_.diff(other.table_, std::forward<OnAdded>(on_added),
+                           std::forward<OnRemoved>(on_removed),
+                           std::forward<OnChanged>(on_changed));
+    }
+
     JSTD_FORCED_INLINE
     void swap(this_type & other) {
         table_.swap(other.table_);
@@ -682,6 +743,39 @@ void swap(group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & lhs,
     lhs.swap(rhs);
 }
 
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc>
+inline
+bool operator == (const group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & lhs,
+                  const group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & rhs)
+{
+    return lhs.equals(rhs);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc>
+inline
+bool operator != (const group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & lhs,
+                  const group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & rhs)
+{
+    return !lhs.equals(rhs);
+}
+
+/**
+ * Reports the changes from @c old_map to @c new_map: on_added(value), on_removed(value)
+ * and on_changed(old_value, new_value). Returns the number of changes.
+ */
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Alloc,
+          typename OnAdded, typename OnRemoved, typename OnChanged>
+inline
+typename group16_flat_map<Key, Value, Hash, KeyEqual, Alloc>::size_type
+diff(const group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & old_map,
+     const group16_flat_map<Key, Value, Hash, KeyEqual, Alloc> & new_map,
+     OnAdded && on_added, OnRemoved && on_removed, OnChanged && on_changed)
+{
+    return old_map.diff(new_map, std::forward<OnAdded>(on_added),
+                        std::forward<OnRemoved>(on_removed),
+                        std::forward<OnChanged>(on_changed));
+}
+
 } // namespace jstd
 
 ///////////////////////////////////////////////////////////
@@ -53,6 +53,7 @@
 
 #define NOMINMAX
 #include <stdint.h>
+#include <string.h>         // For memcmp()
 
 #include <cstdint>
 #include <memory>           // For std::allocator<T>
@@ -76,6 +77,7 @@
 #include "jstd/hashmap/flat_map_iterator.hpp"
 #include "jstd/hashmap/flat_map_group16.hpp"
 #include "jstd/hashmap/group_quadratic_prober.hpp"
+#include "jstd/hashmap/hash_token.hpp"
 
 #include "jstd/hashmap/detail/hashmap_traits.h"
 
@@ -128,6 +130,7 @@ public:
     static constexpr bool kEnableExchange = true;
 
     static constexpr bool kIsTransparent = (jstd::is_transparent<Hash>::value && jstd::is_transparent<KeyEqual>::value);
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hash>::value;
     static constexpr bool kIsLayoutCompatible = jstd::is_layout_compatible_kv<key_type, mapped_type>::value;
 
     static constexpr size_type npos = static_cast<size_type>(-1);
@@ -210,6 +213,8 @@ public:
     using iterator       = flat_map_iterator<this_type, value_type, kIsIndirectKV>;
     using const_iterator = flat_map_iterator<this_type, const value_type, kIsIndirectKV>;
 
+    using hash_token = jstd::hash_token<Hash>;
+
     static constexpr size_type kDefaultCapacity = 0;
     // kMinCapacity must be >= (kGroupWidth * 2)
     static constexpr size_type kMinCapacity = kGroupWidth * 2;
@@ -228,6 +233,9 @@ public:
 
     static constexpr size_type kSkipGroupsLimit = 5;
 
+    // The number of lookups in flight of equals() and diff().
+    static constexpr size_type kDiffBatchSize = 16;
+
     using group_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<group_type>;
     using slot_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<slot_type>;
 
@@ -759,6 +767,37 @@ public:
         return this->iterator_at(slot_index);
     }
 
+    ///
+    /// Hash token: make_token(key), prefetch(token), find(key, token)
+    ///
+    /// The token must be made from the same key, see jstd::hash_token<Hash>.
+    ///
+    JSTD_FORCED_INLINE
+    hash_token make_token(const key_type & key) const {
+        return hash_token(this->raw_hash_for(key));
+    }
+
+    JSTD_FORCED_INLINE
+    void prefetch(const hash_token & token) const noexcept {
+        size_type group_index = this->index_for_hash(this->hash_for_token(token));
+        Prefetch_Read_T0((const void *)this->group_at(group_index));
+    }
+
+    JSTD_FORCED_INLINE
+    iterator find(const key_type & key, const hash_token & token) {
+        return const_cast<const this_type *>(this)->find(key, token);
+    }
+
+    JSTD_FORCED_INLINE
+    const_iterator find(const key_type & key, const hash_token & token) const {
+        assert(token == this->make_token(key));
+        std::size_t key_hash = this->hash_for_token(token);
+        size_type group_index = this->index_for_hash(key_hash);
+        std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
+        size_type slot_index = this->find_index(key, group_index, ctrl_hash);
+        return this->iterator_at(slot_index);
+    }
+
     ///
     /// Modifiers
     ///
@@ -916,12 +955,28 @@ public:
         return this->try_emplace_impl(std::move(key), std::forward<Args>(args)...);
     }
 
-    template <typename KeyT, typename ... Args>
+    template <typename KeyT, typename ... Args,
+              typename std::enable_if<!jstd::is_hash_token_arg<KeyT>::value>::type * = nullptr>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> try_emplace(KeyT && key, Args && ... args) {
         return this->try_emplace_impl(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, const key_type & key, Args && ... args) {
+        assert(token == this->make_token(key));
+        return this->try_emplace_with_hash(this->hash_for_token(token), key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace(const hash_token & token, key_type && key, Args && ... args) {
+        assert(token == this->make_token(key));
+        return this->try_emplace_with_hash(this->hash_for_token(token), std::move(key),
+                                           std::forward<Args>(args)...);
+    }
+
     template <typename ... Args>
     JSTD_FORCED_INLINE
     std::pair<iterator, bool> try_emplace(const_iterator hint, const key_type & key, Args && ... args) {
@@ -962,6 +1017,74 @@ public:
         return this->erase(iterator(pos));
     }
 
+    ///
+    /// Comparison: equals(other), diff(other, on_added, on_removed, on_changed)
+    ///
+    //
+    // Two tables are equal if they have the same keys, and the mapped values of each key
+    // are equal (operator ==). The sizes are compared first.
+    //
+    // The used slots of this table are walked group by group, and looked up in the other
+    // table in batches of kDiffBatchSize, the groups of a batch are prefetched before
+    // the first lookup. If both tables have the same capacity, a group that is
+    // byte-for-byte identical (memcmp) with the group of the same index in the other table
+    // most likely holds the same keys at the same positions, so its slots are paired
+    // directly, without any lookup. In a group that differs, only the slots whose ctrl byte
+    // differs are looked up. It's the common case of a copy of a table that was changed
+    // a little.
+    //
+    bool equals(const this_type & other) const {
+        if (this->size() != other.size())
+            return false;
+        if (std::addressof(other) == this || this->size() == 0)
+            return true;
+
+        return this->match_slots(other, [](const slot_type * slot, const slot_type * other_slot) -> bool {
+            return ((other_slot != nullptr) && (slot->value.second == other_slot->value.second));
+        });
+    }
+
+    //
+    // Reports the changes from this table (the old one) to the other table (the new one):
+    //
+    //   on_added(value):              the key is only in the other table.
+    //   on_removed(value):            the key is only in this table.
+    //   on_changed(value, new_value): the key is in both tables, but the mapped values are different.
+    //
+    // Returns the number of changes.
+    //
+    template <typename OnAdded, typename OnRemoved, typename OnChanged>
+    size_type diff(const this_type & other, OnAdded && on_added,
+                   OnRemoved && on_removed, OnChanged && on_changed) const {
+        size_type num_changes = 0;
+        if (std::addressof(other) == this)
+            return num_changes;
+
+        if (this->size() != 0) {
+            this->match_slots(other, [&](const slot_type * slot, const slot_type * other_slot) -> bool {
+                if (other_slot == nullptr) {
+                    on_removed(slot->value);
+                    num_changes++;
+                } else if (!(slot->value.second == other_slot->value.second)) {
+                    on_changed(slot->value, other_slot->value);
+                    num_changes++;
+                }
+                return true;
+            });
+        }
+        if (other.size() != 0) {
+            // The keys that are in both tables have been reported, only look for the added keys.
+            other.match_slots(*this, [&](const slot_type * slot, const slot_type * other_slot) -> bool {
+                if (other_slot == nullptr) {
+                    on_added(slot->value);
+                    num_changes++;
+                }
+                return true;
+            });
+        }
+        return num_changes;
+    }
+
     JSTD_FORCED_INLINE
     void swap(this_type & other) {
         if (std::addressof(other) != this) {
@@ -1307,8 +1430,11 @@ private:
         return (size_type)((std::uintptr_t)this->ctrls() >> 12);
     }
 
+    //
+    // The hash code of the hasher, before the avalanche mixing.
+    //
     JSTD_FORCED_INLINE
-    std::size_t hash_for(const key_type & key) const
+    std::size_t raw_hash_for(const key_type & key) const
         noexcept(noexcept(this->hasher_(key))) {
 #if GROUP16_USE_HASH_POLICY
         std::size_t key_hash = static_cast<std::size_t>(this->hash_policy_.get_hash_code(key));
@@ -1322,12 +1448,29 @@ private:
   #else
         std::size_t key_hash = static_cast<std::size_t>(this->hasher_(key));
   #endif
-        if (!jstd::detail::hash_is_avalanching<Hash>::value)
-            key_hash = hashes::mum_mul_mix(key_hash);
 #endif
         return key_hash;
     }
 
+    JSTD_FORCED_INLINE
+    std::size_t hash_for(const key_type & key) const
+        noexcept(noexcept(this->hasher_(key))) {
+#if GROUP16_USE_HASH_POLICY
+        return this->raw_hash_for(key);
+#else
+        return hash_token::mix_hash(this->raw_hash_for(key));
+#endif
+    }
+
+    JSTD_FORCED_INLINE
+    std::size_t hash_for_token(const hash_token & token) const noexcept {
+#if GROUP16_USE_HASH_POLICY
+        return token.hash();
+#else
+        return token.mixed_hash();
+#endif
+    }
+
     //
     // Do the index hash on the basis of hash code for the index_for_hash().
     //
@@ -1347,10 +1490,15 @@ private:
     std::size_t ctrl_hasher(std::size_t key_hash) const noexcept {
 #if (GROUP16_USE_HASH_POLICY != 0) || (GROUP16_USE_INDEX_SHIFT != 0)
         return key_hash;
-#elif 1
+#else
+        // The index uses the low bits, take the ctrl hash from the high bits.
+        if (kIsAvalanching)
+            return (key_hash >> (sizeof(std::size_t) * 8 - 8));
+  #if 1
         return (size_type)hashes::fibonacci_hash(key_hash);
-#elif 0
+  #else
         return (size_type)hashes::mum_hash(key_hash);
+  #endif
 #endif
     }
 
@@ -1615,6 +1763,7 @@ private:
         if (this->slots() != nullptr && other.slots() != nullptr) {
             copy_groups_array_from(other);
             copy_slots_array_from(other);
+            this->slot_size_ = other.slot_size_;
         }
     }
 
@@ -1660,7 +1809,7 @@ private:
          */
         std::memcpy(
             reinterpret_cast<unsigned char *>(this->slots()),
-            reinterpret_cast<unsigned char *>(other.slots()),
+            reinterpret_cast<const unsigned char *>(other.slots()),
             other.slot_capacity() * sizeof(slot_type));
     }
 
@@ -1786,7 +1935,7 @@ private:
          */
         std::memcpy(
             reinterpret_cast<unsigned char *>(this->slots()),
-            reinterpret_cast<unsigned char *>(other.slots()),
+            reinterpret_cast<const unsigned char *>(other.slots()),
             other.slot_capacity() * sizeof(slot_type));
 
         // Reset all of other slots
@@ -2131,6 +2280,88 @@ private:
         return this->slot_capacity();
     }
 
+    //
+    // Calls visitor(slot, other_slot) for each used slot of this table, other_slot is the slot
+    // of the same key in the other table, or nullptr if the other table doesn't contain it.
+    // Stops and returns false as soon as the visitor returns false.
+    //
+    template <typename Visitor>
+    bool match_slots(const this_type & other, Visitor && visitor) const {
+        const bool same_layout = (this->group_capacity() == other.group_capacity());
+
+        const slot_type * batch_slots[kDiffBatchSize];
+        std::size_t batch_hashes[kDiffBatchSize];
+        size_type batch_size = 0;
+
+        for (size_type group_index = 0; group_index < this->group_capacity(); group_index++) {
+            const group_type * group = this->group_at(group_index);
+            std::uint32_t used_mask = group->match_used();
+            if (used_mask == 0)
+                continue;
+
+            const slot_type * slot_base = this->slots() + group_index * kGroupWidth;
+            const slot_type * other_slot_base = nullptr;
+            const ctrl_type * ctrls = reinterpret_cast<const ctrl_type *>(group);
+            const ctrl_type * other_ctrls = nullptr;
+            bool is_same_group = false;
+            if (same_layout) {
+                const group_type * other_group = other.group_at(group_index);
+                other_ctrls = reinterpret_cast<const ctrl_type *>(other_group);
+                other_slot_base = other.slots() + group_index * kGroupWidth;
+                is_same_group = (memcmp((const void *)group, (const void *)other_group, sizeof(group_type)) == 0);
+            }
+
+            do {
+                size_type used_pos = static_cast<size_type>(BitUtils::bsf32(used_mask));
+                used_mask = BitUtils::clearLowBit32(used_mask);
+                const slot_type * slot = slot_base + used_pos;
+                // The same ctrl byte at the same position, it's most likely the same key.
+                if (same_layout && (is_same_group || ctrls[used_pos].value() == other_ctrls[used_pos].value())) {
+                    const slot_type * other_slot = other_slot_base + used_pos;
+                    if (likely(this->key_equal_(slot->value.first, other_slot->value.first))) {
+                        if (!visitor(slot, other_slot))
+                            return false;
+                        continue;
+                    }
+                }
+
+                std::size_t key_hash = other.hash_for(slot->value.first);
+                Prefetch_Read_T0((const void *)other.group_at(other.index_for_hash(key_hash)));
+                batch_slots[batch_size] = slot;
+                batch_hashes[batch_size] = key_hash;
+                batch_size++;
+                if (batch_size == kDiffBatchSize) {
+                    if (!other.find_batch(batch_slots, batch_hashes, batch_size, visitor))
+                        return false;
+                    batch_size = 0;
+                }
+            } while (used_mask != 0);
+        }
+
+        if (batch_size != 0)
+            return other.find_batch(batch_slots, batch_hashes, batch_size, visitor);
+        else
+            return true;
+    }
+
+    //
+    // The second half of match_slots(): look up the keys of the slots of the other table,
+    // whose groups have been prefetched, and call visitor(slot, found_slot).
+    //
+    template <typename Visitor>
+    bool find_batch(const slot_type * const * slots, const std::size_t * key_hashes,
+                    size_type count, Visitor & visitor) const {
+        for (size_type i = 0; i < count; i++) {
+            size_type group_index = this->index_for_hash(key_hashes[i]);
+            std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hashes[i]);
+            size_type slot_index = this->find_index(slots[i]->value.first, group_index, ctrl_hash);
+            const slot_type * slot = (slot_index != this->slot_capacity()) ? this->slot_at(slot_index) : nullptr;
+            if (!visitor(slots[i], slot))
+                return false;
+        }
+        return true;
+    }
+
     void display_meta_datas(group_type * group) {
         ctrl_type * ctrl = reinterpret_cast<ctrl_type *>(group);
         printf("[");
@@ -2180,7 +2411,12 @@ private:
     template <typename KeyT>
     JSTD_FORCED_INLINE
     std::pair<size_type, bool> find_or_insert(const KeyT & key) {
-        std::size_t key_hash = this->hash_for(key);
+        return this->find_or_insert(key, this->hash_for(key));
+    }
+
+    template <typename KeyT>
+    JSTD_FORCED_INLINE
+    std::pair<size_type, bool> find_or_insert(const KeyT & key, std::size_t key_hash) {
         size_type group_index = this->index_for_hash(key_hash);
         std::uint8_t ctrl_hash = this->ctrl_for_hash(key_hash);
 
@@ -2517,6 +2753,25 @@ private:
         return { this->iterator_at(slot_index), need_insert };
     }
 
+    template <typename KeyT, typename ... Args>
+    JSTD_FORCED_INLINE
+    std::pair<iterator, bool> try_emplace_with_hash(std::size_t key_hash, KeyT && key, Args && ... args) {
+        auto find_info = this->find_or_insert(key, key_hash);
+        size_type slot_index = find_info.first;
+        bool need_insert = find_info.second;
+        if (need_insert) {
+            // The key to be inserted is not exists.
+            slot_type * slot = this->slot_at(slot_index);
+            assert(slot != nullptr);
+            SlotPolicyTraits::construct(&this->slot_allocator_, slot,
+                                        std::piecewise_construct,
+                                        std::forward_as_tuple(std::forward<KeyT>(key)),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+            this->slot_size_++;
+        }
+        return { this->iterator_at(slot_index), need_insert };
+    }
+
     JSTD_FORCED_INLINE
     bool ctrl_is_last_bit(size_type slot_index) const noexcept {
         const group_type * group = this->groups() + slot_index / kGroupWidth;
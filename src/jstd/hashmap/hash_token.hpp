@@ -0,0 +1,136 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_HASH_TOKEN_HPP
+#define JSTD_HASHMAP_HASH_TOKEN_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/hasher/hashes.h"
+#include "jstd/hashmap/detail/hashmap_traits.h"
+
+namespace jstd {
+
+/*
+ * hash_token<Hash>: The hash code of a key, computed once by map.make_token(key),
+ * and reused by map.prefetch(token), map.find(key, token) and map.try_emplace(token, key, ...).
+ *
+ * It's useful when a key is looked up in several maps that share a hasher, or when
+ * the caller pipelines the hash, prefetch and probe stages of many keys by itself.
+ *
+ * The token only keeps the capacity independent part of the hash: the hash code of Hash,
+ * and the avalanched hash code used by the group flat tables (group15, group16). The group
+ * index and the ctrl hash depend on the capacity of each map, so they are derived from
+ * the token in a few ALU instructions, a token is still valid after the map is rehashed.
+ *
+ * A token can be used with any jstd::robin_hash_map, jstd::group15_flat_map and
+ * jstd::group16_flat_map whose Hash is the same type, and whose hasher objects return
+ * the same hash code for the key.
+ */
+template <typename Hash>
+class hash_token {
+public:
+    typedef Hash            hasher;
+    typedef std::size_t     hash_code_t;
+
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hash>::value;
+
+private:
+    hash_code_t hash_;
+    hash_code_t mixed_hash_;
+
+public:
+    hash_token() noexcept : hash_(0), mixed_hash_(0) {}
+    explicit hash_token(hash_code_t hash_code) noexcept
+        : hash_(hash_code), mixed_hash_(mix_hash(hash_code)) {}
+    hash_token(const hash_token & src) noexcept = default;
+    ~hash_token() = default;
+
+    hash_token & operator = (const hash_token & rhs) noexcept = default;
+
+    // The hash code of Hash.
+    hash_code_t hash() const noexcept { return this->hash_; }
+
+    // The hash code after the avalanche mixing, if Hash is not avalanching.
+    hash_code_t mixed_hash() const noexcept { return this->mixed_hash_; }
+
+    static hash_code_t mix_hash(hash_code_t hash_code) noexcept {
+        if (!kIsAvalanching)
+            return static_cast<hash_code_t>(hashes::mum_mul_mix(hash_code));
+        else
+            return hash_code;
+    }
+
+    friend inline bool operator == (const hash_token & lhs, const hash_token & rhs) noexcept {
+        return (lhs.hash() == rhs.hash());
+    }
+
+    friend inline bool operator != (const hash_token & lhs, const hash_token & rhs) noexcept {
+        return (lhs.hash() != rhs.hash());
+    }
+};
+
+template <typename T>
+struct is_hash_token : std::false_type {};
+
+template <typename Hash>
+struct is_hash_token<hash_token<Hash>> : std::true_type {};
+
+template <typename T>
+struct is_hash_token_arg
+    : is_hash_token<typename std::remove_cv<typename std::remove_reference<T>::type>::type> {};
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_HASH_TOKEN_HPP
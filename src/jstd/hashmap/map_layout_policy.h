@@ -20,6 +20,8 @@
 
 #include <type_traits>
 #include "jstd/traits/has_member.h"
+#include "jstd/traits/type_traits.h"
+#include "jstd/hashmap/capacity_policy.hpp"
 
 namespace jstd {
 
@@ -50,6 +52,34 @@ struct default_layout_policy {
 
     static constexpr bool autoDetectStoreHash = true;
     static constexpr bool needStoreHash = true;
+
+    typedef pow2_capacity_policy capacity_policy;
+};
+
+//
+// The default layout with another capacity policy, e.g.
+//
+//   jstd::robin_hash_map<K, V, Hash, KeyEqual,
+//                        jstd::capacity_layout_policy<K, V, jstd::prime_capacity_policy>>
+//
+template <typename Key, typename Value, typename CapacityPolicy>
+struct capacity_layout_policy : public default_layout_policy<Key, Value> {
+    typedef CapacityPolicy capacity_policy;
 };
 
+namespace detail {
+
+// The layout policies without the capacity_policy use pow2_capacity_policy.
+template <typename LayoutPolicy, typename = void>
+struct layout_capacity_policy {
+    typedef pow2_capacity_policy type;
+};
+
+template <typename LayoutPolicy>
+struct layout_capacity_policy<LayoutPolicy, jstd::void_t<typename LayoutPolicy::capacity_policy>> {
+    typedef typename LayoutPolicy::capacity_policy type;
+};
+
+} // namespace detail
+
 } // namespace jstd
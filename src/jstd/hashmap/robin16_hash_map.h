@@ -76,6 +76,7 @@
 #include "jstd/lang/launder.h"
 #include "jstd/hasher/hashes.h"
 #include "jstd/hasher/hash_crc32.h"
+#include "jstd/hashmap/detail/hashmap_traits.h"
 #include "jstd/support/BitUtils.h"
 #include "jstd/support/Power2.h"
 #include "jstd/support/BitVec.h"
@@ -134,6 +135,9 @@ public:
     static constexpr bool kUseUnrollLoop = true;
     static constexpr bool kUseIndexSalt = false;
 
+    // The hash code of an avalanching hasher is used directly, the third hash is skipped.
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hash>::value;
+
     static constexpr size_type npos = size_type(-1);
 
     static constexpr size_type kCtrlHashMask = 0x000000FFul;
@@ -1968,11 +1972,16 @@ private:
     inline hash_code_t get_third_hash(hash_code_t value) const noexcept {
 #if ROBIN16_USE_HASH_POLICY
         return value;
-#elif 1
+#else
+        // The index uses the low bits, take the ctrl hash from the high bits.
+        if (kIsAvalanching)
+            return (hash_code_t)((size_type)value >> (sizeof(size_type) * 8 - 8));
+  #if 1
         return (size_type)hashes::fibonacci_hash((size_type)value);
-#elif 1
+  #else
         return (size_type)hashes::simple_int_hash_crc32((size_type)value);
-#endif
+  #endif
+#endif // ROBIN16_USE_HASH_POLICY
     }
 
     inline size_type index_salt() const noexcept {
@@ -79,10 +79,12 @@
 #include "jstd/hashmap/map_layout_policy.h"
 #include "jstd/hashmap/map_slot_policy.h"
 #include "jstd/hashmap/slot_policy_traits.h"
+#include "jstd/hashmap/hash_token.hpp"
 #include "jstd/support/BitUtils.h"
 #include "jstd/support/Power2.h"
 #include "jstd/support/BitVec.h"
 #include "jstd/support/CPUPrefetch.h"
+#include "jstd/support/SimdVec256.h"
 
 #ifdef _MSC_VER
 #ifndef __SSE2__
@@ -104,6 +106,34 @@
 
 #define ROBIN_REHASH_READ_PREFETCH  0
 
+//
+// The implementation of the group match operations (BitMask256):
+//
+//   2: AVX2,
+//   1: SSE2, two 128-bit halves,
+//   0: SWAR, four 64-bit integers, no SIMD instructions.
+//
+// The default is the highest level that the compiler flags allow,
+// define it before including this header to force a lower level.
+//
+#ifndef ROBIN_SIMD_LEVEL
+#if defined(__AVX2__)
+#define ROBIN_SIMD_LEVEL            2
+#elif JSTD_HAVE_SIMD_VEC256_SSE2
+#define ROBIN_SIMD_LEVEL            1
+#else
+#define ROBIN_SIMD_LEVEL            0
+#endif
+#endif // ROBIN_SIMD_LEVEL
+
+#if (ROBIN_SIMD_LEVEL >= 2) && !defined(__AVX2__)
+#error "jstd::robin_hash_map<K,V>: ROBIN_SIMD_LEVEL = 2 required Intel AVX2 or heigher intrinsics."
+#endif
+
+#if (ROBIN_SIMD_LEVEL == 1) && !JSTD_HAVE_SIMD_VEC256_SSE2
+#error "jstd::robin_hash_map<K,V>: ROBIN_SIMD_LEVEL = 1 required Intel SSE2 intrinsics."
+#endif
+
 namespace jstd {
 
 template <typename Key, typename Value, typename SlotType>
@@ -192,6 +222,8 @@ public:
     typedef typename hash_policy_selector<Hash>::type
                                                     hash_policy_t;
     typedef LayoutPolicy                            layout_policy_t;
+    typedef typename detail::layout_capacity_policy<LayoutPolicy>::type
+                                                    capacity_policy_t;
 
     typedef std::size_t                             size_type;
     typedef std::ptrdiff_t                          ssize_type;
@@ -253,6 +285,9 @@ public:
     //
     static constexpr bool kIsTransparent = (jstd::is_transparent<Hash>::value && jstd::is_transparent<KeyEqual>::value);
 
+    // The hash code of an avalanching hasher is used directly, the second and third hash are skipped.
+    static constexpr bool kIsAvalanching = jstd::detail::hash_is_avalanching<Hash>::value;
+
     template <typename K>
     using key_arg = typename key_arg_selector<K, key_type, kIsTransparent>::type;
 
@@ -2561,14 +2596,633 @@ public:
 
 #endif // __AVX512DQ__ && __AVX512VL__
 
+#endif // __AVX2__
+
+    //
+    // The portable implementations of BitMask256_AVX, by the emulated 256-bit vectors
+    // of jstd/support/SimdVec256.h: Vec = vec256_sse2 (SSE2) or vec256_swar (SWAR).
+    // They are the line by line ports of the AVX2 versions, so the bitmasks are the same.
+    //
+    template <typename T, bool NeedStoreHash, bool IsIndirectKV, typename Vec>
+    struct BitMask256_Vec;
+
+    template <typename T, typename Vec>
+    struct BitMask256_Vec<T, false, false, Vec> {
+        typedef T           value_type;
+        typedef T *         pointer;
+        typedef const T *   const_pointer;
+        typedef T &         reference;
+        typedef const T &   const_reference;
+
+        typedef Vec                 vec_type;
+        typedef std::uint32_t       bitmask_type;
+
+        static constexpr size_type kGroupWidth = 32;
+
+        pointer ctrl;
+
+        BitMask256_Vec() noexcept : ctrl(nullptr) {
+        }
+        explicit BitMask256_Vec(pointer ctrl) noexcept : ctrl(ctrl) {
+        }
+        explicit BitMask256_Vec(const_pointer ctrl) noexcept
+            : ctrl(const_cast<pointer>(ctrl)) {
+        }
+        BitMask256_Vec(const BitMask256_Vec & src) noexcept : ctrl(src.ctrl) {
+        }
+        ~BitMask256_Vec() = default;
+
+        template <std::int8_t ControlTag>
+        void fillAll(pointer ptr) {
+            vec_type tag_bits = Vec::set1_epi8(ControlTag);
+            Vec::storeu(ptr, tag_bits);
+        }
+
+        void fillAllZeros() {
+            vec_type zero_bits = Vec::setzero();
+            Vec::storeu(this->ctrl, zero_bits);
+        }
+
+        void fillAllEmpty() {
+            fillAll<kEmptySlot>(this->ctrl);
+        }
+
+        void fillAllEndOf() {
+            fillAll<kEndOfMark>(this->ctrl);
+        }
+
+        std::uint32_t matchTag(std::int8_t tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi8(tag);
+            vec_type match_mask = Vec::cmpeq_epi8(ctrl_bits, tag_bits);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchHash(std::uint8_t ctrl_hash) const {
+            (void)ctrl_hash;
+            return 0;
+        }
+
+        std::uint32_t matchEmpty() const {
+            if (kEmptySlot == 0b11111111) {
+                vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+                vec_type ones_bits  = Vec::setones();
+                vec_type match_mask = Vec::cmpeq_epi8(ctrl_bits, ones_bits);
+                std::uint32_t mask = Vec::movemask_epi8(match_mask);
+                return mask;
+            } else {
+                return this->matchTag(kEmptySlot);
+            }
+        }
+
+        std::uint32_t matchNonEmpty() const {
+            if (kEmptySlot == 0b11111111) {
+                vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+                vec_type ones_bits  = Vec::setones();
+                vec_type match_mask = Vec::cmpeq_epi8(ones_bits, ctrl_bits);
+                         match_mask = Vec::andnot_si256(match_mask, ones_bits);
+                std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+                return maskUsed;
+            } else {
+                vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+                vec_type tag_bits   = Vec::set1_epi16(kEmptySlot);
+                vec_type ones_bits  = Vec::setones();
+                vec_type match_mask = Vec::cmpeq_epi8(tag_bits, ctrl_bits);
+                         match_mask = Vec::andnot_si256(match_mask, ones_bits);
+                std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+                return maskUsed;
+            }
+        }
+
+        std::uint32_t matchUsed() const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type ones_bits  = Vec::setones();
+            vec_type match_mask = Vec::cmpgt_epi8(ctrl_bits, ones_bits);
+            std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+            return maskUsed;
+        }
+
+        std::uint32_t matchUnused() const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type zero_bits  = Vec::setzero();
+            vec_type match_mask = Vec::cmpgt_epi8(zero_bits, ctrl_bits);
+            std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+            return maskUsed;
+        }
+
+        static vec_type distance_base() {
+            static const std::uint8_t kDistanceBase[32] = {
+                0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+                0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+                0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+            };
+            return Vec::loadu(kDistanceBase);
+        }
+
+        MatchMask2<std::uint32_t>
+        matchHashAndDistance(std::int8_t distance) const {
+            assert(distance <= kMaxDist);
+            vec_type dist_0      = Vec::set1_epi8(distance);
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type dist_and_0  = Vec::adds_epi8(dist_0, distance_base());
+            vec_type match_mask  = Vec::cmpeq_epi8(dist_and_0, ctrl_bits);
+            vec_type empty_mask  = Vec::cmpgt_epi8(dist_and_0, ctrl_bits);
+            vec_type result_mask = Vec::andnot_si256(empty_mask, match_mask);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(empty_mask);
+            std::uint32_t maskHash  = Vec::movemask_epi8(result_mask);
+            return { maskEmpty, maskHash };
+        }
+
+        std::uint32_t matchEmptyOrZero() const {
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type zero_bits   = Vec::setzero();
+            vec_type empty_mask  = Vec::cmpgt_epi8(zero_bits, ctrl_bits);
+            vec_type zero_mask   = Vec::cmpeq_epi8(zero_bits, ctrl_bits);
+            vec_type result_mask = Vec::or_si256(empty_mask, zero_mask);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(result_mask);
+            return maskEmpty;
+        }
+
+        std::uint32_t matchEmptyAndDistance(std::int8_t distance) const {
+            assert(distance <= kMaxDist);
+            vec_type dist_0      = Vec::set1_epi8(distance);
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type dist_and_0  = Vec::adds_epi8(dist_0, distance_base());
+            vec_type result_mask = Vec::cmpgt_epi8(dist_and_0, ctrl_bits);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(result_mask);
+            return maskEmpty;
+        }
+
+        bool hasAnyMatch(std::uint8_t ctrl_hash) const {
+            (void)ctrl_hash;
+            return true;
+        }
+
+        bool hasAnyEmpty() const {
+            return (this->matchEmpty() != 0);
+        }
+
+        bool hasAnyUsed() const {
+            return (this->matchUsed() != 0);
+        }
+
+        bool hasAnyUnused() const {
+            return (this->matchUnused() != 0);
+        }
+
+        bool isAllEmpty() const {
+            return (this->matchEmpty() == kFullMask32);
+        }
+
+        bool isAllUsed() const {
+            return (this->matchUnused() == 0);
+        }
+
+        bool isAllUnused() const {
+            return (this->matchUsed() == 0);
+        }
+
+        static inline size_type bitPos(size_type pos) {
+            return pos;
+        }
+    };
+
+    template <typename T, typename Vec>
+    struct BitMask256_Vec<T, true, false, Vec> {
+        typedef T           value_type;
+        typedef T *         pointer;
+        typedef const T *   const_pointer;
+        typedef T &         reference;
+        typedef const T &   const_reference;
+
+        typedef Vec                 vec_type;
+        typedef std::uint32_t       bitmask_type;
+
+        static constexpr size_type kGroupWidth = 16;
+
+        pointer ctrl;
+
+        BitMask256_Vec() noexcept : ctrl(nullptr) {
+        }
+        explicit BitMask256_Vec(pointer ctrl) noexcept : ctrl(ctrl) {
+        }
+        explicit BitMask256_Vec(const_pointer ctrl) noexcept
+            : ctrl(const_cast<pointer>(ctrl)) {
+        }
+        BitMask256_Vec(const BitMask256_Vec & src) noexcept : ctrl(src.ctrl) {
+        }
+        ~BitMask256_Vec() = default;
+
+        template <std::int16_t ControlTag>
+        void fillAll(pointer ptr) {
+            vec_type tag_bits = Vec::set1_epi16(ControlTag);
+            Vec::storeu(ptr, tag_bits);
+        }
+
+        void fillAllZeros() {
+            vec_type zero_bits = Vec::setzero();
+            Vec::storeu(this->ctrl, zero_bits);
+        }
+
+        void fillAllEmpty() {
+            fillAll<kEmptySlot16>(this->ctrl);
+        }
+
+        void fillAllEndOf() {
+            fillAll<kEndOfMark16>(this->ctrl);
+        }
+
+        std::uint32_t matchTag(std::int16_t ctrl_tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi16(ctrl_tag);
+            vec_type match_mask = Vec::cmpeq_epi16(ctrl_bits, tag_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchLowTag(std::uint8_t ctrl_tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi16(ctrl_tag);
+            vec_type ones_bits  = Vec::setones();
+            vec_type low_mask16 = Vec::srli_epi16(ones_bits, 8);
+            vec_type low_bits   = Vec::and_si256(ctrl_bits, low_mask16);
+            vec_type match_mask = Vec::cmpeq_epi16(low_bits, tag_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchHighTag(std::uint8_t ctrl_tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi16(ctrl_tag);
+            vec_type high_bits  = Vec::srli_epi16(ctrl_bits, 8);
+            vec_type match_mask = Vec::cmpeq_epi16(high_bits, tag_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchHash(std::uint8_t ctrl_hash) const {
+            vec_type hash_bits  = Vec::set1_epi16(ctrl_hash);
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type match_mask = Vec::cmpeq_epi8(ctrl_bits, hash_bits);
+                     match_mask = Vec::slli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchEmpty() const {
+            if (kEmptySlot == 0b11111111) {
+                vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+                vec_type ones_bits  = Vec::setones();
+                vec_type match_mask = Vec::cmpeq_epi8(ctrl_bits, ones_bits);
+                         match_mask = Vec::srli_epi16(match_mask, 8);
+                std::uint32_t mask = Vec::movemask_epi8(match_mask);
+                return mask;
+            } else {
+                return this->matchHighTag(static_cast<std::uint8_t>(kEmptySlot));
+            }
+        }
+
+        std::uint32_t matchNonEmpty() const {
+            if (kEmptySlot == 0b11111111) {
+                vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+                vec_type ones_bits  = Vec::setones();
+                vec_type match_mask = Vec::cmpeq_epi8(ones_bits, ctrl_bits);
+                         match_mask = Vec::andnot_si256(match_mask, ones_bits);
+                         match_mask = Vec::srli_epi16(match_mask, 8);
+                std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+                return maskUsed;
+            } else {
+                vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+                vec_type tag_bits   = Vec::set1_epi16(kEmptySlot16);
+                vec_type ones_bits  = Vec::setones();
+                vec_type match_mask = Vec::cmpeq_epi8(tag_bits, ctrl_bits);
+                         match_mask = Vec::andnot_si256(match_mask, ones_bits);
+                         match_mask = Vec::srli_epi16(match_mask, 8);
+                std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+                return maskUsed;
+            }
+        }
+
+        std::uint32_t matchUsed() const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type ones_bits  = Vec::setones();
+            vec_type match_mask = Vec::cmpgt_epi16(ctrl_bits, ones_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+            return maskUsed;
+        }
+
+        std::uint32_t matchUnused() const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type zero_bits  = Vec::setzero();
+            vec_type match_mask = Vec::cmpgt_epi16(zero_bits, ctrl_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+            return maskUsed;
+        }
+
+        static vec_type distance_base() {
+            static const std::uint16_t kDistanceBase[16] = {
+                0x0000, 0x0100, 0x0200, 0x0300, 0x0400, 0x0500, 0x0600, 0x0700,
+                0x0800, 0x0900, 0x0A00, 0x0B00, 0x0C00, 0x0D00, 0x0E00, 0x0F00
+            };
+            return Vec::loadu(kDistanceBase);
+        }
+
+        MatchMask2<std::uint32_t>
+        matchHashAndDistance(std::int16_t dist_and_hash) const {
+            assert(dist_and_hash <= kMaxDist16);
+            vec_type dist_0_hash = Vec::set1_epi16(dist_and_hash);
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type ones_bits   = Vec::setones();
+            vec_type high_mask   = Vec::slli_epi16(ones_bits, 8);
+            vec_type dist_1_hash = Vec::adds_epi16(dist_0_hash, distance_base());
+            vec_type dist_and_0  = Vec::and_si256(dist_1_hash, high_mask);
+            vec_type ctrl_dist   = Vec::and_si256(ctrl_bits,   high_mask);
+            vec_type match_mask  = Vec::cmpeq_epi16(dist_1_hash, ctrl_bits);
+            vec_type empty_mask  = Vec::cmpgt_epi16(dist_and_0,  ctrl_dist);
+            vec_type result_mask = Vec::andnot_si256(empty_mask, match_mask);
+                     empty_mask  = Vec::srli_epi16(empty_mask, 8);
+                     result_mask = Vec::srli_epi16(result_mask, 8);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(empty_mask);
+            std::uint32_t maskHash  = Vec::movemask_epi8(result_mask);
+            return { maskEmpty, maskHash };
+        }
+
+        std::uint32_t matchEmptyOrZero() const {
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type zero_bits   = Vec::setzero();
+            vec_type empty_mask  = Vec::cmpgt_epi16(zero_bits, ctrl_bits);
+            vec_type zero_mask   = Vec::cmpeq_epi16(zero_bits, ctrl_bits);
+            vec_type result_mask = Vec::or_si256(empty_mask, zero_mask);
+                     result_mask = Vec::srli_epi16(result_mask, 8);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(result_mask);
+            return maskEmpty;
+        }
+
+        std::uint32_t matchEmptyAndDistance(std::int8_t distance) const {
+            assert(distance <= kMaxDist);
+            vec_type dist_0      = Vec::set1_epi16((std::int16_t)distance);
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type dist_and_0  = Vec::slli_epi16(dist_0, 8);
+            vec_type dist_bits   = Vec::adds_epi16(dist_and_0, distance_base());
+            vec_type result_mask = Vec::cmpgt_epi16(dist_bits, ctrl_bits);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(result_mask);
+            return maskEmpty;
+        }
+
+        bool hasAnyMatch( std::uint8_t ctrl_hash) const {
+            return (this->matchHash(ctrl_hash) != 0);
+        }
+
+        bool hasAnyEmpty() const {
+            return (this->matchEmpty() != 0);
+        }
+
+        bool hasAnyUsed() const {
+            return (this->matchUsed() != 0);
+        }
+
+        bool hasAnyUnused() const {
+            return (this->matchUnused() != 0);
+        }
+
+        bool isAllEmpty() const {
+            return (this->matchEmpty() == kFullMask32_Half);
+        }
+
+        bool isAllUsed() const {
+            return (this->matchUnused() == 0);
+        }
+
+        bool isAllUnused() const {
+            return (this->matchUsed() == 0);
+        }
+
+        static inline size_type bitPos(size_type pos) {
+            return (pos >> 1);
+        }
+    };
+
+    template <typename T, typename Vec>
+    struct BitMask256_Vec<T, true, true, Vec> {
+        typedef T           value_type;
+        typedef T *         pointer;
+        typedef const T *   const_pointer;
+        typedef T &         reference;
+        typedef const T &   const_reference;
+
+        typedef Vec                 vec_type;
+        typedef std::uint32_t       bitmask_type;
+
+        static constexpr size_type kGroupWidth = 4;
+
+        pointer ctrl;
+
+        BitMask256_Vec() noexcept : ctrl(nullptr) {
+        }
+        explicit BitMask256_Vec(pointer ctrl) noexcept : ctrl(ctrl) {
+        }
+        explicit BitMask256_Vec(const_pointer ctrl) noexcept
+            : ctrl(const_cast<pointer>(ctrl)) {
+        }
+        BitMask256_Vec(const BitMask256_Vec & src) noexcept : ctrl(src.ctrl) {
+        }
+        ~BitMask256_Vec() = default;
+
+        template <std::int64_t ControlTag>
+        void fillAll(pointer ptr) {
+            vec_type tag_bits = Vec::set1_epi64x(ControlTag);
+            Vec::storeu(ptr, tag_bits);
+        }
+
+        void fillAllZeros() {
+            vec_type zero_bits = Vec::setzero();
+            Vec::storeu(this->ctrl, zero_bits);
+        }
+
+        void fillAllEmpty() {
+            this->fillAll<kEmptySlot64>(this->ctrl);
+        }
+
+        void fillAllEndOf() {
+            this->fillAll<kEndOfMark64>(this->ctrl);
+        }
+
+        std::uint32_t matchTag(std::int16_t ctrl_tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi16(ctrl_tag);
+            vec_type match_mask = Vec::cmpeq_epi16(ctrl_bits, tag_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchLowTag(std::uint8_t ctrl_tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi16(ctrl_tag);
+            vec_type ones_bits  = Vec::setones();
+            vec_type low_mask16 = Vec::srli_epi16(ones_bits, 8);
+            vec_type low_bits   = Vec::and_si256(ctrl_bits, low_mask16);
+            vec_type match_mask = Vec::cmpeq_epi16(low_bits, tag_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchHighTag(std::uint16_t ctrl_tag) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type tag_bits   = Vec::set1_epi16((std::int16_t)ctrl_tag);
+            vec_type high_bits  = Vec::srli_epi16(ctrl_bits, 8);
+            vec_type match_mask = Vec::cmpeq_epi16(high_bits, tag_bits);
+                     match_mask = Vec::srli_epi16(match_mask, 8);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchHash(std::uint8_t ctrl_hash) const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type hash_bits  = Vec::set1_epi64x((std::int64_t)ctrl_hash);
+                     ctrl_bits  = Vec::slli_epi16(ctrl_bits, 56);
+                     hash_bits  = Vec::slli_epi16(hash_bits, 56);
+            vec_type match_mask = Vec::cmpeq_epi64(ctrl_bits, hash_bits);
+                     match_mask = Vec::srli_epi64(match_mask, 56);
+            std::uint32_t mask = Vec::movemask_epi8(match_mask);
+            return mask;
+        }
+
+        std::uint32_t matchEmpty() const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type empty_bits = Vec::set1_epi64x((std::int64_t)kEmptySlot64);
+                     ctrl_bits  = Vec::and_si256(ctrl_bits, empty_bits);
+            vec_type match_mask = Vec::cmpeq_epi64(empty_bits, ctrl_bits);
+                     match_mask = Vec::srli_epi64(match_mask, 56);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(match_mask);
+            return maskEmpty;
+        }
+
+        std::uint32_t matchNonEmpty() const {
+            vec_type ctrl_bits  = Vec::loadu(this->ctrl);
+            vec_type empty_bits = Vec::set1_epi64x((std::int64_t)kEmptySlot64);
+                     ctrl_bits  = Vec::and_si256(ctrl_bits, empty_bits);
+            vec_type match_mask = Vec::cmpgt_epi64(empty_bits, ctrl_bits);
+                     match_mask = Vec::srli_epi64(match_mask, 56);
+            std::uint32_t maskUsed = Vec::movemask_epi8(match_mask);
+            return maskUsed;
+        }
+
+        std::uint32_t matchUsed() const {
+            return this->matchNonEmpty();
+        }
+
+        std::uint32_t matchUnused() const {
+            return this->matchEmpty();
+        }
+
+        static vec_type distance_base() {
+            static const std::uint64_t kDistanceBase[4] = {
+                0x0000000000000000ull, 0x0000000000010000ull,
+                0x0000000000020000ull, 0x0000000000030000ull
+            };
+            return Vec::loadu(kDistanceBase);
+        }
+
+        MatchMask2<std::uint32_t>
+        matchHashAndDistance(std::int16_t dist_and_hash) const {
+            assert(dist_and_hash <= kMaxDist16);
+            vec_type dist_0_hash = Vec::set1_epi16(dist_and_hash);
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type ones_bits   = Vec::setones();
+            vec_type high_mask   = Vec::slli_epi16(ones_bits, 8);
+            vec_type dist_1_hash = Vec::adds_epi16(dist_0_hash, distance_base());
+            vec_type dist_and_0  = Vec::and_si256(dist_1_hash, high_mask);
+            vec_type ctrl_dist   = Vec::and_si256(ctrl_bits,   high_mask);
+            vec_type match_mask  = Vec::cmpeq_epi16(dist_1_hash, ctrl_bits);
+            vec_type empty_mask  = Vec::cmpgt_epi16(dist_and_0,  ctrl_dist);
+            vec_type result_mask = Vec::andnot_si256(empty_mask, match_mask);
+                     empty_mask  = Vec::srli_epi16(empty_mask, 8);
+                     result_mask = Vec::srli_epi16(result_mask, 8);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(empty_mask);
+            std::uint32_t maskHash  = Vec::movemask_epi8(result_mask);
+            return { maskEmpty, maskHash };
+        }
+
+        std::uint32_t matchEmptyOrZero() const {
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type zero_bits   = Vec::setzero();
+            vec_type empty_mask  = Vec::cmpgt_epi16(zero_bits, ctrl_bits);
+            vec_type zero_mask   = Vec::cmpeq_epi16(zero_bits, ctrl_bits);
+            vec_type result_mask = Vec::or_si256(empty_mask, zero_mask);
+                     result_mask = Vec::srli_epi16(result_mask, 8);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(result_mask);
+            return maskEmpty;
+        }
+
+        std::uint32_t matchEmptyAndDistance(std::int8_t distance) const {
+            assert(distance <= kMaxDist);
+            vec_type dist_0      = Vec::set1_epi16((std::int16_t)distance);
+            vec_type ctrl_bits   = Vec::loadu(this->ctrl);
+            vec_type dist_and_0  = Vec::slli_epi16(dist_0, 8);
+            vec_type dist_bits   = Vec::adds_epi16(dist_and_0, distance_base());
+            vec_type result_mask = Vec::cmpgt_epi16(dist_bits, ctrl_bits);
+            std::uint32_t maskEmpty = Vec::movemask_epi8(result_mask);
+            return maskEmpty;
+        }
+
+        bool hasAnyMatch( std::uint8_t ctrl_hash) const {
+            return (this->matchHash(ctrl_hash) != 0);
+        }
+
+        bool hasAnyEmpty() const {
+            return (this->matchEmpty() != 0);
+        }
+
+        bool hasAnyUsed() const {
+            return (this->matchUsed() != 0);
+        }
+
+        bool hasAnyUnused() const {
+            return (this->matchUnused() != 0);
+        }
+
+        bool isAllEmpty() const {
+            return (this->matchEmpty() == kFullMask32_Half);
+        }
+
+        bool isAllUsed() const {
+            return (this->matchUnused() == 0);
+        }
+
+        bool isAllUnused() const {
+            return (this->matchUsed() == 0);
+        }
+
+        static inline size_type bitPos(size_type pos) {
+            return (pos >> 3);
+        }
+    };
+
+#if (ROBIN_SIMD_LEVEL >= 2)
+
     template <typename T, bool NeedStoreHash, bool IsIndirectKV>
     using BitMask256 = BitMask256_AVX<T, NeedStoreHash, IsIndirectKV>;
 
+#elif (ROBIN_SIMD_LEVEL == 1)
+
+    template <typename T, bool NeedStoreHash, bool IsIndirectKV>
+    using BitMask256 = BitMask256_Vec<T, NeedStoreHash, IsIndirectKV, vec256_sse2>;
+
 #else
 
-    static_assert(false, "jstd::robin_hash_map<K,V> required Intel AVX2 or heigher intrinsics.")
+    template <typename T, bool NeedStoreHash, bool IsIndirectKV>
+    using BitMask256 = BitMask256_Vec<T, NeedStoreHash, IsIndirectKV, vec256_swar>;
 
-#endif // __AVX2__
+#endif // ROBIN_SIMD_LEVEL
 
     struct group_mask {
         typedef BitMask256<ctrl_type, kNeedStoreHash, kIsIndirectKV>
@@ -3014,6 +3668,8 @@ public:
     using iterator       = basic_iterator<value_type, kIsIndirectKV>;
     using const_iterator = basic_iterator<const value_type, kIsIndirectKV>;
 
+    using hash_token = jstd::hash_token<Hash>;
+
     typedef typename std::allocator_traits<allocator_type> AllocTraits;
 
     typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<ctrl_type>
@@ -3040,6 +3696,7 @@ private:
 #if ROBIN_USE_HASH_POLICY
     hash_policy_t   hash_policy_;
 #endif
+    capacity_policy_t   capacity_policy_;
 
     hasher          hasher_;
     key_equal       key_equal_;
@@ -3123,6 +3780,7 @@ public:
 #if ROBIN_USE_HASH_POLICY
         hash_policy_(),
 #endif
+        capacity_policy_(),
         hasher_(other.hash_function_ref()), key_equal_(other.key_eq_ref()),
         allocator_(alloc),
         ctrl_allocator_(alloc), slot_allocator_(alloc) {
@@ -3157,6 +3815,7 @@ public:
 #if ROBIN_USE_HASH_POLICY
         hash_policy_(jstd::exchange(other.hash_policy_ref(), hash_policy_t())),
 #endif
+        capacity_policy_(jstd::exchange(other.capacity_policy_, capacity_policy_t())),
         hasher_(std::move(other.hash_function_ref())),
         key_equal_(std::move(other.key_eq_ref())),
         allocator_(std::move(other.get_allocator_ref())),
@@ -3175,6 +3834,7 @@ public:
 #if ROBIN_USE_HASH_POLICY
         hash_policy_(jstd::exchange(other.hash_policy_ref(), hash_policy_t())),
 #endif
+        capacity_policy_(),
         hasher_(std::move(other.hash_function_ref())),
         key_equal_(std::move(other.key_eq_ref())),
         allocator_(alloc),
@@ -3215,6 +3875,7 @@ public:
 #if ROBIN_USE_HASH_POLICY
         hash_policy_(),
 #endif
+        capacity_policy_(),
         hasher_(hash), key_equal_(equal),
         allocator_(alloc),
         ctrl_allocator_(alloc), slot_allocator_(alloc) {
@@ -3504,7 +4165,7 @@ public:
         if (this->slot_capacity() > kDefaultCapacity) {
             if (need_destroy) {
                 this->destroy_data();
-                this->create_slots<false>(kDefaultCapacity);
+                this->create_slots<false>(this->calc_capacity(kDefaultCapacity));
                 assert(this->slot_size() == 0);
                 return;
             }
@@ -3554,10 +4215,35 @@ public:
 
     const_iterator find(const key_type & key) const {
         const slot_type * slot = this->find_impl(key);
-        if (!kIsIndirectKV)
-            return this->iterator_at(this->index_of(slot));
-        else
-            return this->iterator_at(slot);
+        return this->find_iterator(slot);
+    }
+
+    //
+    // Hash token: make_token(key), prefetch(token), find(key, token), try_emplace(token, key, args...)
+    //
+    // Compute the hash of a key once, and reuse it in the maps that share the hasher,
+    // the token must be made from the same key, see jstd::hash_token<Hash>.
+    //
+    hash_token make_token(const key_type & key) const {
+        return hash_token(this->get_hash(key));
+    }
+
+    void prefetch(const hash_token & token) const noexcept {
+        size_type slot_index = this->index_for_hash(token.hash());
+        Prefetch_Read_T0((const void *)this->ctrl_at(slot_index));
+        if (!kIsIndirectKV) {
+            Prefetch_Read_T0((const void *)this->slot_at(slot_index));
+        }
+    }
+
+    iterator find(const key_type & key, const hash_token & token) {
+        return const_cast<const this_type *>(this)->find(key, token);
+    }
+
+    const_iterator find(const key_type & key, const hash_token & token) const {
+        assert(token == this->make_token(key));
+        const slot_type * slot = this->find_impl(key, token.hash());
+        return this->find_iterator(slot);
     }
 
     std::pair<iterator, iterator> equal_range(const key_type & key) {
@@ -3677,6 +4363,18 @@ public:
         return this->try_emplace_impl(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    template <typename ... Args>
+    std::pair<iterator, bool> try_emplace(const hash_token & token, const key_type & key, Args && ... args) {
+        assert(token == this->make_token(key));
+        return this->try_emplace_with_hash(token.hash(), key, std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    std::pair<iterator, bool> try_emplace(const hash_token & token, key_type && key, Args && ... args) {
+        assert(token == this->make_token(key));
+        return this->try_emplace_with_hash(token.hash(), std::move(key), std::forward<Args>(args)...);
+    }
+
     template <typename KeyT = key_type, typename ... Args>
     iterator try_emplace(const_iterator hint, const key_arg<KeyT> & key, Args && ... args) {
         return this->try_emplace(key, std::forward<Args>(args)...).first;
@@ -3841,11 +4539,7 @@ private:
 
     JSTD_FORCED_INLINE
     size_type calc_capacity(size_type init_capacity) const noexcept {
-        size_type new_capacity = (std::max)(init_capacity, kMinCapacity);
-        if (!pow2::is_pow2(new_capacity)) {
-            new_capacity = pow2::round_up<size_type, kMinCapacity>(new_capacity);
-        }
-        return new_capacity;
+        return capacity_policy_t::round_up(init_capacity, kMinCapacity);
     }
 
     size_type calc_slot_threshold(size_type now_slot_capacity) const {
@@ -3854,9 +4548,10 @@ private:
 
     size_type calc_max_lookups(size_type new_capacity) const {
         assert(new_capacity > 1);
-        assert(pow2::is_pow2(new_capacity));
+        assert(!capacity_policy_t::kIsPow2 || pow2::is_pow2(new_capacity));
 #if 1
-        // Fast to get log2_int, if the new_size is power of 2.
+        // Fast to get log2_int, if the new_size is power of 2,
+        // otherwise it's floor(log2(new_capacity)).
         // Use bsf(n) has the same effect.
         size_type max_lookups = size_type(BitUtils::bsr(new_capacity));
 #else
@@ -3990,17 +4685,25 @@ private:
     inline size_type index_for_hash(hash_code_t hash_code) const noexcept {
         size_type hash_value = static_cast<size_type>(hash_code);
 #if ROBIN_USE_HASH_POLICY
+        static_assert(capacity_policy_t::kIsPow2,
+                      "jstd::robin_hash_map: ROBIN_USE_HASH_POLICY requires the pow2 capacity policy.");
         if (kUseIndexSalt) {
             hash_value ^= this->index_salt();
         }
         size_type index = this->hash_policy_.template index_for_hash<key_type>(hash_value, this->slot_mask());
         return index;
 #else
+        if (kIsAvalanching) {
+            if (kUseIndexSalt) {
+                hash_value ^= this->index_salt();
+            }
+            return this->capacity_policy_.index_for_avalanched_hash(hash_value, this->slot_mask());
+        }
         hash_value = this->get_second_hash(hash_value);
         if (kUseIndexSalt) {
             hash_value ^= this->index_salt();
         }
-        return (hash_value & this->slot_mask());
+        return this->capacity_policy_.index_for_hash(hash_value, this->slot_mask());
 #endif
     }
 
@@ -4010,13 +4713,22 @@ private:
     inline hash_code_t get_third_hash(hash_code_t hash_code) const noexcept {
 #if ROBIN_USE_HASH_POLICY
         return hash_code;
-#elif 0
+#else
+        if (kIsAvalanching) {
+            // Take the ctrl hash from the other end of the bits that the index used.
+            if (capacity_policy_t::kIndexUsesHighBits)
+                return hash_code;
+            else
+                return (hash_code_t)((size_type)hash_code >> (sizeof(size_type) * 8 - 8));
+        }
+  #if 0
         return (size_type)hashes::mum_hash((size_type)hash_code);
-#elif 1
+  #elif 1
         return (size_type)hashes::fibonacci_hash((size_type)hash_code);
-#elif 1
+  #else
         return (size_type)hashes::simple_int_hash_crc32((size_type)hash_code);
-#endif
+  #endif
+#endif // ROBIN_USE_HASH_POLICY
     }
 
     // Maybe call the third hash to calculate the ctrl hash.
@@ -4267,7 +4979,7 @@ private:
     }
 
     void grow_if_necessary() {
-        size_type new_capacity = (this->slot_mask_ + 1) * 2;
+        size_type new_capacity = capacity_policy_t::next_capacity(this->slot_mask_ + 1);
         this->rehash_impl<false, true>(new_capacity);
     }
 
@@ -4291,10 +5003,11 @@ private:
 #if ROBIN_USE_HASH_POLICY
         this->hash_policy_.reset();
 #endif
+        this->capacity_policy_.reset();
     }
 
     bool isValidCapacity(size_type capacity) const {
-        return ((capacity >= kMinCapacity) && pow2::is_pow2(capacity));
+        return ((capacity >= kMinCapacity) && capacity_policy_t::is_valid(capacity));
     }
 
     // Given the pointer of ctrls and the capacity of ctrl, computes the padding of
@@ -4347,6 +5060,7 @@ private:
         auto hash_policy_setting = this->hash_policy_.calc_next_capacity(new_capacity);
         this->hash_policy_.commit(hash_policy_setting);
 #endif
+        this->capacity_policy_.commit(new_capacity);
         size_type new_max_lookups = this->calc_max_lookups(new_capacity);
         if (new_max_lookups < 16)
             new_max_lookups = (std::max)(new_max_lookups * 2, kMinLookups);
@@ -5062,6 +5776,20 @@ private:
         ctrl->setEmpty();
     }
 
+    //
+    // The iterator of the slot returned by find_impl(), last_slot() is a miss.
+    // The miss must be checked first: the indirect-KV iterators never reach last_slot(),
+    // and the empty table has no slots for index_of().
+    //
+    const_iterator find_iterator(const slot_type * slot) const {
+        if (slot == this->last_slot())
+            return this->end();
+        else if (!kIsIndirectKV)
+            return this->iterator_at(this->index_of(slot));
+        else
+            return this->iterator_at(slot);
+    }
+
     template <typename KeyT>
     slot_type * find_impl(const KeyT & key) {
         return const_cast<slot_type *>(
@@ -5071,19 +5799,23 @@ private:
 
     template <typename KeyT>
     const slot_type * find_impl(const KeyT & key) const {
+        return this->find_impl(key, this->get_hash(key));
+    }
+
+    template <typename KeyT>
+    const slot_type * find_impl(const KeyT & key, hash_code_t hash_code) const {
         if (!kIsIndirectKV) {
-            return this->direct_find(key);
+            return this->direct_find(key, hash_code);
         } else {
-            return this->indirect_find(key);
+            return this->indirect_find(key, hash_code);
         }
     }
 
     template <typename KeyT>
-    const slot_type * direct_find(const KeyT & key) const {
+    const slot_type * direct_find(const KeyT & key, hash_code_t hash_code) const {
         // Prefetch for resolve potential ctrls TLB misses.
         //Prefetch_Read_T2(this->ctrls());
 
-        hash_code_t hash_code = this->get_hash(key);
         size_type slot_index = this->index_for_hash(hash_code);
         std::uint8_t ctrl_hash = this->get_ctrl_hash(hash_code);
         ctrl_type dist_and_hash(no_init_t{});
@@ -5218,11 +5950,10 @@ private:
     }
 
     template <typename KeyT>
-    const slot_type * indirect_find(const KeyT & key) const {
+    const slot_type * indirect_find(const KeyT & key, hash_code_t hash_code) const {
         // Prefetch for resolve potential ctrls TLB misses.
         //Prefetch_Read_T2(this->ctrls());
 
-        hash_code_t hash_code = this->get_hash(key);
         size_type ctrl_index = this->index_for_hash(hash_code);
         std::uint8_t ctrl_hash = this->get_ctrl_hash(hash_code);
 
@@ -5457,18 +6188,23 @@ private:
     template <typename KeyT>
     std::pair<slot_type *, FindResult>
     find_and_insert(const KeyT & key) {
+        return this->find_and_insert(key, this->get_hash(key));
+    }
+
+    template <typename KeyT>
+    std::pair<slot_type *, FindResult>
+    find_and_insert(const KeyT & key, hash_code_t hash_code) {
         if (!kIsIndirectKV) {
-            return this->direct_find_and_insert(key);
+            return this->direct_find_and_insert(key, hash_code);
         } else {
-            return this->indirect_find_and_insert(key);
+            return this->indirect_find_and_insert(key, hash_code);
         }
     }
 
     template <typename KeyT>
     JSTD_FORCED_INLINE
     std::pair<slot_type *, FindResult>
-    direct_find_and_insert(const KeyT & key) {
-        hash_code_t hash_code = this->get_hash(key);
+    direct_find_and_insert(const KeyT & key, hash_code_t hash_code) {
         size_type slot_index = this->index_for_hash(hash_code);
         std::uint8_t ctrl_hash = this->get_ctrl_hash(hash_code);
 
@@ -5617,8 +6353,7 @@ InsertOrGrow_Start:
     template <typename KeyT>
     JSTD_FORCED_INLINE
     std::pair<slot_type *, FindResult>
-    indirect_find_and_insert(const KeyT & key) {
-        hash_code_t hash_code = this->get_hash(key);
+    indirect_find_and_insert(const KeyT & key, hash_code_t hash_code) {
         size_type ctrl_index = this->index_for_hash(hash_code);
         std::uint8_t ctrl_hash = this->get_ctrl_hash(hash_code);
 
@@ -6139,6 +6874,28 @@ InsertOrGrow_Start:
         return { this->iterator_at(slot), (is_exists == kIsNotExists) };
     }
 
+    template <typename KeyT, typename ... Args>
+    std::pair<iterator, bool> try_emplace_with_hash(hash_code_t hash_code, KeyT && key, Args && ... args) {
+        auto find_info = this->find_and_insert(key, hash_code);
+        slot_type * slot = find_info.first;
+        FindResult is_exists = find_info.second;
+        if (is_exists == kIsNotExists) {
+            // The key to be inserted is not exists.
+            assert(slot != nullptr);
+            SlotPolicyTraits::construct(&this->allocator_, slot,
+                                        std::piecewise_construct,
+                                        std::forward_as_tuple(std::forward<KeyT>(key)),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+            this->slot_size_++;
+        } else if (is_exists < kIsNotExists) {
+            assert(is_exists == kNeedGrow);
+            this->grow_if_necessary();
+            return this->try_emplace_with_hash(hash_code, std::forward<KeyT>(key),
+                                               std::forward<Args>(args)...);
+        }
+        return { this->iterator_at(slot), (is_exists == kIsNotExists) };
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////
 
     template <typename KeyT>
@@ -6564,6 +7321,7 @@ Insert_To_Slot:
 #if ROBIN_USE_HASH_POLICY
         swap(this->hash_policy_, other.hash_policy_ref());
 #endif
+        swap(this->capacity_policy_, other.capacity_policy_);
     }
 
     void swap_policy(this_type & other) noexcept {
@@ -0,0 +1,346 @@
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2024-2025 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_HASHMAP_STATIC_MAP_HPP
+#define JSTD_HASHMAP_STATIC_MAP_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>           // For std::equal_to<T>
+#include <type_traits>
+#include <utility>              // For std::pair<F, S>, std::index_sequence<I...>
+#include <string_view>
+#include <stdexcept>
+
+#include "jstd/basic/stddef.h"
+
+namespace jstd {
+
+//
+// The hashes of static_map, all of them are constexpr, so that the same function
+// is used to build the table at compile time and to look up at run time.
+//
+namespace static_hash {
+
+static constexpr std::uint64_t kFnv1aOffsetBasis64 = 14695981039346656037ull;
+static constexpr std::uint64_t kFnv1aPrime64       = 1099511628211ull;
+
+//
+// FNV-1a over 8-byte little-endian words, the tail is zero padded and the length
+// is mixed in at the end. The bytes are assembled by shifts to be constexpr,
+// the compilers turn them into a single unaligned load at run time.
+//
+constexpr std::uint64_t fnv1a_64(const char * data, std::size_t size) noexcept {
+    std::uint64_t hash = kFnv1aOffsetBasis64;
+    std::size_t pos = 0;
+    for (; (pos + 8) <= size; pos += 8) {
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[pos + i])) << (i * 8);
+        }
+        hash = (hash ^ word) * kFnv1aPrime64;
+    }
+    if (pos < size) {
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; (pos + i) < size; i++) {
+            word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[pos + i])) << (i * 8);
+        }
+        hash = (hash ^ word) * kFnv1aPrime64;
+    }
+    hash = (hash ^ static_cast<std::uint64_t>(size)) * kFnv1aPrime64;
+    return (hash ^ (hash >> 32));
+}
+
+// The finalizer of splitmix64.
+constexpr std::uint64_t mix_64(std::uint64_t value) noexcept {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return (value ^ (value >> 31));
+}
+
+} // namespace static_hash
+
+template <typename Key, typename Enable = void>
+struct static_map_hash;
+
+template <typename Key>
+struct static_map_hash<Key, typename std::enable_if<std::is_integral<Key>::value ||
+                                                    std::is_enum<Key>::value>::type> {
+    constexpr std::uint64_t operator () (Key key) const noexcept {
+        return static_hash::mix_64(static_cast<std::uint64_t>(key));
+    }
+};
+
+template <typename CharT, typename Traits>
+struct static_map_hash<std::basic_string_view<CharT, Traits>, void> {
+    static_assert((sizeof(CharT) == 1), "static_map_hash<basic_string_view<CharT>>: Only support the 1 byte CharT.");
+
+    constexpr std::uint64_t operator () (std::basic_string_view<CharT, Traits> key) const noexcept {
+        return static_hash::fnv1a_64(key.data(), key.size());
+    }
+};
+
+/*
+ * static_map<K, V, N>: A constant map of N entries, built at compile time.
+ *
+ * The constexpr constructor searches a multiplier for the multiply-shift hash:
+ *
+ *     slot = (hash(key) * multiplier) >> (64 - kSlotBits)
+ *
+ * that maps the N keys to distinct slots of kSlotCount (= 4 * round_up_pow2(N)) slots,
+ * each slot is the index of an entry. The empty slots point to entry 0, it's never equal
+ * to a key that hashes into an empty slot, so a lookup is one hash, one load of the index
+ * and one compare, without any branch for the empty slot.
+ *
+ * A constexpr static_map lives in the read-only data, there is no heap and no startup cost:
+ *
+ *     static constexpr auto kHttpMethods = jstd::make_static_map<std::string_view, int>({
+ *         { "GET", 1 }, { "HEAD", 2 }, { "POST", 3 }
+ *     });
+ *
+ *     static_assert(kHttpMethods.at("POST") == 3, "");
+ *
+ * The key and the value must be literal types, and the keys must be unique,
+ * a duplicate key is a compile error (or std::logic_error at run time).
+ * It's designed for the small key sets (up to a few hundred keys), the slots grow as N^2 / 8.
+ */
+template <typename Key, typename Value, std::size_t N,
+          typename Hash = static_map_hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class JSTD_DLL static_map
+{
+public:
+    typedef Key                             key_type;
+    typedef Value                           mapped_type;
+    typedef std::pair<Key, Value>           value_type;
+    typedef std::size_t                     size_type;
+    typedef std::ptrdiff_t                  difference_type;
+    typedef Hash                            hasher;
+    typedef KeyEqual                        key_equal;
+
+    typedef const value_type &              reference;
+    typedef const value_type &              const_reference;
+    typedef const value_type *              iterator;
+    typedef const value_type *              const_iterator;
+
+    static_assert((N > 0), "static_map<K, V, N>: N must be greater than 0.");
+
+    typedef typename std::conditional<(N <= 0xFFu), std::uint8_t,
+            typename std::conditional<(N <= 0xFFFFu), std::uint16_t, std::uint32_t>::type>::type
+                                            index_type;
+
+private:
+    static constexpr size_type round_up_pow2_log2(size_type n) noexcept {
+        size_type bits = 0;
+        while ((size_type(1) << bits) < n) {
+            bits++;
+        }
+        return bits;
+    }
+
+    static constexpr size_type max_of(size_type a, size_type b) noexcept {
+        return (a > b) ? a : b;
+    }
+
+public:
+    //
+    // A random function maps N keys to M slots without collision in about e^(N^2 / 2M) tries,
+    // so M is at least N^2 / 8, it's about e^4 tries at most. The small maps use 4x slots.
+    //
+    static constexpr size_type kSlotBits  = max_of(round_up_pow2_log2(N) + 2,
+                                                   round_up_pow2_log2(N * N / 8));
+    static constexpr size_type kSlotCount = size_type(1) << kSlotBits;
+    static constexpr size_type kSlotShift = 64 - kSlotBits;
+
+    // The maximum number of the multipliers to try.
+    static constexpr size_type kMaxSeedTries = 1 << 16;
+
+    using this_type = static_map<Key, Value, N, Hash, KeyEqual>;
+
+private:
+    value_type      entries_[N];
+    index_type      slots_[kSlotCount];
+    std::uint64_t   multiplier_;
+
+public:
+    ///
+    /// Constructors
+    ///
+    constexpr explicit static_map(const value_type (&entries)[N])
+        : static_map(entries, std::make_index_sequence<N>()) {
+    }
+
+private:
+    template <std::size_t ... I>
+    constexpr static_map(const value_type (&entries)[N], std::index_sequence<I...>)
+        : entries_{ entries[I]... }, slots_{}, multiplier_(0) {
+        this->build();
+    }
+
+public:
+    ///
+    /// Observers
+    ///
+    constexpr hasher hash_function() const noexcept { return hasher(); }
+    constexpr key_equal key_eq() const noexcept { return key_equal(); }
+    constexpr std::uint64_t multiplier() const noexcept { return this->multiplier_; }
+
+    static const char * name() noexcept {
+        return "jstd::static_map<K, V, N>";
+    }
+
+    ///
+    /// Iterators
+    ///
+    constexpr const_iterator begin() const noexcept { return &this->entries_[0]; }
+    constexpr const_iterator end() const noexcept { return &this->entries_[0] + N; }
+
+    constexpr const_iterator cbegin() const noexcept { return this->begin(); }
+    constexpr const_iterator cend() const noexcept { return this->end(); }
+
+    ///
+    /// Capacity
+    ///
+    constexpr bool empty() const noexcept { return false; }
+    constexpr size_type size() const noexcept { return N; }
+    constexpr size_type max_size() const noexcept { return N; }
+    constexpr size_type bucket_count() const noexcept { return kSlotCount; }
+
+    constexpr float load_factor() const noexcept {
+        return (static_cast<float>(N) / kSlotCount);
+    }
+
+    ///
+    /// Lookup
+    ///
+    JSTD_FORCED_INLINE
+    constexpr const_iterator find(const key_type & key) const {
+        size_type index = this->slots_[this->slot_for_hash(hasher()(key))];
+        const value_type & entry = this->entries_[index];
+        return (key_equal()(entry.first, key) ? &entry : this->end());
+    }
+
+    JSTD_FORCED_INLINE
+    constexpr size_type count(const key_type & key) const {
+        return (this->find(key) != this->end()) ? 1 : 0;
+    }
+
+    JSTD_FORCED_INLINE
+    constexpr bool contains(const key_type & key) const {
+        return (this->find(key) != this->end());
+    }
+
+    constexpr const mapped_type & at(const key_type & key) const {
+        const_iterator iter = this->find(key);
+        if (iter != this->end())
+            return iter->second;
+        else
+            throw std::out_of_range("key was not found in static_map");
+    }
+
+private:
+    JSTD_FORCED_INLINE
+    constexpr size_type slot_for_hash(std::uint64_t hash) const noexcept {
+        return static_cast<size_type>((hash * this->multiplier_) >> kSlotShift);
+    }
+
+    constexpr void build() {
+        std::uint64_t hashes[N] = {};
+        for (size_type i = 0; i < N; i++) {
+            hashes[i] = hasher()(this->entries_[i].first);
+            for (size_type j = 0; j < i; j++) {
+                if (hashes[j] == hashes[i] && key_equal()(this->entries_[j].first, this->entries_[i].first)) {
+                    throw std::logic_error("static_map: duplicate key");
+                }
+            }
+        }
+
+        // The slots that are not empty, slots_[] is 0 for the empty slots.
+        bool used[kSlotCount] = {};
+        for (size_type seed = 1; seed <= kMaxSeedTries; seed++) {
+            this->multiplier_ = static_hash::mix_64(seed) | 1;
+            size_type i = 0;
+            for (; i < N; i++) {
+                size_type slot = this->slot_for_hash(hashes[i]);
+                if (used[slot])
+                    break;
+                used[slot] = true;
+                this->slots_[slot] = static_cast<index_type>(i);
+            }
+            if (i == N)
+                return;
+            // Rollback the placed keys only.
+            while (i > 0) {
+                i--;
+                size_type slot = this->slot_for_hash(hashes[i]);
+                used[slot] = false;
+                this->slots_[slot] = 0;
+            }
+        }
+        throw std::logic_error("static_map: can not find a perfect hash multiplier");
+    }
+};
+
+//
+// make_static_map<K, V>({ { key, value }, ... }), N is deduced from the initializer list.
+//
+template <typename Key, typename Value,
+          typename Hash = static_map_hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          std::size_t N>
+constexpr static_map<Key, Value, N, Hash, KeyEqual>
+make_static_map(const std::pair<Key, Value> (&entries)[N]) {
+    return static_map<Key, Value, N, Hash, KeyEqual>(entries);
+}
+
+} // namespace jstd
+
+#endif // JSTD_HASHMAP_STATIC_MAP_HPP
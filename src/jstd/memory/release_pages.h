@@ -0,0 +1,97 @@
+
+#ifndef JSTD_MEMORY_RELEASE_PAGES_H
+#define JSTD_MEMORY_RELEASE_PAGES_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <cstdint>
+#include <cstddef>
+
+#include "jstd/basic/stddef.h"
+
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  #define JSTD_HAVE_RELEASE_PAGES   1
+#elif defined(__unix__) || defined(__unix) || defined(unix) || (defined(__APPLE__) && defined(__MACH__))
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #define JSTD_HAVE_RELEASE_PAGES   1
+#else
+  #define JSTD_HAVE_RELEASE_PAGES   0
+#endif
+
+namespace jstd {
+
+//
+// The size of a virtual memory page, 4096 if it can not be determined.
+//
+static inline
+std::size_t get_page_size() noexcept
+{
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    static const std::size_t s_page_size = []() -> std::size_t {
+        SYSTEM_INFO si;
+        ::GetSystemInfo(&si);
+        return (si.dwPageSize != 0) ? static_cast<std::size_t>(si.dwPageSize) : std::size_t(4096);
+    }();
+    return s_page_size;
+#elif JSTD_HAVE_RELEASE_PAGES
+    static const std::size_t s_page_size = []() -> std::size_t {
+        long page_size = ::sysconf(_SC_PAGESIZE);
+        return (page_size > 0) ? static_cast<std::size_t>(page_size) : std::size_t(4096);
+    }();
+    return s_page_size;
+#else
+    return 4096;
+#endif
+}
+
+//
+// Return the physical pages of [ptr, ptr + size) to the OS, only the whole pages
+// inside the range are released. The address range keeps valid and reserved,
+// the pages are faulted in again (zero-filled or the old contents) when touched,
+// so the contents of the range are undefined after the call.
+//
+// Linux:   madvise(MADV_DONTNEED), the RSS drops immediately.
+// Windows: VirtualAlloc(MEM_RESET), the pages are discarded lazily under memory pressure.
+//
+// Returns the bytes released, or 0 if the range has no whole page or it's not supported.
+//
+static inline
+std::size_t release_pages(void * ptr, std::size_t size) noexcept
+{
+#if JSTD_HAVE_RELEASE_PAGES
+    std::size_t page_size = get_page_size();
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(ptr);
+    std::uintptr_t last = first + size;
+    std::uintptr_t page_first = (first + page_size - 1) & ~(std::uintptr_t(page_size) - 1);
+    std::uintptr_t page_last = last & ~(std::uintptr_t(page_size) - 1);
+    if (ptr == nullptr || page_first >= page_last)
+        return 0;
+
+    std::size_t page_bytes = static_cast<std::size_t>(page_last - page_first);
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    void * result = ::VirtualAlloc(reinterpret_cast<void *>(page_first), page_bytes, MEM_RESET, PAGE_READWRITE);
+    return (result != nullptr) ? page_bytes : 0;
+#else
+    int result = ::madvise(reinterpret_cast<void *>(page_first), page_bytes, MADV_DONTNEED);
+    return (result == 0) ? page_bytes : 0;
+#endif
+#else
+    JSTD_UNUSED(ptr);
+    JSTD_UNUSED(size);
+    return 0;
+#endif
+}
+
+} // namespace jstd
+
+#endif // JSTD_MEMORY_RELEASE_PAGES_H
@@ -0,0 +1,468 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2018-2022 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+  -------------------------------------------------------------------
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+************************************************************************************/
+
+#ifndef JSTD_SUPPORT_SIMD_VEC256_H
+#define JSTD_SUPPORT_SIMD_VEC256_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>          // For std::memcpy()
+
+#include "jstd/basic/stddef.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+   (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>      // SSE2
+#define JSTD_HAVE_SIMD_VEC256_SSE2  1
+#else
+#define JSTD_HAVE_SIMD_VEC256_SSE2  0
+#endif
+
+//
+// The 256-bit vectors emulated by two SSE2 registers (vec256_sse2), or by four
+// 64-bit integers (vec256_swar, SIMD Within A Register). The operations have
+// the same names and the same results as the AVX2 intrinsics (_mm256_xxxx()),
+// so the AVX2 code can be ported to them line by line.
+//
+// All the shift counts larger than the lane width produce zeros, like AVX2.
+//
+
+namespace jstd {
+
+#if JSTD_HAVE_SIMD_VEC256_SSE2
+
+struct vec256_sse2 {
+    __m128i lo;
+    __m128i hi;
+
+    typedef vec256_sse2 vec_type;
+
+    static JSTD_FORCED_INLINE
+    vec_type make(__m128i lo, __m128i hi) {
+        vec_type result;
+        result.lo = lo;
+        result.hi = hi;
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type loadu(const void * ptr) {
+        return make(_mm_loadu_si128((const __m128i *)ptr),
+                    _mm_loadu_si128((const __m128i *)ptr + 1));
+    }
+
+    static JSTD_FORCED_INLINE
+    void storeu(void * ptr, const vec_type & v) {
+        _mm_storeu_si128((__m128i *)ptr, v.lo);
+        _mm_storeu_si128((__m128i *)ptr + 1, v.hi);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type setzero() {
+        __m128i zero_bits = _mm_setzero_si128();
+        return make(zero_bits, zero_bits);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type setones() {
+        __m128i ones_bits = _mm_setzero_si128();
+        ones_bits = _mm_cmpeq_epi32(ones_bits, ones_bits);
+        return make(ones_bits, ones_bits);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type set1_epi8(std::int8_t value) {
+        __m128i bits = _mm_set1_epi8((char)value);
+        return make(bits, bits);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type set1_epi16(std::int16_t value) {
+        __m128i bits = _mm_set1_epi16((short)value);
+        return make(bits, bits);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type set1_epi64x(std::int64_t value) {
+#if defined(_M_IX86) && defined(_MSC_VER) && (_MSC_VER < 1900)
+        __m128i bits = _mm_set_epi32((int)(value >> 32), (int)value, (int)(value >> 32), (int)value);
+#else
+        __m128i bits = _mm_set1_epi64x(value);
+#endif
+        return make(bits, bits);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type and_si256(const vec_type & a, const vec_type & b) {
+        return make(_mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type andnot_si256(const vec_type & a, const vec_type & b) {
+        return make(_mm_andnot_si128(a.lo, b.lo), _mm_andnot_si128(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type or_si256(const vec_type & a, const vec_type & b) {
+        return make(_mm_or_si128(a.lo, b.lo), _mm_or_si128(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpeq_epi8(const vec_type & a, const vec_type & b) {
+        return make(_mm_cmpeq_epi8(a.lo, b.lo), _mm_cmpeq_epi8(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpgt_epi8(const vec_type & a, const vec_type & b) {
+        return make(_mm_cmpgt_epi8(a.lo, b.lo), _mm_cmpgt_epi8(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpeq_epi16(const vec_type & a, const vec_type & b) {
+        return make(_mm_cmpeq_epi16(a.lo, b.lo), _mm_cmpeq_epi16(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpgt_epi16(const vec_type & a, const vec_type & b) {
+        return make(_mm_cmpgt_epi16(a.lo, b.lo), _mm_cmpgt_epi16(a.hi, b.hi));
+    }
+
+    // _mm_cmpeq_epi64() is SSE4.1, use two 32-bit compares.
+    static JSTD_FORCED_INLINE
+    __m128i cmpeq_epi64_128(__m128i a, __m128i b) {
+        __m128i eq32 = _mm_cmpeq_epi32(a, b);
+        __m128i eq32_swap = _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_and_si128(eq32, eq32_swap);
+    }
+
+    // _mm_cmpgt_epi64() is SSE4.2, compare the high 32 bits (signed), and if they
+    // are equal, use the borrow of (b - a) for the low 32 bits (unsigned).
+    static JSTD_FORCED_INLINE
+    __m128i cmpgt_epi64_128(__m128i a, __m128i b) {
+        __m128i result = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+        result = _mm_or_si128(result, _mm_cmpgt_epi32(a, b));
+        return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpeq_epi64(const vec_type & a, const vec_type & b) {
+        return make(cmpeq_epi64_128(a.lo, b.lo), cmpeq_epi64_128(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpgt_epi64(const vec_type & a, const vec_type & b) {
+        return make(cmpgt_epi64_128(a.lo, b.lo), cmpgt_epi64_128(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type adds_epi8(const vec_type & a, const vec_type & b) {
+        return make(_mm_adds_epi8(a.lo, b.lo), _mm_adds_epi8(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type adds_epi16(const vec_type & a, const vec_type & b) {
+        return make(_mm_adds_epi16(a.lo, b.lo), _mm_adds_epi16(a.hi, b.hi));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type srli_epi16(const vec_type & a, int count) {
+        return make(_mm_srli_epi16(a.lo, count), _mm_srli_epi16(a.hi, count));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type slli_epi16(const vec_type & a, int count) {
+        return make(_mm_slli_epi16(a.lo, count), _mm_slli_epi16(a.hi, count));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type srli_epi64(const vec_type & a, int count) {
+        return make(_mm_srli_epi64(a.lo, count), _mm_srli_epi64(a.hi, count));
+    }
+
+    static JSTD_FORCED_INLINE
+    std::uint32_t movemask_epi8(const vec_type & a) {
+        std::uint32_t mask_lo = (std::uint32_t)_mm_movemask_epi8(a.lo);
+        std::uint32_t mask_hi = (std::uint32_t)_mm_movemask_epi8(a.hi);
+        return (mask_lo | (mask_hi << 16));
+    }
+};
+
+#endif // JSTD_HAVE_SIMD_VEC256_SSE2
+
+struct vec256_swar {
+    std::uint64_t u64[4];
+
+    typedef vec256_swar vec_type;
+
+    static constexpr std::uint64_t kMSBs8  = 0x8080808080808080ull;
+    static constexpr std::uint64_t kLSBs8  = 0x0101010101010101ull;
+    static constexpr std::uint64_t kMSBs16 = 0x8000800080008000ull;
+    static constexpr std::uint64_t kLSBs16 = 0x0001000100010001ull;
+
+    static JSTD_FORCED_INLINE
+    vec_type make(std::uint64_t value) {
+        vec_type result;
+        result.u64[0] = value;
+        result.u64[1] = value;
+        result.u64[2] = value;
+        result.u64[3] = value;
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type loadu(const void * ptr) {
+        vec_type result;
+        std::memcpy((void *)&result.u64[0], ptr, sizeof(result.u64));
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    void storeu(void * ptr, const vec_type & v) {
+        std::memcpy(ptr, (const void *)&v.u64[0], sizeof(v.u64));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type setzero() {
+        return make(0);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type setones() {
+        return make(~std::uint64_t(0));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type set1_epi8(std::int8_t value) {
+        return make(std::uint64_t((std::uint8_t)value) * kLSBs8);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type set1_epi16(std::int16_t value) {
+        return make(std::uint64_t((std::uint16_t)value) * kLSBs16);
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type set1_epi64x(std::int64_t value) {
+        return make((std::uint64_t)value);
+    }
+
+    //
+    // The lane-wise operations of a 64-bit word, kMSBs is the most significant
+    // bit of each lane (8-bit or 16-bit), the lanes never carry or borrow to
+    // the next lane.
+    //
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_fill(std::uint64_t msbs) {
+        // Spread the MSB of each lane to the whole lane.
+        return ((msbs - (msbs >> (kMSBs == kMSBs8 ? 7 : 15))) | msbs);
+    }
+
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_add(std::uint64_t a, std::uint64_t b) {
+        return (((a & ~kMSBs) + (b & ~kMSBs)) ^ ((a ^ b) & kMSBs));
+    }
+
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_sub(std::uint64_t a, std::uint64_t b) {
+        return (((a | kMSBs) - (b & ~kMSBs)) ^ ((a ^ ~b) & kMSBs));
+    }
+
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_cmpeq(std::uint64_t a, std::uint64_t b) {
+        std::uint64_t x = a ^ b;
+        // The MSB of each lane is set if the lane is non-zero.
+        std::uint64_t non_zero = (((x & ~kMSBs) + ~kMSBs) | x) & kMSBs;
+        return lane_fill<kMSBs>(non_zero ^ kMSBs);
+    }
+
+    // Unsigned (a < b), it's the borrow out of (a - b) of each lane.
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_cmplt_u(std::uint64_t a, std::uint64_t b) {
+        std::uint64_t diff = lane_sub<kMSBs>(a, b);
+        std::uint64_t borrow = ((~a & b) | (~(a ^ b) & diff)) & kMSBs;
+        return lane_fill<kMSBs>(borrow);
+    }
+
+    // Signed (a > b), flip the sign bits and compare as unsigned.
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_cmpgt(std::uint64_t a, std::uint64_t b) {
+        return lane_cmplt_u<kMSBs>(b ^ kMSBs, a ^ kMSBs);
+    }
+
+    // Signed saturating add.
+    template <std::uint64_t kMSBs>
+    static JSTD_FORCED_INLINE
+    std::uint64_t lane_adds(std::uint64_t a, std::uint64_t b) {
+        std::uint64_t sum = lane_add<kMSBs>(a, b);
+        // Overflow if a and b have the same sign and the sign of sum is different.
+        std::uint64_t overflow = lane_fill<kMSBs>(~(a ^ b) & (a ^ sum) & kMSBs);
+        // 0x7F..F if a >= 0, 0x80..0 if a < 0.
+        std::uint64_t saturated = (~kMSBs) + ((a & kMSBs) >> (kMSBs == kMSBs8 ? 7 : 15));
+        return ((sum & ~overflow) | (saturated & overflow));
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type and_si256(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = a.u64[i] & b.u64[i];
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type andnot_si256(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = ~a.u64[i] & b.u64[i];
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type or_si256(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = a.u64[i] | b.u64[i];
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpeq_epi8(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = lane_cmpeq<kMSBs8>(a.u64[i], b.u64[i]);
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpgt_epi8(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = lane_cmpgt<kMSBs8>(a.u64[i], b.u64[i]);
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpeq_epi16(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = lane_cmpeq<kMSBs16>(a.u64[i], b.u64[i]);
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpgt_epi16(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = lane_cmpgt<kMSBs16>(a.u64[i], b.u64[i]);
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpeq_epi64(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = (a.u64[i] == b.u64[i]) ? ~std::uint64_t(0) : 0;
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type cmpgt_epi64(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = ((std::int64_t)a.u64[i] > (std::int64_t)b.u64[i]) ? ~std::uint64_t(0) : 0;
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type adds_epi8(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = lane_adds<kMSBs8>(a.u64[i], b.u64[i]);
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type adds_epi16(const vec_type & a, const vec_type & b) {
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = lane_adds<kMSBs16>(a.u64[i], b.u64[i]);
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type srli_epi16(const vec_type & a, int count) {
+        if (count > 15)
+            return setzero();
+        std::uint64_t lane_mask = std::uint64_t(0xFFFFu >> count) * kLSBs16;
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = (a.u64[i] >> count) & lane_mask;
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type slli_epi16(const vec_type & a, int count) {
+        if (count > 15)
+            return setzero();
+        std::uint64_t lane_mask = std::uint64_t((0xFFFFu << count) & 0xFFFFu) * kLSBs16;
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = (a.u64[i] << count) & lane_mask;
+        return result;
+    }
+
+    static JSTD_FORCED_INLINE
+    vec_type srli_epi64(const vec_type & a, int count) {
+        if (count > 63)
+            return setzero();
+        vec_type result;
+        for (std::size_t i = 0; i < 4; i++)
+            result.u64[i] = a.u64[i] >> count;
+        return result;
+    }
+
+    // Gather the MSB of each byte, the bit i is the MSB of the byte i (little endian).
+    static JSTD_FORCED_INLINE
+    std::uint32_t movemask_epi8(const vec_type & a) {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < 4; i++) {
+            std::uint64_t msbs = (a.u64[i] & kMSBs8) >> 7;
+            std::uint32_t mask8 = (std::uint32_t)((msbs * 0x0102040810204080ull) >> 56);
+            mask |= mask8 << (i * 8);
+        }
+        return mask;
+    }
+};
+
+} // namespace jstd
+
+#endif // JSTD_SUPPORT_SIMD_VEC256_H
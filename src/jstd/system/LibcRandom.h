@@ -90,6 +90,13 @@ public:
         return static_cast<value_type>(LibcRand::rand());
     }
 
+    // Same as n times rand().
+    void fill(value_type * first, size_type n) {
+        for (size_type i = 0; i < n; i++) {
+            first[i] = this->rand();
+        }
+    }
+
     std::int32_t nextInt32() {
         return static_cast<std::int32_t>(this->nextUInt32());
     }
@@ -296,6 +296,13 @@ public:
         return y;
     }
 
+    // Same as n times rand().
+    void fill(value_type * first, size_type n) {
+        for (size_type i = 0; i < n; i++) {
+            first[i] = this->rand();
+        }
+    }
+
     std::int32_t nextInt32() {
         return static_cast<std::int32_t>(this->rand() & 0xFFFFFFFFull);
     }
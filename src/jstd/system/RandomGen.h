@@ -55,10 +55,18 @@
 #endif
 
 #include <assert.h>
+#include <math.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <utility>      // For std::swap()
 
 #include "jstd/system/LibcRandom.h"
 #include "jstd/system/MT19937_32.h"
 #include "jstd/system/MT19937_64.h"
+#include "jstd/system/Xoshiro256.h"
 
 namespace jstd {
 
@@ -94,6 +102,16 @@ public:
         return this_type::getInstance().rand();
     }
 
+    // Same as n times rand(), the Xoshiro256x4 writes the whole SIMD blocks to first[] directly.
+    static void fill(value_type * first, size_type n) {
+        this_type::getInstance().fill(first, n);
+    }
+
+    template <typename Container>
+    static void fill(Container & container) {
+        this_type::getInstance().fill(container.data(), container.size());
+    }
+
     static std::int32_t nextInt32() {
         return this_type::getInstance().nextInt32();
     }
@@ -269,6 +287,338 @@ typedef BasicRandomGenerator<MT19937_64>    MtRandomGen;
 typedef BasicRandomGenerator<MT19937_32>    MtRandomGen;
 #endif
 
+typedef BasicRandomGenerator<Xoshiro256>    XoshiroRandomGen64;
+typedef BasicRandomGenerator<Xoshiro256x4>  XoshiroRandomGen;
+
+//
+// Fills first[0, n) with the random numbers of RandomAlgorithm in parallel.
+//
+// The range is divided into the chunks of kRandomFillChunkSize numbers, the chunk #i
+// is generated by the sub-stream #i of RandomAlgorithm(seed), i.e. after i times long_jump().
+// So the result only depends on the seed, not on the number of threads.
+// The RandomAlgorithm must have fill() and long_jump(), such as Xoshiro256 and Xoshiro256x4.
+//
+static const std::size_t kRandomFillChunkSize = std::size_t(1) << 20;
+
+template <typename RandomAlgorithm = Xoshiro256x4>
+void parallel_random_fill(typename RandomAlgorithm::value_type * first, std::size_t n,
+                          typename RandomAlgorithm::value_type seed,
+                          std::size_t num_threads = 0)
+{
+    std::size_t chunks = (n + kRandomFillChunkSize - 1) / kRandomFillChunkSize;
+    if (num_threads == 0)
+        num_threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+    if (num_threads > chunks)
+        num_threads = chunks;
+    if (num_threads == 0)
+        num_threads = 1;
+
+    auto fill_chunks = [=](std::size_t thread_id) {
+        // The base is at the start of the sub-stream #chunk.
+        RandomAlgorithm base(seed);
+        for (std::size_t i = 0; i < thread_id; i++) {
+            base.long_jump();
+        }
+        for (std::size_t chunk = thread_id; chunk < chunks; chunk += num_threads) {
+            std::size_t offset = chunk * kRandomFillChunkSize;
+            std::size_t count = (n - offset < kRandomFillChunkSize) ? (n - offset) : kRandomFillChunkSize;
+            RandomAlgorithm stream(base);
+            stream.fill(first + offset, count);
+            if (chunk + num_threads < chunks) {
+                for (std::size_t i = 0; i < num_threads; i++) {
+                    base.long_jump();
+                }
+            }
+        }
+    };
+
+    if (num_threads == 1) {
+        fill_chunks(0);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (std::size_t t = 0; t < num_threads; t++) {
+            threads.emplace_back(fill_chunks, t);
+        }
+        for (std::size_t t = 0; t < num_threads; t++) {
+            threads[t].join();
+        }
+    }
+}
+
+//
+// Fisher-Yates shuffle, the random numbers are generated in blocks by the RandomAlgorithm,
+// and the index in [0, i] is reduced by a multiply-shift (Lemire) instead of the modulo
+// when the range fits in 32 bits.
+//
+template <typename RandomAlgorithm = Xoshiro256x4, typename RandomAccessIter>
+void random_shuffle(RandomAccessIter first, RandomAccessIter last,
+                    typename RandomAlgorithm::value_type seed)
+{
+    typedef typename RandomAlgorithm::value_type value_type;
+    static const std::size_t kBlockSize = 256;
+
+    RandomAlgorithm random(seed);
+    value_type block[kBlockSize];
+    std::size_t index = kBlockSize;
+
+    std::size_t n = static_cast<std::size_t>(last - first);
+    for (; n >= 2; n--) {
+        if (index >= kBlockSize) {
+            random.fill(block, kBlockSize);
+            index = 0;
+        }
+        std::uint64_t r = static_cast<std::uint64_t>(block[index++]);
+        std::size_t rnd_idx;
+        if (std::uint64_t(n) <= 0xFFFFFFFFull)
+            rnd_idx = static_cast<std::size_t>(((r >> 32) * std::uint64_t(n)) >> 32);
+        else
+            rnd_idx = static_cast<std::size_t>(r % std::uint64_t(n));
+        using std::swap;
+        swap(first[n - 1], first[rnd_idx]);
+    }
+}
+
+//
+// Key access generators, all of them generate the key indices (ranks) in range [0, n).
+//
+// The range can be grown by resize(n), so a generator can follow a table that is
+// still being filled, the generated sequence only depends on the seed of RandomGen.
+//
+
+//
+// Uniform distribution.
+//
+template <typename RandomGen = MtRandomGen>
+class JSTD_DLL UniformKeyGenerator {
+public:
+    typedef std::size_t     size_type;
+
+private:
+    size_type n_;
+
+public:
+    explicit UniformKeyGenerator(size_type n = 1) : n_((n > 0) ? n : 1) {}
+    ~UniformKeyGenerator() {}
+
+    size_type size() const { return this->n_; }
+
+    void resize(size_type n) {
+        this->n_ = (n > 0) ? n : 1;
+    }
+
+    size_type next() {
+        return RandomGen::nextUInt(this->n_ - 1);
+    }
+};
+
+//
+// Zipfian distribution, the index 0 is the most frequently accessed,
+// the probability of index i is proportional to 1 / (i + 1)^theta.
+//
+// From: Jim Gray, et al. "Quickly Generating Billion-Record Synthetic Databases", SIGMOD 1994.
+// (The same algorithm is used by YCSB), the valid range of theta is (0, 1).
+//
+template <typename RandomGen = MtRandomGen>
+class JSTD_DLL ZipfianKeyGenerator {
+public:
+    typedef std::size_t     size_type;
+
+private:
+    size_type n_;
+    double    theta_;
+    double    alpha_;
+    double    zeta2_;
+    double    zetan_;
+    double    eta_;
+
+public:
+    explicit ZipfianKeyGenerator(size_type n = 1, double theta = 0.99)
+        : n_(0), theta_(theta), zeta2_(0.0), zetan_(0.0), eta_(0.0) {
+        assert(theta > 0.0 && theta < 1.0);
+        if (this->theta_ <= 0.0)
+            this->theta_ = 0.01;
+        else if (this->theta_ >= 1.0)
+            this->theta_ = 0.9999;
+        this->alpha_ = 1.0 / (1.0 - this->theta_);
+        this->zeta2_ = 1.0 + ::pow(0.5, this->theta_);
+        this->resize(n);
+    }
+    ~ZipfianKeyGenerator() {}
+
+    size_type size() const { return this->n_; }
+    double theta() const { return this->theta_; }
+
+    //
+    // The zeta(n) is updated incrementally, so growing the range step by step
+    // only costs O(new_n - old_n).
+    //
+    void resize(size_type n) {
+        if (n == 0)
+            n = 1;
+        if (n > this->n_) {
+            for (size_type i = this->n_ + 1; i <= n; i++) {
+                this->zetan_ += 1.0 / ::pow(static_cast<double>(i), this->theta_);
+            }
+        } else if (n < this->n_) {
+            for (size_type i = this->n_; i > n; i--) {
+                this->zetan_ -= 1.0 / ::pow(static_cast<double>(i), this->theta_);
+            }
+        }
+        this->n_ = n;
+        if (n > 1) {
+            this->eta_ = (1.0 - ::pow(2.0 / static_cast<double>(n), 1.0 - this->theta_)) /
+                         (1.0 - this->zeta2_ / this->zetan_);
+        } else {
+            this->eta_ = 0.0;
+        }
+    }
+
+    size_type next() {
+        if (this->n_ <= 1)
+            return 0;
+        double u = RandomGen::nextDouble53();
+        double uz = u * this->zetan_;
+        if (uz < 1.0)
+            return 0;
+        if (uz < this->zeta2_)
+            return 1;
+        size_type index = static_cast<size_type>(static_cast<double>(this->n_) *
+                                                 ::pow(this->eta_ * u - this->eta_ + 1.0, this->alpha_));
+        return (index < this->n_) ? index : (this->n_ - 1);
+    }
+};
+
+//
+// Hot/cold set distribution, (hot_access_ratio) of accesses go to the first
+// (hot_set_ratio) of the indices, the rest go to the cold set, both are uniform.
+//
+template <typename RandomGen = MtRandomGen>
+class JSTD_DLL HotColdKeyGenerator {
+public:
+    typedef std::size_t     size_type;
+
+private:
+    size_type n_;
+    size_type hot_n_;
+    double    hot_set_ratio_;
+    double    hot_access_ratio_;
+
+public:
+    explicit HotColdKeyGenerator(size_type n = 1, double hot_set_ratio = 0.2,
+                                 double hot_access_ratio = 0.8)
+        : n_(0), hot_n_(0), hot_set_ratio_(hot_set_ratio),
+          hot_access_ratio_(hot_access_ratio) {
+        assert(hot_set_ratio > 0.0 && hot_set_ratio <= 1.0);
+        assert(hot_access_ratio >= 0.0 && hot_access_ratio <= 1.0);
+        this->resize(n);
+    }
+    ~HotColdKeyGenerator() {}
+
+    size_type size() const { return this->n_; }
+    size_type hot_size() const { return this->hot_n_; }
+
+    void resize(size_type n) {
+        this->n_ = (n > 0) ? n : 1;
+        size_type hot_n = static_cast<size_type>(static_cast<double>(this->n_) * this->hot_set_ratio_);
+        if (hot_n == 0)
+            hot_n = 1;
+        this->hot_n_ = (hot_n < this->n_) ? hot_n : this->n_;
+    }
+
+    size_type next() {
+        if ((this->hot_n_ >= this->n_) || (RandomGen::nextDouble53() < this->hot_access_ratio_)) {
+            return RandomGen::nextUInt(this->hot_n_ - 1);
+        } else {
+            return (this->hot_n_ + RandomGen::nextUInt(this->n_ - this->hot_n_ - 1));
+        }
+    }
+};
+
+//
+// Monotonically increasing IDs, it's wrapped around to 0 at the end of range.
+//
+template <typename RandomGen = MtRandomGen>
+class JSTD_DLL MonotonicKeyGenerator {
+public:
+    typedef std::size_t     size_type;
+
+private:
+    size_type n_;
+    size_type next_id_;
+
+public:
+    explicit MonotonicKeyGenerator(size_type n = 1, size_type first_id = 0)
+        : n_((n > 0) ? n : 1), next_id_(first_id) {
+        if (this->next_id_ >= this->n_)
+            this->next_id_ = 0;
+    }
+    ~MonotonicKeyGenerator() {}
+
+    size_type size() const { return this->n_; }
+
+    void resize(size_type n) {
+        this->n_ = (n > 0) ? n : 1;
+        if (this->next_id_ >= this->n_)
+            this->next_id_ = 0;
+    }
+
+    void seek(size_type next_id) {
+        this->next_id_ = (next_id < this->n_) ? next_id : 0;
+    }
+
+    size_type next() {
+        size_type id = this->next_id_;
+        this->next_id_++;
+        if (this->next_id_ >= this->n_)
+            this->next_id_ = 0;
+        return id;
+    }
+};
+
+//
+// Clustered ranges, picks a uniform random start and then returns
+// (cluster_size) consecutive indices, and so on.
+//
+template <typename RandomGen = MtRandomGen>
+class JSTD_DLL ClusteredKeyGenerator {
+public:
+    typedef std::size_t     size_type;
+
+private:
+    size_type n_;
+    size_type cluster_size_;
+    size_type cluster_start_;
+    size_type remaining_;
+
+public:
+    explicit ClusteredKeyGenerator(size_type n = 1, size_type cluster_size = 32)
+        : n_((n > 0) ? n : 1), cluster_size_((cluster_size > 0) ? cluster_size : 1),
+          cluster_start_(0), remaining_(0) {
+    }
+    ~ClusteredKeyGenerator() {}
+
+    size_type size() const { return this->n_; }
+    size_type cluster_size() const { return this->cluster_size_; }
+
+    void resize(size_type n) {
+        this->n_ = (n > 0) ? n : 1;
+        this->remaining_ = 0;
+    }
+
+    size_type next() {
+        if (this->remaining_ == 0) {
+            size_type cluster_size = (this->cluster_size_ < this->n_) ? this->cluster_size_ : this->n_;
+            this->cluster_start_ = RandomGen::nextUInt(this->n_ - cluster_size);
+            this->remaining_ = cluster_size;
+        }
+        size_type index = this->cluster_start_;
+        this->cluster_start_++;
+        this->remaining_--;
+        return index;
+    }
+};
+
 } // namespace jstd
 
 #endif // JSTD_SYSTEM_RANDOMGEN_H
@@ -0,0 +1,457 @@
+
+/************************************************************************************
+
+  CC BY-SA 4.0 License
+
+  Copyright (c) 2017-2022 XiongHui Guo (gz_shines at msn.com)
+
+  https://github.com/shines77/jstd_hashmap
+  https://gitee.com/shines77/jstd_hashmap
+
+*************************************************************************************
+
+  CC Attribution-ShareAlike 4.0 International
+
+  https://creativecommons.org/licenses/by-sa/4.0/deed.en
+
+  You are free to:
+
+    1. Share -- copy and redistribute the material in any medium or format.
+
+    2. Adapt -- remix, transforn, and build upon the material for any purpose,
+    even commerically.
+
+    The licensor cannot revoke these freedoms as long as you follow the license terms.
+
+  Under the following terms:
+
+    * Attribution -- You must give appropriate credit, provide a link to the license,
+    and indicate if changes were made. You may do so in any reasonable manner,
+    but not in any way that suggests the licensor endorses you or your use.
+
+    * ShareAlike -- If you remix, transform, or build upon the material, you must
+    distribute your contributions under the same license as the original.
+
+    * No additional restrictions -- You may not apply legal terms or technological
+    measures that legally restrict others from doing anything the license permits.
+
+  Notices:
+
+    * You do not have to comply with the license for elements of the material
+    in the public domain or where your use is permitted by an applicable exception
+    or limitation.
+
+    * No warranties are given. The license may not give you all of the permissions
+    necessary for your intended use. For example, other rights such as publicity,
+    privacy, or moral rights may limit how you use the material.
+
+************************************************************************************/
+
+
+#ifndef JSTD_SYSTEM_XOSHIRO256_H
+#define JSTD_SYSTEM_XOSHIRO256_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include "jstd/basic/stddef.h"
+#include "jstd/basic/stdint.h"
+#include "jstd/basic/stdsize.h"
+
+#include <time.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>      // For std::memcpy()
+
+#if defined(__AVX2__)
+#include <immintrin.h>  // For AVX2
+#define JSTD_HAVE_XOSHIRO256_AVX2   1
+#else
+#define JSTD_HAVE_XOSHIRO256_AVX2   0
+#endif
+
+//
+// xoshiro256** 1.0, from: David Blackman and Sebastiano Vigna,
+// "Scrambled Linear Pseudorandom Number Generators", ACM TOMS, 2021.
+//
+// See: https://prng.di.unimi.it/xoshiro256starstar.c
+//
+// The period is 2^256 - 1, jump() advances the state by 2^128 steps, and long_jump()
+// advances it by 2^192 steps, so the sub-streams created by them never overlap.
+//
+
+namespace jstd {
+
+class JSTD_DLL Xoshiro256
+{
+public:
+    typedef std::uint64_t   value_type;
+    typedef std::size_t     size_type;
+    typedef Xoshiro256      this_type;
+
+    static const value_type kDefaultSeed = 19650218019770711ull;
+    static const value_type kRandMax = 0xFFFFFFFFFFFFFFFFull;
+
+    static const size_type kStateSize = 4;
+
+private:
+    value_type state[kStateSize];
+
+public:
+    explicit Xoshiro256(value_type initSeed = kDefaultSeed) {
+        this->init(initSeed);
+    }
+
+    ~Xoshiro256() {}
+
+    value_type rand_max() const {
+        return static_cast<value_type>(kRandMax);
+    }
+
+    static inline value_type rotl(value_type x, int k) {
+        return ((x << k) | (x >> (64 - k)));
+    }
+
+    // splitmix64, it's used to expand the 64-bit seed to the 256-bit state.
+    static inline value_type splitmix64(value_type & x) {
+        value_type z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return (z ^ (z >> 31));
+    }
+
+private:
+    void init(value_type initSeed = kDefaultSeed) {
+        if (initSeed == 0) {
+            time_t timer;
+            ::time(&timer);
+            initSeed = static_cast<value_type>(timer);
+        }
+        value_type seed = initSeed;
+        for (size_type i = 0; i < kStateSize; i++) {
+            this->state[i] = splitmix64(seed);
+        }
+    }
+
+    void jump_by(const value_type (&polynomial)[kStateSize]) {
+        value_type s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (size_type i = 0; i < kStateSize; i++) {
+            for (int b = 0; b < 64; b++) {
+                if ((polynomial[i] & (value_type(1) << b)) != 0) {
+                    s0 ^= this->state[0];
+                    s1 ^= this->state[1];
+                    s2 ^= this->state[2];
+                    s3 ^= this->state[3];
+                }
+                this->rand();
+            }
+        }
+        this->state[0] = s0;
+        this->state[1] = s1;
+        this->state[2] = s2;
+        this->state[3] = s3;
+    }
+
+public:
+    void srand(value_type initSeed = kDefaultSeed) {
+        this->init(initSeed);
+    }
+
+    const value_type * get_state() const {
+        return this->state;
+    }
+
+    void set_state(const value_type * new_state) {
+        std::memcpy(this->state, new_state, sizeof(this->state));
+    }
+
+    value_type rand() {
+        const value_type result = rotl(this->state[1] * 5, 7) * 9;
+        const value_type t = this->state[1] << 17;
+
+        this->state[2] ^= this->state[0];
+        this->state[3] ^= this->state[1];
+        this->state[1] ^= this->state[2];
+        this->state[0] ^= this->state[3];
+
+        this->state[2] ^= t;
+        this->state[3] = rotl(this->state[3], 45);
+        return result;
+    }
+
+    // Equivalent to 2^128 calls to rand().
+    void jump() {
+        static const value_type kJump[kStateSize] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+            0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+        };
+        this->jump_by(kJump);
+    }
+
+    // Equivalent to 2^192 calls to rand().
+    void long_jump() {
+        static const value_type kLongJump[kStateSize] = {
+            0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull,
+            0x77710069854EE241ull, 0x39109BB02ACBE635ull
+        };
+        this->jump_by(kLongJump);
+    }
+
+    // The sub-stream #stream_id of this generator, it's the stream_id times long_jump().
+    this_type substream(size_type stream_id) const {
+        this_type stream(*this);
+        for (size_type i = 0; i < stream_id; i++) {
+            stream.long_jump();
+        }
+        return stream;
+    }
+
+    // Same as n times rand().
+    void fill(value_type * first, size_type n) {
+        for (size_type i = 0; i < n; i++) {
+            first[i] = this->rand();
+        }
+    }
+
+    std::int32_t nextInt32() {
+        return static_cast<std::int32_t>(this->rand() >> 32);
+    }
+
+    std::uint32_t nextUInt32() {
+        return static_cast<std::uint32_t>(this->rand() >> 32);
+    }
+
+    std::int64_t nextInt64() {
+        return static_cast<std::int64_t>(this->rand());
+    }
+
+    std::uint64_t nextUInt64() {
+        return static_cast<std::uint64_t>(this->rand());
+    }
+
+    std::intptr_t nextInt() {
+        return static_cast<std::intptr_t>(this->rand());
+    }
+
+    std::size_t nextUInt() {
+        return static_cast<std::size_t>(this->rand());
+    }
+};
+
+//
+// Xoshiro256x4: Four interleaved xoshiro256** lanes, the lane #i is the lane #0
+// after i times jump(). The state is stored as structure of arrays, so the four
+// lanes are advanced by one AVX2 step, and the scalar fallback generates the same
+// sequence: lane 0, 1, 2, 3 of the step 0, and then the step 1, and so on.
+//
+// Like the SFMT (SIMD-oriented Fast Mersenne Twister), the numbers are generated
+// in blocks of kBlockSize into an internal buffer, rand() only reads the buffer,
+// and fill() writes the whole steps to the destination directly.
+//
+class JSTD_DLL Xoshiro256x4
+{
+public:
+    typedef std::uint64_t   value_type;
+    typedef std::size_t     size_type;
+    typedef Xoshiro256x4    this_type;
+
+    static const value_type kDefaultSeed = Xoshiro256::kDefaultSeed;
+    static const value_type kRandMax = 0xFFFFFFFFFFFFFFFFull;
+
+    static const size_type kLanes = 4;
+    static const size_type kStateSize = Xoshiro256::kStateSize;
+    static const size_type kBlockSize = 64;
+
+private:
+    // state[word][lane]
+    alignas(32) value_type state[kStateSize][kLanes];
+    alignas(32) value_type block[kBlockSize];
+    size_type              index;
+
+public:
+    explicit Xoshiro256x4(value_type initSeed = kDefaultSeed) {
+        this->init(initSeed);
+    }
+
+    ~Xoshiro256x4() {}
+
+    value_type rand_max() const {
+        return static_cast<value_type>(kRandMax);
+    }
+
+private:
+    void init(value_type initSeed = kDefaultSeed) {
+        Xoshiro256 lane(initSeed);
+        for (size_type i = 0; i < kLanes; i++) {
+            if (i != 0) {
+                lane.jump();
+            }
+            this->set_lane(i, lane);
+        }
+        this->index = kBlockSize;
+    }
+
+    Xoshiro256 get_lane(size_type i) const {
+        value_type lane_state[kStateSize];
+        for (size_type w = 0; w < kStateSize; w++) {
+            lane_state[w] = this->state[w][i];
+        }
+        Xoshiro256 lane;
+        lane.set_state(lane_state);
+        return lane;
+    }
+
+    void set_lane(size_type i, const Xoshiro256 & lane) {
+        const value_type * lane_state = lane.get_state();
+        for (size_type w = 0; w < kStateSize; w++) {
+            this->state[w][i] = lane_state[w];
+        }
+    }
+
+    // Generates the (steps * kLanes) numbers to out[], the out[] needn't be aligned.
+    void generate(value_type * out, size_type steps) {
+#if JSTD_HAVE_XOSHIRO256_AVX2
+        __m256i s0 = _mm256_load_si256((const __m256i *)&this->state[0][0]);
+        __m256i s1 = _mm256_load_si256((const __m256i *)&this->state[1][0]);
+        __m256i s2 = _mm256_load_si256((const __m256i *)&this->state[2][0]);
+        __m256i s3 = _mm256_load_si256((const __m256i *)&this->state[3][0]);
+
+        for (size_type i = 0; i < steps; i++) {
+            // AVX2 has no 64-bit multiply, x * 5 = (x << 2) + x, x * 9 = (x << 3) + x.
+            __m256i r = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+            r = _mm256_or_si256(_mm256_slli_epi64(r, 7), _mm256_srli_epi64(r, 64 - 7));
+            r = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+
+            __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 64 - 45));
+
+            _mm256_storeu_si256((__m256i *)out, r);
+            out += kLanes;
+        }
+
+        _mm256_store_si256((__m256i *)&this->state[0][0], s0);
+        _mm256_store_si256((__m256i *)&this->state[1][0], s1);
+        _mm256_store_si256((__m256i *)&this->state[2][0], s2);
+        _mm256_store_si256((__m256i *)&this->state[3][0], s3);
+#else
+        value_type * s0 = this->state[0];
+        value_type * s1 = this->state[1];
+        value_type * s2 = this->state[2];
+        value_type * s3 = this->state[3];
+
+        for (size_type i = 0; i < steps; i++) {
+            for (size_type j = 0; j < kLanes; j++) {
+                out[j] = Xoshiro256::rotl(s1[j] * 5, 7) * 9;
+                const value_type t = s1[j] << 17;
+                s2[j] ^= s0[j];
+                s3[j] ^= s1[j];
+                s1[j] ^= s2[j];
+                s0[j] ^= s3[j];
+                s2[j] ^= t;
+                s3[j] = Xoshiro256::rotl(s3[j], 45);
+            }
+            out += kLanes;
+        }
+#endif
+    }
+
+    JSTD_NO_INLINE
+    void refill() {
+        this->generate(this->block, kBlockSize / kLanes);
+        this->index = 0;
+    }
+
+public:
+    void srand(value_type initSeed = kDefaultSeed) {
+        this->init(initSeed);
+    }
+
+    value_type rand() {
+        if (unlikely(this->index >= kBlockSize)) {
+            this->refill();
+        }
+        return this->block[this->index++];
+    }
+
+    // Jumps all of the lanes by 2^192 steps, and discards the buffered numbers.
+    void long_jump() {
+        for (size_type i = 0; i < kLanes; i++) {
+            Xoshiro256 lane = this->get_lane(i);
+            lane.long_jump();
+            this->set_lane(i, lane);
+        }
+        this->index = kBlockSize;
+    }
+
+    // The sub-stream #stream_id of this generator, it's the stream_id times long_jump().
+    // The lanes of a sub-stream are 2^128 steps apart, so they never overlap
+    // with the lanes of the other sub-streams.
+    this_type substream(size_type stream_id) const {
+        this_type stream(*this);
+        for (size_type i = 0; i < stream_id; i++) {
+            stream.long_jump();
+        }
+        stream.index = kBlockSize;
+        return stream;
+    }
+
+    // Same as n times rand(), but the whole steps are written to first[] directly.
+    void fill(value_type * first, size_type n) {
+        // Drain the buffered numbers first.
+        size_type buffered = kBlockSize - this->index;
+        if (buffered > n)
+            buffered = n;
+        std::memcpy(first, &this->block[this->index], buffered * sizeof(value_type));
+        this->index += buffered;
+        first += buffered;
+        n -= buffered;
+
+        size_type steps = n / kLanes;
+        if (steps != 0) {
+            this->generate(first, steps);
+            first += steps * kLanes;
+            n -= steps * kLanes;
+        }
+
+        if (n != 0) {
+            this->refill();
+            std::memcpy(first, this->block, n * sizeof(value_type));
+            this->index = n;
+        }
+    }
+
+    std::int32_t nextInt32() {
+        return static_cast<std::int32_t>(this->rand() >> 32);
+    }
+
+    std::uint32_t nextUInt32() {
+        return static_cast<std::uint32_t>(this->rand() >> 32);
+    }
+
+    std::int64_t nextInt64() {
+        return static_cast<std::int64_t>(this->rand());
+    }
+
+    std::uint64_t nextUInt64() {
+        return static_cast<std::uint64_t>(this->rand());
+    }
+
+    std::intptr_t nextInt() {
+        return static_cast<std::intptr_t>(this->rand());
+    }
+
+    std::size_t nextUInt() {
+        return static_cast<std::size_t>(this->rand());
+    }
+};
+
+} // namespace jstd
+
+#endif // JSTD_SYSTEM_XOSHIRO256_H
@@ -0,0 +1,410 @@
+
+#ifndef JSTD_TEST_BENCHMARK_REPORT_H
+#define JSTD_TEST_BENCHMARK_REPORT_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "jstd/basic/stddef.h"
+
+#if defined(JSTD_IS_X86)
+  #if defined(_MSC_VER)
+    #include <intrin.h>     // For __cpuid()
+  #else
+    #include <cpuid.h>      // For __get_cpuid()
+  #endif
+#endif
+
+//
+// The build flags can be passed in by the build system, see bench/CMakeLists.txt.
+//
+#ifndef JTEST_BUILD_FLAGS
+#define JTEST_BUILD_FLAGS   ""
+#endif
+
+#ifndef JTEST_BUILD_TYPE
+#if defined(NDEBUG)
+#define JTEST_BUILD_TYPE    "Release"
+#else
+#define JTEST_BUILD_TYPE    "Debug"
+#endif
+#endif
+
+namespace jtest {
+
+//
+// Simple robust statistics for the repeated runs.
+//
+namespace stats {
+
+static inline
+double median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    std::size_t n = values.size();
+    if ((n & 1) != 0)
+        return values[n / 2];
+    else
+        return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+//
+// The median absolute deviation (MAD), (1.4826 * MAD) is a consistent
+// estimator of the standard deviation for the normal distribution.
+//
+static inline
+double mad(const std::vector<double> & values)
+{
+    if (values.empty())
+        return 0.0;
+    double m = median(values);
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (std::size_t i = 0; i < values.size(); i++) {
+        deviations.push_back(std::fabs(values[i] - m));
+    }
+    return median(deviations);
+}
+
+} // namespace stats
+
+//
+// The environment metadata of a benchmark run.
+//
+struct BenchEnv {
+    static std::string cpu_model() {
+        std::string model;
+#if defined(JSTD_IS_X86)
+        // The processor brand string (CPUID leaf 0x80000002 ~ 0x80000004).
+        unsigned int regs[12] = { 0 };
+  #if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned int>(info[0]) >= 0x80000004u) {
+            for (unsigned int i = 0; i < 3; i++) {
+                __cpuid(info, static_cast<int>(0x80000002u + i));
+                regs[i * 4 + 0] = static_cast<unsigned int>(info[0]);
+                regs[i * 4 + 1] = static_cast<unsigned int>(info[1]);
+                regs[i * 4 + 2] = static_cast<unsigned int>(info[2]);
+                regs[i * 4 + 3] = static_cast<unsigned int>(info[3]);
+            }
+        }
+  #else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) && (eax >= 0x80000004u)) {
+            for (unsigned int i = 0; i < 3; i++) {
+                __get_cpuid(0x80000002u + i, &regs[i * 4 + 0], &regs[i * 4 + 1],
+                                             &regs[i * 4 + 2], &regs[i * 4 + 3]);
+            }
+        }
+  #endif
+        char brand[sizeof(regs) + 1];
+        ::memcpy(brand, regs, sizeof(regs));
+        brand[sizeof(regs)] = '\0';
+        model = trim(brand);
+#endif // JSTD_IS_X86
+
+#if defined(__linux__)
+        if (model.empty()) {
+            FILE * fp = ::fopen("/proc/cpuinfo", "r");
+            if (fp != nullptr) {
+                char line[512];
+                while (::fgets(line, sizeof(line), fp) != nullptr) {
+                    if ((::strncmp(line, "model name", 10) == 0) || (::strncmp(line, "Model", 5) == 0)) {
+                        const char * colon = ::strchr(line, ':');
+                        if (colon != nullptr) {
+                            model = trim(colon + 1);
+                            break;
+                        }
+                    }
+                }
+                ::fclose(fp);
+            }
+        }
+#endif
+        if (model.empty())
+            model = "unknown";
+        return model;
+    }
+
+    static std::string compiler() {
+        char buf[256];
+#if defined(__clang__)
+        snprintf(buf, sizeof(buf), "clang %d.%d.%d", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+        snprintf(buf, sizeof(buf), "gcc %d.%d.%d", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+        snprintf(buf, sizeof(buf), "msvc %d", (int)_MSC_FULL_VER);
+#else
+        snprintf(buf, sizeof(buf), "unknown");
+#endif
+        return std::string(buf);
+    }
+
+    static std::string build_flags() {
+        return std::string(JTEST_BUILD_FLAGS);
+    }
+
+    static std::string build_type() {
+        return std::string(JTEST_BUILD_TYPE);
+    }
+
+    // The instruction sets enabled at compile time.
+    static std::string isa_features() {
+        std::string features;
+#if defined(__SSE2__) || defined(_M_X64)
+        features += "sse2 ";
+#endif
+#if defined(__SSE4_2__)
+        features += "sse4.2 ";
+#endif
+#if defined(__AVX__)
+        features += "avx ";
+#endif
+#if defined(__AVX2__)
+        features += "avx2 ";
+#endif
+#if defined(__AVX512F__)
+        features += "avx512f ";
+#endif
+#if defined(__SHA__)
+        features += "sha ";
+#endif
+#if defined(__BMI2__)
+        features += "bmi2 ";
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        features += "neon ";
+#endif
+        return trim(features.c_str());
+    }
+
+    static std::string os() {
+#if defined(_WIN64)
+        return "windows x64";
+#elif defined(_WIN32)
+        return "windows x86";
+#elif defined(__APPLE__)
+        return "macos";
+#elif defined(__linux__)
+        return "linux";
+#else
+        return "unknown";
+#endif
+    }
+
+    static std::string utc_time() {
+        time_t now = ::time(nullptr);
+        char buf[64];
+        struct tm * utc = ::gmtime(&now);
+        if (utc != nullptr)
+            ::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", utc);
+        else
+            buf[0] = '\0';
+        return std::string(buf);
+    }
+
+    static std::string trim(const char * str) {
+        std::string result(str);
+        std::size_t first = result.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos)
+            return std::string();
+        std::size_t last = result.find_last_not_of(" \t\r\n");
+        return result.substr(first, last - first + 1);
+    }
+};
+
+//
+// Machine-readable benchmark results.
+//
+// Every result is identified by its name (e.g. "blueprint/hashmap/test"), and holds
+// the samples of all repeated runs. The results can be written as JSON or CSV,
+// the CSV is in the long format (one row per sample), so the files of several
+// invocations can be concatenated and compared by bench/bench_compare.
+//
+// writeFromEnv() writes the files named by the environment variables
+// JTEST_JSON_OUT and JTEST_CSV_OUT, if they are set.
+//
+class BenchmarkReport {
+public:
+    typedef std::size_t size_type;
+
+    struct Record {
+        std::string         name;
+        std::string         unit;
+        std::vector<double> samples;
+    };
+
+private:
+    std::string         suite_;
+    std::vector<Record> records_;
+
+public:
+    explicit BenchmarkReport(const std::string & suite = "") : suite_(suite) {}
+    ~BenchmarkReport() {}
+
+    const std::string & suite() const { return this->suite_; }
+    void setSuite(const std::string & suite) { this->suite_ = suite; }
+
+    size_type size() const { return this->records_.size(); }
+    bool empty() const { return this->records_.empty(); }
+
+    const Record & getRecord(size_type index) const { return this->records_[index]; }
+
+    void clear() {
+        this->records_.clear();
+    }
+
+    void addSample(const std::string & name, const std::string & unit, double value) {
+        Record & record = this->findOrAddRecord(name, unit);
+        record.samples.push_back(value);
+    }
+
+    void addSamples(const std::string & name, const std::string & unit,
+                    const double * values, size_type count) {
+        Record & record = this->findOrAddRecord(name, unit);
+        for (size_type i = 0; i < count; i++) {
+            record.samples.push_back(values[i]);
+        }
+    }
+
+    bool writeJson(const std::string & filename) const {
+        FILE * fp = ::fopen(filename.c_str(), "w");
+        if (fp == nullptr)
+            return false;
+
+        ::fprintf(fp, "{\n");
+        ::fprintf(fp, "  \"suite\": \"%s\",\n", escape(this->suite_).c_str());
+        ::fprintf(fp, "  \"env\": {\n");
+        ::fprintf(fp, "    \"cpu\": \"%s\",\n", escape(BenchEnv::cpu_model()).c_str());
+        ::fprintf(fp, "    \"compiler\": \"%s\",\n", escape(BenchEnv::compiler()).c_str());
+        ::fprintf(fp, "    \"build_type\": \"%s\",\n", escape(BenchEnv::build_type()).c_str());
+        ::fprintf(fp, "    \"flags\": \"%s\",\n", escape(BenchEnv::build_flags()).c_str());
+        ::fprintf(fp, "    \"isa\": \"%s\",\n", escape(BenchEnv::isa_features()).c_str());
+        ::fprintf(fp, "    \"os\": \"%s\",\n", escape(BenchEnv::os()).c_str());
+        ::fprintf(fp, "    \"date\": \"%s\"\n", escape(BenchEnv::utc_time()).c_str());
+        ::fprintf(fp, "  },\n");
+        ::fprintf(fp, "  \"results\": [\n");
+        for (size_type i = 0; i < this->records_.size(); i++) {
+            const Record & record = this->records_[i];
+            ::fprintf(fp, "    { \"name\": \"%s\", \"unit\": \"%s\", \"median\": %.6g, \"mad\": %.6g, \"samples\": [",
+                      escape(record.name).c_str(), escape(record.unit).c_str(),
+                      stats::median(record.samples), stats::mad(record.samples));
+            for (size_type j = 0; j < record.samples.size(); j++) {
+                ::fprintf(fp, (j == 0) ? "%.6g" : ", %.6g", record.samples[j]);
+            }
+            ::fprintf(fp, (i + 1 < this->records_.size()) ? "] },\n" : "] }\n");
+        }
+        ::fprintf(fp, "  ]\n");
+        ::fprintf(fp, "}\n");
+        ::fclose(fp);
+        return true;
+    }
+
+    bool writeCsv(const std::string & filename) const {
+        FILE * fp = ::fopen(filename.c_str(), "w");
+        if (fp == nullptr)
+            return false;
+
+        ::fprintf(fp, "# suite: %s\n", this->suite_.c_str());
+        ::fprintf(fp, "# cpu: %s\n", BenchEnv::cpu_model().c_str());
+        ::fprintf(fp, "# compiler: %s\n", BenchEnv::compiler().c_str());
+        ::fprintf(fp, "# build_type: %s\n", BenchEnv::build_type().c_str());
+        ::fprintf(fp, "# flags: %s\n", BenchEnv::build_flags().c_str());
+        ::fprintf(fp, "# isa: %s\n", BenchEnv::isa_features().c_str());
+        ::fprintf(fp, "# os: %s\n", BenchEnv::os().c_str());
+        ::fprintf(fp, "# date: %s\n", BenchEnv::utc_time().c_str());
+        ::fprintf(fp, "suite,name,unit,run,value\n");
+        for (size_type i = 0; i < this->records_.size(); i++) {
+            const Record & record = this->records_[i];
+            for (size_type j = 0; j < record.samples.size(); j++) {
+                ::fprintf(fp, "%s,%s,%s,%u,%.6g\n",
+                          csv_field(this->suite_).c_str(), csv_field(record.name).c_str(),
+                          csv_field(record.unit).c_str(), (unsigned)j, record.samples[j]);
+            }
+        }
+        ::fclose(fp);
+        return true;
+    }
+
+    void writeFromEnv() const {
+        const char * json_out = ::getenv("JTEST_JSON_OUT");
+        if (json_out != nullptr && json_out[0] != '\0') {
+            if (this->writeJson(json_out))
+                printf("JSON results: %s\n", json_out);
+            else
+                printf("Can not write the JSON results: %s\n", json_out);
+        }
+        const char * csv_out = ::getenv("JTEST_CSV_OUT");
+        if (csv_out != nullptr && csv_out[0] != '\0') {
+            if (this->writeCsv(csv_out))
+                printf("CSV results: %s\n", csv_out);
+            else
+                printf("Can not write the CSV results: %s\n", csv_out);
+        }
+    }
+
+private:
+    Record & findOrAddRecord(const std::string & name, const std::string & unit) {
+        for (size_type i = 0; i < this->records_.size(); i++) {
+            if (this->records_[i].name == name)
+                return this->records_[i];
+        }
+        Record record;
+        record.name = name;
+        record.unit = unit;
+        this->records_.push_back(std::move(record));
+        return this->records_.back();
+    }
+
+    static std::string escape(const std::string & str) {
+        std::string result;
+        result.reserve(str.size());
+        for (std::size_t i = 0; i < str.size(); i++) {
+            char ch = str[i];
+            if (ch == '"' || ch == '\\') {
+                result.push_back('\\');
+                result.push_back(ch);
+            } else if (static_cast<unsigned char>(ch) < 0x20) {
+                result.push_back(' ');
+            } else {
+                result.push_back(ch);
+            }
+        }
+        return result;
+    }
+
+    static std::string csv_field(const std::string & str) {
+        if (str.find_first_of(",\"\r\n") == std::string::npos)
+            return str;
+        std::string result = "\"";
+        for (std::size_t i = 0; i < str.size(); i++) {
+            if (str[i] == '"')
+                result.push_back('"');
+            result.push_back(str[i]);
+        }
+        result.push_back('"');
+        return result;
+    }
+};
+
+} // namespace jtest
+
+#endif // JSTD_TEST_BENCHMARK_REPORT_H
@@ -0,0 +1,146 @@
+
+#ifndef JSTD_TEST_COUNTING_ALLOCATOR_H
+#define JSTD_TEST_COUNTING_ALLOCATOR_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>       // For std::allocator<T>
+#include <new>
+#include <type_traits>
+#include <utility>      // For std::forward()
+
+#include "jstd/basic/stddef.h"
+
+namespace jtest {
+
+//
+// The global statistics of jtest::CountingAllocator<T>, in bytes.
+//
+// peak_bytes() is the maximum of current_bytes() since the last reset_peak(),
+// e.g. the moment that the old and new tables both are alive during a rehash.
+//
+class JSTD_DLL AllocCounter {
+public:
+    typedef std::size_t size_type;
+
+private:
+    struct Counters {
+        size_type current_bytes;
+        size_type peak_bytes;
+        size_type total_bytes;
+        size_type alloc_count;
+        size_type free_count;
+    };
+
+    static Counters & counters() noexcept {
+        static Counters s_counters = { 0, 0, 0, 0, 0 };
+        return s_counters;
+    }
+
+public:
+    static size_type current_bytes() noexcept { return counters().current_bytes; }
+    static size_type peak_bytes()    noexcept { return counters().peak_bytes; }
+    static size_type total_bytes()   noexcept { return counters().total_bytes; }
+    static size_type alloc_count()   noexcept { return counters().alloc_count; }
+    static size_type free_count()    noexcept { return counters().free_count; }
+
+    static void on_allocate(size_type bytes) noexcept {
+        Counters & c = counters();
+        c.current_bytes += bytes;
+        c.total_bytes += bytes;
+        c.alloc_count++;
+        if (c.current_bytes > c.peak_bytes)
+            c.peak_bytes = c.current_bytes;
+    }
+
+    static void on_deallocate(size_type bytes) noexcept {
+        Counters & c = counters();
+        c.current_bytes -= bytes;
+        c.free_count++;
+    }
+
+    // Reset the peak to the current bytes, and clear the total statistics.
+    static void reset_peak() noexcept {
+        Counters & c = counters();
+        c.peak_bytes = c.current_bytes;
+        c.total_bytes = 0;
+        c.alloc_count = 0;
+        c.free_count = 0;
+    }
+};
+
+//
+// A stateless allocator that forwards to std::allocator<T> and counts the bytes
+// in AllocCounter, so all the rebound allocators of a container share the counters.
+//
+template <typename T>
+class JSTD_DLL CountingAllocator {
+public:
+    typedef T                   value_type;
+    typedef T *                 pointer;
+    typedef const T *           const_pointer;
+    typedef T &                 reference;
+    typedef const T &           const_reference;
+    typedef std::size_t         size_type;
+    typedef std::ptrdiff_t      difference_type;
+
+    typedef std::true_type      propagate_on_container_move_assignment;
+    typedef std::true_type      is_always_equal;
+
+    template <typename U>
+    struct rebind {
+        typedef CountingAllocator<U> other;
+    };
+
+    CountingAllocator() noexcept {}
+    CountingAllocator(const CountingAllocator &) noexcept {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &) noexcept {}
+    ~CountingAllocator() {}
+
+    pointer allocate(size_type n, const void * hint = nullptr) {
+        (void)hint;
+        pointer ptr = std::allocator<T>().allocate(n);
+        AllocCounter::on_allocate(n * sizeof(T));
+        return ptr;
+    }
+
+    void deallocate(pointer ptr, size_type n) noexcept {
+        if (ptr != nullptr) {
+            AllocCounter::on_deallocate(n * sizeof(T));
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    }
+
+    size_type max_size() const noexcept {
+        return (static_cast<size_type>(-1) / sizeof(T));
+    }
+
+    template <typename U, typename ... Args>
+    void construct(U * ptr, Args && ... args) {
+        ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    void destroy(U * ptr) {
+        ptr->~U();
+    }
+};
+
+template <typename T, typename U>
+inline bool operator == (const CountingAllocator<T> &, const CountingAllocator<U> &) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+inline bool operator != (const CountingAllocator<T> &, const CountingAllocator<U> &) noexcept {
+    return false;
+}
+
+} // namespace jtest
+
+#endif // JSTD_TEST_COUNTING_ALLOCATOR_H
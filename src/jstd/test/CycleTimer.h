@@ -0,0 +1,182 @@
+
+#ifndef JSTD_TEST_CYCLETIMER_H
+#define JSTD_TEST_CYCLETIMER_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdint.h>
+#include <cstdint>
+#include <chrono>
+
+#include "jstd/basic/stddef.h"
+
+#if defined(JSTD_IS_X86)
+  #if defined(_MSC_VER)
+    #include <intrin.h>         // For __rdtsc(), __rdtscp(), _mm_lfence()
+  #else
+    #include <x86intrin.h>      // For __rdtsc(), __rdtscp(), _mm_lfence()
+  #endif
+  #define JSTD_HAVE_RDTSCP      1
+#else
+  #define JSTD_HAVE_RDTSCP      0
+#endif
+
+#ifndef __COMPILER_BARRIER
+#if defined(_MSC_VER) || defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+#include <intrin.h>
+#pragma intrinsic(_ReadWriteBarrier)
+#define __COMPILER_BARRIER()        _ReadWriteBarrier()
+#else
+#define __COMPILER_BARRIER()        __asm__ __volatile__ ("" : : : "memory")
+#endif
+#endif // __COMPILER_BARRIER
+
+namespace jtest {
+
+//
+// A cycle-accurate timer based on the time stamp counter (TSC).
+//
+// start() uses (lfence + rdtsc), stop() uses (rdtscp + lfence), so the code
+// being measured can not be reordered out of the [start, stop] window.
+// The TSC frequency is calibrated once against std::chrono::steady_clock.
+//
+// On the non-x86 platforms, the "cycles" is nanoseconds of steady_clock,
+// and the frequency is always 1.0 GHz.
+//
+class JSTD_DLL CycleTimer {
+public:
+    typedef std::uint64_t   cycle_t;
+    typedef double          time_float_t;
+
+private:
+    cycle_t start_cycles_;
+    cycle_t stop_cycles_;
+
+public:
+    CycleTimer() : start_cycles_(0), stop_cycles_(0) {}
+    ~CycleTimer() {}
+
+    static bool is_tsc_supported() noexcept {
+        return (JSTD_HAVE_RDTSCP != 0);
+    }
+
+    static inline cycle_t begin_cycles() noexcept {
+#if JSTD_HAVE_RDTSCP
+        _mm_lfence();
+        cycle_t cycles = static_cast<cycle_t>(__rdtsc());
+        __COMPILER_BARRIER();
+        return cycles;
+#else
+        return steady_nanosecs();
+#endif
+    }
+
+    static inline cycle_t end_cycles() noexcept {
+#if JSTD_HAVE_RDTSCP
+        unsigned int aux;
+        __COMPILER_BARRIER();
+        cycle_t cycles = static_cast<cycle_t>(__rdtscp(&aux));
+        _mm_lfence();
+        return cycles;
+#else
+        return steady_nanosecs();
+#endif
+    }
+
+    void start() noexcept {
+        this->start_cycles_ = begin_cycles();
+    }
+
+    void stop() noexcept {
+        this->stop_cycles_ = end_cycles();
+    }
+
+    cycle_t getElapsedCycles() const noexcept {
+        return (this->stop_cycles_ - this->start_cycles_);
+    }
+
+    time_float_t getElapsedNanosec() const {
+        return cycles_to_nanosec(this->getElapsedCycles());
+    }
+
+    time_float_t getElapsedMicrosec() const {
+        return (this->getElapsedNanosec() / 1000.0);
+    }
+
+    time_float_t getElapsedMillisec() const {
+        return (this->getElapsedNanosec() / 1000000.0);
+    }
+
+    //
+    // The calibrated frequency of cycle counter, Unit: GHz (cycles per nanosecond).
+    //
+    static time_float_t frequency() {
+        static const time_float_t s_frequency = calibrate();
+        return s_frequency;
+    }
+
+    static time_float_t cycles_to_nanosec(cycle_t cycles) {
+        return (static_cast<time_float_t>(cycles) / frequency());
+    }
+
+    static time_float_t cycles_to_nanosec(time_float_t cycles) {
+        return (cycles / frequency());
+    }
+
+    //
+    // Measure the cycle counter against steady_clock, repeat a few rounds
+    // and take the median result to filter out the preemption noise.
+    //
+    static time_float_t calibrate(int rounds = 5, int round_millisecs = 20) {
+#if JSTD_HAVE_RDTSCP
+        static constexpr int kMaxRounds = 15;
+        time_float_t samples[kMaxRounds];
+        if (rounds < 1) rounds = 1;
+        if (rounds > kMaxRounds) rounds = kMaxRounds;
+
+        const std::int64_t round_nanosecs = static_cast<std::int64_t>(round_millisecs) * 1000000;
+        for (int i = 0; i < rounds; i++) {
+            cycle_t start_ns = steady_nanosecs();
+            cycle_t start_tsc = begin_cycles();
+            cycle_t now_ns;
+            do {
+                now_ns = steady_nanosecs();
+            } while (static_cast<std::int64_t>(now_ns - start_ns) < round_nanosecs);
+            cycle_t stop_tsc = end_cycles();
+            samples[i] = static_cast<time_float_t>(stop_tsc - start_tsc) /
+                         static_cast<time_float_t>(now_ns - start_ns);
+        }
+
+        // Insertion sort, the rounds is very small.
+        for (int i = 1; i < rounds; i++) {
+            time_float_t value = samples[i];
+            int j = i - 1;
+            while (j >= 0 && samples[j] > value) {
+                samples[j + 1] = samples[j];
+                j--;
+            }
+            samples[j + 1] = value;
+        }
+
+        time_float_t freq = samples[rounds / 2];
+        return ((freq > 0.0) ? freq : 1.0);
+#else
+        (void)rounds;
+        (void)round_millisecs;
+        return 1.0;
+#endif
+    }
+
+private:
+    static inline cycle_t steady_nanosecs() noexcept {
+        using namespace std::chrono;
+        return static_cast<cycle_t>(
+            duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+} // namespace jtest
+
+#endif // JSTD_TEST_CYCLETIMER_H
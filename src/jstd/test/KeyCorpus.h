@@ -0,0 +1,352 @@
+
+#ifndef JSTD_TEST_KEY_CORPUS_H
+#define JSTD_TEST_KEY_CORPUS_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>   // For mmap(), munmap(), madvise()
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <thread>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+#include "jstd/basic/stddef.h"
+#include "jstd/support/BitUtils.h"
+#include "jstd/string/string_view.h"
+#include "jstd/string/string_view_array.h"
+
+namespace jtest {
+
+//
+// A read-only file mapping, the whole file is mapped into the address space.
+//
+class MappedFile {
+public:
+    typedef std::size_t size_type;
+
+private:
+    const char * data_;
+    size_type    size_;
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    HANDLE       file_;
+    HANDLE       mapping_;
+#endif
+
+public:
+    MappedFile() : data_(nullptr), size_(0)
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+                 , file_(INVALID_HANDLE_VALUE), mapping_(NULL)
+#endif
+    {
+    }
+
+    MappedFile(const MappedFile & src) = delete;
+    MappedFile & operator = (const MappedFile & rhs) = delete;
+
+    ~MappedFile() {
+        this->close();
+    }
+
+    const char * data() const { return this->data_; }
+    size_type size() const { return this->size_; }
+
+    bool is_open() const { return (this->data_ != nullptr); }
+
+#if defined(_WIN32) || defined(WIN32) || defined(OS_WINDOWS) || defined(_WINDOWS_)
+    bool open(const std::string & filename) {
+        this->close();
+
+        this->file_ = ::CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (this->file_ == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER file_size;
+        if (!::GetFileSizeEx(this->file_, &file_size) || file_size.QuadPart == 0) {
+            this->close();
+            return false;
+        }
+
+        this->mapping_ = ::CreateFileMappingA(this->file_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (this->mapping_ == NULL) {
+            this->close();
+            return false;
+        }
+
+        void * data = ::MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0);
+        if (data == NULL) {
+            this->close();
+            return false;
+        }
+
+        this->data_ = static_cast<const char *>(data);
+        this->size_ = static_cast<size_type>(file_size.QuadPart);
+        return true;
+    }
+
+    void close() {
+        if (this->data_ != nullptr) {
+            ::UnmapViewOfFile(this->data_);
+            this->data_ = nullptr;
+        }
+        if (this->mapping_ != NULL) {
+            ::CloseHandle(this->mapping_);
+            this->mapping_ = NULL;
+        }
+        if (this->file_ != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(this->file_);
+            this->file_ = INVALID_HANDLE_VALUE;
+        }
+        this->size_ = 0;
+    }
+#else
+    bool open(const std::string & filename) {
+        this->close();
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        size_type size = static_cast<size_type>(st.st_size);
+        void * data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps the file alive, the descriptor is no longer needed.
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return false;
+
+        ::madvise(data, size, MADV_SEQUENTIAL);
+
+        this->data_ = static_cast<const char *>(data);
+        this->size_ = size;
+        return true;
+    }
+
+    void close() {
+        if (this->data_ != nullptr) {
+            ::munmap(const_cast<char *>(this->data_), this->size_);
+            this->data_ = nullptr;
+        }
+        this->size_ = 0;
+    }
+#endif // _WIN32
+};
+
+//
+// KeyCorpus: The keys of a text file, one key per line.
+//
+// The file is mapped by MappedFile, and the keys are jstd::string_view pointing directly
+// into the mapping, so loading a corpus doesn't allocate or copy the key strings.
+// The keys are valid as long as the KeyCorpus is alive.
+//
+// The file is split into one range per thread, each thread finds the '\n' in its range
+// with SSE2/AVX2 and makes the keys of the lines that end in its range. The trailing '\r'
+// is removed and the empty lines are skipped, the order of the keys is the file order.
+//
+class KeyCorpus {
+public:
+    typedef jstd::string_view                       key_type;
+    typedef std::vector<key_type>                   vector_type;
+    typedef typename vector_type::size_type         size_type;
+    typedef typename vector_type::const_iterator    const_iterator;
+
+private:
+    MappedFile  file_;
+    vector_type keys_;
+    std::string filename_;
+
+public:
+    KeyCorpus() {}
+    ~KeyCorpus() {}
+
+    KeyCorpus(const KeyCorpus & src) = delete;
+    KeyCorpus & operator = (const KeyCorpus & rhs) = delete;
+
+    bool is_open() const { return this->file_.is_open(); }
+    bool empty() const { return this->keys_.empty(); }
+    size_type size() const { return this->keys_.size(); }
+
+    // The bytes of the mapped file.
+    size_type file_size() const { return this->file_.size(); }
+    const std::string & filename() const { return this->filename_; }
+
+    const vector_type & keys() const { return this->keys_; }
+
+    const_iterator begin() const { return this->keys_.begin(); }
+    const_iterator end() const { return this->keys_.end(); }
+
+    const key_type & operator [] (size_type pos) const {
+        return this->keys_[pos];
+    }
+
+    void close() {
+        this->keys_.clear();
+        this->keys_.shrink_to_fit();
+        this->file_.close();
+        this->filename_.clear();
+    }
+
+    // num_threads = 0 means std::thread::hardware_concurrency().
+    bool load(const std::string & filename, size_type num_threads = 0) {
+        this->close();
+        if (!this->file_.open(filename))
+            return false;
+        this->filename_ = filename;
+        split_lines(this->file_.data(), this->file_.size(), this->keys_, num_threads);
+        return true;
+    }
+
+    //
+    // Appends the pairs of (key, values[i]) to the string_view_array, the first of the pairs
+    // point into the mapped file. The values must outlive the array, like the keys.
+    //
+    template <typename Second, typename ValueList>
+    void to_string_view_array(jstd::string_view_array<jstd::string_view, Second> & array,
+                              const ValueList & values) const {
+        typedef typename jstd::string_view_array<jstd::string_view, Second>::element_type element_type;
+
+        size_type count = (values.size() < this->keys_.size()) ? values.size() : this->keys_.size();
+        array.reserve(array.size() + count);
+        for (size_type i = 0; i < count; i++) {
+            array.push_back(new element_type(this->keys_[i], values[i]));
+        }
+    }
+
+    static void split_lines(const char * data, size_type size, vector_type & keys,
+                            size_type num_threads = 0) {
+        static const size_type kMinBytesPerThread = 1024 * 1024;
+
+        keys.clear();
+        if (data == nullptr || size == 0)
+            return;
+
+        if (num_threads == 0)
+            num_threads = static_cast<size_type>(std::thread::hardware_concurrency());
+        size_type max_threads = (size + kMinBytesPerThread - 1) / kMinBytesPerThread;
+        if (num_threads > max_threads)
+            num_threads = max_threads;
+        if (num_threads == 0)
+            num_threads = 1;
+
+        if (num_threads == 1) {
+            split_range(data, size, 0, size, keys);
+            return;
+        }
+
+        std::vector<vector_type> thread_keys(num_threads);
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        size_type range_size = size / num_threads;
+        for (size_type t = 0; t < num_threads; t++) {
+            size_type first = t * range_size;
+            size_type last = (t == num_threads - 1) ? size : (first + range_size);
+            threads.emplace_back(split_range, data, size, first, last, std::ref(thread_keys[t]));
+        }
+
+        size_type total = 0;
+        for (size_type t = 0; t < num_threads; t++) {
+            threads[t].join();
+            total += thread_keys[t].size();
+        }
+
+        keys.reserve(total);
+        for (size_type t = 0; t < num_threads; t++) {
+            keys.insert(keys.end(), thread_keys[t].begin(), thread_keys[t].end());
+        }
+    }
+
+private:
+    static void add_key(const char * data, size_type line_first, size_type line_last, vector_type & keys) {
+        if (line_last > line_first && data[line_last - 1] == '\r')
+            line_last--;
+        if (line_last > line_first)
+            keys.push_back(key_type(data + line_first, line_last - line_first));
+    }
+
+    //
+    // Makes the keys of the lines that end in [first, last), the last line of the file
+    // without a '\n' belongs to the range that contains the end of the file.
+    //
+    static void split_range(const char * data, size_type size,
+                            size_type first, size_type last, vector_type & keys) {
+        // The line that ends in this range may start in the previous range.
+        size_type line_first = first;
+        while (line_first > 0 && data[line_first - 1] != '\n') {
+            line_first--;
+        }
+
+        keys.reserve(keys.size() + (last - first) / 8);
+
+        size_type pos = first;
+#if defined(__AVX2__)
+        const __m256i newline32 = _mm256_set1_epi8('\n');
+        for (; pos + 32 <= last; pos += 32) {
+            __m256i chars = _mm256_loadu_si256((const __m256i *)(data + pos));
+            std::uint32_t mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, newline32)));
+            while (mask != 0) {
+                size_type line_last = pos + jstd::BitUtils::bsf32(mask);
+                add_key(data, line_first, line_last, keys);
+                line_first = line_last + 1;
+                mask &= mask - 1;
+            }
+        }
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+        const __m128i newline16 = _mm_set1_epi8('\n');
+        for (; pos + 16 <= last; pos += 16) {
+            __m128i chars = _mm_loadu_si128((const __m128i *)(data + pos));
+            std::uint32_t mask = static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chars, newline16)));
+            while (mask != 0) {
+                size_type line_last = pos + jstd::BitUtils::bsf32(mask);
+                add_key(data, line_first, line_last, keys);
+                line_first = line_last + 1;
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; pos < last; pos++) {
+            if (data[pos] == '\n') {
+                add_key(data, line_first, pos, keys);
+                line_first = pos + 1;
+            }
+        }
+
+        if (last == size && line_first < size) {
+            add_key(data, line_first, size, keys);
+        }
+    }
+};
+
+} // namespace jtest
+
+#endif // JSTD_TEST_KEY_CORPUS_H
@@ -0,0 +1,225 @@
+
+#ifndef JSTD_TEST_LATENCY_HISTOGRAM_H
+#define JSTD_TEST_LATENCY_HISTOGRAM_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/support/BitUtils.h"
+#include "jstd/test/CycleTimer.h"
+
+namespace jtest {
+
+//
+// A log-linear (HDR-style) latency histogram.
+//
+// The values below 2^SubBucketBits are recorded exactly, every power of 2 range
+// above that is split into 2^SubBucketBits linear sub-buckets, so the relative
+// error of any recorded value is less than 1 / 2^SubBucketBits (3.125% by default).
+// The whole uint64_t range is covered, recording a value is O(1) and allocation free.
+//
+template <std::size_t SubBucketBits = 5>
+class JSTD_DLL BasicLatencyHistogram {
+public:
+    typedef std::uint64_t                       value_type;
+    typedef std::uint64_t                       count_type;
+    typedef std::size_t                         size_type;
+    typedef BasicLatencyHistogram<SubBucketBits> this_type;
+
+    static constexpr size_type kSubBucketBits  = SubBucketBits;
+    static constexpr size_type kSubBucketCount = size_type(1) << kSubBucketBits;
+    static constexpr size_type kSubBucketMask  = kSubBucketCount - 1;
+    static constexpr size_type kBucketCount    = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+    static_assert((SubBucketBits >= 1 && SubBucketBits <= 16),
+                  "jtest::BasicLatencyHistogram<N>: SubBucketBits must be in range [1, 16].");
+
+private:
+    std::vector<count_type> counts_;
+    count_type  total_count_;
+    value_type  min_value_;
+    value_type  max_value_;
+    double      total_value_;
+
+public:
+    BasicLatencyHistogram() : counts_(kBucketCount, 0) {
+        this->reset();
+    }
+    BasicLatencyHistogram(const this_type & src) = default;
+    BasicLatencyHistogram(this_type && src) = default;
+    ~BasicLatencyHistogram() {}
+
+    this_type & operator = (const this_type & rhs) = default;
+    this_type & operator = (this_type && rhs) = default;
+
+    void reset() {
+        std::fill(this->counts_.begin(), this->counts_.end(), 0);
+        this->total_count_ = 0;
+        this->min_value_ = ~value_type(0);
+        this->max_value_ = 0;
+        this->total_value_ = 0.0;
+    }
+
+    bool empty() const noexcept { return (this->total_count_ == 0); }
+    count_type count() const noexcept { return this->total_count_; }
+
+    value_type min_value() const noexcept {
+        return (this->total_count_ != 0) ? this->min_value_ : 0;
+    }
+
+    value_type max_value() const noexcept {
+        return this->max_value_;
+    }
+
+    double mean() const noexcept {
+        return (this->total_count_ != 0) ? (this->total_value_ / this->total_count_) : 0.0;
+    }
+
+    static size_type index_of(value_type value) noexcept {
+        if (value < kSubBucketCount) {
+            return static_cast<size_type>(value);
+        } else {
+            size_type shift = static_cast<size_type>(jstd::BitUtils::bsr64(value)) - kSubBucketBits;
+            return (((shift + 1) << kSubBucketBits) | static_cast<size_type>((value >> shift) & kSubBucketMask));
+        }
+    }
+
+    // The lowest value that falls into the bucket.
+    static value_type lowest_value_of(size_type index) noexcept {
+        if (index < kSubBucketCount) {
+            return static_cast<value_type>(index);
+        } else {
+            size_type shift = (index >> kSubBucketBits) - 1;
+            return (static_cast<value_type>(kSubBucketCount | (index & kSubBucketMask)) << shift);
+        }
+    }
+
+    // The highest value that falls into the bucket.
+    static value_type highest_value_of(size_type index) noexcept {
+        if (index < kSubBucketCount) {
+            return static_cast<value_type>(index);
+        } else {
+            size_type shift = (index >> kSubBucketBits) - 1;
+            return (lowest_value_of(index) + ((value_type(1) << shift) - 1));
+        }
+    }
+
+    JSTD_FORCED_INLINE
+    void record(value_type value) noexcept {
+        this->record_n(value, 1);
+    }
+
+    JSTD_FORCED_INLINE
+    void record_n(value_type value, count_type count) noexcept {
+        size_type index = this_type::index_of(value);
+        assert(index < kBucketCount);
+        this->counts_[index] += count;
+        this->total_count_ += count;
+        this->total_value_ += static_cast<double>(value) * static_cast<double>(count);
+        if (value < this->min_value_)
+            this->min_value_ = value;
+        if (value > this->max_value_)
+            this->max_value_ = value;
+    }
+
+    void merge(const this_type & other) {
+        for (size_type i = 0; i < kBucketCount; i++) {
+            this->counts_[i] += other.counts_[i];
+        }
+        this->total_count_ += other.total_count_;
+        this->total_value_ += other.total_value_;
+        if (other.total_count_ != 0) {
+            if (other.min_value_ < this->min_value_)
+                this->min_value_ = other.min_value_;
+            if (other.max_value_ > this->max_value_)
+                this->max_value_ = other.max_value_;
+        }
+    }
+
+    //
+    // Returns the value at the given percentile (0.0 ~ 100.0),
+    // as the highest equivalent value of the bucket, clamped to [min, max].
+    //
+    value_type percentile(double percent) const noexcept {
+        if (this->total_count_ == 0)
+            return 0;
+        if (percent <= 0.0)
+            return this->min_value();
+        if (percent >= 100.0)
+            return this->max_value();
+
+        count_type target = static_cast<count_type>(percent / 100.0 * static_cast<double>(this->total_count_) + 0.5);
+        if (target == 0)
+            target = 1;
+
+        count_type accumulated = 0;
+        for (size_type i = 0; i < kBucketCount; i++) {
+            accumulated += this->counts_[i];
+            if (accumulated >= target) {
+                value_type value = this_type::highest_value_of(i);
+                if (value > this->max_value_)
+                    value = this->max_value_;
+                if (value < this->min_value_)
+                    value = this->min_value_;
+                return value;
+            }
+        }
+        return this->max_value();
+    }
+};
+
+typedef BasicLatencyHistogram<5> LatencyHistogram;
+
+//
+// Print "p50 / p99 / p99.9 / max" of a histogram that records the cycles per op.
+//
+template <std::size_t SubBucketBits>
+static inline
+void print_latency_percentiles(const char * title, const BasicLatencyHistogram<SubBucketBits> & histogram,
+                               bool is_cycles = true)
+{
+    typedef BasicLatencyHistogram<SubBucketBits> histogram_type;
+    if (histogram.empty()) {
+        printf("%-32s  (no samples)\n", (title != nullptr) ? title : "");
+        return;
+    }
+
+    typename histogram_type::value_type p50  = histogram.percentile(50.0);
+    typename histogram_type::value_type p99  = histogram.percentile(99.0);
+    typename histogram_type::value_type p999 = histogram.percentile(99.9);
+    typename histogram_type::value_type vmax = histogram.max_value();
+
+    if (is_cycles) {
+        printf("%-32s  p50 = %7.1f ns, p99 = %7.1f ns, p99.9 = %8.1f ns, max = %10.1f ns  (%llu samples)\n",
+               (title != nullptr) ? title : "",
+               CycleTimer::cycles_to_nanosec(p50),
+               CycleTimer::cycles_to_nanosec(p99),
+               CycleTimer::cycles_to_nanosec(p999),
+               CycleTimer::cycles_to_nanosec(vmax),
+               static_cast<unsigned long long>(histogram.count()));
+    } else {
+        printf("%-32s  p50 = %7llu, p99 = %7llu, p99.9 = %8llu, max = %10llu  (%llu samples)\n",
+               (title != nullptr) ? title : "",
+               static_cast<unsigned long long>(p50),
+               static_cast<unsigned long long>(p99),
+               static_cast<unsigned long long>(p999),
+               static_cast<unsigned long long>(vmax),
+               static_cast<unsigned long long>(histogram.count()));
+    }
+}
+
+} // namespace jtest
+
+#endif // JSTD_TEST_LATENCY_HISTOGRAM_H
@@ -0,0 +1,486 @@
+
+#ifndef JSTD_TEST_OP_TRACE_H
+#define JSTD_TEST_OP_TRACE_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <unordered_map>
+
+#include "jstd/basic/stddef.h"
+#include "jstd/string/string_view.h"
+#include "jstd/test/KeyCorpus.h"    // For jtest::MappedFile
+
+//
+// The operation trace of a hash map, see bench/trace_replay.
+//
+// File format (little-endian):
+//
+//   header:  "JOT1", u32 version, u32 key_format, u32 flags, u64 record_count
+//   record:  u8 op [| key ] [| value_size ]
+//
+//   op:          bits 0-1 = OpTrace::kFind, kInsert, kAssign, kErase,
+//                bit 2 = a value_size follows the key.
+//   key:         kKeyUInt64: varint(key),
+//                kKeyBytes:  varint(length) + the bytes of the key.
+//   value_size:  varint, the bytes of the value (e.g. std::string::size()).
+//
+// The varint is the LEB128 (7 bits per byte), so a small key id takes 1 ~ 3 bytes.
+//
+namespace jtest {
+
+struct OpTrace {
+    enum op_type {
+        kFind,
+        kInsert,    // Insert if the key is not exists, like emplace().
+        kAssign,    // Insert or overwrite, like insert_or_assign().
+        kErase,
+        kOpTypeCount
+    };
+
+    enum key_format {
+        kKeyUInt64,
+        kKeyBytes
+    };
+
+    static const std::uint32_t kVersion = 1;
+    static const std::uint32_t kFlagValueSize = 0x01u;
+
+    static const std::uint8_t kOpMask = 0x03u;
+    static const std::uint8_t kOpHasValueSize = 0x04u;
+
+    static const std::uint32_t kNoValueSize = 0xFFFFFFFFu;
+
+    static const std::size_t kHeaderSize = 24;
+
+    static const char * op_name(std::size_t op) {
+        switch (op) {
+            case kFind:   return "find";
+            case kInsert: return "insert";
+            case kAssign: return "assign";
+            case kErase:  return "erase";
+            default:      return "unknown";
+        }
+    }
+
+    static void write_u32(char * dest, std::uint32_t value) {
+        for (std::size_t i = 0; i < 4; i++) {
+            dest[i] = static_cast<char>((value >> (i * 8)) & 0xFFu);
+        }
+    }
+
+    static void write_u64(char * dest, std::uint64_t value) {
+        for (std::size_t i = 0; i < 8; i++) {
+            dest[i] = static_cast<char>((value >> (i * 8)) & 0xFFu);
+        }
+    }
+
+    static std::uint32_t read_u32(const char * src) {
+        std::uint32_t value = 0;
+        for (std::size_t i = 0; i < 4; i++) {
+            value |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(src[i])) << (i * 8);
+        }
+        return value;
+    }
+
+    static std::uint64_t read_u64(const char * src) {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(src[i])) << (i * 8);
+        }
+        return value;
+    }
+};
+
+//
+// Streams the operations to a trace file, the records are encoded into a 64 KB buffer,
+// so a record costs a few stores, and a fwrite() per 64 KB.
+//
+class OpTraceWriter {
+public:
+    typedef std::size_t size_type;
+
+    static const size_type kBufferSize = 64 * 1024;
+    // The max size of a record without the key bytes: op + 2 varints.
+    static const size_type kMaxRecordSize = 1 + 10 + 10;
+
+private:
+    FILE *              fp_;
+    std::vector<char>   buffer_;
+    size_type           pos_;
+    std::uint64_t       record_count_;
+    std::uint32_t       key_format_;
+    std::uint32_t       flags_;
+
+public:
+    OpTraceWriter() : fp_(nullptr), buffer_(kBufferSize), pos_(0),
+                      record_count_(0), key_format_(OpTrace::kKeyUInt64), flags_(0) {
+    }
+
+    OpTraceWriter(const OpTraceWriter & src) = delete;
+    OpTraceWriter & operator = (const OpTraceWriter & rhs) = delete;
+
+    ~OpTraceWriter() {
+        this->close();
+    }
+
+    bool is_open() const { return (this->fp_ != nullptr); }
+    std::uint64_t record_count() const { return this->record_count_; }
+    std::uint32_t key_format() const { return this->key_format_; }
+
+    bool open(const std::string & filename, std::uint32_t key_format) {
+        this->close();
+        this->fp_ = ::fopen(filename.c_str(), "wb");
+        if (this->fp_ == nullptr)
+            return false;
+        this->key_format_ = key_format;
+        this->flags_ = 0;
+        this->record_count_ = 0;
+        this->pos_ = 0;
+
+        // The record count and the flags are rewritten by close().
+        char header[OpTrace::kHeaderSize];
+        this->make_header(header);
+        ::fwrite(header, 1, sizeof(header), this->fp_);
+        return true;
+    }
+
+    void close() {
+        if (this->fp_ != nullptr) {
+            this->flush();
+            char header[OpTrace::kHeaderSize];
+            this->make_header(header);
+            ::fseek(this->fp_, 0, SEEK_SET);
+            ::fwrite(header, 1, sizeof(header), this->fp_);
+            ::fclose(this->fp_);
+            this->fp_ = nullptr;
+        }
+    }
+
+    void flush() {
+        if (this->fp_ != nullptr && this->pos_ != 0) {
+            ::fwrite(this->buffer_.data(), 1, this->pos_, this->fp_);
+            this->pos_ = 0;
+        }
+    }
+
+    JSTD_FORCED_INLINE
+    void write(std::uint32_t op, std::uint64_t key, std::uint32_t value_size = OpTrace::kNoValueSize) {
+        assert(this->key_format_ == OpTrace::kKeyUInt64);
+        if (unlikely(this->pos_ + kMaxRecordSize > kBufferSize))
+            this->flush();
+        this->put_op(op, value_size);
+        this->put_varint(key);
+        this->put_value_size(value_size);
+        this->record_count_++;
+    }
+
+    void write(std::uint32_t op, const char * key, size_type length,
+               std::uint32_t value_size = OpTrace::kNoValueSize) {
+        assert(this->key_format_ == OpTrace::kKeyBytes);
+        if (unlikely(this->pos_ + kMaxRecordSize + length > kBufferSize))
+            this->flush();
+        this->put_op(op, value_size);
+        this->put_varint(static_cast<std::uint64_t>(length));
+        if (likely(this->pos_ + length <= kBufferSize)) {
+            ::memcpy(&this->buffer_[this->pos_], key, length);
+            this->pos_ += length;
+        } else {
+            // A huge key, write it directly.
+            this->flush();
+            ::fwrite(key, 1, length, this->fp_);
+        }
+        this->put_value_size(value_size);
+        this->record_count_++;
+    }
+
+private:
+    void make_header(char * header) const {
+        ::memcpy(header, "JOT1", 4);
+        OpTrace::write_u32(header + 4, OpTrace::kVersion);
+        OpTrace::write_u32(header + 8, this->key_format_);
+        OpTrace::write_u32(header + 12, this->flags_);
+        OpTrace::write_u64(header + 16, this->record_count_);
+    }
+
+    JSTD_FORCED_INLINE
+    void put_op(std::uint32_t op, std::uint32_t value_size) {
+        std::uint8_t code = static_cast<std::uint8_t>(op & OpTrace::kOpMask);
+        if (value_size != OpTrace::kNoValueSize)
+            code |= OpTrace::kOpHasValueSize;
+        this->buffer_[this->pos_++] = static_cast<char>(code);
+    }
+
+    JSTD_FORCED_INLINE
+    void put_varint(std::uint64_t value) {
+        while (value >= 0x80u) {
+            this->buffer_[this->pos_++] = static_cast<char>((value & 0x7Fu) | 0x80u);
+            value >>= 7;
+        }
+        this->buffer_[this->pos_++] = static_cast<char>(value);
+    }
+
+    JSTD_FORCED_INLINE
+    void put_value_size(std::uint32_t value_size) {
+        if (value_size != OpTrace::kNoValueSize) {
+            this->flags_ |= OpTrace::kFlagValueSize;
+            this->put_varint(value_size);
+        }
+    }
+};
+
+//
+// A decoded trace. The keys of a kKeyBytes trace are interned, record.key is the key id,
+// and key_table()[key_id] points into the mapped trace file.
+//
+class OpTraceReader {
+public:
+    typedef std::size_t size_type;
+
+    struct record_type {
+        std::uint64_t key;
+        std::uint32_t value_size;
+        std::uint32_t op;
+    };
+
+private:
+    MappedFile                      file_;
+    std::vector<record_type>        records_;
+    std::vector<jstd::string_view>  key_table_;
+    std::uint32_t                   key_format_;
+    std::uint32_t                   flags_;
+
+public:
+    OpTraceReader() : key_format_(OpTrace::kKeyUInt64), flags_(0) {}
+    ~OpTraceReader() {}
+
+    OpTraceReader(const OpTraceReader & src) = delete;
+    OpTraceReader & operator = (const OpTraceReader & rhs) = delete;
+
+    const std::vector<record_type> & records() const { return this->records_; }
+    const std::vector<jstd::string_view> & key_table() const { return this->key_table_; }
+
+    size_type size() const { return this->records_.size(); }
+    size_type file_size() const { return this->file_.size(); }
+
+    std::uint32_t key_format() const { return this->key_format_; }
+    bool has_value_size() const { return ((this->flags_ & OpTrace::kFlagValueSize) != 0); }
+
+    bool load(const std::string & filename) {
+        this->records_.clear();
+        this->key_table_.clear();
+        if (!this->file_.open(filename))
+            return false;
+
+        const char * data = this->file_.data();
+        size_type size = this->file_.size();
+        if (size < OpTrace::kHeaderSize || ::memcmp(data, "JOT1", 4) != 0 ||
+            OpTrace::read_u32(data + 4) != OpTrace::kVersion) {
+            this->file_.close();
+            return false;
+        }
+
+        this->key_format_ = OpTrace::read_u32(data + 8);
+        this->flags_ = OpTrace::read_u32(data + 12);
+        std::uint64_t record_count = OpTrace::read_u64(data + 16);
+        this->records_.reserve(static_cast<size_type>(record_count));
+
+        std::unordered_map<std::string_view, std::uint64_t> key_ids;
+
+        size_type pos = OpTrace::kHeaderSize;
+        while (pos < size) {
+            record_type record;
+            std::uint8_t code = static_cast<std::uint8_t>(data[pos++]);
+            record.op = code & OpTrace::kOpMask;
+            std::uint64_t key;
+            if (!get_varint(data, size, pos, key))
+                return this->fail();
+            if (this->key_format_ == OpTrace::kKeyBytes) {
+                if (key > size - pos)
+                    return this->fail();
+                std::string_view key_view(data + pos, static_cast<size_type>(key));
+                pos += static_cast<size_type>(key);
+                auto iter = key_ids.find(key_view);
+                if (iter != key_ids.end()) {
+                    record.key = iter->second;
+                } else {
+                    record.key = static_cast<std::uint64_t>(this->key_table_.size());
+                    key_ids.emplace(key_view, record.key);
+                    this->key_table_.push_back(jstd::string_view(key_view.data(), key_view.size()));
+                }
+            } else {
+                record.key = key;
+            }
+            if ((code & OpTrace::kOpHasValueSize) != 0) {
+                std::uint64_t value_size;
+                if (!get_varint(data, size, pos, value_size))
+                    return this->fail();
+                record.value_size = static_cast<std::uint32_t>(value_size);
+            } else {
+                record.value_size = OpTrace::kNoValueSize;
+            }
+            this->records_.push_back(record);
+        }
+        return true;
+    }
+
+private:
+    bool fail() {
+        this->records_.clear();
+        this->key_table_.clear();
+        this->file_.close();
+        return false;
+    }
+
+    static bool get_varint(const char * data, size_type size, size_type & pos, std::uint64_t & value) {
+        value = 0;
+        for (std::uint32_t shift = 0; shift < 64; shift += 7) {
+            if (pos >= size)
+                return false;
+            std::uint8_t byte = static_cast<std::uint8_t>(data[pos++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0)
+                return true;
+        }
+        return false;
+    }
+};
+
+//
+// How the keys and the values are written to the trace.
+//
+template <typename Key, typename Enable = void>
+struct OpTraceKey {
+    // The integer keys, and the other trivial keys no larger than 8 bytes.
+    static const std::uint32_t kFormat = OpTrace::kKeyUInt64;
+
+    static void write(OpTraceWriter & writer, std::uint32_t op, const Key & key, std::uint32_t value_size) {
+        static_assert((sizeof(Key) <= sizeof(std::uint64_t) && std::is_trivially_copyable<Key>::value),
+                      "jtest::OpTraceKey<Key>: the Key is not supported.");
+        std::uint64_t key64 = 0;
+        ::memcpy(&key64, &key, sizeof(Key));
+        writer.write(op, key64, value_size);
+    }
+};
+
+template <typename Key>
+struct OpTraceKey<Key, typename std::enable_if<std::is_same<Key, std::string>::value ||
+                                               std::is_same<Key, jstd::string_view>::value>::type> {
+    static const std::uint32_t kFormat = OpTrace::kKeyBytes;
+
+    static void write(OpTraceWriter & writer, std::uint32_t op, const Key & key, std::uint32_t value_size) {
+        writer.write(op, key.data(), key.size(), value_size);
+    }
+};
+
+// The fixed size values don't write the value size.
+template <typename Value>
+static inline
+std::uint32_t op_trace_value_size(const Value &) {
+    return OpTrace::kNoValueSize;
+}
+
+static inline
+std::uint32_t op_trace_value_size(const std::string & value) {
+    return static_cast<std::uint32_t>(value.size());
+}
+
+//
+// TracingMap: Wraps a jstd map (or std::unordered_map), forwards the operations
+// to the map and writes them to the trace. The writer must be opened with
+// OpTraceKey<key_type>::kFormat, see open_trace().
+//
+template <typename Map>
+class TracingMap {
+public:
+    typedef Map                                 map_type;
+    typedef typename Map::key_type              key_type;
+    typedef typename Map::mapped_type           mapped_type;
+    typedef typename Map::value_type            value_type;
+    typedef typename Map::size_type             size_type;
+    typedef typename Map::iterator              iterator;
+    typedef typename Map::const_iterator        const_iterator;
+
+    typedef OpTraceKey<key_type>                trace_key;
+
+private:
+    Map &           map_;
+    OpTraceWriter & writer_;
+
+public:
+    TracingMap(Map & map, OpTraceWriter & writer) : map_(map), writer_(writer) {
+    }
+
+    ~TracingMap() {}
+
+    bool open_trace(const std::string & filename) {
+        return this->writer_.open(filename, trace_key::kFormat);
+    }
+
+    Map & map() { return this->map_; }
+    const Map & map() const { return this->map_; }
+
+    OpTraceWriter & writer() { return this->writer_; }
+
+    size_type size() const { return this->map_.size(); }
+    bool empty() const { return this->map_.empty(); }
+
+    iterator begin() { return this->map_.begin(); }
+    iterator end() { return this->map_.end(); }
+    const_iterator begin() const { return this->map_.begin(); }
+    const_iterator end() const { return this->map_.end(); }
+
+    iterator find(const key_type & key) {
+        trace_key::write(this->writer_, OpTrace::kFind, key, OpTrace::kNoValueSize);
+        return this->map_.find(key);
+    }
+
+    size_type count(const key_type & key) {
+        trace_key::write(this->writer_, OpTrace::kFind, key, OpTrace::kNoValueSize);
+        return this->map_.count(key);
+    }
+
+    std::pair<iterator, bool> insert(const value_type & value) {
+        trace_key::write(this->writer_, OpTrace::kInsert, value.first, op_trace_value_size(value.second));
+        return this->map_.insert(value);
+    }
+
+    template <typename KeyT, typename MappedT>
+    std::pair<iterator, bool> emplace(KeyT && key, MappedT && value) {
+        trace_key::write(this->writer_, OpTrace::kInsert, key, op_trace_value_size(value));
+        return this->map_.emplace(std::forward<KeyT>(key), std::forward<MappedT>(value));
+    }
+
+    template <typename MappedT>
+    std::pair<iterator, bool> insert_or_assign(const key_type & key, MappedT && value) {
+        trace_key::write(this->writer_, OpTrace::kAssign, key, op_trace_value_size(value));
+        return this->map_.insert_or_assign(key, std::forward<MappedT>(value));
+    }
+
+    // The value is written after the record, so it's recorded as an insert without the value size.
+    mapped_type & operator [] (const key_type & key) {
+        trace_key::write(this->writer_, OpTrace::kInsert, key, OpTrace::kNoValueSize);
+        return this->map_[key];
+    }
+
+    size_type erase(const key_type & key) {
+        trace_key::write(this->writer_, OpTrace::kErase, key, OpTrace::kNoValueSize);
+        return this->map_.erase(key);
+    }
+};
+
+} // namespace jtest
+
+#endif // JSTD_TEST_OP_TRACE_H
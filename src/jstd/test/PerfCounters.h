@@ -0,0 +1,321 @@
+
+#ifndef JSTD_TEST_PERF_COUNTERS_H
+#define JSTD_TEST_PERF_COUNTERS_H
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1020)
+#pragma once
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "jstd/basic/stddef.h"
+#include "jstd/test/StopWatch.h"
+
+#if defined(__linux__) && defined(__NR_perf_event_open)
+  #define JSTD_HAVE_PERF_EVENT      1
+#else
+  #define JSTD_HAVE_PERF_EVENT      0
+#endif
+
+namespace jtest {
+
+//
+// The hardware performance counters of the current thread (user space only),
+// by Linux perf_event_open(2).
+//
+// Each counter is opened separately, so if some counters are not supported
+// by the CPU (or the VM), the others can still work. If the kernel multiplexes
+// the counters, the values are scaled by (time_enabled / time_running).
+//
+// When perf_event_open() is not permitted (e.g. in containers, or when
+// /proc/sys/kernel/perf_event_paranoid is too high), or on the other OS,
+// all counters are unavailable and all the operations are no-ops.
+// Set the environment variable JTEST_PERF_COUNTERS=0 to disable it.
+//
+// The counts are accumulated between the start() and stop() pairs, until reset().
+//
+class JSTD_DLL PerfCounters {
+public:
+    typedef std::size_t     size_type;
+    typedef std::uint64_t   count_type;
+
+    enum Event {
+        kCycles,
+        kInstructions,
+        kL1dMisses,
+        kLLCMisses,
+        kDTLBMisses,
+        kBranchMisses,
+        kEventCount
+    };
+
+private:
+    int         fds_[kEventCount];
+    count_type  counts_[kEventCount];
+    count_type  op_count_;
+    int         open_errno_;
+    bool        running_;
+
+public:
+    explicit PerfCounters(bool enabled = true) : op_count_(0), open_errno_(0), running_(false) {
+        for (size_type i = 0; i < kEventCount; i++) {
+            this->fds_[i] = -1;
+            this->counts_[i] = 0;
+        }
+        if (enabled && is_enabled_by_env()) {
+            this->open();
+        }
+    }
+
+    ~PerfCounters() {
+        this->close();
+    }
+
+    static const char * event_name(size_type event) {
+        static const char * const s_event_names[kEventCount] = {
+            "cycles", "instr", "L1d-miss", "LLC-miss", "dTLB-miss", "br-miss"
+        };
+        return (event < kEventCount) ? s_event_names[event] : "unknown";
+    }
+
+    static bool is_enabled_by_env() {
+        const char * env = ::getenv("JTEST_PERF_COUNTERS");
+        return !(env != nullptr && (::strcmp(env, "0") == 0 || ::strcmp(env, "off") == 0));
+    }
+
+    bool is_available() const noexcept {
+        for (size_type i = 0; i < kEventCount; i++) {
+            if (this->fds_[i] >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool has(size_type event) const noexcept {
+        return (event < kEventCount) && (this->fds_[event] >= 0);
+    }
+
+    // The reason why the counters are unavailable.
+    std::string status() const {
+        if (this->is_available())
+            return "available";
+#if JSTD_HAVE_PERF_EVENT
+        if (this->open_errno_ != 0)
+            return std::string("unavailable (perf_event_open: ") + ::strerror(this->open_errno_) + ")";
+        else
+            return "disabled";
+#else
+        return "unsupported";
+#endif
+    }
+
+    bool open() {
+#if JSTD_HAVE_PERF_EVENT
+        static const std::uint32_t s_types[kEventCount] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+            PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+        };
+        static const std::uint64_t s_configs[kEventCount] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            (PERF_COUNT_HW_CACHE_L1D  | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)),
+            PERF_COUNT_HW_CACHE_MISSES,
+            (PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)),
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        this->close();
+        for (size_type i = 0; i < kEventCount; i++) {
+            struct perf_event_attr attr;
+            ::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = s_types[i];
+            attr.config = s_configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            long fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fd >= 0) {
+                this->fds_[i] = static_cast<int>(fd);
+            } else {
+                this->fds_[i] = -1;
+                if (this->open_errno_ == 0)
+                    this->open_errno_ = errno;
+            }
+        }
+        return this->is_available();
+#else
+        return false;
+#endif
+    }
+
+    void close() {
+#if JSTD_HAVE_PERF_EVENT
+        for (size_type i = 0; i < kEventCount; i++) {
+            if (this->fds_[i] >= 0) {
+                ::close(this->fds_[i]);
+                this->fds_[i] = -1;
+            }
+        }
+#endif
+        this->running_ = false;
+    }
+
+    void reset() noexcept {
+        for (size_type i = 0; i < kEventCount; i++) {
+            this->counts_[i] = 0;
+        }
+        this->op_count_ = 0;
+    }
+
+    JSTD_FORCED_INLINE
+    void start() noexcept {
+#if JSTD_HAVE_PERF_EVENT
+        if (!this->running_) {
+            for (size_type i = 0; i < kEventCount; i++) {
+                if (this->fds_[i] >= 0) {
+                    ::ioctl(this->fds_[i], PERF_EVENT_IOC_RESET, 0);
+                    ::ioctl(this->fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+            this->running_ = true;
+        }
+#endif
+    }
+
+    JSTD_FORCED_INLINE
+    void stop(size_type op_count = 0) noexcept {
+#if JSTD_HAVE_PERF_EVENT
+        if (this->running_) {
+            for (size_type i = 0; i < kEventCount; i++) {
+                if (this->fds_[i] >= 0) {
+                    ::ioctl(this->fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+            for (size_type i = 0; i < kEventCount; i++) {
+                if (this->fds_[i] >= 0) {
+                    // { value, time_enabled, time_running }
+                    std::uint64_t data[3] = { 0, 0, 0 };
+                    if (::read(this->fds_[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data))) {
+                        if (data[2] != 0 && data[2] < data[1]) {
+                            data[0] = static_cast<std::uint64_t>(
+                                static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]));
+                        }
+                        this->counts_[i] += data[0];
+                    }
+                }
+            }
+            this->running_ = false;
+        }
+#endif
+        this->op_count_ += op_count;
+    }
+
+    count_type count(size_type event) const noexcept {
+        return (event < kEventCount) ? this->counts_[event] : 0;
+    }
+
+    count_type op_count() const noexcept {
+        return this->op_count_;
+    }
+
+    //
+    // The counts per operation, if op_count is 0, use the accumulated op_count of stop().
+    // Returns -1.0 if the counter is unavailable.
+    //
+    double per_op(size_type event, size_type op_count = 0) const noexcept {
+        if (!this->has(event))
+            return -1.0;
+        if (op_count == 0)
+            op_count = static_cast<size_type>(this->op_count_);
+        if (op_count == 0)
+            return -1.0;
+        return (static_cast<double>(this->counts_[event]) / static_cast<double>(op_count));
+    }
+
+    //
+    // Format as "cycles = 12.34, instr = 56.78, L1d-miss = 0.12, ...", per operation.
+    //
+    std::string format_per_op(size_type op_count = 0) const {
+        std::string result;
+        char buf[64];
+        for (size_type i = 0; i < kEventCount; i++) {
+            double value = this->per_op(i, op_count);
+            if (value >= 0.0)
+                ::snprintf(buf, sizeof(buf), "%s%s = %0.2f", (i != 0) ? ", " : "", event_name(i), value);
+            else
+                ::snprintf(buf, sizeof(buf), "%s%s = n/a", (i != 0) ? ", " : "", event_name(i));
+            result += buf;
+        }
+        return result;
+    }
+};
+
+//
+// Scope the counters to a block: start() on construction, stop(op_count) on destruction.
+//
+class JSTD_DLL PerfScope {
+private:
+    PerfCounters &          counters_;
+    PerfCounters::size_type op_count_;
+
+public:
+    explicit PerfScope(PerfCounters & counters, PerfCounters::size_type op_count = 0)
+        : counters_(counters), op_count_(op_count) {
+        this->counters_.start();
+    }
+
+    ~PerfScope() {
+        this->counters_.stop(this->op_count_);
+    }
+};
+
+//
+// A StopWatch that also scopes the counters between start() and stop(),
+// the counters are enabled outside of the timing window, so the overhead
+// of the ioctl() calls is not included in the elapsed time.
+//
+template <typename StopWatchT = StopWatch>
+class JSTD_DLL BasicPerfStopWatch : public StopWatchT {
+private:
+    PerfCounters & counters_;
+
+public:
+    explicit BasicPerfStopWatch(PerfCounters & counters) : StopWatchT(), counters_(counters) {}
+    ~BasicPerfStopWatch() {}
+
+    void start() {
+        this->counters_.start();
+        StopWatchT::start();
+    }
+
+    void stop() {
+        StopWatchT::stop();
+        this->counters_.stop();
+    }
+
+    PerfCounters & counters() { return this->counters_; }
+    const PerfCounters & counters() const { return this->counters_; }
+};
+
+typedef BasicPerfStopWatch<StopWatch> PerfStopWatch;
+
+} // namespace jtest
+
+#endif // JSTD_TEST_PERF_COUNTERS_H
@@ -682,9 +682,8 @@ struct call_static_name {
     }
 
     static std::string name() {
-        T t;
         std::string sname;
-        static_name_impl<T>(&t, &sname);
+        static_name_impl<T>(static_cast<const T *>(nullptr), &sname);
         return sname;
     }
 };
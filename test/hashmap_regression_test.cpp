@@ -0,0 +1,402 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <string>
+#include <utility>
+
+#include <jstd/hashmap/robin_hash_map.h>
+#include <jstd/hashmap/group15_flat_map.hpp>
+#include <jstd/hashmap/group16_flat_map.hpp>
+#include <jstd/hashmap/expiring_flat_map.hpp>
+#include <jstd/hashmap/group15_ordered_flat_map.hpp>
+#if defined(__AVX2__)
+// robin16_hash_map and flat16_hash_map require the AVX2 instructions.
+#include <jstd/hashmap/robin16_hash_map.h>
+#include <jstd/hashmap/flat16_hash_map.h>
+#endif
+#include <jstd/hashmap/map_layout_policy.h>
+#include <jstd/hashmap/capacity_policy.hpp>
+#include <jstd/hashmap/detail/hashmap_traits.h>
+#include <jstd/hasher/digest_hash.h>
+#include <jstd/system/Console.h>
+#include <jstd/test/Test.h>
+
+//
+// Regression tests for the hashmap fixes, run by ctest.
+//
+
+static int g_failed_count = 0;
+
+#define REGRESSION_CHECK(expr) \
+    do { \
+        printf("Test: [%s], ", #expr); \
+        if (expr) { \
+            jstd::print_passed_ln(); \
+        } else { \
+            jstd::print_failed_ln(); \
+            g_failed_count++; \
+        } \
+    } while (0)
+
+//
+// robin_hash_map<std::string, ...> stores the key-value pairs indirectly,
+// a miss of find() must return end(), not an iterator of the last slot.
+//
+void robin_hash_map_indirect_kv_find_miss_test()
+{
+    printf("robin_hash_map_indirect_kv_find_miss_test()\n\n");
+
+    typedef jstd::robin_hash_map<std::string, std::string> map_type;
+
+    map_type map;
+    REGRESSION_CHECK(map.find("missing") == map.end());
+
+    for (int i = 0; i < 100; i++) {
+        map.emplace(std::to_string(i), std::to_string(i * 2));
+    }
+    REGRESSION_CHECK(map.find("missing") == map.end());
+    REGRESSION_CHECK(map.find("42") != map.end());
+    REGRESSION_CHECK(map.find("42")->second == "84");
+
+    const map_type & cmap = map;
+    REGRESSION_CHECK(cmap.find("missing") == cmap.end());
+    REGRESSION_CHECK(cmap.find("missing", cmap.make_token("missing")) == cmap.end());
+    REGRESSION_CHECK(cmap.find("7", cmap.make_token("7")) != cmap.end());
+
+    printf("\n");
+}
+
+//
+// robin_hash_map<int, int> stores the key-value pairs in the slots,
+// a miss on the empty table has no slot to map back to an iterator.
+//
+void robin_hash_map_empty_find_miss_test()
+{
+    printf("robin_hash_map_empty_find_miss_test()\n\n");
+
+    typedef jstd::robin_hash_map<int, int> map_type;
+
+    map_type map;
+    const map_type & cmap = map;
+    REGRESSION_CHECK(map.find(1) == map.end());
+    REGRESSION_CHECK(cmap.find(1) == cmap.end());
+    REGRESSION_CHECK(cmap.find(1, cmap.make_token(1)) == cmap.end());
+
+    map.emplace(1, 2);
+    REGRESSION_CHECK(map.find(3) == map.end());
+    REGRESSION_CHECK(map.find(1) != map.end());
+
+    printf("\n");
+}
+
+//
+// Iterating to the end of a group15 map must compare equal to end(), and visit each element
+// exactly once. The iterator reaches the end either at the sentinel of its current group,
+// or after the scan of the following groups, both must reset it to end().
+//
+template <typename MapType, typename Iterator>
+bool iterate_to_end(MapType & map, Iterator first, Iterator last)
+{
+    std::size_t count = 0;
+    for (; first != last; ++first) {
+        count++;
+        if (count > map.size())
+            break;
+    }
+    return ((first == last) && (count == map.size()));
+}
+
+void group15_flat_map_iterate_to_end_test()
+{
+    printf("group15_flat_map_iterate_to_end_test()\n\n");
+
+    typedef jstd::group15_flat_map<int, int> map_type;
+
+    map_type map;
+    REGRESSION_CHECK(map.begin() == map.end());
+
+    map.emplace(1, 1);
+    REGRESSION_CHECK(iterate_to_end(map, map.begin(), map.end()));
+
+    for (int i = 0; i < 100; i++) {
+        map.emplace(i, i);
+    }
+    REGRESSION_CHECK(iterate_to_end(map, map.begin(), map.end()));
+
+    const map_type & cmap = map;
+    REGRESSION_CHECK(iterate_to_end(cmap, cmap.begin(), cmap.end()));
+    REGRESSION_CHECK(iterate_to_end(cmap, cmap.cbegin(), cmap.cend()));
+
+    // Leave the elements in the first groups only, the tail is a run of empty groups.
+    for (int i = 10; i < 100; i++) {
+        map.erase(i);
+    }
+    REGRESSION_CHECK(iterate_to_end(map, map.begin(), map.end()));
+
+    auto iter = map.begin();
+    for (std::size_t i = 0; i < map.size(); i++) {
+        iter++;
+    }
+    REGRESSION_CHECK(iter == map.end());
+
+    printf("\n");
+}
+
+//
+// The copy of a group15 map must keep the size of the source, the slots are copied
+// as a whole array (fast_copy_slots_from()), both by the copy constructor and
+// the copy assignment, then the copy must be equal to the source.
+//
+void group15_flat_map_copy_size_test()
+{
+    printf("group15_flat_map_copy_size_test()\n\n");
+
+    typedef jstd::group15_flat_map<int, int> map_type;
+
+    map_type empty_map;
+    map_type copy0(empty_map);
+    REGRESSION_CHECK(copy0.size() == 0);
+    REGRESSION_CHECK(copy0.begin() == copy0.end());
+
+    map_type map;
+    map.emplace(1, 2);
+    map_type copy1(map);
+    REGRESSION_CHECK(copy1.size() == 1);
+    REGRESSION_CHECK(copy1.find(1) != copy1.end());
+    REGRESSION_CHECK(copy1 == map);
+
+    for (int i = 0; i < 100; i++) {
+        map.emplace(i, i);
+    }
+    map_type copy2(map);
+    REGRESSION_CHECK(copy2.size() == map.size());
+    REGRESSION_CHECK(copy2.find(99) != copy2.end());
+    REGRESSION_CHECK(copy2 == map);
+
+    // The copy assignment into a map that already has the slots.
+    copy1 = map;
+    REGRESSION_CHECK(copy1.size() == map.size());
+    REGRESSION_CHECK(copy1 == map);
+
+    copy2 = empty_map;
+    REGRESSION_CHECK(copy2.size() == 0);
+    REGRESSION_CHECK(copy2.find(1) == copy2.end());
+
+    // The size is right for the later insertions and erasures.
+    copy1.emplace(1000, 1000);
+    copy1.erase(0);
+    REGRESSION_CHECK(copy1.size() == map.size());
+    REGRESSION_CHECK(!(copy1 == map));
+
+    printf("\n");
+}
+
+//
+// group16_flat_map::insert_or_assign() inserts a new key and assigns an existing one.
+//
+void group16_flat_map_insert_or_assign_test()
+{
+    printf("group16_flat_map_insert_or_assign_test()\n\n");
+
+    typedef jstd::group16_flat_map<int, std::string> map_type;
+
+    map_type map;
+    auto result1 = map.insert_or_assign(1, std::string("one"));
+    REGRESSION_CHECK(result1.second);
+    REGRESSION_CHECK(result1.first->second == "one");
+
+    auto result2 = map.insert_or_assign(1, "uno");
+    REGRESSION_CHECK(!result2.second);
+    REGRESSION_CHECK(result2.first == result1.first);
+    REGRESSION_CHECK(map[1] == "uno");
+    REGRESSION_CHECK(map.size() == 1);
+
+    const int key = 2;
+    auto result3 = map.insert_or_assign(key, "two");
+    REGRESSION_CHECK(result3.second);
+    REGRESSION_CHECK(map.size() == 2);
+
+    printf("\n");
+}
+
+//
+// An insertion into expiring_flat_map overwrites the expired entries of other keys
+// on its probe path, instead of growing the table.
+//
+void expiring_flat_map_reuse_expired_test()
+{
+    printf("expiring_flat_map_reuse_expired_test()\n\n");
+
+    typedef jstd::expiring_flat_map<int, int> map_type;
+
+    map_type map(10);
+    // Only the insertions reuse the expired entries, no incremental reclaim.
+    map.set_reclaim_groups(0);
+
+    int key = 0;
+    for (int i = 0; i < 1000; i++, key++) {
+        map.try_emplace(key, key);
+    }
+    std::size_t old_capacity = map.slot_capacity();
+
+    // Each round expires all the entries of the previous round.
+    for (int round = 0; round < 20; round++) {
+        map.advance(10);
+        for (int i = 0; i < 1000; i++, key++) {
+            map.try_emplace(key, key);
+        }
+    }
+    REGRESSION_CHECK(map.slot_capacity() == old_capacity);
+    REGRESSION_CHECK(map.size() + map.expired_count() == static_cast<std::size_t>(key));
+    REGRESSION_CHECK(map.find(0) == nullptr);
+    REGRESSION_CHECK(map.find(key - 1) != nullptr && *map.find(key - 1) == key - 1);
+
+    std::size_t live_count = 0;
+    map.for_each([&](const int & key, const int & value, std::uint32_t) {
+        if (key == value)
+            live_count++;
+    });
+    REGRESSION_CHECK(live_count == 1000);
+
+    printf("\n");
+}
+
+//
+// An insertion that doesn't reallocate the entries of group15_ordered_flat_map only appends,
+// an old iterator must walk to the new entries, and stop at the current end().
+//
+void group15_ordered_flat_map_append_iterator_test()
+{
+    printf("group15_ordered_flat_map_append_iterator_test()\n\n");
+
+    typedef jstd::group15_ordered_flat_map<int, int> map_type;
+
+    map_type map;
+    map.reserve(64);
+    map.emplace(1, 10);
+    map.emplace(2, 20);
+    map.erase(2);
+
+    // The end of the entries is at the position of the key 3 here.
+    map_type::iterator iter = map.begin();
+    map.emplace(3, 30);
+    map.emplace(4, 40);
+    map.erase(3);
+    ++iter;
+    REGRESSION_CHECK(iter != map.end());
+    REGRESSION_CHECK(iter != map.end() && iter->first == 4);
+    ++iter;
+    REGRESSION_CHECK(iter == map.end());
+
+    printf("\n");
+}
+
+//
+// A hint of group15_flat_map kept across the grows points into the freed blocks,
+// emplace_hint() must only use the group and the pos of it, validated against this table.
+//
+void group15_flat_map_stale_hint_test()
+{
+    printf("group15_flat_map_stale_hint_test()\n\n");
+
+    typedef jstd::group15_flat_map<std::string, int> map_type;
+
+    map_type map;
+    map.emplace("0", 0);
+    map_type::const_iterator hint = map.find("0");
+
+    // Grow several times, the old groups and slots are freed.
+    for (int i = 1; i < 1000; i++) {
+        map.emplace(std::to_string(i), i);
+    }
+
+    bool all_found = true;
+    for (int i = 0; i < 2000; i++) {
+        map_type::iterator iter = map.emplace_hint(hint, std::to_string(i), i);
+        if (iter == map.end() || iter->second != i)
+            all_found = false;
+    }
+    REGRESSION_CHECK(all_found);
+    REGRESSION_CHECK(map.size() == 2000);
+    REGRESSION_CHECK(map.find("1999") != map.end());
+
+    printf("\n");
+}
+
+//
+// jstd::identity_hash<T> of the sequential integer keys must not be treated as avalanching,
+// the engines that honor hash_is_avalanching<Hash> would put all the keys into a few home slots.
+//
+template <typename MapType>
+bool insert_and_find_sequential_keys(std::size_t count)
+{
+    MapType map;
+    for (std::size_t i = 0; i < count; i++) {
+        map.emplace(static_cast<std::uint64_t>(i), static_cast<std::uint64_t>(i * 2));
+    }
+    if (map.size() != count)
+        return false;
+    for (std::size_t i = 0; i < count; i++) {
+        auto iter = map.find(static_cast<std::uint64_t>(i));
+        if (iter == map.end() || iter->second != static_cast<std::uint64_t>(i * 2))
+            return false;
+    }
+    return (map.find(static_cast<std::uint64_t>(count)) == map.end());
+}
+
+void identity_hash_sequential_keys_test()
+{
+    printf("identity_hash_sequential_keys_test()\n\n");
+
+    typedef std::uint64_t                       key_type;
+    typedef jstd::identity_hash<key_type>       hasher;
+    typedef std::equal_to<key_type>             key_equal;
+    typedef jstd::capacity_layout_policy<key_type, key_type, jstd::fastrange_capacity_policy>
+                                                fastrange_layout;
+
+    static const std::size_t kKeyCount = 20000;
+
+    REGRESSION_CHECK(!jstd::detail::hash_is_avalanching<hasher>::value);
+    REGRESSION_CHECK(jstd::detail::hash_is_avalanching<jstd::prehashed_hash<key_type>>::value);
+
+    REGRESSION_CHECK((insert_and_find_sequential_keys<
+                      jstd::robin_hash_map<key_type, key_type, hasher>>(kKeyCount)));
+    REGRESSION_CHECK((insert_and_find_sequential_keys<
+                      jstd::robin_hash_map<key_type, key_type, hasher, key_equal, fastrange_layout>>(kKeyCount)));
+#if defined(__AVX2__)
+    REGRESSION_CHECK((insert_and_find_sequential_keys<
+                      jstd::robin16_hash_map<key_type, key_type, hasher>>(kKeyCount)));
+    REGRESSION_CHECK((insert_and_find_sequential_keys<
+                      jstd::flat16_hash_map<key_type, key_type, hasher>>(kKeyCount)));
+#endif
+    REGRESSION_CHECK((insert_and_find_sequential_keys<
+                      jstd::group15_flat_map<key_type, key_type, hasher>>(kKeyCount)));
+    REGRESSION_CHECK((insert_and_find_sequential_keys<
+                      jstd::group16_flat_map<key_type, key_type, hasher>>(kKeyCount)));
+
+    printf("\n");
+}
+
+int main(int argc, char * argv[])
+{
+    robin_hash_map_indirect_kv_find_miss_test();
+    robin_hash_map_empty_find_miss_test();
+    group15_flat_map_iterate_to_end_test();
+    group15_flat_map_copy_size_test();
+    group16_flat_map_insert_or_assign_test();
+    expiring_flat_map_reuse_expired_test();
+    group15_ordered_flat_map_append_iterator_test();
+    identity_hash_sequential_keys_test();
+    group15_flat_map_stale_hint_test();
+
+    if (g_failed_count != 0) {
+        printf("%d test(s) failed.\n\n", g_failed_count);
+        return 1;
+    }
+
+    //jstd::Console::ReadKey();
+    return 0;
+}